@@ -31,7 +31,9 @@ namespace btadmin = google::bigtable::admin::v2;
  * should only reconnect on those errors that indicate the credentials or
  * connections need refreshing.
  */
-class DefaultAdminClient : public google::cloud::bigtable::AdminClient {
+class DefaultAdminClient
+    : public google::cloud::bigtable::AdminClient,
+      public std::enable_shared_from_this<DefaultAdminClient> {
  private:
   // Introduce an early `private:` section because this type is used to define
   // the public interface, it should not be part of the public interface.
@@ -55,6 +57,18 @@ class DefaultAdminClient : public google::cloud::bigtable::AdminClient {
   std::string const& project() const override { return project_; }
   std::shared_ptr<grpc::Channel> Channel() override { return impl_.Channel(); }
   void reset() override { return impl_.reset(); }
+  std::future<std::size_t> WarmUp(std::chrono::milliseconds timeout) override {
+    return google::cloud::bigtable::internal::AsyncConnectAll(
+        shared_from_this(), timeout);
+  }
+  std::size_t ready_channel_count() override {
+    return impl_.ready_channel_count();
+  }
+
+  /// Connect all the channels, blocking the calling thread.
+  std::size_t ConnectAll(std::chrono::milliseconds timeout) {
+    return impl_.WarmUp(std::chrono::system_clock::now() + timeout);
+  }
 
   grpc::Status CreateTable(grpc::ClientContext* context,
                            btadmin::CreateTableRequest const& request,
@@ -152,8 +166,19 @@ namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 std::shared_ptr<AdminClient> CreateDefaultAdminClient(std::string project,
                                                       ClientOptions options) {
-  return std::make_shared<DefaultAdminClient>(std::move(project),
-                                              std::move(options));
+  auto warmup_timeout = options.warmup_timeout();
+  auto client = std::make_shared<DefaultAdminClient>(std::move(project),
+                                                     std::move(options));
+  if (warmup_timeout.count() > 0) {
+    client->ConnectAll(warmup_timeout);
+  }
+  return client;
+}
+
+std::future<std::size_t> AdminClient::WarmUp(std::chrono::milliseconds) {
+  std::promise<std::size_t> ready;
+  ready.set_value(0);
+  return ready.get_future();
 }
 
 }  // namespace BIGTABLE_CLIENT_NS
@@ -17,6 +17,8 @@
 
 #include "google/cloud/bigtable/client_options.h"
 #include <google/bigtable/admin/v2/bigtable_table_admin.grpc.pb.h>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -65,6 +67,24 @@ class AdminClient {
    */
   virtual void reset() = 0;
 
+  /**
+   * Create the connection pool and connect all its channels.
+   *
+   * The returned future is satisfied with the number of channels that are
+   * ready, once all of them are, or once @p timeout expires.  This function
+   * does not block, and the future can be discarded without waiting for the
+   * channels.  The default implementation, used by the test clients, has no
+   * channels to connect.
+   */
+  virtual std::future<std::size_t> WarmUp(std::chrono::milliseconds timeout);
+
+  /**
+   * Return the number of channels in the pool that are ready.
+   *
+   * This does not create the pool, nor does it start connecting any channels.
+   */
+  virtual std::size_t ready_channel_count() { return 0; }
+
   // The member functions of this class are not intended for general use by
   // application developers (they are simply a dependency injection point). Make
   // them protected, so the mock classes can override them, and then make the
@@ -0,0 +1,64 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_OPERATION_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_OPERATION_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * The result of an asynchronous timer.
+ *
+ * Timers are not very interesting by themselves, the only information we
+ * provide to the callback is the deadline configured for the timer.
+ */
+struct AsyncTimerResult {
+  std::chrono::system_clock::time_point deadline;
+};
+
+/**
+ * An asynchronous operation.
+ *
+ * Applications start asynchronous operations using the member functions in
+ * `bigtable::CompletionQueue` or the `Async*()` member functions in
+ * `bigtable::Table`. The operation completes when its callback is invoked.
+ * Applications can use the returned `AsyncOperation` to cancel the operation.
+ */
+class AsyncOperation {
+ public:
+  virtual ~AsyncOperation() = default;
+
+  /**
+   * Requests that the operation be cancelled.
+   *
+   * Cancellation is best effort: the operation may have completed already, or
+   * it may complete successfully before the cancellation takes effect. In any
+   * case the callback for the operation is still invoked exactly once. If the
+   * cancellation was effective the callback receives a `CANCELLED` status (or
+   * `ok == false` for timers).
+   */
+  virtual void Cancel() = 0;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_OPERATION_H_
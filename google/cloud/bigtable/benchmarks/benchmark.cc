@@ -45,6 +45,10 @@ Benchmark::Benchmark(BenchmarkSetup const& setup)
   }
   client_options_.set_connection_pool_size(
       static_cast<std::size_t>(setup_.thread_count()));
+  // Replace the channels before the service closes them for their age, the
+  // reconnections would otherwise show up in the tail latency of long runs.
+  client_options_.set_channel_refresh_period(std::chrono::minutes(30),
+                                             std::chrono::minutes(45));
 }
 
 Benchmark::~Benchmark() {
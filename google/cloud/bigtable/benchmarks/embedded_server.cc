@@ -13,13 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/benchmarks/embedded_server.h"
-#include "google/cloud/bigtable/benchmarks/random_mutation.h"
-#include "google/cloud/bigtable/benchmarks/setup.h"
+#include "google/cloud/bigtable/benchmarks/in_memory_table.h"
 #include <google/bigtable/admin/v2/bigtable_table_admin.grpc.pb.h>
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
 #include <atomic>
-#include <iomanip>
-#include <sstream>
+#include <map>
+#include <mutex>
 
 namespace btproto = google::bigtable::v2;
 namespace adminproto = google::bigtable::admin::v2;
@@ -29,92 +28,143 @@ namespace cloud {
 namespace bigtable {
 namespace benchmarks {
 /**
- * Implement the portions of the `google.bigtable.v2.Bigtable` interface
- * necessary for the benchmarks.
+ * The tables in the embedded server, shared by the data and admin services.
+ */
+class TableRegistry {
+ public:
+  grpc::Status CreateTable(std::string const& table_name,
+                           adminproto::CreateTableRequest const& request) {
+    std::vector<std::string> splits;
+    for (auto const& split : request.initial_splits()) {
+      splits.push_back(split.key());
+    }
+    std::map<std::string, int> column_families;
+    for (auto const& kv : request.table().column_families()) {
+      // Only the simplest garbage collection rule is enforced, the other
+      // rules keep all the versions.
+      column_families[kv.first] = kv.second.gc_rule().max_num_versions();
+    }
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (tables_.count(table_name) != 0) {
+      return grpc::Status(grpc::StatusCode::ALREADY_EXISTS,
+                          "table <" + table_name + "> already exists");
+    }
+    tables_.emplace(table_name, std::make_shared<InMemoryTable>(
+                                    std::move(splits),
+                                    std::move(column_families)));
+    return grpc::Status::OK;
+  }
+
+  grpc::Status DeleteTable(std::string const& table_name) {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (tables_.erase(table_name) == 0) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                          "table <" + table_name + "> not found");
+    }
+    return grpc::Status::OK;
+  }
+
+  /**
+   * Return the table called @p table_name.
+   *
+   * Some benchmarks write to tables they never create, so the data APIs
+   * create (an unsplit table with any column families) on demand.
+   */
+  std::shared_ptr<InMemoryTable> GetTable(std::string const& table_name) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& table = tables_[table_name];
+    if (not table) {
+      table = std::make_shared<InMemoryTable>();
+    }
+    return table;
+  }
+
+ private:
+  std::mutex mu_;
+  std::map<std::string, std::shared_ptr<InMemoryTable>> tables_;
+};
+
+/**
+ * Implement the `google.bigtable.v2.Bigtable` interface for the benchmarks.
  *
- * This is not a Mock (use `google::bigtable::v2::MockBigtableStub` for that,
- * nor is this a Fake implementation (use the Cloud Bigtable Emulator for that),
- * this is an implementation of the interface that returns hardcoded values.
- * It is suitable for the benchmarks, but for nothing else.
+ * This is not a Mock (use `google::bigtable::v2::MockBigtableStub` for that),
+ * nor a complete implementation of the service (use the Cloud Bigtable
+ * Emulator for that).  It stores the data in memory, as described in
+ * `InMemoryTable`, with the overhead kept as small as possible, so the
+ * benchmarks measure the client library.
  */
 class BigtableImpl final : public btproto::Bigtable::Service {
  public:
-  BigtableImpl()
-      : mutate_row_count_(0), mutate_rows_count_(0), read_rows_count_(0) {
-    // Prepare a list of random values to use at run-time.  This is because we
-    // want the overhead of this implementation to be as small as possible.
-    // Using a single value is an option, but compresses too well and makes the
-    // tests a bit unrealistic.
-    auto generator = google::cloud::internal::MakeDefaultPRNG();
-    values_.resize(1000);
-    std::generate(values_.begin(), values_.end(),
-                  [&generator]() { return MakeRandomValue(generator); });
-  }
+  explicit BigtableImpl(TableRegistry& tables)
+      : tables_(tables),
+        mutate_row_count_(0),
+        mutate_rows_count_(0),
+        read_rows_count_(0) {}
 
   grpc::Status MutateRow(grpc::ServerContext* context,
                          btproto::MutateRowRequest const* request,
                          btproto::MutateRowResponse* response) override {
     ++mutate_row_count_;
-    return grpc::Status::OK;
+    return tables_.GetTable(request->table_name())
+        ->MutateRow(request->row_key(), request->mutations());
   }
 
   grpc::Status MutateRows(
       grpc::ServerContext* context, btproto::MutateRowsRequest const* request,
       grpc::ServerWriter<btproto::MutateRowsResponse>* writer) override {
     ++mutate_rows_count_;
+    auto table = tables_.GetTable(request->table_name());
     btproto::MutateRowsResponse msg;
     for (int index = 0; index != request->entries_size(); ++index) {
+      auto const& request_entry = request->entries(index);
+      auto status =
+          table->MutateRow(request_entry.row_key(), request_entry.mutations());
       auto& entry = *msg.add_entries();
       entry.set_index(index);
-      entry.mutable_status()->set_code(grpc::StatusCode::OK);
+      entry.mutable_status()->set_code(status.error_code());
+      entry.mutable_status()->set_message(status.error_message());
     }
     writer->WriteLast(msg, grpc::WriteOptions());
     return grpc::Status::OK;
   }
 
-  grpc::Status ReadRows(
+  grpc::Status CheckAndMutateRow(
       grpc::ServerContext* context,
-      google::bigtable::v2::ReadRowsRequest const* request,
-      grpc::ServerWriter<google::bigtable::v2::ReadRowsResponse>* writer)
-      override {
+      btproto::CheckAndMutateRowRequest const* request,
+      btproto::CheckAndMutateRowResponse* response) override {
+    return tables_.GetTable(request->table_name())
+        ->CheckAndMutateRow(*request, *response);
+  }
+
+  grpc::Status ReadModifyWriteRow(
+      grpc::ServerContext* context,
+      btproto::ReadModifyWriteRowRequest const* request,
+      btproto::ReadModifyWriteRowResponse* response) override {
+    return tables_.GetTable(request->table_name())
+        ->ReadModifyWriteRow(*request, *response);
+  }
+
+  grpc::Status ReadRows(
+      grpc::ServerContext* context, btproto::ReadRowsRequest const* request,
+      grpc::ServerWriter<btproto::ReadRowsResponse>* writer) override {
     ++read_rows_count_;
-    std::int64_t rows_limit = 10000;
-    if (request->rows_limit() != 0) {
-      rows_limit = request->rows_limit();
-    }
+    return tables_.GetTable(request->table_name())
+        ->ReadRows(*request, [writer](btproto::ReadRowsResponse const& msg) {
+          return writer->Write(msg);
+        });
+  }
 
-    btproto::ReadRowsResponse msg;
-    for (std::int64_t i = 0; i != rows_limit; ++i) {
-      std::size_t idx = 0;
-      char const* cf = kColumnFamily;
-      std::ostringstream os;
-      os << "user" << std::setw(12) << std::setfill('0') << i;
-      std::string row_key = os.str();
-      for (int j = 0; j != kNumFields; ++j) {
-        auto& chunk = *msg.add_chunks();
-        // This is neither the real format of the keys, nor the keys requested,
-        // but it is good enough for a simulation.
-        chunk.set_row_key(row_key);
-        chunk.set_timestamp_micros(0);
-        chunk.mutable_family_name()->set_value(cf);
-        chunk.mutable_qualifier()->set_value("field" + std::to_string(j));
-        chunk.set_value(values_[idx]);
-        chunk.set_value_size(static_cast<std::int32_t>(values_[idx].size()));
-        if (++idx >= values_.size()) {
-          idx = 0;
-        }
-        cf = "";
-        if (j == kNumFields - 1) {
-          chunk.set_value_size(0);
-          chunk.set_commit_row(true);
-        }
-      }
-      if (i != request->rows_limit() - 1) {
-        writer->Write(msg);
-        msg = {};
+  grpc::Status SampleRowKeys(
+      grpc::ServerContext* context,
+      btproto::SampleRowKeysRequest const* request,
+      grpc::ServerWriter<btproto::SampleRowKeysResponse>* writer) override {
+    for (auto const& sample :
+         tables_.GetTable(request->table_name())->SampleRowKeys()) {
+      if (not writer->Write(sample)) {
+        break;
       }
     }
-    writer->WriteLast(msg, grpc::WriteOptions());
     return grpc::Status::OK;
   }
 
@@ -123,7 +173,7 @@ class BigtableImpl final : public btproto::Bigtable::Service {
   int read_rows_count() const { return read_rows_count_.load(); }
 
  private:
-  std::vector<std::string> values_;
+  TableRegistry& tables_;
   std::atomic<int> mutate_row_count_;
   std::atomic<int> mutate_rows_count_;
   std::atomic<int> read_rows_count_;
@@ -135,14 +185,21 @@ class BigtableImpl final : public btproto::Bigtable::Service {
  */
 class TableAdminImpl final : public adminproto::BigtableTableAdmin::Service {
  public:
-  TableAdminImpl() : create_table_count_(0), delete_table_count_(0) {}
+  explicit TableAdminImpl(TableRegistry& tables)
+      : tables_(tables), create_table_count_(0), delete_table_count_(0) {}
 
   grpc::Status CreateTable(
       grpc::ServerContext* context,
       google::bigtable::admin::v2::CreateTableRequest const* request,
       google::bigtable::admin::v2::Table* response) override {
     ++create_table_count_;
-    response->set_name(request->parent() + "/tables/" + request->table_id());
+    auto name = request->parent() + "/tables/" + request->table_id();
+    auto status = tables_.CreateTable(name, *request);
+    if (not status.ok()) {
+      return status;
+    }
+    *response = request->table();
+    response->set_name(std::move(name));
     return grpc::Status::OK;
   }
 
@@ -151,13 +208,14 @@ class TableAdminImpl final : public adminproto::BigtableTableAdmin::Service {
       google::bigtable::admin::v2::DeleteTableRequest const* request,
       ::google::protobuf::Empty* response) override {
     ++delete_table_count_;
-    return grpc::Status::OK;
+    return tables_.DeleteTable(request->name());
   }
 
   int create_table_count() const { return create_table_count_.load(); }
   int delete_table_count() const { return delete_table_count_.load(); }
 
  private:
+  TableRegistry& tables_;
   std::atomic<int> create_table_count_;
   std::atomic<int> delete_table_count_;
 };
@@ -165,7 +223,8 @@ class TableAdminImpl final : public adminproto::BigtableTableAdmin::Service {
 /// The implementation of EmbeddedServer.
 class DefaultEmbeddedServer : public EmbeddedServer {
  public:
-  explicit DefaultEmbeddedServer() {
+  explicit DefaultEmbeddedServer()
+      : bigtable_service_(tables_), admin_service_(tables_) {
     int port;
     std::string server_address("[::]:0");
     builder_.AddListeningPort(server_address, grpc::InsecureServerCredentials(),
@@ -177,6 +236,9 @@ class DefaultEmbeddedServer : public EmbeddedServer {
   }
 
   std::string address() const override { return address_; }
+  std::shared_ptr<grpc::Channel> InProcessChannel() override {
+    return server_->InProcessChannel(grpc::ChannelArguments());
+  }
   void Shutdown() override { server_->Shutdown(); }
   void Wait() override { server_->Wait(); }
 
@@ -197,6 +259,7 @@ class DefaultEmbeddedServer : public EmbeddedServer {
   }
 
  private:
+  TableRegistry tables_;
   BigtableImpl bigtable_service_;
   TableAdminImpl admin_service_;
   grpc::ServerBuilder builder_;
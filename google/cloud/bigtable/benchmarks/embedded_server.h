@@ -15,6 +15,7 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_EMBEDDED_SERVER_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_EMBEDDED_SERVER_H_
 
+#include <grpcpp/grpcpp.h>
 #include <memory>
 #include <string>
 
@@ -30,12 +31,19 @@ namespace benchmarks {
  * small changes to the library.  This class is used to run (using Wait()) and
  * stop (using Shutdown()) such a server, without exposing the implementation
  * details to the application.
+ *
+ * The server keeps the tables in memory, and implements the semantics of the
+ * Cloud Bigtable data APIs: the rows written by the benchmarks can be read
+ * back, with filters, row ranges, and row limits.  The tables are created by
+ * `CreateTable()`, or on their first use by any data API.
  */
 class EmbeddedServer {
  public:
   virtual ~EmbeddedServer() = default;
 
   virtual std::string address() const = 0;
+  /// Return a channel to the server that does not use the network.
+  virtual std::shared_ptr<grpc::Channel> InProcessChannel() = 0;
   virtual void Shutdown() = 0;
   virtual void Wait() = 0;
 
@@ -15,6 +15,8 @@
 #include "google/cloud/bigtable/benchmarks/embedded_server.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/bigtable/table_admin.h"
+#include "google/cloud/bigtable/testing/inprocess_admin_client.h"
+#include "google/cloud/bigtable/testing/inprocess_data_client.h"
 #include <gmock/gmock.h>
 #include <thread>
 
@@ -50,7 +52,7 @@ TEST(EmbeddedServer, Admin) {
   EXPECT_EQ(1, server->create_table_count());
 
   EXPECT_EQ(0, server->delete_table_count());
-  admin.DeleteTable("fake-table-02");
+  admin.DeleteTable("fake-table-01");
   EXPECT_EQ(1, server->delete_table_count());
 
   server->Shutdown();
@@ -113,6 +115,9 @@ TEST(EmbeddedServer, ReadRows1) {
                             "fake-project", "fake-instance", options),
                         "fake-table");
 
+  table.Apply(bigtable::SingleRowMutation(
+      "row1", {bigtable::SetCell("fam", "col", milliseconds(0), "val")}));
+
   EXPECT_EQ(0, server->read_rows_count());
   auto reader = table.ReadRows(bigtable::RowSet("row1"), 1,
                                bigtable::Filter::PassAllFilter());
@@ -134,9 +139,17 @@ TEST(EmbeddedServer, ReadRows100) {
                             "fake-project", "fake-instance", options),
                         "fake-table");
 
+  bigtable::BulkMutation bulk;
+  for (int i = 0; i != 200; ++i) {
+    bulk.emplace_back(bigtable::SingleRowMutation(
+        "row" + std::to_string(1000 + i),
+        {bigtable::SetCell("fam", "col", milliseconds(0), "val")}));
+  }
+  table.BulkApply(std::move(bulk));
+
   EXPECT_EQ(0, server->read_rows_count());
   auto reader =
-      table.ReadRows(bigtable::RowSet(bigtable::RowRange::StartingAt("foo")),
+      table.ReadRows(bigtable::RowSet(bigtable::RowRange::StartingAt("row1")),
                      100, bigtable::Filter::PassAllFilter());
   auto count = std::distance(reader.begin(), reader.end());
   EXPECT_EQ(100, count);
@@ -145,3 +158,61 @@ TEST(EmbeddedServer, ReadRows100) {
   server->Shutdown();
   wait_thread.join();
 }
+
+/// @test Verify that the server stores the data, using in-process channels.
+TEST(EmbeddedServer, ReadAfterWrite) {
+  auto server = CreateEmbeddedServer();
+  std::thread wait_thread([&server]() { server->Wait(); });
+
+  bigtable::TableAdmin admin(
+      std::make_shared<bigtable::testing::InProcessAdminClient>(
+          "fake-project", server->InProcessChannel()),
+      "fake-instance");
+  admin.CreateTable(
+      "fake-table",
+      bigtable::TableConfig({{"fam", bigtable::GcRule::MaxNumVersions(2)}},
+                            {"row2"}));
+  bigtable::Table table(
+      std::make_shared<bigtable::testing::InProcessDataClient>(
+          "fake-project", "fake-instance", server->InProcessChannel()),
+      "fake-table");
+
+  for (int i = 0; i != 3; ++i) {
+    for (auto const* key : {"row1", "row2", "row3"}) {
+      table.Apply(bigtable::SingleRowMutation(
+          key, {bigtable::SetCell("fam", "col", milliseconds(i),
+                                  std::to_string(i))}));
+    }
+  }
+  // The garbage collection rule keeps the 2 newest versions.
+  auto row = table.ReadRow("row2", bigtable::Filter::PassAllFilter());
+  ASSERT_TRUE(row.first);
+  ASSERT_EQ(2U, row.second.cells().size());
+  EXPECT_EQ("2", row.second.cells()[0].value());
+  EXPECT_EQ("1", row.second.cells()[1].value());
+
+  auto reader = table.ReadRows(
+      bigtable::RowSet(bigtable::RowRange::LeftOpen("row1", "row3")),
+      bigtable::Filter::Latest(1));
+  std::vector<std::string> keys;
+  for (auto const& r : reader) {
+    keys.push_back(r.row_key());
+  }
+  EXPECT_EQ((std::vector<std::string>{"row2", "row3"}), keys);
+
+  EXPECT_TRUE(table.CheckAndMutateRow(
+      "row1", bigtable::Filter::ValueRegex("2"),
+      {bigtable::SetCell("fam", "checked", milliseconds(0), "yes")}, {}));
+  auto counter = table.ReadModifyWriteRow(
+      "row1", bigtable::ReadModifyWriteRule::IncrementAmount("fam", "n", 5));
+  ASSERT_EQ(1U, counter.cells().size());
+  EXPECT_EQ(5, counter.cells()[0].value_as<bigtable::bigendian64_t>().get());
+
+  auto samples = table.SampleRows<std::vector>();
+  ASSERT_EQ(2U, samples.size());
+  EXPECT_EQ("row2", samples[0].row_key);
+
+  admin.DeleteTable("fake-table");
+  server->Shutdown();
+  wait_thread.join();
+}
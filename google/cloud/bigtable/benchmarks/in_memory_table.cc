@@ -0,0 +1,935 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/in_memory_table.h"
+#include "google/cloud/internal/random.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <random>
+#include <regex>
+
+namespace btproto = google::bigtable::v2;
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+namespace {
+/// Batch the rows returned by `ReadRows()` in messages of about this size.
+std::size_t const kMaxResponseBytes = 1024 * 1024;
+
+google::cloud::internal::DefaultPRNG& Generator() {
+  thread_local auto generator = google::cloud::internal::MakeDefaultPRNG();
+  return generator;
+}
+
+/// The timestamp for cells created by the server, with millisecond
+/// granularity, as Cloud Bigtable uses by default.
+std::int64_t ServerTimestamp() {
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  return static_cast<std::int64_t>(now.count()) * 1000;
+}
+
+std::string EncodeBigEndian(std::int64_t value) {
+  auto v = static_cast<std::uint64_t>(value);
+  std::string result(8, '\0');
+  for (int i = 7; i >= 0; --i, v >>= 8) {
+    result[i] = static_cast<char>(v & 0xFF);
+  }
+  return result;
+}
+
+std::int64_t DecodeBigEndian(std::string const& value) {
+  std::uint64_t v = 0;
+  for (char c : value) {
+    v = (v << 8) | static_cast<unsigned char>(c);
+  }
+  return static_cast<std::int64_t>(v);
+}
+
+/**
+ * A cell, as seen by the filters.
+ *
+ * The cells point to the data in the table, so they are only valid while the
+ * caller holds the lock for the tablet.
+ */
+struct Cell {
+  std::string const* family;
+  std::string const* column;
+  std::int64_t timestamp;
+  std::string const* value;
+  bool strip_value;
+  std::vector<std::string> labels;
+};
+
+std::string const& CellValue(Cell const& cell) {
+  static std::string const kEmpty;
+  return cell.strip_value ? kEmpty : *cell.value;
+}
+
+/// The order of the cells in a row: by family, column, and newest first.
+bool CellOrder(Cell const& a, Cell const& b) {
+  int cmp = a.family->compare(*b.family);
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  cmp = a.column->compare(*b.column);
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  return a.timestamp > b.timestamp;
+}
+
+template <typename Row>
+std::vector<Cell> MakeCells(Row const& row) {
+  std::vector<Cell> cells;
+  for (auto const& family : row) {
+    for (auto const& column : family.second) {
+      for (auto const& cell : column.second) {
+        cells.push_back(Cell{&family.first, &column.first, cell.first,
+                             &cell.second, false, {}});
+      }
+    }
+  }
+  return cells;
+}
+
+template <typename Row>
+std::int64_t RowBytes(std::string const& row_key, Row const& row) {
+  auto bytes = static_cast<std::int64_t>(row_key.size());
+  for (auto const& family : row) {
+    for (auto const& column : family.second) {
+      for (auto const& cell : column.second) {
+        bytes += family.first.size() + column.first.size() +
+                 cell.second.size() + sizeof(cell.first);
+      }
+    }
+  }
+  return bytes;
+}
+
+/**
+ * Return true if @p value is in a range of strings.
+ *
+ * The ranges in the filters use the same representation: an optional start
+ * (closed or open) and an optional end (closed or open).
+ */
+bool InRange(std::string const& value, bool has_start, bool start_open,
+             std::string const& start, bool has_end, bool end_open,
+             std::string const& end) {
+  if (has_start and (start_open ? value <= start : value < start)) {
+    return false;
+  }
+  return not has_end or (end_open ? value < end : value <= end);
+}
+
+bool InColumnRange(Cell const& cell, btproto::ColumnRange const& range) {
+  using R = btproto::ColumnRange;
+  if (*cell.family != range.family_name()) {
+    return false;
+  }
+  bool const start_open =
+      range.start_qualifier_case() == R::kStartQualifierOpen;
+  bool const end_open = range.end_qualifier_case() == R::kEndQualifierOpen;
+  return InRange(*cell.column,
+                 range.start_qualifier_case() != R::START_QUALIFIER_NOT_SET,
+                 start_open,
+                 start_open ? range.start_qualifier_open()
+                            : range.start_qualifier_closed(),
+                 range.end_qualifier_case() != R::END_QUALIFIER_NOT_SET,
+                 end_open,
+                 end_open ? range.end_qualifier_open()
+                          : range.end_qualifier_closed());
+}
+
+bool InValueRange(Cell const& cell, btproto::ValueRange const& range) {
+  using R = btproto::ValueRange;
+  bool const start_open = range.start_value_case() == R::kStartValueOpen;
+  bool const end_open = range.end_value_case() == R::kEndValueOpen;
+  return InRange(
+      CellValue(cell), range.start_value_case() != R::START_VALUE_NOT_SET,
+      start_open,
+      start_open ? range.start_value_open() : range.start_value_closed(),
+      range.end_value_case() != R::END_VALUE_NOT_SET, end_open,
+      end_open ? range.end_value_open() : range.end_value_closed());
+}
+
+/**
+ * A filter, with its regular expression (if any) compiled.
+ *
+ * The filters are compiled once for each request, and then applied to each
+ * row.
+ */
+struct CompiledFilter {
+  btproto::RowFilter const* proto = nullptr;
+  std::unique_ptr<std::regex> regex;
+  /// The filters in a chain or interleave, or the predicate, true, and false
+  /// filters of a condition.  A missing branch of a condition is null.
+  std::vector<std::unique_ptr<CompiledFilter>> children;
+};
+
+grpc::Status Compile(btproto::RowFilter const& proto, CompiledFilter& filter);
+
+grpc::Status CompileRegex(std::string const& pattern, CompiledFilter& filter) {
+  try {
+    filter.regex.reset(new std::regex(
+        pattern, std::regex::ECMAScript | std::regex::optimize));
+  } catch (std::regex_error const& ex) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "invalid regular expression <" + pattern +
+                            ">: " + ex.what());
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status CompileChild(btproto::RowFilter const* proto,
+                          CompiledFilter& filter) {
+  filter.children.emplace_back();
+  if (proto == nullptr) {
+    return grpc::Status::OK;
+  }
+  filter.children.back().reset(new CompiledFilter);
+  return Compile(*proto, *filter.children.back());
+}
+
+grpc::Status CompileChildren(
+    google::protobuf::RepeatedPtrField<btproto::RowFilter> const& children,
+    CompiledFilter& filter) {
+  for (auto const& child : children) {
+    auto status = CompileChild(&child, filter);
+    if (not status.ok()) {
+      return status;
+    }
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status Compile(btproto::RowFilter const& proto, CompiledFilter& filter) {
+  filter.proto = &proto;
+  switch (proto.filter_case()) {
+    case btproto::RowFilter::kChain:
+      return CompileChildren(proto.chain().filters(), filter);
+    case btproto::RowFilter::kInterleave:
+      return CompileChildren(proto.interleave().filters(), filter);
+    case btproto::RowFilter::kCondition: {
+      auto const& condition = proto.condition();
+      auto status = CompileChild(&condition.predicate_filter(), filter);
+      if (not status.ok()) {
+        return status;
+      }
+      status = CompileChild(
+          condition.has_true_filter() ? &condition.true_filter() : nullptr,
+          filter);
+      if (not status.ok()) {
+        return status;
+      }
+      return CompileChild(
+          condition.has_false_filter() ? &condition.false_filter() : nullptr,
+          filter);
+    }
+    case btproto::RowFilter::kSink:
+      return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                          "the sink filter is not supported");
+    case btproto::RowFilter::kRowKeyRegexFilter:
+      return CompileRegex(proto.row_key_regex_filter(), filter);
+    case btproto::RowFilter::kFamilyNameRegexFilter:
+      return CompileRegex(proto.family_name_regex_filter(), filter);
+    case btproto::RowFilter::kColumnQualifierRegexFilter:
+      return CompileRegex(proto.column_qualifier_regex_filter(), filter);
+    case btproto::RowFilter::kValueRegexFilter:
+      return CompileRegex(proto.value_regex_filter(), filter);
+    case btproto::RowFilter::kRowSampleFilter:
+      if (proto.row_sample_filter() < 0.0 or proto.row_sample_filter() > 1.0) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "row sample probability must be in [0, 1]");
+      }
+      return grpc::Status::OK;
+    case btproto::RowFilter::kCellsPerRowOffsetFilter:
+    case btproto::RowFilter::kCellsPerRowLimitFilter:
+    case btproto::RowFilter::kCellsPerColumnLimitFilter:
+      if (proto.cells_per_row_offset_filter() < 0 or
+          proto.cells_per_row_limit_filter() < 0 or
+          proto.cells_per_column_limit_filter() < 0) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "cell counts in filters must not be negative");
+      }
+      return grpc::Status::OK;
+    default:
+      return grpc::Status::OK;
+  }
+}
+
+/// Apply @p filter to the @p cells of the row @p row_key.
+std::vector<Cell> ApplyFilter(CompiledFilter const* filter,
+                              std::string const& row_key,
+                              std::vector<Cell> cells) {
+  if (filter == nullptr) {
+    return {};
+  }
+  auto keep_if = [&cells](std::function<bool(Cell const&)> const& pred) {
+    cells.erase(std::remove_if(cells.begin(), cells.end(),
+                               [&pred](Cell const& c) { return not pred(c); }),
+                cells.end());
+  };
+  auto const& proto = *filter->proto;
+  switch (proto.filter_case()) {
+    case btproto::RowFilter::kChain:
+      for (auto const& child : filter->children) {
+        if (cells.empty()) {
+          break;
+        }
+        cells = ApplyFilter(child.get(), row_key, std::move(cells));
+      }
+      break;
+    case btproto::RowFilter::kInterleave: {
+      std::vector<Cell> result;
+      for (auto const& child : filter->children) {
+        auto r = ApplyFilter(child.get(), row_key, cells);
+        result.insert(result.end(), std::make_move_iterator(r.begin()),
+                      std::make_move_iterator(r.end()));
+      }
+      std::stable_sort(result.begin(), result.end(), CellOrder);
+      return result;
+    }
+    case btproto::RowFilter::kCondition: {
+      bool const matched =
+          not ApplyFilter(filter->children[0].get(), row_key, cells).empty();
+      return ApplyFilter(filter->children[matched ? 1 : 2].get(), row_key,
+                         std::move(cells));
+    }
+    case btproto::RowFilter::kBlockAllFilter:
+      if (proto.block_all_filter()) {
+        cells.clear();
+      }
+      break;
+    case btproto::RowFilter::kRowKeyRegexFilter:
+      if (not std::regex_match(row_key, *filter->regex)) {
+        cells.clear();
+      }
+      break;
+    case btproto::RowFilter::kRowSampleFilter: {
+      std::bernoulli_distribution sample(proto.row_sample_filter());
+      if (not sample(Generator())) {
+        cells.clear();
+      }
+      break;
+    }
+    case btproto::RowFilter::kFamilyNameRegexFilter:
+      keep_if([filter](Cell const& c) {
+        return std::regex_match(*c.family, *filter->regex);
+      });
+      break;
+    case btproto::RowFilter::kColumnQualifierRegexFilter:
+      keep_if([filter](Cell const& c) {
+        return std::regex_match(*c.column, *filter->regex);
+      });
+      break;
+    case btproto::RowFilter::kColumnRangeFilter:
+      keep_if([&proto](Cell const& c) {
+        return InColumnRange(c, proto.column_range_filter());
+      });
+      break;
+    case btproto::RowFilter::kTimestampRangeFilter: {
+      auto const& range = proto.timestamp_range_filter();
+      auto const start = range.start_timestamp_micros();
+      auto const end = range.end_timestamp_micros();
+      keep_if([start, end](Cell const& c) {
+        return c.timestamp >= start and (end == 0 or c.timestamp < end);
+      });
+      break;
+    }
+    case btproto::RowFilter::kValueRegexFilter:
+      keep_if([filter](Cell const& c) {
+        return std::regex_match(CellValue(c), *filter->regex);
+      });
+      break;
+    case btproto::RowFilter::kValueRangeFilter:
+      keep_if([&proto](Cell const& c) {
+        return InValueRange(c, proto.value_range_filter());
+      });
+      break;
+    case btproto::RowFilter::kCellsPerRowOffsetFilter: {
+      auto n = std::min(cells.size(),
+                        static_cast<std::size_t>(
+                            proto.cells_per_row_offset_filter()));
+      cells.erase(cells.begin(), cells.begin() + n);
+      break;
+    }
+    case btproto::RowFilter::kCellsPerRowLimitFilter: {
+      auto n = std::min(
+          cells.size(),
+          static_cast<std::size_t>(proto.cells_per_row_limit_filter()));
+      cells.resize(n);
+      break;
+    }
+    case btproto::RowFilter::kCellsPerColumnLimitFilter: {
+      auto const limit = proto.cells_per_column_limit_filter();
+      std::string const* family = nullptr;
+      std::string const* column = nullptr;
+      int count = 0;
+      keep_if([limit, &family, &column, &count](Cell const& c) {
+        if (family == nullptr or *family != *c.family or *column != *c.column) {
+          family = c.family;
+          column = c.column;
+          count = 0;
+        }
+        return ++count <= limit;
+      });
+      break;
+    }
+    case btproto::RowFilter::kStripValueTransformer:
+      if (proto.strip_value_transformer()) {
+        for (auto& c : cells) {
+          c.strip_value = true;
+        }
+      }
+      break;
+    case btproto::RowFilter::kApplyLabelTransformer:
+      for (auto& c : cells) {
+        c.labels.push_back(proto.apply_label_transformer());
+      }
+      break;
+    default:
+      // The pass all filter, and an empty filter, return all the cells.
+      break;
+  }
+  return cells;
+}
+
+/**
+ * Append the row @p row_key to @p response, if any of its cells pass @p filter.
+ *
+ * @return true if the row was added.
+ */
+template <typename Row>
+bool AppendRow(CompiledFilter const& filter, std::string const& row_key,
+               Row const& row, btproto::ReadRowsResponse& response,
+               std::size_t& response_bytes) {
+  auto cells = ApplyFilter(&filter, row_key, MakeCells(row));
+  if (cells.empty()) {
+    return false;
+  }
+  std::string const* family = nullptr;
+  std::string const* column = nullptr;
+  response_bytes += row_key.size();
+  for (auto const& cell : cells) {
+    auto& chunk = *response.add_chunks();
+    if (family == nullptr) {
+      chunk.set_row_key(row_key);
+    }
+    if (family == nullptr or *family != *cell.family) {
+      family = cell.family;
+      column = nullptr;
+      chunk.mutable_family_name()->set_value(*family);
+    }
+    if (column == nullptr or *column != *cell.column) {
+      column = cell.column;
+      chunk.mutable_qualifier()->set_value(*column);
+    }
+    chunk.set_timestamp_micros(cell.timestamp);
+    for (auto const& label : cell.labels) {
+      chunk.add_labels(label);
+    }
+    chunk.set_value(CellValue(cell));
+    response_bytes += column->size() + chunk.value().size();
+  }
+  response.mutable_chunks(response.chunks_size() - 1)->set_commit_row(true);
+  return true;
+}
+
+/// A range of row keys, an empty end means there is no limit.
+struct KeyRange {
+  std::string start;
+  bool start_open;
+  std::string end;
+  bool end_open;
+
+  bool AboveEnd(std::string const& key) const {
+    if (end.empty()) {
+      return false;
+    }
+    return end_open ? key >= end : key > end;
+  }
+};
+
+/// Convert @p rows to a list of ranges, sorted by their start.
+std::vector<KeyRange> MakeKeyRanges(btproto::RowSet const& rows) {
+  std::vector<KeyRange> ranges;
+  // Special case: an empty RowSet means "all rows".
+  if (rows.row_keys().empty() and rows.row_ranges().empty()) {
+    ranges.push_back(KeyRange{std::string(), false, std::string(), false});
+    return ranges;
+  }
+  for (auto const& key : rows.row_keys()) {
+    if (not key.empty()) {
+      ranges.push_back(KeyRange{key, false, key, false});
+    }
+  }
+  for (auto const& r : rows.row_ranges()) {
+    KeyRange range{std::string(), false, std::string(), false};
+    switch (r.start_key_case()) {
+      case btproto::RowRange::kStartKeyClosed:
+        range.start = r.start_key_closed();
+        break;
+      case btproto::RowRange::kStartKeyOpen:
+        range.start = r.start_key_open();
+        range.start_open = true;
+        break;
+      default:
+        break;
+    }
+    switch (r.end_key_case()) {
+      case btproto::RowRange::kEndKeyClosed:
+        range.end = r.end_key_closed();
+        break;
+      case btproto::RowRange::kEndKeyOpen:
+        range.end = r.end_key_open();
+        range.end_open = true;
+        break;
+      default:
+        break;
+    }
+    ranges.push_back(std::move(range));
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](KeyRange const& a, KeyRange const& b) {
+              if (a.start != b.start) {
+                return a.start < b.start;
+              }
+              return not a.start_open and b.start_open;
+            });
+  return ranges;
+}
+
+std::vector<std::string> SortedSplits(std::vector<std::string> splits) {
+  splits.erase(std::remove(splits.begin(), splits.end(), std::string()),
+               splits.end());
+  std::sort(splits.begin(), splits.end());
+  splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+  return splits;
+}
+}  // namespace
+
+InMemoryTable::InMemoryTable(std::vector<std::string> splits,
+                             std::map<std::string, int> column_families)
+    : splits_(SortedSplits(std::move(splits))),
+      column_families_(std::move(column_families)) {
+  for (std::size_t i = 0; i != splits_.size() + 1; ++i) {
+    tablets_.emplace_back(new Tablet);
+  }
+}
+
+grpc::Status InMemoryTable::MutateRow(
+    std::string const& row_key,
+    google::protobuf::RepeatedPtrField<btproto::Mutation> const& mutations) {
+  if (row_key.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "row key must not be empty");
+  }
+  auto status = ValidateMutations(mutations);
+  if (not status.ok()) {
+    return status;
+  }
+  auto& tablet = *tablets_[TabletIndex(row_key)];
+  std::lock_guard<std::mutex> lk(tablet.mu);
+  ApplyMutations(tablet, row_key, mutations);
+  return grpc::Status::OK;
+}
+
+grpc::Status InMemoryTable::CheckAndMutateRow(
+    btproto::CheckAndMutateRowRequest const& request,
+    btproto::CheckAndMutateRowResponse& response) {
+  if (request.row_key().empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "row key must not be empty");
+  }
+  // A missing predicate checks if the row has any cells, which is what the
+  // (empty) default filter does.
+  CompiledFilter predicate;
+  auto status = Compile(request.predicate_filter(), predicate);
+  if (not status.ok()) {
+    return status;
+  }
+  for (auto const* mutations :
+       {&request.true_mutations(), &request.false_mutations()}) {
+    if (mutations->empty()) {
+      continue;
+    }
+    status = ValidateMutations(*mutations);
+    if (not status.ok()) {
+      return status;
+    }
+  }
+
+  auto& tablet = *tablets_[TabletIndex(request.row_key())];
+  std::lock_guard<std::mutex> lk(tablet.mu);
+  auto row = tablet.rows.find(request.row_key());
+  bool const matched =
+      row != tablet.rows.end() and
+      not ApplyFilter(&predicate, row->first, MakeCells(row->second)).empty();
+  auto const& mutations =
+      matched ? request.true_mutations() : request.false_mutations();
+  if (not mutations.empty()) {
+    ApplyMutations(tablet, request.row_key(), mutations);
+  }
+  response.set_predicate_matched(matched);
+  return grpc::Status::OK;
+}
+
+grpc::Status InMemoryTable::ReadModifyWriteRow(
+    btproto::ReadModifyWriteRowRequest const& request,
+    btproto::ReadModifyWriteRowResponse& response) {
+  if (request.row_key().empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "row key must not be empty");
+  }
+  if (request.rules().empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "at least one rule is required");
+  }
+  for (auto const& rule : request.rules()) {
+    if (rule.family_name().empty() or
+        (not column_families_.empty() and
+         column_families_.count(rule.family_name()) == 0)) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                          "column family <" + rule.family_name() +
+                              "> not found");
+    }
+    if (rule.rule_case() == btproto::ReadModifyWriteRule::RULE_NOT_SET) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "rule must set append_value or increment_amount");
+    }
+  }
+
+  auto& tablet = *tablets_[TabletIndex(request.row_key())];
+  std::lock_guard<std::mutex> lk(tablet.mu);
+  auto row = tablet.rows.find(request.row_key());
+
+  // Compute all the new values before changing the row, so the row is
+  // unchanged if any rule fails.  Later rules see the results of earlier rules.
+  std::map<std::string, std::map<std::string, std::string>> values;
+  for (auto const& rule : request.rules()) {
+    auto& family = values[rule.family_name()];
+    auto value = family.find(rule.column_qualifier());
+    if (value == family.end()) {
+      std::string current;
+      if (row != tablet.rows.end()) {
+        auto f = row->second.find(rule.family_name());
+        if (f != row->second.end()) {
+          auto c = f->second.find(rule.column_qualifier());
+          if (c != f->second.end() and not c->second.empty()) {
+            current = c->second.begin()->second;
+          }
+        }
+      }
+      value = family.emplace(rule.column_qualifier(), std::move(current)).first;
+    }
+    if (rule.rule_case() == btproto::ReadModifyWriteRule::kAppendValue) {
+      value->second += rule.append_value();
+      continue;
+    }
+    if (not value->second.empty() and value->second.size() != 8) {
+      return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                          "cannot increment a value that is not a 64-bit "
+                          "big-endian integer");
+    }
+    value->second = EncodeBigEndian(DecodeBigEndian(value->second) +
+                                    rule.increment_amount());
+  }
+
+  auto const now = ServerTimestamp();
+  auto& stored = tablet.rows[request.row_key()];
+  auto& result = *response.mutable_row();
+  result.set_key(request.row_key());
+  for (auto& family : values) {
+    auto& result_family = *result.add_families();
+    result_family.set_name(family.first);
+    for (auto& value : family.second) {
+      auto& column = stored[family.first][value.first];
+      // The new cell must be the latest version, even if the clocks disagree.
+      auto timestamp =
+          column.empty() ? now : std::max(now, column.begin()->first);
+      auto& result_column = *result_family.add_columns();
+      result_column.set_qualifier(value.first);
+      auto& cell = *result_column.add_cells();
+      cell.set_timestamp_micros(timestamp);
+      cell.set_value(value.second);
+      column[timestamp] = std::move(value.second);
+      GarbageCollect(family.first, column);
+    }
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status InMemoryTable::ReadRows(
+    btproto::ReadRowsRequest const& request,
+    std::function<bool(btproto::ReadRowsResponse const&)> const& write) {
+  if (request.rows_limit() < 0) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "rows_limit must not be negative");
+  }
+  CompiledFilter filter;
+  auto status = Compile(request.filter(), filter);
+  if (not status.ok()) {
+    return status;
+  }
+
+  auto const ranges = MakeKeyRanges(request.rows());
+  std::int64_t const rows_limit = request.rows_limit();
+  std::int64_t row_count = 0;
+  btproto::ReadRowsResponse response;
+  std::size_t response_bytes = 0;
+  // The last row scanned, the ranges may overlap and each row is returned
+  // only once.
+  std::string last;
+  bool has_last = false;
+  bool done = false;
+  for (auto const& range : ranges) {
+    if (done) {
+      break;
+    }
+    std::string start = range.start;
+    bool start_open = range.start_open;
+    if (has_last and last >= start) {
+      start = last;
+      start_open = true;
+    }
+    // Scan one tablet at a time, and release its lock to send each response.
+    auto index = TabletIndex(start);
+    for (;;) {
+      bool range_done = false;
+      bool tablet_done = false;
+      {
+        auto& tablet = *tablets_[index];
+        std::lock_guard<std::mutex> lk(tablet.mu);
+        auto i = start_open ? tablet.rows.upper_bound(start)
+                            : tablet.rows.lower_bound(start);
+        for (; i != tablet.rows.end(); ++i) {
+          if (range.AboveEnd(i->first)) {
+            range_done = true;
+            break;
+          }
+          if (response_bytes >= kMaxResponseBytes) {
+            break;
+          }
+          last = i->first;
+          has_last = true;
+          if (AppendRow(filter, i->first, i->second, response,
+                        response_bytes) and
+              ++row_count == rows_limit) {
+            range_done = true;
+            done = true;
+            break;
+          }
+        }
+        tablet_done = i == tablet.rows.end();
+      }
+      if (response_bytes >= kMaxResponseBytes) {
+        if (not write(response)) {
+          // The client cancelled the call, there is nobody to report to.
+          return grpc::Status::OK;
+        }
+        response.Clear();
+        response_bytes = 0;
+      }
+      if (range_done) {
+        break;
+      }
+      if (tablet_done) {
+        if (++index == tablets_.size()) {
+          break;
+        }
+        start = splits_[index - 1];
+        start_open = false;
+        continue;
+      }
+      // The response was full, continue after the last row.
+      start = last;
+      start_open = true;
+    }
+  }
+  if (response.chunks_size() != 0) {
+    write(response);
+  }
+  return grpc::Status::OK;
+}
+
+std::vector<btproto::SampleRowKeysResponse> InMemoryTable::SampleRowKeys() {
+  std::vector<btproto::SampleRowKeysResponse> samples;
+  std::int64_t offset = 0;
+  for (std::size_t i = 0; i != tablets_.size(); ++i) {
+    {
+      auto& tablet = *tablets_[i];
+      std::lock_guard<std::mutex> lk(tablet.mu);
+      for (auto const& row : tablet.rows) {
+        offset += RowBytes(row.first, row.second);
+      }
+    }
+    btproto::SampleRowKeysResponse sample;
+    if (i != splits_.size()) {
+      sample.set_row_key(splits_[i]);
+    }
+    sample.set_offset_bytes(offset);
+    samples.push_back(std::move(sample));
+  }
+  return samples;
+}
+
+std::size_t InMemoryTable::TabletIndex(std::string const& row_key) const {
+  return static_cast<std::size_t>(
+      std::upper_bound(splits_.begin(), splits_.end(), row_key) -
+      splits_.begin());
+}
+
+grpc::Status InMemoryTable::ValidateMutations(
+    google::protobuf::RepeatedPtrField<btproto::Mutation> const& mutations)
+    const {
+  if (mutations.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "at least one mutation is required");
+  }
+  auto check_family = [this](std::string const& family_name) {
+    if (family_name.empty() or (not column_families_.empty() and
+                                column_families_.count(family_name) == 0)) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                          "column family <" + family_name + "> not found");
+    }
+    return grpc::Status::OK;
+  };
+  for (auto const& m : mutations) {
+    switch (m.mutation_case()) {
+      case btproto::Mutation::kSetCell: {
+        auto status = check_family(m.set_cell().family_name());
+        if (not status.ok()) {
+          return status;
+        }
+        if (m.set_cell().timestamp_micros() < -1) {
+          return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "invalid timestamp in SetCell mutation");
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromColumn: {
+        auto status = check_family(m.delete_from_column().family_name());
+        if (not status.ok()) {
+          return status;
+        }
+        auto const& range = m.delete_from_column().time_range();
+        if (range.end_timestamp_micros() != 0 and
+            range.end_timestamp_micros() < range.start_timestamp_micros()) {
+          return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "invalid time range in DeleteFromColumn");
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromFamily: {
+        auto status = check_family(m.delete_from_family().family_name());
+        if (not status.ok()) {
+          return status;
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromRow:
+        break;
+      default:
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "mutation type not set");
+    }
+  }
+  return grpc::Status::OK;
+}
+
+void InMemoryTable::ApplyMutations(
+    Tablet& tablet, std::string const& row_key,
+    google::protobuf::RepeatedPtrField<btproto::Mutation> const& mutations) {
+  auto const now = ServerTimestamp();
+  auto& rows = tablet.rows;
+  for (auto const& m : mutations) {
+    switch (m.mutation_case()) {
+      case btproto::Mutation::kSetCell: {
+        auto const& set_cell = m.set_cell();
+        auto& column = rows[row_key][set_cell.family_name()]
+                           [set_cell.column_qualifier()];
+        auto timestamp = set_cell.timestamp_micros() == -1
+                             ? now
+                             : set_cell.timestamp_micros();
+        column[timestamp] = set_cell.value();
+        GarbageCollect(set_cell.family_name(), column);
+        break;
+      }
+      case btproto::Mutation::kDeleteFromColumn: {
+        auto const& d = m.delete_from_column();
+        auto row = rows.find(row_key);
+        if (row == rows.end()) {
+          break;
+        }
+        auto family = row->second.find(d.family_name());
+        if (family == row->second.end()) {
+          break;
+        }
+        auto column = family->second.find(d.column_qualifier());
+        if (column == family->second.end()) {
+          break;
+        }
+        auto const start = d.time_range().start_timestamp_micros();
+        auto const end = d.time_range().end_timestamp_micros();
+        // The cells are sorted by descending timestamp.
+        auto& cells = column->second;
+        auto first = end == 0 ? cells.begin() : cells.upper_bound(end);
+        cells.erase(first, cells.upper_bound(start));
+        if (cells.empty()) {
+          family->second.erase(column);
+        }
+        if (family->second.empty()) {
+          row->second.erase(family);
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromFamily: {
+        auto row = rows.find(row_key);
+        if (row != rows.end()) {
+          row->second.erase(m.delete_from_family().family_name());
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromRow:
+        rows.erase(row_key);
+        break;
+      default:
+        break;
+    }
+  }
+  // Rows without cells do not exist.
+  auto row = rows.find(row_key);
+  if (row != rows.end() and row->second.empty()) {
+    rows.erase(row);
+  }
+}
+
+void InMemoryTable::GarbageCollect(std::string const& family_name,
+                                   Column& column) const {
+  auto family = column_families_.find(family_name);
+  if (family == column_families_.end() or family->second <= 0 or
+      column.size() <= static_cast<std::size_t>(family->second)) {
+    return;
+  }
+  column.erase(std::next(column.begin(), family->second), column.end());
+}
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,137 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_IN_MEMORY_TABLE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_IN_MEMORY_TABLE_H_
+
+#include <google/bigtable/v2/bigtable.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+/**
+ * Store the data for one table of the embedded server.
+ *
+ * The table keeps the cells in memory, ordered by row key, column family,
+ * column qualifier, and (descending) timestamp, and implements the semantics of
+ * the `google.bigtable.v2.Bigtable` data operations on them: mutations are
+ * atomic for each row, reads return the rows in order, with the filters
+ * applied.
+ *
+ * Like a Cloud Bigtable table, the rows are divided into tablets at the
+ * initial splits of the table.  Each tablet is an ordered map with its own
+ * mutex, so operations on different tablets do not contend.  Reads lock one
+ * tablet at a time, and only for a batch of rows, so long scans do not block
+ * writers.
+ *
+ * The regular expressions in the filters use the ECMAScript syntax of
+ * `std::regex`, which agrees with the RE2 syntax used by Cloud Bigtable for
+ * the common cases.  The `sink` filter is not supported.
+ */
+class InMemoryTable {
+ public:
+  /**
+   * Create an empty table.
+   *
+   * @param splits the initial splits, the first key of each tablet but the
+   *     first one.
+   * @param column_families the column families and the maximum number of
+   *     versions kept for each (0 means no limit).  If empty, the table accepts
+   *     mutations for any column family and keeps all the versions.
+   */
+  explicit InMemoryTable(std::vector<std::string> splits = {},
+                         std::map<std::string, int> column_families = {});
+
+  InMemoryTable(InMemoryTable const&) = delete;
+  InMemoryTable& operator=(InMemoryTable const&) = delete;
+
+  /// Apply @p mutations atomically to the row @p row_key.
+  grpc::Status MutateRow(
+      std::string const& row_key,
+      google::protobuf::RepeatedPtrField<google::bigtable::v2::Mutation> const&
+          mutations);
+
+  grpc::Status CheckAndMutateRow(
+      google::bigtable::v2::CheckAndMutateRowRequest const& request,
+      google::bigtable::v2::CheckAndMutateRowResponse& response);
+
+  grpc::Status ReadModifyWriteRow(
+      google::bigtable::v2::ReadModifyWriteRowRequest const& request,
+      google::bigtable::v2::ReadModifyWriteRowResponse& response);
+
+  /**
+   * Read the rows in @p request, and send them to @p write.
+   *
+   * @param write called with each response message, returns false if the
+   *     message could not be sent (e.g. the call was cancelled), and the read
+   *     should stop.
+   */
+  grpc::Status ReadRows(
+      google::bigtable::v2::ReadRowsRequest const& request,
+      std::function<bool(google::bigtable::v2::ReadRowsResponse const&)> const&
+          write);
+
+  /// Return the end key of each tablet, and the approximate size of the data
+  /// before it.  The last sample, with an empty key, is the end of the table.
+  std::vector<google::bigtable::v2::SampleRowKeysResponse> SampleRowKeys();
+
+ private:
+  /// The cells in a column, ordered from the newest to the oldest.
+  using Column =
+      std::map<std::int64_t, std::string, std::greater<std::int64_t>>;
+  using Family = std::map<std::string, Column>;
+  using Row = std::map<std::string, Family>;
+
+  struct Tablet {
+    std::mutex mu;
+    std::map<std::string, Row> rows;
+  };
+
+  /// Return the index of the tablet containing @p row_key.
+  std::size_t TabletIndex(std::string const& row_key) const;
+
+  /// Validate @p mutations before applying any of them.
+  grpc::Status ValidateMutations(
+      google::protobuf::RepeatedPtrField<google::bigtable::v2::Mutation> const&
+          mutations) const;
+
+  /// Apply (validated) @p mutations to the row @p row_key of @p tablet.
+  void ApplyMutations(
+      Tablet& tablet, std::string const& row_key,
+      google::protobuf::RepeatedPtrField<google::bigtable::v2::Mutation> const&
+          mutations);
+
+  /// Discard the versions of a column beyond the limit of its family.
+  void GarbageCollect(std::string const& family_name, Column& column) const;
+
+  std::vector<std::string> const splits_;
+  std::map<std::string, int> const column_families_;
+  std::vector<std::unique_ptr<Tablet>> tablets_;
+};
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_IN_MEMORY_TABLE_H_
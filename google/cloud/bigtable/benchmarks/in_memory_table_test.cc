@@ -0,0 +1,408 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/in_memory_table.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/mutations.h"
+#include "google/cloud/bigtable/row_set.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using bigtable::benchmarks::InMemoryTable;
+using std::chrono::milliseconds;
+using ::testing::ElementsAre;
+
+namespace {
+/// Apply @p mutations to @p row_key, and verify they are successful.
+void Apply(InMemoryTable& table, std::string row_key,
+           std::initializer_list<bigtable::Mutation> mutations) {
+  btproto::MutateRowRequest request;
+  bigtable::SingleRowMutation(std::move(row_key), mutations).MoveTo(request);
+  auto status = table.MutateRow(request.row_key(), request.mutations());
+  ASSERT_TRUE(status.ok()) << status.error_message();
+}
+
+/**
+ * Read from @p table and format the cells as strings.
+ *
+ * Each cell is formatted as `row/family:column@timestamp=value`, followed by
+ * its labels, if any.
+ */
+std::vector<std::string> Read(InMemoryTable& table,
+                              btproto::ReadRowsRequest const& request,
+                              int* message_count = nullptr) {
+  std::vector<std::string> cells;
+  std::string row;
+  std::string family;
+  std::string column;
+  int messages = 0;
+  auto status = table.ReadRows(
+      request, [&](btproto::ReadRowsResponse const& response) {
+        ++messages;
+        for (auto const& chunk : response.chunks()) {
+          if (not chunk.row_key().empty()) {
+            row = chunk.row_key();
+          }
+          if (chunk.has_family_name()) {
+            family = chunk.family_name().value();
+          }
+          if (chunk.has_qualifier()) {
+            column = chunk.qualifier().value();
+          }
+          std::string cell = row + "/" + family + ":" + column + "@" +
+                             std::to_string(chunk.timestamp_micros()) + "=" +
+                             chunk.value();
+          for (auto const& label : chunk.labels()) {
+            cell += "[" + label + "]";
+          }
+          cells.push_back(std::move(cell));
+        }
+        return true;
+      });
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  if (message_count != nullptr) {
+    *message_count = messages;
+  }
+  return cells;
+}
+
+std::vector<std::string> Read(InMemoryTable& table, bigtable::RowSet row_set,
+                              bigtable::Filter filter,
+                              std::int64_t rows_limit = 0) {
+  btproto::ReadRowsRequest request;
+  *request.mutable_rows() = row_set.as_proto();
+  *request.mutable_filter() = filter.as_proto();
+  request.set_rows_limit(rows_limit);
+  return Read(table, request);
+}
+
+std::vector<std::string> ReadAll(InMemoryTable& table) {
+  return Read(table, bigtable::RowSet(), bigtable::Filter::PassAllFilter());
+}
+
+/// Create a table with rows "r0" .. "r5" and a few cells in each row.
+void Populate(InMemoryTable& table) {
+  for (int i = 0; i != 6; ++i) {
+    Apply(table, "r" + std::to_string(i),
+          {bigtable::SetCell("fam", "c0", milliseconds(1), "v1"),
+           bigtable::SetCell("fam", "c0", milliseconds(2), "v2"),
+           bigtable::SetCell("fam", "c1", milliseconds(1), "x")});
+  }
+}
+}  // namespace
+
+/// @test Verify that the cells are returned in order, newest first.
+TEST(InMemoryTableTest, MutateAndRead) {
+  InMemoryTable table;
+  Apply(table, "r2", {bigtable::SetCell("fam", "c1", milliseconds(1), "a"),
+                      bigtable::SetCell("fam", "c0", milliseconds(1), "b")});
+  Apply(table, "r1", {bigtable::SetCell("fam", "c0", milliseconds(1), "c"),
+                      bigtable::SetCell("fam", "c0", milliseconds(3), "d"),
+                      bigtable::SetCell("alt", "c0", milliseconds(2), "e")});
+  // Overwrite an existing cell.
+  Apply(table, "r2", {bigtable::SetCell("fam", "c1", milliseconds(1), "f")});
+
+  EXPECT_THAT(ReadAll(table),
+              ElementsAre("r1/alt:c0@2000=e", "r1/fam:c0@3000=d",
+                          "r1/fam:c0@1000=c", "r2/fam:c0@1000=b",
+                          "r2/fam:c1@1000=f"));
+}
+
+TEST(InMemoryTableTest, ServerTimestamp) {
+  InMemoryTable table;
+  Apply(table, "r1", {bigtable::SetCell("fam", "c0", "v")});
+  btproto::ReadRowsRequest request;
+  std::int64_t timestamp = 0;
+  auto status =
+      table.ReadRows(request, [&timestamp](btproto::ReadRowsResponse const& r) {
+        timestamp = r.chunks(0).timestamp_micros();
+        return true;
+      });
+  ASSERT_TRUE(status.ok());
+  EXPECT_LT(0, timestamp);
+  EXPECT_EQ(0, timestamp % 1000);
+}
+
+TEST(InMemoryTableTest, DeleteMutations) {
+  InMemoryTable table;
+  Populate(table);
+  Apply(table, "r0", {bigtable::DeleteFromRow()});
+  Apply(table, "r1", {bigtable::DeleteFromFamily("fam"),
+                      bigtable::SetCell("fam", "c2", milliseconds(1), "y")});
+  Apply(table, "r2",
+        {bigtable::DeleteFromColumn("fam", "c0", std::chrono::microseconds(0),
+                                    std::chrono::microseconds(2000))});
+  Apply(table, "r3", {bigtable::DeleteFromColumn("fam", "c0"),
+                      bigtable::DeleteFromColumn("fam", "c1")});
+
+  EXPECT_THAT(
+      Read(table, bigtable::RowSet(bigtable::RowRange::Range("r0", "r4")),
+           bigtable::Filter::PassAllFilter()),
+      ElementsAre("r1/fam:c2@1000=y", "r2/fam:c0@2000=v2", "r2/fam:c1@1000=x"));
+}
+
+TEST(InMemoryTableTest, ColumnFamilies) {
+  InMemoryTable table({}, {{"fam", 2}, {"all", 0}});
+  for (int i = 1; i != 5; ++i) {
+    Apply(table, "r1",
+          {bigtable::SetCell("fam", "c0", milliseconds(i), std::to_string(i)),
+           bigtable::SetCell("all", "c0", milliseconds(i), std::to_string(i))});
+  }
+  EXPECT_THAT(ReadAll(table),
+              ElementsAre("r1/all:c0@4000=4", "r1/all:c0@3000=3",
+                          "r1/all:c0@2000=2", "r1/all:c0@1000=1",
+                          "r1/fam:c0@4000=4", "r1/fam:c0@3000=3"));
+
+  btproto::MutateRowRequest request;
+  bigtable::SingleRowMutation("r1", {bigtable::SetCell("fam", "c0", "v"),
+                                     bigtable::SetCell("unknown", "c0", "v")})
+      .MoveTo(request);
+  auto status = table.MutateRow(request.row_key(), request.mutations());
+  EXPECT_EQ(grpc::StatusCode::NOT_FOUND, status.error_code());
+  // The mutations are atomic, the valid mutation was not applied either.
+  EXPECT_EQ(6U, ReadAll(table).size());
+}
+
+/// @test Verify that overlapping ranges and keys return each row once.
+TEST(InMemoryTableTest, ReadRowSet) {
+  InMemoryTable table({"r2", "r4"});
+  Populate(table);
+  auto only_c1 = bigtable::Filter::ColumnRegex("c1");
+
+  using R = bigtable::RowRange;
+  EXPECT_THAT(
+      Read(table,
+           bigtable::RowSet("r5", R::Range("r1", "r3"), "r2", "r0",
+                            R::Closed("r2", "r3"), "missing"),
+           only_c1),
+      ElementsAre("r0/fam:c1@1000=x", "r1/fam:c1@1000=x", "r2/fam:c1@1000=x",
+                  "r3/fam:c1@1000=x", "r5/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, bigtable::RowSet(R::Open("r1", "r3")), only_c1),
+              ElementsAre("r2/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, bigtable::RowSet(R::Open("r3", "")), only_c1),
+              ElementsAre("r4/fam:c1@1000=x", "r5/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, bigtable::RowSet(R::Empty()), only_c1),
+              ElementsAre());
+  EXPECT_THAT(Read(table, bigtable::RowSet(), only_c1, 3),
+              ElementsAre("r0/fam:c1@1000=x", "r1/fam:c1@1000=x",
+                          "r2/fam:c1@1000=x"));
+}
+
+/// @test Verify that large reads are returned in multiple messages.
+TEST(InMemoryTableTest, ReadManyRows) {
+  InMemoryTable table({"row-1", "row-3", "row-5"});
+  std::string const value(10000, 'x');
+  int const row_count = 700;
+  for (int i = 0; i != row_count; ++i) {
+    Apply(table, "row-" + std::to_string(i),
+          {bigtable::SetCell("fam", "col", milliseconds(0), value)});
+  }
+
+  btproto::ReadRowsRequest request;
+  int messages = 0;
+  auto cells = Read(table, request, &messages);
+  EXPECT_EQ(row_count, static_cast<int>(cells.size()));
+  EXPECT_TRUE(std::is_sorted(cells.begin(), cells.end()));
+  EXPECT_LT(1, messages);
+}
+
+TEST(InMemoryTableTest, Filters) {
+  InMemoryTable table;
+  Populate(table);
+  using F = bigtable::Filter;
+  auto const row = bigtable::RowSet("r1");
+
+  EXPECT_THAT(Read(table, row, F::Latest(1)),
+              ElementsAre("r1/fam:c0@2000=v2", "r1/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, row, F::CellsRowLimit(2)),
+              ElementsAre("r1/fam:c0@2000=v2", "r1/fam:c0@1000=v1"));
+  EXPECT_THAT(Read(table, row, F::CellsRowOffset(2)),
+              ElementsAre("r1/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, row, F::ValueRegex("v.")),
+              ElementsAre("r1/fam:c0@2000=v2", "r1/fam:c0@1000=v1"));
+  EXPECT_THAT(Read(table, row, F::ValueRangeClosed("v2", "x")),
+              ElementsAre("r1/fam:c0@2000=v2", "r1/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, row, F::ColumnRangeClosed("fam", "c1", "c2")),
+              ElementsAre("r1/fam:c1@1000=x"));
+  EXPECT_EQ(3U, Read(table, row, F::FamilyRegex("f.*")).size());
+  EXPECT_THAT(Read(table, row, F::FamilyRegex("f")), ElementsAre());
+  EXPECT_THAT(Read(table, row,
+                   F::TimestampRange(std::chrono::microseconds(1500),
+                                     std::chrono::microseconds(2500))),
+              ElementsAre("r1/fam:c0@2000=v2"));
+  EXPECT_EQ(6U,
+            Read(table, bigtable::RowSet(), F::RowKeysRegex("r[24]")).size());
+  EXPECT_THAT(Read(table, row,
+                   F::Chain(F::Latest(1), F::StripValueTransformer(),
+                            F::ApplyLabelTransformer("l"))),
+              ElementsAre("r1/fam:c0@2000=[l]", "r1/fam:c1@1000=[l]"));
+  EXPECT_THAT(
+      Read(table, row,
+           F::Interleave(
+               F::ColumnRegex("c1"),
+               F::Chain(F::Latest(1), F::ApplyLabelTransformer("l")))),
+      ElementsAre("r1/fam:c0@2000=v2[l]", "r1/fam:c1@1000=x",
+                  "r1/fam:c1@1000=x[l]"));
+  EXPECT_THAT(Read(table, row,
+                   F::Condition(F::ValueRegex("x"), F::ColumnRegex("c0"),
+                                F::BlockAllFilter())),
+              ElementsAre("r1/fam:c0@2000=v2", "r1/fam:c0@1000=v1"));
+  EXPECT_THAT(Read(table, row,
+                   F::Condition(F::ValueRegex("z"), F::ColumnRegex("c0"),
+                                F::ColumnRegex("c1"))),
+              ElementsAre("r1/fam:c1@1000=x"));
+  EXPECT_THAT(Read(table, bigtable::RowSet(), F::RowSample(0.0)),
+              ElementsAre());
+  EXPECT_EQ(18U, Read(table, bigtable::RowSet(), F::RowSample(1.0)).size());
+}
+
+TEST(InMemoryTableTest, InvalidFilters) {
+  InMemoryTable table;
+  auto read = [&table](bigtable::Filter filter) {
+    btproto::ReadRowsRequest request;
+    *request.mutable_filter() = filter.as_proto();
+    return table.ReadRows(
+        request, [](btproto::ReadRowsResponse const&) { return true; });
+  };
+  EXPECT_EQ(grpc::StatusCode::INVALID_ARGUMENT,
+            read(bigtable::Filter::ValueRegex("[")).error_code());
+  EXPECT_EQ(grpc::StatusCode::INVALID_ARGUMENT,
+            read(bigtable::Filter::RowSample(2.0)).error_code());
+  EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED,
+            read(bigtable::Filter::Sink()).error_code());
+}
+
+TEST(InMemoryTableTest, CheckAndMutateRow) {
+  InMemoryTable table;
+  Populate(table);
+
+  btproto::CheckAndMutateRowRequest request;
+  request.set_row_key("r1");
+  *request.mutable_predicate_filter() =
+      bigtable::Filter::ValueRegex("v2").as_proto();
+  *request.add_true_mutations() =
+      bigtable::SetCell("fam", "matched", milliseconds(0), "yes").op;
+  *request.add_false_mutations() =
+      bigtable::SetCell("fam", "matched", milliseconds(0), "no").op;
+  btproto::CheckAndMutateRowResponse response;
+  ASSERT_TRUE(table.CheckAndMutateRow(request, response).ok());
+  EXPECT_TRUE(response.predicate_matched());
+
+  request.set_row_key("new-row");
+  ASSERT_TRUE(table.CheckAndMutateRow(request, response).ok());
+  EXPECT_FALSE(response.predicate_matched());
+
+  auto filter = bigtable::Filter::ColumnRegex("matched");
+  EXPECT_THAT(Read(table, bigtable::RowSet(), filter),
+              ElementsAre("new-row/fam:matched@0=no", "r1/fam:matched@0=yes"));
+}
+
+TEST(InMemoryTableTest, ReadModifyWriteRow) {
+  InMemoryTable table;
+  Apply(table, "r1",
+        {bigtable::SetCell("fam", "counter", milliseconds(0),
+                           std::string("\0\0\0\0\0\0\0\x05", 8)),
+         bigtable::SetCell("fam", "text", milliseconds(0), "abc")});
+
+  btproto::ReadModifyWriteRowRequest request;
+  request.set_row_key("r1");
+  auto& increment = *request.add_rules();
+  increment.set_family_name("fam");
+  increment.set_column_qualifier("counter");
+  increment.set_increment_amount(3);
+  *request.add_rules() = increment;
+  auto& append = *request.add_rules();
+  append.set_family_name("fam");
+  append.set_column_qualifier("text");
+  append.set_append_value("def");
+
+  btproto::ReadModifyWriteRowResponse response;
+  auto status = table.ReadModifyWriteRow(request, response);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  auto const& row = response.row();
+  EXPECT_EQ("r1", row.key());
+  ASSERT_EQ(1, row.families_size());
+  ASSERT_EQ(2, row.families(0).columns_size());
+  EXPECT_EQ("counter", row.families(0).columns(0).qualifier());
+  EXPECT_EQ(std::string("\0\0\0\0\0\0\0\x0b", 8),
+            row.families(0).columns(0).cells(0).value());
+  EXPECT_EQ("text", row.families(0).columns(1).qualifier());
+  EXPECT_EQ("abcdef", row.families(0).columns(1).cells(0).value());
+
+  // The new values are the latest version of each column.
+  auto cells = Read(table, bigtable::RowSet("r1"), bigtable::Filter::Latest(1));
+  ASSERT_EQ(2U, cells.size());
+  EXPECT_THAT(cells[1], ::testing::EndsWith("=abcdef"));
+
+  // Only 64-bit values can be incremented.
+  btproto::ReadModifyWriteRowRequest invalid;
+  invalid.set_row_key("r1");
+  *invalid.add_rules() = increment;
+  invalid.mutable_rules(0)->set_column_qualifier("text");
+  status = table.ReadModifyWriteRow(invalid, response);
+  EXPECT_EQ(grpc::StatusCode::FAILED_PRECONDITION, status.error_code());
+}
+
+TEST(InMemoryTableTest, SampleRowKeys) {
+  InMemoryTable table({"r2", "r4"});
+  Populate(table);
+  auto samples = table.SampleRowKeys();
+  ASSERT_EQ(3U, samples.size());
+  EXPECT_EQ("r2", samples[0].row_key());
+  EXPECT_EQ("r4", samples[1].row_key());
+  EXPECT_EQ("", samples[2].row_key());
+  EXPECT_LT(0, samples[0].offset_bytes());
+  EXPECT_EQ(2 * samples[0].offset_bytes(), samples[1].offset_bytes());
+  EXPECT_EQ(3 * samples[0].offset_bytes(), samples[2].offset_bytes());
+}
+
+/// @test Verify that concurrent updates to the same row are atomic.
+TEST(InMemoryTableTest, ConcurrentReadModifyWrite) {
+  InMemoryTable table({"m"});
+  btproto::ReadModifyWriteRowRequest request;
+  request.set_row_key("counter");
+  auto& rule = *request.add_rules();
+  rule.set_family_name("fam");
+  rule.set_column_qualifier("c");
+  rule.set_increment_amount(1);
+
+  int const thread_count = 4;
+  int const iterations = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != thread_count; ++i) {
+    threads.emplace_back([&table, &request, i]() {
+      for (int j = 0; j != iterations; ++j) {
+        btproto::ReadModifyWriteRowResponse response;
+        EXPECT_TRUE(table.ReadModifyWriteRow(request, response).ok());
+        // Scan the table at the same time.
+        (void)ReadAll(table);
+        Apply(table, "row-" + std::to_string(i),
+              {bigtable::SetCell("fam", "c", milliseconds(j), "v")});
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto cells = Read(table, bigtable::RowSet("counter"),
+                    bigtable::Filter::Latest(1));
+  ASSERT_EQ(1U, cells.size());
+  auto const value = cells[0].substr(cells[0].find('=') + 1);
+  EXPECT_EQ(thread_count * iterations,
+            static_cast<unsigned char>(value[6]) * 256 +
+                static_cast<unsigned char>(value[7]));
+}
@@ -0,0 +1,187 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_data_client.h"
+#include "google/cloud/internal/retry_budget.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the cost of resuming `Table::ReadRows()` for large sets of keys.
+ *
+ * The benchmark reads a `RowSet` with 100,000 keys (configurable via the
+ * command-line) from a fake `DataClient`.  Each stream returns a fixed number
+ * of rows and then fails with `UNAVAILABLE`, so the `RowReader` must resume
+ * the read, requesting only the keys not yet received.  The benchmark reports
+ * the time to read all the rows, and the time per retry, as the number of rows
+ * per stream shrinks (and the number of retries grows).
+ *
+ * The fake client only looks at the first few keys in each request, so the
+ * results measure the client library: the cost of computing the remaining
+ * keys, and of building and serializing each request.
+ */
+
+namespace {
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+
+std::string MakeKey(long index) {
+  // Fixed width, so the lexicographic order matches the numeric order.
+  std::ostringstream os;
+  os << "user" << std::setw(10) << std::setfill('0') << index;
+  return os.str();
+}
+
+/**
+ * A stream returning a row for each of the first few keys in a request.
+ *
+ * The stream returns `row_count` rows (or fewer, if the request has fewer
+ * keys), and then fails with `UNAVAILABLE` unless the request is complete.
+ */
+class FakeReadRowsReader
+    : public grpc::ClientReaderInterface<btproto::ReadRowsResponse> {
+ public:
+  FakeReadRowsReader(btproto::ReadRowsRequest const& request, int row_count)
+      : complete_(request.rows().row_keys_size() <= row_count) {
+    // Serialize the request, as gRPC does, to include its cost.
+    std::string buffer;
+    request.SerializeToString(&buffer);
+    auto const& keys = request.rows().row_keys();
+    auto end = complete_ ? keys.end() : keys.begin() + row_count;
+    keys_.assign(keys.begin(), end);
+  }
+
+  void WaitForInitialMetadata() override {}
+  bool NextMessageSize(std::uint32_t* sz) override {
+    *sz = std::numeric_limits<std::uint32_t>::max();
+    return true;
+  }
+
+  bool Read(btproto::ReadRowsResponse* response) override {
+    if (next_ == keys_.size()) {
+      return false;
+    }
+    response->Clear();
+    auto& chunk = *response->add_chunks();
+    chunk.set_row_key(std::move(keys_[next_++]));
+    chunk.mutable_family_name()->set_value("cf");
+    chunk.mutable_qualifier()->set_value("field0");
+    chunk.set_timestamp_micros(0);
+    chunk.set_value("value");
+    chunk.set_commit_row(true);
+    return true;
+  }
+
+  grpc::Status Finish() override {
+    if (complete_) {
+      return grpc::Status::OK;
+    }
+    // Keep the process-wide retry budget funded, as the successful requests
+    // of a real application would.
+    auto& budget = google::cloud::internal::DefaultRetryBudget();
+    while (budget.tokens() < 1.0) {
+      budget.OnSuccess();
+    }
+    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "injected failure");
+  }
+
+ private:
+  bool complete_;
+  std::vector<std::string> keys_;
+  std::size_t next_ = 0;
+};
+
+struct Result {
+  long rows;
+  long streams;
+  std::chrono::microseconds elapsed;
+};
+
+Result RunBenchmark(long key_count, int rows_per_stream) {
+  auto client = std::make_shared<
+      ::testing::NiceMock<bigtable::testing::MockDataClient>>();
+  long streams = 0;
+  ON_CALL(*client, ReadRows(::testing::_, ::testing::_))
+      .WillByDefault(::testing::Invoke(
+          [&streams, rows_per_stream](grpc::ClientContext*,
+                                      btproto::ReadRowsRequest const& r) {
+            ++streams;
+            return std::unique_ptr<
+                grpc::ClientReaderInterface<btproto::ReadRowsResponse>>(
+                new FakeReadRowsReader(r, rows_per_stream));
+          }));
+
+  bigtable::Table table(
+      client, "resume-benchmark",
+      bigtable::LimitedErrorCountRetryPolicy(
+          std::numeric_limits<int>::max()),
+      bigtable::ExponentialBackoffPolicy(std::chrono::microseconds(0),
+                                         std::chrono::microseconds(0)),
+      bigtable::SafeIdempotentMutationPolicy());
+
+  bigtable::RowSet row_set;
+  for (long i = 0; i != key_count; ++i) {
+    row_set.Append(MakeKey(i));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  long rows = 0;
+  auto reader =
+      table.ReadRows(std::move(row_set), bigtable::Filter::PassAllFilter());
+  for (auto const& row : reader) {
+    (void)row;
+    ++rows;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return Result{rows, streams, elapsed};
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  long key_count = 100000;
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [key-count]" << std::endl;
+    return 1;
+  }
+  if (argc == 2) {
+    key_count = std::stol(argv[1]);
+  }
+
+  std::cout << "RowsPerStream,Streams,Rows,ElapsedUs,UsPerStream\n";
+  for (int rows_per_stream : {100000, 10000, 1000, 100}) {
+    auto result = RunBenchmark(key_count, rows_per_stream);
+    if (result.rows != key_count) {
+      std::cerr << "Expected " << key_count << " rows, got " << result.rows
+                << std::endl;
+      return 1;
+    }
+    std::cout << rows_per_stream << ',' << result.streams << ','
+              << result.rows << ',' << result.elapsed.count() << ','
+              << result.elapsed.count() / result.streams << std::endl;
+  }
+
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
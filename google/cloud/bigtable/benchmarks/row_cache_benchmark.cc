@@ -0,0 +1,118 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_cache.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the throughput of `bigtable::RowCache` as the number of threads
+ * grows.
+ *
+ * The cache is populated with a fixed set of rows, and then each thread looks
+ * up random keys from that set in a loop, inserting the (few) results that
+ * were evicted or expired.  The benchmark reports the aggregate number of
+ * lookups per second for 1 to 128 threads, and for a cache with a single
+ * shard vs. the default number of shards.
+ */
+
+namespace {
+namespace bigtable = google::cloud::bigtable;
+
+int const kRowCount = 10000;
+
+std::string MakeKey(int index) { return "user" + std::to_string(index); }
+
+std::pair<bool, bigtable::Row> MakeRow(std::string const& key) {
+  return std::make_pair(
+      true, bigtable::Row(key, {bigtable::Cell(key, "fam", "col", 0,
+                                               std::string(100, 'x'), {})}));
+}
+
+/// Run @p thread_count threads using @p cache, return the lookups per second.
+double RunBenchmark(bigtable::RowCache& cache, int thread_count,
+                    std::chrono::milliseconds test_duration) {
+  std::atomic<bool> done(false);
+  std::atomic<long> total_calls(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != thread_count; ++i) {
+    threads.emplace_back([&cache, &done, &total_calls, i]() {
+      std::mt19937 generator(i);
+      std::uniform_int_distribution<int> distribution(0, kRowCount - 1);
+      std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+      std::uint64_t token;
+      long calls = 0;
+      while (not done.load(std::memory_order_relaxed)) {
+        auto key = MakeKey(distribution(generator));
+        if (not cache.Lookup(key, "filter", result, token)) {
+          cache.Insert(key, "filter", MakeRow(key), token);
+        }
+        ++calls;
+      }
+      total_calls += calls;
+    });
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(test_duration);
+  done.store(true);
+  for (auto& t : threads) {
+    t.join();
+  }
+  using std::chrono::duration_cast;
+  auto elapsed = duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return static_cast<double>(total_calls.load()) * 1.0E6 /
+         static_cast<double>(elapsed.count());
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  std::chrono::milliseconds test_duration(1000);
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [test-duration-ms]" << std::endl;
+    return 1;
+  }
+  if (argc == 2) {
+    test_duration = std::chrono::milliseconds(std::stol(argv[1]));
+  }
+
+  std::cout << "Shards,Threads,LookupsPerSecond" << std::endl;
+  for (std::size_t shard_count : {1, 16}) {
+    bigtable::RowCache cache(64 * 1024 * 1024, std::chrono::minutes(10),
+                             shard_count);
+    for (int i = 0; i != kRowCount; ++i) {
+      auto key = MakeKey(i);
+      std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+      std::uint64_t token;
+      cache.Lookup(key, "filter", result, token);
+      cache.Insert(key, "filter", MakeRow(key), token);
+    }
+    for (int thread_count = 1; thread_count <= 128; thread_count *= 2) {
+      auto throughput = RunBenchmark(cache, thread_count, test_duration);
+      std::cout << shard_count << "," << thread_count << ","
+                << static_cast<long>(throughput) << std::endl;
+    }
+  }
+
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
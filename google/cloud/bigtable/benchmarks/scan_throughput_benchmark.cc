@@ -18,6 +18,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <unordered_set>
 
 /**
  * @file
@@ -47,6 +48,10 @@
  * The benchmark will report throughput in rows per second for each scans with
  * 100, 1,000 and 10,000 rows.
  *
+ * Finally, the benchmark retains the results of a 10,000 row scan, once as
+ * `bigtable::Row` objects and once as `bigtable::RowView` objects, and reports
+ * the (estimated) memory used by each representation.
+ *
  * Using a command-line parameter the benchmark can be configured to create a
  * local gRPC server that implements the Cloud Bigtable APIs used by the
  * benchmark.  If this parameter is not used, the benchmark uses the default
@@ -67,6 +72,12 @@ BenchmarkResult RunBenchmark(bigtable::benchmarks::Benchmark const& benchmark,
                              long table_size, std::string const& table_id,
                              long scan_size,
                              std::chrono::seconds test_duration);
+
+/// Report the memory used to retain a scan as `Row` vs. `RowView` objects.
+void CompareMemoryUsage(bigtable::benchmarks::Benchmark const& benchmark,
+                        std::shared_ptr<bigtable::DataClient> data_client,
+                        long table_size, std::string const& table_id,
+                        long scan_size);
 }  // anonymous namespace
 
 int main(int argc, char* argv[]) try {
@@ -99,6 +110,9 @@ int main(int argc, char* argv[]) try {
     results_by_size[op_name] = std::move(combined);
   }
 
+  CompareMemoryUsage(benchmark, data_client, setup.table_size(),
+                     setup.table_id(), kScanSizes[2]);
+
   std::cout << bigtable::benchmarks::Benchmark::ResultsCsvHeader() << std::endl;
   benchmark.PrintResultCsv(std::cout, "scant", "BulkApply()", "Latency",
                            populate_results);
@@ -147,4 +161,98 @@ BenchmarkResult RunBenchmark(bigtable::benchmarks::Benchmark const& benchmark,
   return result;
 }
 
+/**
+ * Estimate the memory used by a string.
+ *
+ * This ignores small string optimizations and allocator overhead, it is only
+ * intended to compare the different representations.
+ */
+std::size_t StringBytes(std::string const& s) {
+  return sizeof(s) + s.capacity();
+}
+
+std::size_t LabelsBytes(std::vector<std::string> const& labels) {
+  std::size_t total = labels.capacity() * sizeof(std::string);
+  for (auto const& label : labels) {
+    total += label.capacity();
+  }
+  return total;
+}
+
+std::size_t RowBytes(bigtable::Row const& row) {
+  std::size_t total = sizeof(row) + row.row_key().capacity() +
+                      row.cells().capacity() * sizeof(bigtable::Cell);
+  for (auto const& cell : row.cells()) {
+    total += cell.row_key().capacity() + cell.family_name().capacity() +
+             cell.column_qualifier().capacity() + cell.value().capacity() +
+             LabelsBytes(cell.labels());
+  }
+  return total;
+}
+
+/// Count each shared buffer once, including its reference count block.
+std::size_t BufferBytes(bigtable::CellView::Buffer const& buffer,
+                        std::unordered_set<void const*>& seen) {
+  if (not seen.insert(buffer.get()).second) {
+    return 0;
+  }
+  return 2 * sizeof(long) + StringBytes(*buffer);
+}
+
+std::size_t RowViewBytes(bigtable::RowView const& row,
+                         std::unordered_set<void const*>& seen) {
+  std::size_t total = sizeof(row) + BufferBytes(row.row_key_buffer(), seen) +
+                      row.cells().capacity() * sizeof(bigtable::CellView);
+  for (auto const& cell : row.cells()) {
+    total += BufferBytes(cell.row_key_buffer(), seen) +
+             BufferBytes(cell.family_name_buffer(), seen) +
+             BufferBytes(cell.column_qualifier_buffer(), seen) +
+             BufferBytes(cell.value_buffer(), seen) +
+             LabelsBytes(cell.labels());
+  }
+  return total;
+}
+
+void CompareMemoryUsage(bigtable::benchmarks::Benchmark const& benchmark,
+                        std::shared_ptr<bigtable::DataClient> data_client,
+                        long table_size, std::string const& table_id,
+                        long scan_size) {
+  bigtable::Table table(std::move(data_client), table_id);
+
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  std::uniform_int_distribution<long> prng(0, table_size - scan_size - 1);
+  auto start_key = benchmark.MakeKey(prng(generator));
+  auto filter = bigtable::Filter::ColumnRangeClosed(kColumnFamily, "field0",
+                                                    "field9");
+
+  std::vector<bigtable::Row> rows;
+  auto reader = table.ReadRows(
+      bigtable::RowSet(bigtable::RowRange::StartingAt(start_key)), scan_size,
+      filter);
+  std::move(reader.begin(), reader.end(), std::back_inserter(rows));
+  std::size_t row_bytes = rows.capacity() * sizeof(bigtable::Row);
+  for (auto const& row : rows) {
+    row_bytes += RowBytes(row);
+  }
+
+  std::vector<bigtable::RowView> views;
+  auto view_reader = table.ReadRows(
+      bigtable::RowSet(bigtable::RowRange::StartingAt(start_key)), scan_size,
+      filter);
+  bigtable::RowView view(std::make_shared<std::string const>(), {});
+  while (view_reader.NextView(view)) {
+    views.push_back(view);
+  }
+  std::unordered_set<void const*> seen;
+  std::size_t view_bytes = views.capacity() * sizeof(bigtable::RowView);
+  for (auto const& v : views) {
+    view_bytes += RowViewBytes(v, seen);
+  }
+
+  std::cout << "# Memory for a " << scan_size << " row scan (estimated)"
+            << ": Row=" << row_bytes << " bytes (" << rows.size() << " rows)"
+            << ", RowView=" << view_bytes << " bytes (" << views.size()
+            << " rows)" << std::endl;
+}
+
 }  // anonymous namespace
@@ -0,0 +1,107 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/common_client.h"
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the throughput of `internal::CommonClient::Stub()`.
+ *
+ * Every RPC made by the client library calls `Stub()` (or `Channel()`) to
+ * pick a connection from the pool.  This benchmark measures how many calls per
+ * second `Stub()` supports as the number of threads calling it grows, from 1
+ * to 128 threads.  Each thread calls `Stub()` in a loop, the benchmark reports
+ * the aggregate number of calls per second.
+ *
+ * The channels are created, but never connected, so the benchmark does not
+ * need a server.
+ */
+
+namespace {
+namespace bigtable = google::cloud::bigtable;
+
+struct BenchmarkTraits {
+  static std::string const& Endpoint(bigtable::ClientOptions& options) {
+    return options.data_endpoint();
+  }
+};
+
+using Client = bigtable::internal::CommonClient<BenchmarkTraits,
+                                                google::bigtable::v2::Bigtable>;
+
+/// Run @p thread_count threads calling `Stub()`, return the calls per second.
+double RunBenchmark(Client& client, int thread_count,
+                    std::chrono::milliseconds test_duration) {
+  std::atomic<bool> done(false);
+  std::atomic<long> total_calls(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != thread_count; ++i) {
+    threads.emplace_back([&client, &done, &total_calls]() {
+      long calls = 0;
+      while (not done.load(std::memory_order_relaxed)) {
+        auto stub = client.Stub();
+        ++calls;
+      }
+      total_calls += calls;
+    });
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(test_duration);
+  done.store(true);
+  for (auto& t : threads) {
+    t.join();
+  }
+  using std::chrono::duration_cast;
+  auto elapsed = duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return static_cast<double>(total_calls.load()) * 1.0E6 /
+         static_cast<double>(elapsed.count());
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  std::chrono::milliseconds test_duration(1000);
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [test-duration-ms]" << std::endl;
+    return 1;
+  }
+  if (argc == 2) {
+    test_duration = std::chrono::milliseconds(std::stol(argv[1]));
+  }
+
+  Client client(bigtable::ClientOptions(grpc::InsecureChannelCredentials())
+                    .set_data_endpoint("localhost:1")
+                    .set_connection_pool_size(4));
+  // Create the connections before measuring anything.
+  client.Stub();
+
+  std::cout << "Threads,CallsPerSecond" << std::endl;
+  for (int thread_count = 1; thread_count <= 128; thread_count *= 2) {
+    auto throughput = RunBenchmark(client, thread_count, test_duration);
+    std::cout << thread_count << "," << static_cast<long>(throughput)
+              << std::endl;
+  }
+
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
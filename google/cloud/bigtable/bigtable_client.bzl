@@ -1,44 +1,67 @@
 # DO NOT EDIT -- GENERATED BY CMake -- Change the CMakeLists.txt file if needed
 bigtable_client_HDRS = [
     "admin_client.h",
+    "async_operation.h",
     "bigtable_strong_types.h",
+    "bulk_apply_options.h",
     "cell.h",
+    "cell_view.h",
+    "channel_selection_policy.h",
     "client_options.h",
     "cluster_config.h",
     "column_family.h",
+    "completion_queue.h",
     "data_client.h",
     "filters.h",
     "grpc_error.h",
+    "hedging_policy.h",
     "instance_admin_client.h",
     "instance_admin.h",
     "instance_config.h",
     "instance_update_config.h",
+    "internal/async_bulk_apply.h",
+    "internal/arena_message.h",
+    "internal/async_retry_operation.h",
+    "internal/async_retry_unary_rpc.h",
+    "internal/async_row_reader.h",
     "internal/bulk_mutator.h",
     "internal/common_client.h",
+    "internal/completion_queue_impl.h",
     "internal/conjunction.h",
     "internal/encoder.h",
     "internal/endian.h",
     "internal/grpc_error_delegate.h",
     "internal/instance_admin.h",
     "internal/make_unique.h",
+    "internal/name_interner.h",
     "internal/prefix_range_end.h",
     "internal/readrowsparser.h",
+    "internal/row_prefetch_queue.h",
     "internal/rowreaderiterator.h",
+    "internal/rpc_metrics.h",
+    "internal/split_row_set.h",
     "internal/strong_type.h",
     "internal/table.h",
     "internal/table_admin.h",
+    "internal/tracked_stream.h",
     "internal/unary_client_utils.h",
     "idempotent_mutation_policy.h",
     "mutations.h",
     "polling_policy.h",
     "read_modify_write_rule.h",
     "row.h",
+    "row_cache.h",
+    "row_batch.h",
+    "row_view.h",
     "row_range.h",
     "row_reader.h",
     "row_set.h",
     "rpc_backoff_policy.h",
     "rpc_retry_policy.h",
     "metadata_update_policy.h",
+    "multi_get_options.h",
+    "mutation_rate_limiter.h",
+    "mutation_batcher.h",
     "table.h",
     "table_admin.h",
     "table_config.h",
@@ -48,33 +71,47 @@ bigtable_client_HDRS = [
 
 bigtable_client_SRCS = [
     "admin_client.cc",
+    "channel_selection_policy.cc",
     "client_options.cc",
     "cluster_config.cc",
+    "completion_queue.cc",
     "data_client.cc",
     "grpc_error.cc",
+    "hedging_policy.cc",
     "instance_admin_client.cc",
     "instance_admin.cc",
     "instance_config.cc",
     "instance_update_config.cc",
+    "internal/async_bulk_apply.cc",
+    "internal/async_retry_operation.cc",
+    "internal/async_row_reader.cc",
     "internal/bulk_mutator.cc",
     "internal/common_client.cc",
+    "internal/completion_queue_impl.cc",
     "internal/endian.cc",
     "internal/grpc_error_delegate.cc",
     "internal/instance_admin.cc",
+    "internal/name_interner.cc",
     "internal/prefix_range_end.cc",
     "internal/readrowsparser.cc",
+    "internal/row_prefetch_queue.cc",
     "internal/rowreaderiterator.cc",
+    "internal/split_row_set.cc",
     "internal/table.cc",
     "internal/table_admin.cc",
     "idempotent_mutation_policy.cc",
     "mutations.cc",
     "polling_policy.cc",
+    "row_cache.cc",
+    "row_batch.cc",
     "row_range.cc",
     "row_reader.cc",
     "row_set.cc",
     "rpc_backoff_policy.cc",
     "rpc_retry_policy.cc",
     "metadata_update_policy.cc",
+    "mutation_rate_limiter.cc",
+    "mutation_batcher.cc",
     "table.cc",
     "table_admin.cc",
     "table_config.cc",
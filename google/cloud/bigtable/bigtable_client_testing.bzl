@@ -1,9 +1,12 @@
 # DO NOT EDIT -- GENERATED BY CMake -- Change the CMakeLists.txt file if needed
 bigtable_client_testing_HDRS = [
     "testing/chrono_literals.h",
+    "testing/drained_retry_budget.h",
     "testing/embedded_server_test_fixture.h",
     "testing/internal_table_test_fixture.h",
     "testing/mock_admin_client.h",
+    "testing/mock_async_response_reader.h",
+    "testing/mock_completion_queue.h",
     "testing/mock_data_client.h",
     "testing/mock_instance_admin_client.h",
     "testing/inprocess_data_client.h",
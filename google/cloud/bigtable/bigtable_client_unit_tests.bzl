@@ -2,38 +2,56 @@
 bigtable_client_unit_tests = [
     "admin_client_test.cc",
     "cell_test.cc",
+    "cell_view_test.cc",
+    "channel_selection_policy_test.cc",
     "client_options_test.cc",
     "cluster_config_test.cc",
     "column_family_test.cc",
+    "completion_queue_test.cc",
     "data_client_test.cc",
     "filters_test.cc",
     "force_sanitizer_failures_test.cc",
     "grpc_error_test.cc",
+    "hedging_policy_test.cc",
     "idempotent_mutation_policy_test.cc",
     "instance_admin_client_test.cc",
     "instance_admin_test.cc",
     "instance_config_test.cc",
     "instance_update_config_test.cc",
     "internal/bulk_mutator_test.cc",
+    "internal/common_client_test.cc",
     "internal/instance_admin_test.cc",
     "internal/grpc_error_delegate_test.cc",
+    "internal/name_interner_test.cc",
     "internal/prefix_range_end_test.cc",
+    "internal/row_prefetch_queue_test.cc",
+    "internal/split_row_set_test.cc",
     "internal/table_admin_test.cc",
     "internal/table_test.cc",
     "mutations_test.cc",
+    "mutation_rate_limiter_test.cc",
+    "mutation_batcher_test.cc",
     "table_admin_test.cc",
     "table_apply_test.cc",
+    "table_async_apply_test.cc",
+    "table_async_bulk_apply_test.cc",
+    "table_async_check_and_mutate_row_test.cc",
+    "table_async_read_rows_test.cc",
     "table_bulk_apply_test.cc",
     "table_check_and_mutate_row_test.cc",
     "table_config_test.cc",
     "table_readrow_test.cc",
+    "table_readrow_hedging_test.cc",
     "table_readrows_test.cc",
+    "table_readrows_parallel_test.cc",
     "table_sample_row_keys_test.cc",
     "table_test.cc",
     "table_readmodifywriterow_test.cc",
     "read_modify_write_rule_test.cc",
     "row_reader_test.cc",
     "row_test.cc",
+    "row_batch_test.cc",
+    "row_cache_test.cc",
     "row_range_test.cc",
     "row_set_test.cc",
     "rpc_backoff_policy_test.cc",
@@ -0,0 +1,76 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Configure how `Table::BulkApply()` splits large `BulkMutation`s.
+ *
+ * The service rejects `MutateRows` requests with more than 100,000 mutations,
+ * or that are too large.  `BulkApply()` splits the rows into requests with at
+ * most `max_mutations_per_request()` mutations and (approximately)
+ * `max_request_bytes()` bytes.  Each row is always sent in a single request.
+ * Up to `max_parallelism()` requests run at the same time, each with its own
+ * retry and backoff loop.
+ */
+class BulkApplyOptions {
+ public:
+  BulkApplyOptions()
+      : max_mutations_per_request_(100000),
+        max_request_bytes_(64 * 1024 * 1024),
+        max_parallelism_(4) {}
+
+  /// Limit the number of mutations (across all rows) in each request.
+  BulkApplyOptions& set_max_mutations_per_request(std::size_t value) {
+    max_mutations_per_request_ = value;
+    return *this;
+  }
+  std::size_t max_mutations_per_request() const {
+    return max_mutations_per_request_;
+  }
+
+  /// Limit the size of each request.
+  BulkApplyOptions& set_max_request_bytes(std::size_t value) {
+    max_request_bytes_ = value;
+    return *this;
+  }
+  std::size_t max_request_bytes() const { return max_request_bytes_; }
+
+  /// Limit the number of concurrent requests.
+  BulkApplyOptions& set_max_parallelism(std::size_t value) {
+    max_parallelism_ = value;
+    return *this;
+  }
+  std::size_t max_parallelism() const { return max_parallelism_; }
+
+ private:
+  std::size_t max_mutations_per_request_;
+  std::size_t max_request_bytes_;
+  std::size_t max_parallelism_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
@@ -0,0 +1,113 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CELL_VIEW_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CELL_VIEW_H_
+
+#include "google/cloud/bigtable/cell.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * A Bigtable cell that shares its data with other cells.
+ *
+ * The row key, family name, column qualifier and value are reference-counted
+ * buffers. The parser creates these buffers from the data received in the
+ * `ReadRows` response, without copying it, and all the cells in a row share
+ * the same row key buffer. Consecutive cells in the same column share the
+ * family name and column qualifier buffers.
+ *
+ * Copying a `CellView` is cheap, it only copies the references. Use `ToCell()`
+ * to create a `Cell` that owns a copy of the data.
+ */
+class CellView {
+ public:
+  /// The type used to hold (and share) the contents of each field.
+  using Buffer = std::shared_ptr<std::string const>;
+
+  CellView(Buffer row_key, Buffer family_name, Buffer column_qualifier,
+           std::int64_t timestamp, Buffer value,
+           std::vector<std::string> labels)
+      : row_key_(std::move(row_key)),
+        family_name_(std::move(family_name)),
+        column_qualifier_(std::move(column_qualifier)),
+        timestamp_(timestamp),
+        value_(std::move(value)),
+        labels_(std::move(labels)) {}
+
+  /// Return the row key this cell belongs to.
+  std::string const& row_key() const { return *row_key_; }
+
+  /// Return the family this cell belongs to.
+  std::string const& family_name() const { return *family_name_; }
+
+  /// Return the column this cell belongs to.
+  std::string const& column_qualifier() const { return *column_qualifier_; }
+
+  /// Return the timestamp of this cell.
+  std::chrono::microseconds timestamp() const {
+    return std::chrono::microseconds(timestamp_);
+  }
+
+  /// Return the contents of this cell.
+  std::string const& value() const { return *value_; }
+
+  /// Interpret the value as an encoded `T` and return it.
+  template <typename T>
+  T value_as() const {
+    return google::cloud::bigtable::internal::Encoder<T>::Decode(*value_);
+  }
+
+  /// Return the labels applied to this cell by label transformer read filters.
+  std::vector<std::string> const& labels() const { return labels_; }
+
+  //@{
+  /**
+   * @name Access the shared buffers.
+   *
+   * Applications can retain these buffers to keep the data alive after the
+   * `CellView` is deleted, without copying it.
+   */
+  Buffer const& row_key_buffer() const { return row_key_; }
+  Buffer const& family_name_buffer() const { return family_name_; }
+  Buffer const& column_qualifier_buffer() const { return column_qualifier_; }
+  Buffer const& value_buffer() const { return value_; }
+  //@}
+
+  /// Return a `Cell` that owns a copy of this cell's data.
+  Cell ToCell() const {
+    return Cell(*row_key_, *family_name_, *column_qualifier_, timestamp_,
+                *value_, labels_);
+  }
+
+ private:
+  Buffer row_key_;
+  Buffer family_name_;
+  Buffer column_qualifier_;
+  std::int64_t timestamp_;
+  Buffer value_;
+  std::vector<std::string> labels_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CELL_VIEW_H_
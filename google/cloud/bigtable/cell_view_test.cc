@@ -0,0 +1,76 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_view.h"
+#include <gtest/gtest.h>
+
+namespace bigtable = google::cloud::bigtable;
+
+/// @test Verify CellView instantiation and trivial accessors.
+TEST(CellViewTest, Simple) {
+  auto row_key = std::make_shared<std::string const>("row");
+  auto family = std::make_shared<std::string const>("family");
+  auto column = std::make_shared<std::string const>("column");
+  auto value = std::make_shared<std::string const>("value");
+
+  bigtable::CellView cell(row_key, family, column, 42, value, {"l1"});
+  EXPECT_EQ("row", cell.row_key());
+  EXPECT_EQ("family", cell.family_name());
+  EXPECT_EQ("column", cell.column_qualifier());
+  EXPECT_EQ(42, cell.timestamp().count());
+  EXPECT_EQ("value", cell.value());
+  ASSERT_EQ(1U, cell.labels().size());
+  EXPECT_EQ("l1", cell.labels()[0]);
+  EXPECT_EQ(value, cell.value_buffer());
+
+  // Copies share the data.
+  bigtable::CellView copy = cell;
+  EXPECT_EQ(cell.value().data(), copy.value().data());
+  EXPECT_EQ(3, value.use_count());
+}
+
+/// @test Verify CellView decodes numeric values.
+TEST(CellViewTest, NumericValue) {
+  auto buffer = std::make_shared<std::string const>("buffer");
+  bigtable::bigendian64_t value(343321020);
+  auto encoded = std::make_shared<std::string const>(
+      bigtable::internal::AsBigEndian64(value));
+  bigtable::CellView cell(buffer, buffer, buffer, 42, encoded, {});
+  EXPECT_EQ(value.get(), cell.value_as<bigtable::bigendian64_t>().get());
+}
+
+/// @test Verify the conversion from CellView and RowView to Cell and Row.
+TEST(CellViewTest, ConvertToRow) {
+  auto row_key = std::make_shared<std::string const>("row");
+  auto family = std::make_shared<std::string const>("family");
+  auto column = std::make_shared<std::string const>("column");
+  bigtable::RowView view(
+      row_key,
+      {bigtable::CellView(row_key, family, column, 42,
+                          std::make_shared<std::string const>("v1"), {}),
+       bigtable::CellView(row_key, family, column, 41,
+                          std::make_shared<std::string const>("v2"), {})});
+  EXPECT_EQ("row", view.row_key());
+  EXPECT_EQ(2U, view.cells().size());
+
+  bigtable::Row row = view.ToRow();
+  EXPECT_EQ("row", row.row_key());
+  ASSERT_EQ(2U, row.cells().size());
+  EXPECT_EQ("row", row.cells()[0].row_key());
+  EXPECT_EQ("family", row.cells()[0].family_name());
+  EXPECT_EQ("column", row.cells()[0].column_qualifier());
+  EXPECT_EQ(42, row.cells()[0].timestamp().count());
+  EXPECT_EQ("v1", row.cells()[0].value());
+  EXPECT_EQ("v2", row.cells()[1].value());
+}
@@ -0,0 +1,134 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/channel_selection_policy.h"
+#include "google/cloud/internal/random.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Each thread uses its own generator, `Select()` is called concurrently.
+google::cloud::internal::DefaultPRNG& ThreadGenerator() {
+  thread_local auto generator = google::cloud::internal::MakeDefaultPRNG();
+  return generator;
+}
+}  // anonymous namespace
+
+std::unique_ptr<ChannelSelectionPolicy> DefaultChannelSelectionPolicy() {
+  return std::unique_ptr<ChannelSelectionPolicy>(
+      new RoundRobinChannelSelection);
+}
+
+std::unique_ptr<ChannelSelectionPolicy> RoundRobinChannelSelection::clone()
+    const {
+  return std::unique_ptr<ChannelSelectionPolicy>(
+      new RoundRobinChannelSelection);
+}
+
+std::size_t RoundRobinChannelSelection::Select(ChannelPool const& pool) {
+  return current_index_.fetch_add(1, std::memory_order_relaxed) % pool.size();
+}
+
+std::unique_ptr<ChannelSelectionPolicy>
+LeastOutstandingRpcsChannelSelection::clone() const {
+  return std::unique_ptr<ChannelSelectionPolicy>(
+      new LeastOutstandingRpcsChannelSelection);
+}
+
+std::size_t LeastOutstandingRpcsChannelSelection::Select(
+    ChannelPool const& pool) {
+  auto const size = pool.size();
+  // Start the scan at a different channel each time, so ties are broken in
+  // round-robin order.
+  auto const start = current_index_.fetch_add(1, std::memory_order_relaxed);
+  // Querying the state of a channel is much more expensive than reading its
+  // load, so only the least loaded channel is queried in the common case.
+  std::size_t best = start % size;
+  long best_load = pool.outstanding_rpcs(best);
+  for (std::size_t i = 1; i != size; ++i) {
+    auto const index = (start + i) % size;
+    long const load = pool.outstanding_rpcs(index);
+    if (load < best_load) {
+      best = index;
+      best_load = load;
+    }
+  }
+  if (size == 1 or pool.is_ready(best)) {
+    return best;
+  }
+
+  // Query the other channels from the least to the most loaded, stopping at
+  // the first one that is ready.
+  std::vector<std::pair<long, std::size_t>> candidates;
+  candidates.reserve(size - 1);
+  for (std::size_t i = 0; i != size; ++i) {
+    auto const index = (start + i) % size;
+    if (index != best) {
+      candidates.emplace_back(pool.outstanding_rpcs(index), i);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (auto const& c : candidates) {
+    auto const index = (start + c.second) % size;
+    if (pool.is_ready(index)) {
+      return index;
+    }
+  }
+  return best;
+}
+
+std::unique_ptr<ChannelSelectionPolicy>
+PowerOfTwoChoicesChannelSelection::clone() const {
+  return std::unique_ptr<ChannelSelectionPolicy>(
+      new PowerOfTwoChoicesChannelSelection);
+}
+
+std::size_t PowerOfTwoChoicesChannelSelection::Select(ChannelPool const& pool) {
+  auto const size = pool.size();
+  if (size == 1) {
+    return 0;
+  }
+  auto& generator = ThreadGenerator();
+  std::uniform_int_distribution<std::size_t> first_choice(0, size - 1);
+  std::uniform_int_distribution<std::size_t> offset(1, size - 1);
+  auto const a = first_choice(generator);
+  auto const b = (a + offset(generator)) % size;
+
+  bool const a_ready = pool.is_ready(a);
+  bool const b_ready = pool.is_ready(b);
+  if (a_ready != b_ready) {
+    return a_ready ? a : b;
+  }
+  if (not a_ready) {
+    // Neither choice is ready, use any other channel that is.
+    for (std::size_t i = 1; i != size; ++i) {
+      auto const index = (b + i) % size;
+      if (index != a and pool.is_ready(index)) {
+        return index;
+      }
+    }
+  }
+  return pool.outstanding_rpcs(a) <= pool.outstanding_rpcs(b) ? a : b;
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,128 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CHANNEL_SELECTION_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CHANNEL_SELECTION_POLICY_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Define the interface for choosing the channel used by each RPC.
+ *
+ * The clients keep a pool of channels (see
+ * `ClientOptions::set_connection_pool_size()`) and use one of them for each
+ * RPC.  The policy decides which one, using the number of outstanding RPCs in
+ * each channel and their connectivity state.
+ *
+ * The application provides an instance of this class in the `ClientOptions`.
+ * This instance serves as a prototype, each client creates its own copy using
+ * `clone()`.  The same copy is used by all the threads sharing a client, the
+ * implementations of `Select()` must be thread-safe.
+ */
+class ChannelSelectionPolicy {
+ public:
+  /// The channels in the pool, as seen by the policy.
+  class ChannelPool {
+   public:
+    virtual ~ChannelPool() = default;
+
+    /// The number of channels in the pool, always greater than zero.
+    virtual std::size_t size() const = 0;
+
+    /// The number of RPCs started on channel @p index that have not completed.
+    virtual long outstanding_rpcs(std::size_t index) const = 0;
+
+    /**
+     * Return true if channel @p index is in the `GRPC_CHANNEL_READY` state.
+     *
+     * Idle channels start connecting when queried, so they become candidates
+     * for future RPCs.
+     */
+    virtual bool is_ready(std::size_t index) const = 0;
+  };
+
+  virtual ~ChannelSelectionPolicy() = default;
+
+  /// Return a new copy of this object, with its initial state.
+  virtual std::unique_ptr<ChannelSelectionPolicy> clone() const = 0;
+
+  /// Return the index of the channel for the next RPC.
+  virtual std::size_t Select(ChannelPool const& pool) = 0;
+};
+
+/// Return an instance of the default ChannelSelectionPolicy.
+std::unique_ptr<ChannelSelectionPolicy> DefaultChannelSelectionPolicy();
+
+/**
+ * Use the channels in round-robin order, regardless of their state.
+ *
+ * This is the default policy.
+ */
+class RoundRobinChannelSelection : public ChannelSelectionPolicy {
+ public:
+  RoundRobinChannelSelection() : current_index_(0) {}
+
+  std::unique_ptr<ChannelSelectionPolicy> clone() const override;
+  std::size_t Select(ChannelPool const& pool) override;
+
+ private:
+  std::atomic<std::size_t> current_index_;
+};
+
+/**
+ * Use the ready channel with the fewest outstanding RPCs.
+ *
+ * Ties are broken in round-robin order.  If no channel is ready, this picks
+ * the channel with the fewest outstanding RPCs among all of them.  The state
+ * of the channels is queried from the least to the most loaded, and only
+ * until a ready channel is found, typically just once for each RPC.
+ */
+class LeastOutstandingRpcsChannelSelection : public ChannelSelectionPolicy {
+ public:
+  LeastOutstandingRpcsChannelSelection() : current_index_(0) {}
+
+  std::unique_ptr<ChannelSelectionPolicy> clone() const override;
+  std::size_t Select(ChannelPool const& pool) override;
+
+ private:
+  std::atomic<std::size_t> current_index_;
+};
+
+/**
+ * Pick two channels at random, use the one with fewer outstanding RPCs.
+ *
+ * A channel that is ready is preferred over one that is not.  If neither
+ * channel is ready, this uses any other ready channel in the pool.  Compared
+ * to `LeastOutstandingRpcsChannelSelection` this examines only two channels
+ * for each RPC, and avoids sending bursts of RPCs to the same channel.
+ */
+class PowerOfTwoChoicesChannelSelection : public ChannelSelectionPolicy {
+ public:
+  std::unique_ptr<ChannelSelectionPolicy> clone() const override;
+  std::size_t Select(ChannelPool const& pool) override;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CHANNEL_SELECTION_POLICY_H_
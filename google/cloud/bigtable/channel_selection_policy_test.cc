@@ -0,0 +1,159 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/channel_selection_policy.h"
+#include <gmock/gmock.h>
+#include <map>
+#include <vector>
+
+namespace bigtable = google::cloud::bigtable;
+
+namespace {
+/// A fake pool where the tests control the load and state of each channel.
+class FakePool : public bigtable::ChannelSelectionPolicy::ChannelPool {
+ public:
+  FakePool(std::vector<long> outstanding, std::vector<bool> ready)
+      : outstanding_(std::move(outstanding)),
+        ready_(std::move(ready)),
+        state_queries_(0) {}
+
+  std::size_t size() const override { return outstanding_.size(); }
+  long outstanding_rpcs(std::size_t index) const override {
+    return outstanding_.at(index);
+  }
+  bool is_ready(std::size_t index) const override {
+    ++state_queries_;
+    return ready_.at(index);
+  }
+
+  /// The number of calls to `is_ready()`.
+  int state_queries() const { return state_queries_; }
+
+ private:
+  std::vector<long> outstanding_;
+  std::vector<bool> ready_;
+  mutable int state_queries_;
+};
+
+/// Count how many times each channel is selected in @p iterations.
+std::map<std::size_t, int> CountSelections(
+    bigtable::ChannelSelectionPolicy& policy, FakePool const& pool,
+    int iterations) {
+  std::map<std::size_t, int> counts;
+  for (int i = 0; i != iterations; ++i) {
+    ++counts[policy.Select(pool)];
+  }
+  return counts;
+}
+}  // namespace
+
+/// @test Verify that the default policy is round-robin.
+TEST(ChannelSelectionPolicyTest, Default) {
+  auto policy = bigtable::DefaultChannelSelectionPolicy();
+  FakePool pool({0, 0, 0}, {false, true, false});
+  EXPECT_EQ(0U, policy->Select(pool));
+  EXPECT_EQ(1U, policy->Select(pool));
+  EXPECT_EQ(2U, policy->Select(pool));
+  EXPECT_EQ(0U, policy->Select(pool));
+}
+
+/// @test Verify that clone() returns a policy with the initial state.
+TEST(ChannelSelectionPolicyTest, RoundRobinClone) {
+  bigtable::RoundRobinChannelSelection policy;
+  FakePool pool({0, 0, 0}, {true, true, true});
+  EXPECT_EQ(0U, policy.Select(pool));
+  EXPECT_EQ(1U, policy.Select(pool));
+  auto clone = policy.clone();
+  EXPECT_EQ(0U, clone->Select(pool));
+}
+
+/// @test Verify that LeastOutstandingRpcs picks the least loaded channel.
+TEST(ChannelSelectionPolicyTest, LeastOutstandingRpcs) {
+  bigtable::LeastOutstandingRpcsChannelSelection policy;
+  FakePool pool({5, 2, 7, 3}, {true, true, true, true});
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(1U, policy.Select(pool));
+  }
+}
+
+/// @test Verify that LeastOutstandingRpcs breaks ties in round-robin order.
+TEST(ChannelSelectionPolicyTest, LeastOutstandingRpcsTies) {
+  bigtable::LeastOutstandingRpcsChannelSelection policy;
+  FakePool pool({1, 0, 1, 0}, {true, true, true, true});
+  auto counts = CountSelections(policy, pool, 100);
+  EXPECT_EQ(0, counts[0]);
+  EXPECT_EQ(50, counts[1]);
+  EXPECT_EQ(0, counts[2]);
+  EXPECT_EQ(50, counts[3]);
+}
+
+/// @test Verify that LeastOutstandingRpcs skips channels that are not ready.
+TEST(ChannelSelectionPolicyTest, LeastOutstandingRpcsSkipsNotReady) {
+  bigtable::LeastOutstandingRpcsChannelSelection policy;
+  FakePool pool({0, 10, 0, 20}, {false, true, false, true});
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(1U, policy.Select(pool));
+  }
+}
+
+/// @test Verify that LeastOutstandingRpcs works if no channel is ready.
+TEST(ChannelSelectionPolicyTest, LeastOutstandingRpcsNoneReady) {
+  bigtable::LeastOutstandingRpcsChannelSelection policy;
+  FakePool pool({3, 1, 2}, {false, false, false});
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_EQ(1U, policy.Select(pool));
+  }
+}
+
+/// @test Verify that LeastOutstandingRpcs only queries the state it needs.
+TEST(ChannelSelectionPolicyTest, LeastOutstandingRpcsStateQueries) {
+  bigtable::LeastOutstandingRpcsChannelSelection policy;
+  FakePool ready({5, 2, 7, 3}, {true, true, true, true});
+  EXPECT_EQ(1U, policy.Select(ready));
+  EXPECT_EQ(1, ready.state_queries());
+
+  // The least loaded channels are queried first, the most loaded is not.
+  FakePool not_ready({5, 2, 7, 3}, {true, false, true, false});
+  EXPECT_EQ(0U, policy.Select(not_ready));
+  EXPECT_EQ(3, not_ready.state_queries());
+}
+
+/// @test Verify that PowerOfTwoChoices avoids the most loaded channel.
+TEST(ChannelSelectionPolicyTest, PowerOfTwoChoices) {
+  bigtable::PowerOfTwoChoicesChannelSelection policy;
+  FakePool pool({0, 0, 0, 100}, {true, true, true, true});
+  auto counts = CountSelections(policy, pool, 1000);
+  // The most loaded channel loses every comparison.
+  EXPECT_EQ(0, counts[3]);
+  EXPECT_LT(0, counts[0]);
+  EXPECT_LT(0, counts[1]);
+  EXPECT_LT(0, counts[2]);
+}
+
+/// @test Verify that PowerOfTwoChoices skips channels that are not ready.
+TEST(ChannelSelectionPolicyTest, PowerOfTwoChoicesSkipsNotReady) {
+  bigtable::PowerOfTwoChoicesChannelSelection policy;
+  FakePool pool({0, 50, 0, 0}, {false, true, false, false});
+  auto counts = CountSelections(policy, pool, 1000);
+  EXPECT_EQ(1000, counts[1]);
+}
+
+/// @test Verify that PowerOfTwoChoices works with a single channel.
+TEST(ChannelSelectionPolicyTest, PowerOfTwoChoicesSingleChannel) {
+  bigtable::PowerOfTwoChoicesChannelSelection policy;
+  FakePool pool({42}, {false});
+  EXPECT_EQ(0U, policy.Select(pool));
+  auto clone = policy.clone();
+  EXPECT_EQ(0U, clone->Select(pool));
+}
@@ -35,6 +35,11 @@ inline namespace BIGTABLE_CLIENT_NS {
 ClientOptions::ClientOptions(std::shared_ptr<grpc::ChannelCredentials> creds)
     : credentials_(std::move(creds)),
       connection_pool_size_(BIGTABLE_CLIENT_DEFAULT_CONNECTION_POOL_SIZE),
+      channel_selection_policy_(DefaultChannelSelectionPolicy()),
+      warmup_timeout_(0),
+      min_channel_refresh_period_(0),
+      max_channel_refresh_period_(0),
+      has_mutation_throttling_(false),
       data_endpoint_("bigtable.googleapis.com"),
       admin_endpoint_("bigtableadmin.googleapis.com") {
   static std::string const user_agent_prefix = "cbt-c++/" + version_string();
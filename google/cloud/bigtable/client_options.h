@@ -15,9 +15,12 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CLIENT_OPTIONS_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CLIENT_OPTIONS_H_
 
+#include "google/cloud/bigtable/channel_selection_policy.h"
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include <grpcpp/grpcpp.h>
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -103,6 +106,102 @@ class ClientOptions {
   }
   std::size_t connection_pool_size() const { return connection_pool_size_; }
 
+  /**
+   * Set the policy to choose a channel in the connection pool for each RPC.
+   *
+   * The default policy uses the channels in round-robin order, see
+   * `LeastOutstandingRpcsChannelSelection` and
+   * `PowerOfTwoChoicesChannelSelection` for policies that avoid degraded
+   * channels.  The clients make their own copy of @p policy.
+   */
+  ClientOptions& set_channel_selection_policy(
+      ChannelSelectionPolicy const& policy) {
+    channel_selection_policy_ = policy.clone();
+    return *this;
+  }
+  /// Return the prototype for the channel selection policy.
+  ChannelSelectionPolicy const& channel_selection_policy() const {
+    return *channel_selection_policy_;
+  }
+
+  /**
+   * Connect all the channels in the pool when the client is created.
+   *
+   * By default the clients create their channels on the first RPC, and gRPC
+   * connects them lazily, so the first few requests pay for the DNS lookup
+   * and the TLS handshakes.  With a non-zero @p timeout the clients created by
+   * `CreateDefaultDataClient()` and `CreateDefaultAdminClient()` create the
+   * pool eagerly and block until all the channels are ready, or until
+   * @p timeout expires.  Use `DataClient::ready_channel_count()` to find out
+   * how many channels did connect.
+   */
+  ClientOptions& set_warmup_timeout(std::chrono::milliseconds timeout) {
+    warmup_timeout_ = timeout;
+    return *this;
+  }
+  /// Return the warm up timeout, zero disables the eager connections.
+  std::chrono::milliseconds warmup_timeout() const { return warmup_timeout_; }
+
+  /**
+   * Periodically replace the channels in the connection pool.
+   *
+   * The service closes connections after they reach a certain age, and the
+   * RPCs that find their channel closed must wait for it to reconnect.  With a
+   * non-zero @p max_period the clients replace each channel once it is between
+   * @p min_period and @p max_period old.  The age is chosen at random, so the
+   * channels are replaced one at a time.  The replacement is connected before
+   * it is added to the pool, and the RPCs already using the old channel
+   * complete on it.
+   *
+   * @throws std::range_error if @p min_period is larger than @p max_period.
+   */
+  ClientOptions& set_channel_refresh_period(
+      std::chrono::milliseconds min_period,
+      std::chrono::milliseconds max_period) {
+    if (min_period > max_period) {
+      google::cloud::internal::RaiseRangeError(
+          "ClientOptions::set_channel_refresh_period requires"
+          " min_period <= max_period");
+    }
+    min_channel_refresh_period_ = min_period;
+    max_channel_refresh_period_ = max_period;
+    return *this;
+  }
+  //@{
+  /// Return the channel refresh period, a zero maximum disables the refresh.
+  std::chrono::milliseconds min_channel_refresh_period() const {
+    return min_channel_refresh_period_;
+  }
+  std::chrono::milliseconds max_channel_refresh_period() const {
+    return max_channel_refresh_period_;
+  }
+  //@}
+
+  /**
+   * Adapt the rate of `BulkApply()` mutations to the capacity of the service.
+   *
+   * With this option the clients created by `CreateDefaultDataClient()` own a
+   * `MutationRateLimiter`, shared by all the tables using the client.  Each
+   * `MutateRows` request waits until the limiter admits its mutations, this
+   * includes the requests from `AsyncBulkApply()` and `MutationBatcher`, which
+   * wait using a timer in the completion queue.  The limiter increases the
+   * rate while the requests succeed, and cuts it when the service reports an
+   * overload, see `MutationRateLimiter` for details.
+   * Use `DataClient::mutation_rate_limiter()` to query the current rate.
+   */
+  ClientOptions& set_mutation_throttling(
+      MutationThrottlingOptions const& options) {
+    has_mutation_throttling_ = true;
+    mutation_throttling_ = options;
+    return *this;
+  }
+  /// Return true if the mutations are throttled.
+  bool has_mutation_throttling() const { return has_mutation_throttling_; }
+  /// Return the mutation throttling configuration.
+  MutationThrottlingOptions const& mutation_throttling() const {
+    return mutation_throttling_;
+  }
+
   /// Return the current credentials.
   std::shared_ptr<grpc::ChannelCredentials> credentials() const {
     return credentials_;
@@ -279,6 +378,12 @@ class ClientOptions {
   grpc::ChannelArguments channel_arguments_;
   std::string connection_pool_name_;
   std::size_t connection_pool_size_;
+  std::shared_ptr<ChannelSelectionPolicy const> channel_selection_policy_;
+  std::chrono::milliseconds warmup_timeout_;
+  std::chrono::milliseconds min_channel_refresh_period_;
+  std::chrono::milliseconds max_channel_refresh_period_;
+  bool has_mutation_throttling_;
+  MutationThrottlingOptions mutation_throttling_;
   std::string data_endpoint_;
   std::string admin_endpoint_;
 };
@@ -109,6 +109,61 @@ TEST(ClientOptionsTest, EditConnectionPoolSize) {
   EXPECT_EQ(42UL, returned.connection_pool_size());
 }
 
+TEST(ClientOptionsTest, EditChannelSelectionPolicy) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_NE(nullptr, dynamic_cast<bigtable::RoundRobinChannelSelection const*>(
+                         &client_options_object.channel_selection_policy()));
+  auto& returned = client_options_object.set_channel_selection_policy(
+      bigtable::LeastOutstandingRpcsChannelSelection());
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_NE(nullptr,
+            dynamic_cast<bigtable::LeastOutstandingRpcsChannelSelection const*>(
+                &returned.channel_selection_policy()));
+}
+
+TEST(ClientOptionsTest, EditWarmupTimeout) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_EQ(0, client_options_object.warmup_timeout().count());
+  auto& returned =
+      client_options_object.set_warmup_timeout(std::chrono::seconds(2));
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_EQ(std::chrono::milliseconds(2000), returned.warmup_timeout());
+}
+
+TEST(ClientOptionsTest, EditChannelRefreshPeriod) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_EQ(0, client_options_object.max_channel_refresh_period().count());
+  auto& returned = client_options_object.set_channel_refresh_period(
+      std::chrono::minutes(30), std::chrono::minutes(45));
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_EQ(std::chrono::minutes(30), returned.min_channel_refresh_period());
+  EXPECT_EQ(std::chrono::minutes(45), returned.max_channel_refresh_period());
+}
+
+TEST(ClientOptionsTest, EditMutationThrottling) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_FALSE(client_options_object.has_mutation_throttling());
+  auto& returned = client_options_object.set_mutation_throttling(
+      bigtable::MutationThrottlingOptions().set_initial_rate(42));
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_TRUE(returned.has_mutation_throttling());
+  EXPECT_EQ(42, returned.mutation_throttling().initial_rate());
+}
+
+TEST(ClientOptionsTest, InvalidChannelRefreshPeriod) {
+  bigtable::ClientOptions client_options_object;
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  EXPECT_THROW(client_options_object.set_channel_refresh_period(
+                   std::chrono::minutes(2), std::chrono::minutes(1)),
+               std::range_error);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(
+      client_options_object.set_channel_refresh_period(
+          std::chrono::minutes(2), std::chrono::minutes(1)),
+      "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
 TEST(ClientOptionsTest, InvalidConnectionPoolSize) {
   bigtable::ClientOptions client_options_object;
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -0,0 +1,50 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/completion_queue.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+CompletionQueue::CompletionQueue()
+    : impl_(std::make_shared<internal::CompletionQueueImpl>()) {}
+
+void CompletionQueue::Run() { impl_->Run(*this); }
+
+void CompletionQueue::Shutdown() { impl_->Shutdown(); }
+
+std::shared_ptr<AsyncOperation> CompletionQueue::MakeDeadlineTimer(
+    std::chrono::system_clock::time_point deadline, TimerCallback callback) {
+  auto op = std::make_shared<internal::AsyncTimerFunctor>(
+      std::move(callback), deadline, impl_->CreateAlarm());
+  auto& cq = impl_->cq();
+  bool started =
+      impl_->StartOperation(op, [&](void* tag) { op->Set(cq, tag); });
+  if (not started) {
+    // The queue is shutting down, the timer is cancelled immediately.
+    op->Fail(*this);
+  }
+  return op;
+}
+
+grpc::Status CompletionQueue::ShutdownStatus() {
+  return grpc::Status(grpc::StatusCode::CANCELLED,
+                      "CompletionQueue is shutting down");
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,216 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COMPLETION_QUEUE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COMPLETION_QUEUE_H_
+
+#include "google/cloud/bigtable/async_operation.h"
+#include "google/cloud/bigtable/internal/completion_queue_impl.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Call the functor associated with asynchronous operations when they complete.
+ *
+ * Applications (or the library) create one or more `CompletionQueue` objects,
+ * start asynchronous operations using them, and run the event loop in one or
+ * more threads by calling `Run()`. The callbacks for the asynchronous
+ * operations are invoked in the threads running the event loop.
+ *
+ * The only exception are operations started after `Shutdown()`: they fail
+ * immediately, with a `CANCELLED` status (or, for timers, as cancelled), and
+ * their callbacks are invoked in the calling thread, before the function
+ * starting the operation returns.  The queue cannot deliver them, it may have
+ * stopped already.  Callbacks that lock a mutex held by the caller must take
+ * this into account.
+ *
+ * @par Example
+ * @code
+ * bigtable::CompletionQueue cq;
+ * std::thread t([&cq] { cq.Run(); });
+ * table.AsyncApply(mutation, cq, [](bigtable::CompletionQueue&,
+ *                                   grpc::Status& status) { ... });
+ * // ... eventually ...
+ * cq.Shutdown();
+ * t.join();
+ * @endcode
+ *
+ * Copies of a `CompletionQueue` share the same underlying queue.
+ */
+class CompletionQueue {
+ public:
+  CompletionQueue();
+  explicit CompletionQueue(std::shared_ptr<internal::CompletionQueueImpl> impl)
+      : impl_(std::move(impl)) {}
+
+  /// The callback type for timers.
+  using TimerCallback = internal::AsyncTimerFunctor::Callback;
+
+  /**
+   * Run the completion queue event loop.
+   *
+   * Note that more than one thread can call this member function, to create a
+   * pool of threads completing asynchronous operations.
+   *
+   * The function returns once `Shutdown()` has been called and all the pending
+   * operations have completed.
+   */
+  void Run();
+
+  /**
+   * Terminate the completion queue event loop.
+   *
+   * All pending operations are cancelled, their callbacks are still invoked,
+   * in the threads running the event loop. Operations started after this
+   * function is called fail immediately, their callbacks are invoked in the
+   * thread starting them.
+   */
+  void Shutdown();
+
+  /**
+   * Create a timer that fires at @p deadline.
+   *
+   * @param deadline when should the timer expire.
+   * @param callback the value of this object is invoked when the timer expires
+   *     or is cancelled, the last argument is `true` if the timer expired and
+   *     `false` if it was cancelled.
+   * @return an asynchronous operation wrapping the timer; can be used to
+   *     cancel it.
+   *
+   * If the queue is shut down, @p callback is invoked, as cancelled, before
+   * this function returns.
+   */
+  std::shared_ptr<AsyncOperation> MakeDeadlineTimer(
+      std::chrono::system_clock::time_point deadline, TimerCallback callback);
+
+  /**
+   * Create a timer that fires after the @p duration.
+   *
+   * @tparam Rep a placeholder to match the Rep tparam for @p duration type,
+   *     the semantics of this template parameter are documented in
+   *     `std::chrono::duration<>` (in brief, the underlying arithmetic type
+   *     used to store the number of ticks), for our purposes it is simply a
+   *     formal parameter.
+   * @tparam Period a placeholder to match the Period tparam for @p duration
+   *     type, the semantics of this template parameter are documented in
+   *     `std::chrono::duration<>` (in brief, the length of the tick in seconds,
+   *     expressed as a `std::ratio<>`), for our purposes it is simply a formal
+   *     parameter.
+   */
+  template <typename Rep, typename Period>
+  std::shared_ptr<AsyncOperation> MakeRelativeTimer(
+      std::chrono::duration<Rep, Period> duration, TimerCallback callback) {
+    return MakeDeadlineTimer(
+        std::chrono::system_clock::now() +
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                duration),
+        std::move(callback));
+  }
+
+  /**
+   * Make an asynchronous unary RPC.
+   *
+   * @param client an object that holds the asynchronous RPC wrappers, such as
+   *     `bigtable::DataClient`.
+   * @param async_call a pointer to the member function in @p client that
+   *     starts the RPC.
+   * @param request the contents of the request.
+   * @param context an initialized request context to make the call.
+   * @param callback the functor to call when the RPC completes.
+   *
+   * @tparam Client the type of @p client.
+   * @tparam Request the type of the request parameter in the gRPC.
+   * @tparam Response the type of the response in the gRPC.
+   *
+   * @return an asynchronous operation wrapping the RPC; can be used to cancel
+   *     it.
+   *
+   * If the queue is shut down, @p callback is invoked, with a `CANCELLED`
+   * status, before this function returns.
+   */
+  template <typename Client, typename Request, typename Response>
+  std::shared_ptr<AsyncOperation> MakeUnaryRpc(
+      Client& client,
+      std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Response>> (
+          Client::*async_call)(grpc::ClientContext*, Request const&,
+                               grpc::CompletionQueue*),
+      Request const& request, std::unique_ptr<grpc::ClientContext> context,
+      typename internal::AsyncUnaryRpcFunctor<Response>::Callback callback) {
+    auto op = std::make_shared<internal::AsyncUnaryRpcFunctor<Response>>(
+        std::move(callback));
+    auto& cq = impl_->cq();
+    bool started = impl_->StartOperation(op, [&](void* tag) {
+      op->Set(client, async_call, request, std::move(context), cq, tag);
+    });
+    if (not started) {
+      op->Fail(*this, std::move(context), ShutdownStatus());
+    }
+    return op;
+  }
+
+  /**
+   * Make an asynchronous streaming read RPC.
+   *
+   * @param client an object that holds the asynchronous RPC wrappers, such as
+   *     `bigtable::DataClient`.
+   * @param prepare_call a pointer to the member function in @p client that
+   *     prepares (but does not start) the RPC.
+   * @param request the contents of the request.
+   * @param context an initialized request context to make the call.
+   * @param on_read the functor to call for each response in the stream.
+   * @param on_finish the functor to call when the stream completes.
+   *
+   * @return an asynchronous operation wrapping the RPC; can be used to cancel
+   *     it.
+   *
+   * If the queue is shut down, @p on_finish is invoked, with a `CANCELLED`
+   * status, before this function returns.
+   */
+  template <typename Client, typename Request, typename Response>
+  std::shared_ptr<AsyncOperation> MakeStreamingReadRpc(
+      Client& client,
+      std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> (
+          Client::*prepare_call)(grpc::ClientContext*, Request const&,
+                                 grpc::CompletionQueue*),
+      Request const& request, std::unique_ptr<grpc::ClientContext> context,
+      typename internal::AsyncReadStreamFunctor<Response>::ReadCallback on_read,
+      typename internal::AsyncReadStreamFunctor<Response>::FinishCallback
+          on_finish) {
+    auto op = std::make_shared<internal::AsyncReadStreamFunctor<Response>>(
+        std::move(on_read), std::move(on_finish));
+    auto& cq = impl_->cq();
+    bool started = impl_->StartOperation(op, [&](void* tag) {
+      op->Set(client, prepare_call, request, std::move(context), cq, tag);
+    });
+    if (not started) {
+      op->Fail(*this, std::move(context), ShutdownStatus());
+    }
+    return op;
+  }
+
+ private:
+  /// The status reported to operations started after `Shutdown()`.
+  static grpc::Status ShutdownStatus();
+
+  std::shared_ptr<internal::CompletionQueueImpl> impl_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COMPLETION_QUEUE_H_
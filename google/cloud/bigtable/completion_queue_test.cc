@@ -0,0 +1,205 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/mock_data_client.h"
+#include <gmock/gmock.h>
+#include <future>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::chrono_literals;
+
+/// @test Verify that timers expire and their callbacks are invoked.
+TEST(CompletionQueueTest, TimerSmokeTest) {
+  bigtable::CompletionQueue cq;
+  std::thread t([&cq]() { cq.Run(); });
+
+  std::promise<bool> promise;
+  auto start = std::chrono::system_clock::now();
+  cq.MakeRelativeTimer(2_ms,
+                       [&promise](bigtable::CompletionQueue&,
+                                  bigtable::AsyncTimerResult& result, bool ok) {
+                         promise.set_value(ok);
+                       });
+  auto f = promise.get_future();
+  EXPECT_TRUE(f.get());
+  EXPECT_LE(start + 2_ms, std::chrono::system_clock::now());
+
+  cq.Shutdown();
+  t.join();
+}
+
+/// @test Verify that cancelled timers report ok == false.
+TEST(CompletionQueueTest, TimerCancel) {
+  bigtable::CompletionQueue cq;
+  std::thread t([&cq]() { cq.Run(); });
+
+  std::promise<bool> promise;
+  auto op = cq.MakeRelativeTimer(
+      std::chrono::hours(1),
+      [&promise](bigtable::CompletionQueue&, bigtable::AsyncTimerResult&,
+                 bool ok) { promise.set_value(ok); });
+  op->Cancel();
+  auto f = promise.get_future();
+  EXPECT_FALSE(f.get());
+
+  cq.Shutdown();
+  t.join();
+}
+
+/// @test Verify that Shutdown() cancels the pending operations.
+TEST(CompletionQueueTest, ShutdownCancelsPending) {
+  bigtable::CompletionQueue cq;
+  std::thread t([&cq]() { cq.Run(); });
+
+  std::promise<bool> promise;
+  cq.MakeRelativeTimer(std::chrono::hours(1),
+                       [&promise](bigtable::CompletionQueue&,
+                                  bigtable::AsyncTimerResult&,
+                                  bool ok) { promise.set_value(ok); });
+  cq.Shutdown();
+  auto f = promise.get_future();
+  EXPECT_FALSE(f.get());
+  t.join();
+}
+
+/// @test Verify that operations started after Shutdown() fail immediately.
+TEST(CompletionQueueTest, StartAfterShutdown) {
+  bigtable::CompletionQueue cq;
+  std::thread t([&cq]() { cq.Run(); });
+  cq.Shutdown();
+  t.join();
+
+  bool called = false;
+  bool timer_ok = true;
+  cq.MakeRelativeTimer(
+      10_ms, [&called, &timer_ok](bigtable::CompletionQueue&,
+                                  bigtable::AsyncTimerResult&, bool ok) {
+        called = true;
+        timer_ok = ok;
+      });
+  EXPECT_TRUE(called);
+  EXPECT_FALSE(timer_ok);
+}
+
+/// @test Verify that unary RPCs deliver the response and status.
+TEST(CompletionQueueTest, MockUnaryRpc) {
+  using namespace ::testing;
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::testing::MockDataClient client;
+
+  auto reader = bigtable::internal::make_unique<
+      bigtable::testing::MockAsyncResponseReader<
+          btproto::CheckAndMutateRowResponse>>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btproto::CheckAndMutateRowResponse* response,
+                          grpc::Status* status, void*) {
+        response->set_predicate_matched(true);
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(client, AsyncCheckAndMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::CheckAndMutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  bool called = false;
+  btproto::CheckAndMutateRowRequest request;
+  cq.MakeUnaryRpc(
+      client, &bigtable::testing::MockDataClient::AsyncCheckAndMutateRow,
+      request, bigtable::internal::make_unique<grpc::ClientContext>(),
+      [&called](bigtable::CompletionQueue&, grpc::ClientContext&,
+                btproto::CheckAndMutateRowResponse& response,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(response.predicate_matched());
+        called = true;
+      });
+  EXPECT_FALSE(called);
+  EXPECT_EQ(1U, impl->size());
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that streaming read RPCs deliver each response.
+TEST(CompletionQueueTest, MockStreamingReadRpc) {
+  using namespace ::testing;
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::testing::MockDataClient client;
+
+  auto reader = bigtable::internal::make_unique<
+      bigtable::testing::MockClientAsyncReader<btproto::MutateRowsResponse>>();
+  EXPECT_CALL(*reader, StartCall(_)).Times(1);
+  EXPECT_CALL(*reader, Read(_, _))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r, void*) {
+        r->add_entries()->set_index(0);
+      }))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r, void*) {
+        r->add_entries()->set_index(1);
+      }))
+      .WillOnce(Return());
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce(Invoke([](grpc::Status* status, void*) {
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(client, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowsRequest const&,
+                                 grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            btproto::MutateRowsResponse>>(reader.release());
+      }));
+
+  std::vector<std::int64_t> indices;
+  bool finished = false;
+  btproto::MutateRowsRequest request;
+  cq.MakeStreamingReadRpc(
+      client, &bigtable::testing::MockDataClient::PrepareAsyncMutateRows,
+      request, bigtable::internal::make_unique<grpc::ClientContext>(),
+      [&indices](bigtable::CompletionQueue&, grpc::ClientContext&,
+                 btproto::MutateRowsResponse& response) {
+        for (auto const& e : response.entries()) {
+          indices.push_back(e.index());
+        }
+      },
+      [&finished](bigtable::CompletionQueue&, grpc::ClientContext&,
+                  grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        finished = true;
+      });
+
+  impl->SimulateCompletion(cq, true);  // StartCall()
+  impl->SimulateCompletion(cq, true);  // first Read()
+  impl->SimulateCompletion(cq, true);  // second Read()
+  EXPECT_FALSE(finished);
+  impl->SimulateCompletion(cq, false);  // third Read(), end of stream
+  EXPECT_FALSE(finished);
+  impl->SimulateCompletion(cq, true);  // Finish()
+  EXPECT_TRUE(finished);
+  EXPECT_THAT(indices, ElementsAre(0, 1));
+  EXPECT_TRUE(impl->empty());
+}
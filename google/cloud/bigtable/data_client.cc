@@ -14,6 +14,9 @@
 
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/internal/common_client.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/internal/tracked_stream.h"
+#include <grpcpp/alarm.h>
 
 namespace btproto = google::bigtable::v2;
 
@@ -21,13 +24,90 @@ namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+grpc::Status UnimplementedStatus() {
+  return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                      "this DataClient does not implement asynchronous RPCs");
+}
+
+/**
+ * Report a failed event for @p tag through @p cq.
+ *
+ * The event is delivered, with `ok == false`, by cancelling an alarm. The alarm
+ * keeps its own reference to the pending event, so it can be discarded at once.
+ */
+void PostFailedEvent(grpc::CompletionQueue* cq, void* tag) {
+  grpc::Alarm alarm;
+  alarm.Set(cq, std::chrono::system_clock::now() + std::chrono::hours(1), tag);
+  alarm.Cancel();
+}
+
+/**
+ * A unary RPC that finishes with `UNIMPLEMENTED`.
+ *
+ * gRPC specializes `std::default_delete<>` for this interface (the real objects
+ * live in the call arena), so the `std::unique_ptr<>` returned to the caller
+ * never deletes the object. It deletes itself once the RPC finishes, and then
+ * it cannot use an alarm to report a successful event: the `ok` flag for the
+ * `Finish()` event is false, but the status is set.
+ */
+template <typename Response>
+class UnimplementedResponseReader
+    : public grpc::ClientAsyncResponseReaderInterface<Response> {
+ public:
+  explicit UnimplementedResponseReader(grpc::CompletionQueue* cq) : cq_(cq) {}
+
+  void StartCall() override {}
+  void ReadInitialMetadata(void* tag) override { PostFailedEvent(cq_, tag); }
+  void Finish(Response*, grpc::Status* status, void* tag) override {
+    *status = UnimplementedStatus();
+    PostFailedEvent(cq_, tag);
+    delete this;
+  }
+
+ private:
+  grpc::CompletionQueue* cq_;
+};
+
+template <typename Response>
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Response>>
+MakeUnimplementedResponseReader(grpc::CompletionQueue* cq) {
+  return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Response>>(
+      new UnimplementedResponseReader<Response>(cq));
+}
+
+/// A streaming read RPC that fails to start, and finishes with
+/// `UNIMPLEMENTED`.
+template <typename Response>
+class UnimplementedReader : public grpc::ClientAsyncReaderInterface<Response> {
+ public:
+  explicit UnimplementedReader(grpc::CompletionQueue* cq) : cq_(cq) {}
+
+  void StartCall(void* tag) override { PostFailedEvent(cq_, tag); }
+  void ReadInitialMetadata(void* tag) override { PostFailedEvent(cq_, tag); }
+  void Read(Response*, void* tag) override { PostFailedEvent(cq_, tag); }
+  void Finish(grpc::Status* status, void* tag) override {
+    *status = UnimplementedStatus();
+    // The alarm must not be destroyed before it expires, or the event would be
+    // reported as failed, the caller owns this object until then.
+    finish_alarm_.Set(cq_, std::chrono::system_clock::now(), tag);
+  }
+
+ private:
+  grpc::CompletionQueue* cq_;
+  grpc::Alarm finish_alarm_;
+};
+}  // namespace
+
 /**
  * Implement a simple DataClient.
  *
  * This implementation does not support multiple threads, or refresh
  * authorization tokens.  In other words, it is extremely bare bones.
  */
-class DefaultDataClient : public DataClient {
+class DefaultDataClient
+    : public DataClient,
+      public std::enable_shared_from_this<DefaultDataClient> {
  private:
   // Introduce an early `private:` section because this type is used to define
   // the public interface, it should not be part of the public interface.
@@ -44,6 +124,11 @@ class DefaultDataClient : public DataClient {
                     ClientOptions options)
       : project_(std::move(project)),
         instance_(std::move(instance)),
+        mutation_rate_limiter_(
+            options.has_mutation_throttling()
+                ? std::make_shared<MutationRateLimiter>(
+                      options.mutation_throttling())
+                : nullptr),
         impl_(std::move(options)) {}
 
   DefaultDataClient(std::string project, std::string instance)
@@ -55,48 +140,119 @@ class DefaultDataClient : public DataClient {
 
   std::shared_ptr<grpc::Channel> Channel() override { return impl_.Channel(); }
   void reset() override { impl_.reset(); }
+  std::future<std::size_t> WarmUp(std::chrono::milliseconds timeout) override {
+    return bigtable::internal::AsyncConnectAll(shared_from_this(), timeout);
+  }
+  std::size_t ready_channel_count() override {
+    return impl_.ready_channel_count();
+  }
+  std::shared_ptr<MutationRateLimiter> mutation_rate_limiter() override {
+    return mutation_rate_limiter_;
+  }
+
+  /// Connect all the channels, blocking the calling thread.
+  std::size_t ConnectAll(std::chrono::milliseconds timeout) {
+    return impl_.WarmUp(std::chrono::system_clock::now() + timeout);
+  }
 
   grpc::Status MutateRow(grpc::ClientContext* context,
                          btproto::MutateRowRequest const& request,
                          btproto::MutateRowResponse* response) override {
-    return impl_.Stub()->MutateRow(context, request, response);
+    auto rpc = impl_.StartRpc();
+    return rpc.stub->MutateRow(context, request, response);
   }
 
   grpc::Status CheckAndMutateRow(
       grpc::ClientContext* context,
       btproto::CheckAndMutateRowRequest const& request,
       btproto::CheckAndMutateRowResponse* response) override {
-    return impl_.Stub()->CheckAndMutateRow(context, request, response);
+    auto rpc = impl_.StartRpc();
+    return rpc.stub->CheckAndMutateRow(context, request, response);
   }
 
   grpc::Status ReadModifyWriteRow(
       grpc::ClientContext* context,
       btproto::ReadModifyWriteRowRequest const& request,
       btproto::ReadModifyWriteRowResponse* response) override {
-    return impl_.Stub()->ReadModifyWriteRow(context, request, response);
+    auto rpc = impl_.StartRpc();
+    return rpc.stub->ReadModifyWriteRow(context, request, response);
   }
 
   std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
   ReadRows(grpc::ClientContext* context,
            btproto::ReadRowsRequest const& request) override {
-    return impl_.Stub()->ReadRows(context, request);
+    auto rpc = impl_.StartRpc();
+    return bigtable::internal::MakeTrackedStream(
+        rpc.stub->ReadRows(context, request), std::move(rpc.tracker));
   }
 
   std::unique_ptr<grpc::ClientReaderInterface<btproto::SampleRowKeysResponse>>
   SampleRowKeys(grpc::ClientContext* context,
                 btproto::SampleRowKeysRequest const& request) override {
-    return impl_.Stub()->SampleRowKeys(context, request);
+    auto rpc = impl_.StartRpc();
+    return bigtable::internal::MakeTrackedStream(
+        rpc.stub->SampleRowKeys(context, request), std::move(rpc.tracker));
   }
 
   std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
   MutateRows(grpc::ClientContext* context,
              btproto::MutateRowsRequest const& request) override {
-    return impl_.Stub()->MutateRows(context, request);
+    auto rpc = impl_.StartRpc();
+    return bigtable::internal::MakeTrackedStream(
+        rpc.stub->MutateRows(context, request), std::move(rpc.tracker));
+  }
+
+  // gRPC never deletes the asynchronous unary readers (they live in the call
+  // arena), so there is no place to release a tracker for these RPCs.
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<btproto::MutateRowResponse>>
+  AsyncMutateRow(grpc::ClientContext* context,
+                 btproto::MutateRowRequest const& request,
+                 grpc::CompletionQueue* cq) override {
+    return impl_.Stub()->AsyncMutateRow(context, request, cq);
+  }
+
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      btproto::CheckAndMutateRowResponse>>
+  AsyncCheckAndMutateRow(grpc::ClientContext* context,
+                         btproto::CheckAndMutateRowRequest const& request,
+                         grpc::CompletionQueue* cq) override {
+    return impl_.Stub()->AsyncCheckAndMutateRow(context, request, cq);
+  }
+
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      btproto::ReadModifyWriteRowResponse>>
+  AsyncReadModifyWriteRow(grpc::ClientContext* context,
+                          btproto::ReadModifyWriteRowRequest const& request,
+                          grpc::CompletionQueue* cq) override {
+    return impl_.Stub()->AsyncReadModifyWriteRow(context, request, cq);
+  }
+
+  std::unique_ptr<grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>
+  PrepareAsyncReadRows(grpc::ClientContext* context,
+                       btproto::ReadRowsRequest const& request,
+                       grpc::CompletionQueue* cq) override {
+    auto rpc = impl_.StartRpc();
+    return bigtable::internal::MakeTrackedStream(
+        rpc.stub->PrepareAsyncReadRows(context, request, cq),
+        std::move(rpc.tracker));
+  }
+
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<btproto::MutateRowsResponse>>
+  PrepareAsyncMutateRows(grpc::ClientContext* context,
+                         btproto::MutateRowsRequest const& request,
+                         grpc::CompletionQueue* cq) override {
+    auto rpc = impl_.StartRpc();
+    return bigtable::internal::MakeTrackedStream(
+        rpc.stub->PrepareAsyncMutateRows(context, request, cq),
+        std::move(rpc.tracker));
   }
 
  private:
   std::string project_;
   std::string instance_;
+  std::shared_ptr<MutationRateLimiter> mutation_rate_limiter_;
   Impl impl_;
 };
 
@@ -107,8 +263,61 @@ std::string const& DefaultDataClient::instance_id() const { return instance_; }
 std::shared_ptr<DataClient> CreateDefaultDataClient(std::string project_id,
                                                     std::string instance_id,
                                                     ClientOptions options) {
-  return std::make_shared<DefaultDataClient>(
+  auto warmup_timeout = options.warmup_timeout();
+  auto client = std::make_shared<DefaultDataClient>(
       std::move(project_id), std::move(instance_id), std::move(options));
+  if (warmup_timeout.count() > 0) {
+    client->ConnectAll(warmup_timeout);
+  }
+  return client;
+}
+
+std::future<std::size_t> DataClient::WarmUp(std::chrono::milliseconds) {
+  std::promise<std::size_t> ready;
+  ready.set_value(0);
+  return ready.get_future();
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<btproto::MutateRowResponse>>
+DataClient::AsyncMutateRow(grpc::ClientContext*,
+                           btproto::MutateRowRequest const&,
+                           grpc::CompletionQueue* cq) {
+  return MakeUnimplementedResponseReader<btproto::MutateRowResponse>(cq);
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    btproto::CheckAndMutateRowResponse>>
+DataClient::AsyncCheckAndMutateRow(grpc::ClientContext*,
+                                   btproto::CheckAndMutateRowRequest const&,
+                                   grpc::CompletionQueue* cq) {
+  return MakeUnimplementedResponseReader<
+      btproto::CheckAndMutateRowResponse>(cq);
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    btproto::ReadModifyWriteRowResponse>>
+DataClient::AsyncReadModifyWriteRow(grpc::ClientContext*,
+                                    btproto::ReadModifyWriteRowRequest const&,
+                                    grpc::CompletionQueue* cq) {
+  return MakeUnimplementedResponseReader<
+      btproto::ReadModifyWriteRowResponse>(cq);
+}
+
+std::unique_ptr<grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>
+DataClient::PrepareAsyncReadRows(grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&,
+                                 grpc::CompletionQueue* cq) {
+  return bigtable::internal::make_unique<
+      UnimplementedReader<btproto::ReadRowsResponse>>(cq);
+}
+
+std::unique_ptr<grpc::ClientAsyncReaderInterface<btproto::MutateRowsResponse>>
+DataClient::PrepareAsyncMutateRows(grpc::ClientContext*,
+                                   btproto::MutateRowsRequest const&,
+                                   grpc::CompletionQueue* cq) {
+  return bigtable::internal::make_unique<
+      UnimplementedReader<btproto::MutateRowsResponse>>(cq);
 }
 
 }  // namespace BIGTABLE_CLIENT_NS
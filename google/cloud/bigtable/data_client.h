@@ -17,6 +17,9 @@
 
 #include "google/cloud/bigtable/client_options.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <chrono>
+#include <future>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -28,6 +31,8 @@ namespace noex {
 class Table;
 }  // namespace noex
 namespace internal {
+class AsyncRetryBulkApply;
+class AsyncRowReader;
 class BulkMutator;
 }  // namespace internal
 
@@ -65,6 +70,35 @@ class DataClient {
    */
   virtual void reset() = 0;
 
+  /**
+   * Create the connection pool and connect all its channels.
+   *
+   * The returned future is satisfied with the number of channels that are
+   * ready, once all of them are, or once @p timeout expires.  This function
+   * does not block, and the future can be discarded without waiting for the
+   * channels.  The default implementation, used by the test clients, has no
+   * channels to connect.
+   */
+  virtual std::future<std::size_t> WarmUp(std::chrono::milliseconds timeout);
+
+  /**
+   * Return the number of channels in the pool that are ready.
+   *
+   * This does not create the pool, nor does it start connecting any channels.
+   */
+  virtual std::size_t ready_channel_count() { return 0; }
+
+  /**
+   * Return the rate limiter for mutations, shared by all the tables using this
+   * client.
+   *
+   * Returns `nullptr` if the mutations are not throttled, see
+   * `ClientOptions::set_mutation_throttling()`.
+   */
+  virtual std::shared_ptr<MutationRateLimiter> mutation_rate_limiter() {
+    return nullptr;
+  }
+
   // The member functions of this class are not intended for general use by
   // application developers (they are simply a dependency injection point). Make
   // them protected, so the mock classes can override them, and then make the
@@ -72,6 +106,8 @@ class DataClient {
  protected:
   friend class Table;
   friend class noex::Table;
+  friend class internal::AsyncRetryBulkApply;
+  friend class internal::AsyncRowReader;
   friend class internal::BulkMutator;
   friend class RowReader;
   //@{
@@ -101,6 +137,46 @@ class DataClient {
   MutateRows(grpc::ClientContext* context,
              google::bigtable::v2::MutateRowsRequest const& request) = 0;
   //@}
+
+  //@{
+  /**
+   * @name the `google.bigtable.v2.Bigtable` asynchronous wrappers.
+   *
+   * The unary RPCs are started immediately, the streaming RPCs are prepared
+   * but not started, the caller must call `StartCall()` on the result.
+   *
+   * The default implementations do not contact the service, the RPCs they
+   * return complete, through @p cq, with a `UNIMPLEMENTED` status.  Only
+   * clients used with the asynchronous APIs need to override them.
+   */
+  virtual std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::MutateRowResponse>>
+  AsyncMutateRow(grpc::ClientContext* context,
+                 google::bigtable::v2::MutateRowRequest const& request,
+                 grpc::CompletionQueue* cq);
+  virtual std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::CheckAndMutateRowResponse>>
+  AsyncCheckAndMutateRow(
+      grpc::ClientContext* context,
+      google::bigtable::v2::CheckAndMutateRowRequest const& request,
+      grpc::CompletionQueue* cq);
+  virtual std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::ReadModifyWriteRowResponse>>
+  AsyncReadModifyWriteRow(
+      grpc::ClientContext* context,
+      google::bigtable::v2::ReadModifyWriteRowRequest const& request,
+      grpc::CompletionQueue* cq);
+  virtual std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+  PrepareAsyncReadRows(grpc::ClientContext* context,
+                       google::bigtable::v2::ReadRowsRequest const& request,
+                       grpc::CompletionQueue* cq);
+  virtual std::unique_ptr<grpc::ClientAsyncReaderInterface<
+      google::bigtable::v2::MutateRowsResponse>>
+  PrepareAsyncMutateRows(grpc::ClientContext* context,
+                         google::bigtable::v2::MutateRowsRequest const& request,
+                         grpc::CompletionQueue* cq);
+  //@}
 };
 
 /// Create the default implementation of ClientInterface.
@@ -37,3 +37,112 @@ TEST(DataClientTest, Default) {
   EXPECT_TRUE(channel1);
   EXPECT_NE(channel0.get(), channel1.get());
 }
+
+TEST(DataClientTest, WarmUpTimeout) {
+  auto data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      bigtable::ClientOptions(grpc::InsecureChannelCredentials())
+          .set_data_endpoint("localhost:1")
+          .set_connection_pool_size(2)
+          .set_warmup_timeout(std::chrono::milliseconds(50)));
+  ASSERT_TRUE(data_client);
+  EXPECT_EQ(0U, data_client->ready_channel_count());
+  EXPECT_EQ(0U, data_client->WarmUp(std::chrono::milliseconds(50)).get());
+}
+
+TEST(DataClientTest, MutationRateLimiter) {
+  auto data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      bigtable::ClientOptions(grpc::InsecureChannelCredentials()));
+  EXPECT_FALSE(data_client->mutation_rate_limiter());
+
+  data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      bigtable::ClientOptions(grpc::InsecureChannelCredentials())
+          .set_mutation_throttling(
+              bigtable::MutationThrottlingOptions().set_initial_rate(500)));
+  auto limiter = data_client->mutation_rate_limiter();
+  ASSERT_TRUE(limiter);
+  // All the tables using the client share the same limiter.
+  EXPECT_EQ(limiter, data_client->mutation_rate_limiter());
+  EXPECT_EQ(500, limiter->rate());
+}
+
+namespace {
+namespace btproto = google::bigtable::v2;
+
+/// A client that only implements the synchronous RPCs.
+class SynchronousDataClient : public bigtable::DataClient {
+ public:
+  std::string const& project_id() const override { return project_; }
+  std::string const& instance_id() const override { return project_; }
+  std::shared_ptr<grpc::Channel> Channel() override { return nullptr; }
+  void reset() override {}
+
+  grpc::Status MutateRow(grpc::ClientContext*, btproto::MutateRowRequest const&,
+                         btproto::MutateRowResponse*) override {
+    return grpc::Status::OK;
+  }
+  grpc::Status CheckAndMutateRow(grpc::ClientContext*,
+                                 btproto::CheckAndMutateRowRequest const&,
+                                 btproto::CheckAndMutateRowResponse*) override {
+    return grpc::Status::OK;
+  }
+  grpc::Status ReadModifyWriteRow(
+      grpc::ClientContext*, btproto::ReadModifyWriteRowRequest const&,
+      btproto::ReadModifyWriteRowResponse*) override {
+    return grpc::Status::OK;
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<btproto::ReadRowsResponse>>
+  ReadRows(grpc::ClientContext*, btproto::ReadRowsRequest const&) override {
+    return nullptr;
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<btproto::SampleRowKeysResponse>>
+  SampleRowKeys(grpc::ClientContext*,
+                btproto::SampleRowKeysRequest const&) override {
+    return nullptr;
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
+  MutateRows(grpc::ClientContext*, btproto::MutateRowsRequest const&) override {
+    return nullptr;
+  }
+
+  using DataClient::AsyncMutateRow;
+  using DataClient::PrepareAsyncReadRows;
+
+ private:
+  std::string project_;
+};
+}  // namespace
+
+/// @test Verify the default asynchronous RPCs complete with UNIMPLEMENTED.
+TEST(DataClientTest, AsyncUnimplemented) {
+  SynchronousDataClient client;
+  grpc::CompletionQueue cq;
+  void* tag;
+  bool ok;
+
+  grpc::ClientContext unary_context;
+  auto unary = client.AsyncMutateRow(&unary_context, {}, &cq);
+  btproto::MutateRowResponse response;
+  grpc::Status status;
+  unary->Finish(&response, &status, &unary_context);
+  ASSERT_TRUE(cq.Next(&tag, &ok));
+  EXPECT_EQ(&unary_context, tag);
+  EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED, status.error_code());
+
+  grpc::ClientContext stream_context;
+  auto stream = client.PrepareAsyncReadRows(&stream_context, {}, &cq);
+  stream->StartCall(&stream_context);
+  ASSERT_TRUE(cq.Next(&tag, &ok));
+  EXPECT_EQ(&stream_context, tag);
+  EXPECT_FALSE(ok);
+  stream->Finish(&status, &stream_context);
+  ASSERT_TRUE(cq.Next(&tag, &ok));
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED, status.error_code());
+
+  cq.Shutdown();
+  while (cq.Next(&tag, &ok)) {
+  }
+}
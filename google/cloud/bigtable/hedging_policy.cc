@@ -0,0 +1,113 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/hedging_policy.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// The number of hedges that can be sent in a burst.
+double const kMaxHedgeTokens = 10.0;
+
+/// The number of latencies kept by `LatencyPercentileHedgingPolicy`.
+std::size_t const kLatencySamples = 512;
+
+/// Recompute the percentile after this many new latencies.
+std::size_t const kLatencyUpdatePeriod = 32;
+}  // anonymous namespace
+
+HedgeBudget::HedgeBudget(double max_hedge_ratio)
+    : max_hedge_ratio_(max_hedge_ratio), tokens_(0.0) {}
+
+void HedgeBudget::OnRequest() {
+  std::lock_guard<std::mutex> lk(mu_);
+  tokens_ = (std::min)(kMaxHedgeTokens, tokens_ + max_hedge_ratio_);
+}
+
+bool HedgeBudget::TryHedge() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (tokens_ < 1.0) {
+    return false;
+  }
+  tokens_ -= 1.0;
+  return true;
+}
+
+FixedDelayHedgingPolicy::FixedDelayHedgingPolicy(
+    std::chrono::microseconds delay, double max_hedge_ratio)
+    : delay_(delay), budget_(max_hedge_ratio) {}
+
+std::unique_ptr<HedgingPolicy> FixedDelayHedgingPolicy::clone() const {
+  return std::unique_ptr<HedgingPolicy>(
+      new FixedDelayHedgingPolicy(delay_, budget_.max_hedge_ratio()));
+}
+
+std::chrono::microseconds FixedDelayHedgingPolicy::OnRequest() {
+  budget_.OnRequest();
+  return delay_;
+}
+
+bool FixedDelayHedgingPolicy::OnHedge() { return budget_.TryHedge(); }
+
+LatencyPercentileHedgingPolicy::LatencyPercentileHedgingPolicy(
+    double percentile, std::chrono::microseconds initial_delay,
+    double max_hedge_ratio)
+    : percentile_(percentile),
+      initial_delay_(initial_delay),
+      budget_(max_hedge_ratio),
+      next_sample_(0),
+      samples_since_update_(0),
+      delay_(initial_delay) {}
+
+std::unique_ptr<HedgingPolicy> LatencyPercentileHedgingPolicy::clone() const {
+  return std::unique_ptr<HedgingPolicy>(new LatencyPercentileHedgingPolicy(
+      percentile_, initial_delay_, budget_.max_hedge_ratio()));
+}
+
+std::chrono::microseconds LatencyPercentileHedgingPolicy::OnRequest() {
+  budget_.OnRequest();
+  std::lock_guard<std::mutex> lk(mu_);
+  return delay_;
+}
+
+bool LatencyPercentileHedgingPolicy::OnHedge() { return budget_.TryHedge(); }
+
+void LatencyPercentileHedgingPolicy::OnSuccess(
+    std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (samples_.size() < kLatencySamples) {
+    samples_.push_back(latency);
+  } else {
+    samples_[next_sample_] = latency;
+    next_sample_ = (next_sample_ + 1) % kLatencySamples;
+  }
+  // Sorting the samples on every request would be too expensive, the
+  // percentile changes slowly anyway.
+  if (++samples_since_update_ < kLatencyUpdatePeriod) {
+    return;
+  }
+  samples_since_update_ = 0;
+  auto sorted = samples_;
+  auto index = static_cast<std::size_t>(percentile_ * (sorted.size() - 1));
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  delay_ = sorted[index];
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,138 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Define the interface for hedging point reads.
+ *
+ * A hedged `Table::ReadRow()` sends a second request if the first one does
+ * not complete within a delay, uses the response that arrives first, and
+ * cancels the other request.  The policy decides how long to wait, and limits
+ * how many requests are hedged, so hedging cannot double the load on the
+ * service.
+ *
+ * The application provides an instance of this class to
+ * `Table::set_hedging_policy()`.  This instance serves as a prototype, the
+ * table creates its own copy using `clone()`.  The copy is shared by all the
+ * operations (and all the copies) of the table, so the implementations must
+ * be thread-safe.
+ */
+class HedgingPolicy {
+ public:
+  virtual ~HedgingPolicy() = default;
+
+  /// Return a new copy of this object, with its initial state.
+  virtual std::unique_ptr<HedgingPolicy> clone() const = 0;
+
+  /// Start a new request, return how long to wait before hedging it.
+  virtual std::chrono::microseconds OnRequest() = 0;
+
+  /// Return true if the current request can be hedged.
+  virtual bool OnHedge() = 0;
+
+  /// Record the latency of a successful request, hedged or not.
+  virtual void OnSuccess(std::chrono::microseconds latency) = 0;
+};
+
+/**
+ * Limit the fraction of the requests that are hedged.
+ *
+ * Each request adds @p max_hedge_ratio tokens to a bucket, and each hedge
+ * consumes one.  The bucket holds a few tokens, so short bursts of slow
+ * requests are all hedged, but on average no more than @p max_hedge_ratio of
+ * the requests are.
+ */
+class HedgeBudget {
+ public:
+  explicit HedgeBudget(double max_hedge_ratio);
+
+  double max_hedge_ratio() const { return max_hedge_ratio_; }
+
+  /// Add the tokens for a new request.
+  void OnRequest();
+
+  /// Consume a token, return false if there are none.
+  bool TryHedge();
+
+ private:
+  std::mutex mu_;
+  double const max_hedge_ratio_;
+  double tokens_;
+};
+
+/// Hedge the requests that take longer than a fixed delay.
+class FixedDelayHedgingPolicy : public HedgingPolicy {
+ public:
+  explicit FixedDelayHedgingPolicy(std::chrono::microseconds delay,
+                                   double max_hedge_ratio = 0.05);
+
+  std::unique_ptr<HedgingPolicy> clone() const override;
+  std::chrono::microseconds OnRequest() override;
+  bool OnHedge() override;
+  void OnSuccess(std::chrono::microseconds) override {}
+
+ private:
+  std::chrono::microseconds const delay_;
+  HedgeBudget budget_;
+};
+
+/**
+ * Hedge the requests that take longer than a percentile of the recent ones.
+ *
+ * The policy keeps the latency of the last few hundred successful requests,
+ * and waits for the @p percentile of those latencies before hedging.  The
+ * @p initial_delay is used until enough latencies are available.
+ */
+class LatencyPercentileHedgingPolicy : public HedgingPolicy {
+ public:
+  explicit LatencyPercentileHedgingPolicy(
+      double percentile = 0.95,
+      std::chrono::microseconds initial_delay = std::chrono::milliseconds(10),
+      double max_hedge_ratio = 0.05);
+
+  std::unique_ptr<HedgingPolicy> clone() const override;
+  std::chrono::microseconds OnRequest() override;
+  bool OnHedge() override;
+  void OnSuccess(std::chrono::microseconds latency) override;
+
+ private:
+  double const percentile_;
+  std::chrono::microseconds const initial_delay_;
+  HedgeBudget budget_;
+
+  std::mutex mu_;
+  std::vector<std::chrono::microseconds> samples_;
+  std::size_t next_sample_;
+  std::size_t samples_since_update_;
+  std::chrono::microseconds delay_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
@@ -0,0 +1,93 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/hedging_policy.h"
+#include <gmock/gmock.h>
+
+namespace bigtable = google::cloud::bigtable;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+/// @test Verify that the budget limits the fraction of hedged requests.
+TEST(HedgingPolicyTest, BudgetLimitsHedgeRatio) {
+  bigtable::FixedDelayHedgingPolicy policy(milliseconds(5), 0.25);
+  int hedges = 0;
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_EQ(milliseconds(5), policy.OnRequest());
+    if (policy.OnHedge()) {
+      ++hedges;
+    }
+  }
+  EXPECT_EQ(25, hedges);
+}
+
+/// @test Verify that unused budget accumulates, but only up to a limit.
+TEST(HedgingPolicyTest, BudgetAllowsShortBursts) {
+  bigtable::FixedDelayHedgingPolicy policy(milliseconds(5), 0.5);
+  for (int i = 0; i != 1000; ++i) {
+    policy.OnRequest();
+  }
+  int hedges = 0;
+  while (policy.OnHedge()) {
+    ++hedges;
+  }
+  EXPECT_EQ(10, hedges);
+}
+
+/// @test Verify that a zero ratio disables hedging.
+TEST(HedgingPolicyTest, ZeroRatioNeverHedges) {
+  bigtable::FixedDelayHedgingPolicy policy(milliseconds(5), 0.0);
+  for (int i = 0; i != 100; ++i) {
+    policy.OnRequest();
+    EXPECT_FALSE(policy.OnHedge());
+  }
+}
+
+/// @test Verify that clone() returns a policy in its initial state.
+TEST(HedgingPolicyTest, CloneResetsBudget) {
+  bigtable::FixedDelayHedgingPolicy policy(milliseconds(5), 1.0);
+  policy.OnRequest();
+  auto clone = policy.clone();
+  EXPECT_FALSE(clone->OnHedge());
+  EXPECT_EQ(milliseconds(5), clone->OnRequest());
+  EXPECT_TRUE(clone->OnHedge());
+  EXPECT_TRUE(policy.OnHedge());
+}
+
+/// @test Verify that the percentile policy starts with the initial delay.
+TEST(HedgingPolicyTest, PercentileInitialDelay) {
+  bigtable::LatencyPercentileHedgingPolicy policy(0.9, milliseconds(7));
+  EXPECT_EQ(milliseconds(7), policy.OnRequest());
+  for (int i = 0; i != 10; ++i) {
+    policy.OnSuccess(microseconds(100));
+  }
+  EXPECT_EQ(milliseconds(7), policy.OnRequest());
+}
+
+/// @test Verify that the percentile policy tracks the observed latencies.
+TEST(HedgingPolicyTest, PercentileTracksLatency) {
+  bigtable::LatencyPercentileHedgingPolicy policy(0.9, milliseconds(7));
+  for (int i = 0; i != 500; ++i) {
+    policy.OnSuccess(microseconds(i % 100));
+  }
+  auto delay = policy.OnRequest();
+  EXPECT_LE(microseconds(85), delay);
+  EXPECT_GE(microseconds(95), delay);
+
+  // The old latencies are forgotten.
+  for (int i = 0; i != 1000; ++i) {
+    policy.OnSuccess(microseconds(1000));
+  }
+  EXPECT_EQ(microseconds(1000), policy.OnRequest());
+}
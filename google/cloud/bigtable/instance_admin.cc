@@ -14,6 +14,7 @@
 
 #include "google/cloud/bigtable/instance_admin.h"
 #include "google/cloud/bigtable/internal/grpc_error_delegate.h"
+#include "google/cloud/bigtable/internal/rpc_metrics.h"
 #include "google/cloud/bigtable/internal/unary_client_utils.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include <google/longrunning/operations.grpc.pb.h>
@@ -29,6 +30,26 @@ inline namespace BIGTABLE_CLIENT_NS {
 static_assert(std::is_copy_assignable<bigtable::InstanceAdmin>::value,
               "bigtable::InstanceAdmin must be CopyAssignable");
 
+namespace {
+/// The metrics for polling long running operations, `bigtable.GetOperation`.
+google::cloud::internal::OperationMetrics& PollingMetrics() {
+  return bigtable::internal::RpcMetrics<
+      google::longrunning::GetOperationRequest>();
+}
+
+/// Poll @p operation once, replacing it with its current state.
+grpc::Status PollOperation(InstanceAdminClient& client,
+                           google::longrunning::Operation& operation) {
+  auto& metrics = PollingMetrics();
+  metrics.attempts.Increment();
+  google::longrunning::GetOperationRequest request;
+  request.set_name(operation.name());
+  grpc::ClientContext context;
+  google::cloud::internal::LatencyTimer timer(metrics.attempt_latency);
+  return client.GetOperation(&context, request, &operation);
+}
+}  // anonymous namespace
+
 std::vector<btproto::Instance> InstanceAdmin::ListInstances() {
   grpc::Status status;
   auto result = impl_.ListInstances(status);
@@ -79,6 +100,10 @@ google::bigtable::admin::v2::Instance InstanceAdmin::CreateInstanceImpl(
   }
 
   google::bigtable::admin::v2::Instance result;
+  // The operation is recorded from the first poll until it completes.
+  auto& metrics = PollingMetrics();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
   do {
     if (response.done()) {
       if (response.has_response()) {
@@ -90,6 +115,7 @@ google::bigtable::admin::v2::Instance InstanceAdmin::CreateInstanceImpl(
         return result;
       }
       if (response.has_error()) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             grpc::Status(static_cast<grpc::StatusCode>(response.error().code()),
                          response.error().message()),
@@ -100,17 +126,16 @@ google::bigtable::admin::v2::Instance InstanceAdmin::CreateInstanceImpl(
     // "response.
     auto delay = backoff_policy->OnCompletion(status);
     std::this_thread::sleep_for(delay);
-    google::longrunning::GetOperationRequest op;
-    op.set_name(response.name());
-    grpc::ClientContext context;
-    status = impl_.client_->GetOperation(&context, op, &response);
+    status = PollOperation(*impl_.client_, response);
     if (not status.ok()) {
       if (not rpc_policy->OnFailure(status)) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             status,
             "unrecoverable error polling longrunning Operation in "
             "CreateInstance()");
       }
+      metrics.retries.Increment();
     }
   } while (true);
   return result;
@@ -147,6 +172,10 @@ google::bigtable::admin::v2::Instance InstanceAdmin::UpdateInstanceImpl(
   }
 
   google::bigtable::admin::v2::Instance result;
+  // The operation is recorded from the first poll until it completes.
+  auto& metrics = PollingMetrics();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
   do {
     if (response.done()) {
       if (response.has_response()) {
@@ -158,6 +187,7 @@ google::bigtable::admin::v2::Instance InstanceAdmin::UpdateInstanceImpl(
         return result;
       }
       if (response.has_error()) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             grpc::Status(static_cast<grpc::StatusCode>(response.error().code()),
                          response.error().message()),
@@ -169,17 +199,16 @@ google::bigtable::admin::v2::Instance InstanceAdmin::UpdateInstanceImpl(
     // TODO(#578) here to use the PollingPolicy once #461 is merged.
     auto delay = backoff_policy->OnCompletion(status);
     std::this_thread::sleep_for(delay);
-    google::longrunning::GetOperationRequest op;
-    op.set_name(response.name());
-    grpc::ClientContext context;
-    status = impl_.client_->GetOperation(&context, op, &response);
+    status = PollOperation(*impl_.client_, response);
     if (not status.ok()) {
       if (not rpc_policy->OnFailure(status)) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             status,
             "unrecoverable error polling longrunning Operation in "
             "UpdateInstance()");
       }
+      metrics.retries.Increment();
     }
   } while (true);
   return result;
@@ -258,6 +287,10 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::UpdateClusterImpl(
   }
 
   google::bigtable::admin::v2::Cluster result;
+  // The operation is recorded from the first poll until it completes.
+  auto& metrics = PollingMetrics();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
   do {
     if (response.done()) {
       if (response.has_response()) {
@@ -269,6 +302,7 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::UpdateClusterImpl(
         return result;
       }
       if (response.has_error()) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             grpc::Status(static_cast<grpc::StatusCode>(response.error().code()),
                          response.error().message()),
@@ -280,17 +314,16 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::UpdateClusterImpl(
     // TODO(#578) here to use the PollingPolicy once #461 is merged.
     auto delay = backoff_policy->OnCompletion(status);
     std::this_thread::sleep_for(delay);
-    google::longrunning::GetOperationRequest op;
-    op.set_name(response.name());
-    grpc::ClientContext context;
-    status = impl_.client_->GetOperation(&context, op, &response);
+    status = PollOperation(*impl_.client_, response);
     if (not status.ok()) {
       if (not rpc_policy->OnFailure(status)) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             status,
             "unrecoverable error polling longrunning Operation in "
             "UpdateInstance()");
       }
+      metrics.retries.Increment();
     }
   } while (true);
   return result;
@@ -336,6 +369,10 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::CreateClusterImpl(
 
   google::bigtable::admin::v2::Cluster result;
 
+  // The operation is recorded from the first poll until it completes.
+  auto& metrics = PollingMetrics();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
   do {
     if (response.done()) {
       if (response.has_response()) {
@@ -347,6 +384,7 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::CreateClusterImpl(
         return result;
       }
       if (response.has_error()) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             grpc::Status(static_cast<grpc::StatusCode>(response.error().code()),
                          response.error().message()),
@@ -358,17 +396,16 @@ google::bigtable::admin::v2::Cluster InstanceAdmin::CreateClusterImpl(
     // TODO(#422) we should use the PollingPolicy here once #461 is merged.
     auto delay = backoff_policy->OnCompletion(status);
     std::this_thread::sleep_for(delay);
-    google::longrunning::GetOperationRequest op;
-    op.set_name(response.name());
-    grpc::ClientContext context;
-    status = impl_.client_->GetOperation(&context, op, &response);
+    status = PollOperation(*impl_.client_, response);
     if (not status.ok()) {
       if (not rpc_policy->OnFailure(status)) {
+        metrics.errors.Increment();
         bigtable::internal::RaiseRpcError(
             status,
             "unrecoverable error polling longrunning Operation in "
             "CreateCluster()");
       }
+      metrics.retries.Increment();
     }
   } while (true);
   return result;
@@ -16,6 +16,7 @@
 #include "google/cloud/bigtable/grpc_error.h"
 #include "google/cloud/bigtable/internal/make_unique.h"
 #include "google/cloud/bigtable/testing/mock_instance_admin_client.h"
+#include "google/cloud/metrics.h"
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gmock/gmock.h>
@@ -417,6 +418,50 @@ TEST_F(InstanceAdminTest, CreateInstancePollRecoverableFailures) {
   EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
 }
 
+/// @test Verify that polling the long running operation records metrics.
+TEST_F(InstanceAdminTest, CreateInstancePollMetrics) {
+  using ::testing::_;
+  using ::testing::Invoke;
+  using ::testing::Return;
+
+  bigtable::InstanceAdmin tested(client_);
+  EXPECT_CALL(*client_, CreateInstance(_, _, _))
+      .WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, GetOperation(_, _, _))
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          google::longrunning::GetOperationRequest const&,
+                          google::longrunning::Operation* operation) {
+        operation->set_done(true);
+        auto any = bigtable::internal::make_unique<google::protobuf::Any>();
+        any->PackFrom(btproto::Instance());
+        operation->set_allocated_response(any.release());
+        return grpc::Status::OK;
+      }));
+
+  auto& registry = google::cloud::DefaultMetricsRegistry();
+  auto before = registry.Snapshot();
+  auto future = tested.CreateInstance(bigtable::InstanceConfig(
+      bigtable::InstanceId("test-instance"), bigtable::DisplayName("foo bar"),
+      {{"c1", {"a-zone", 3, bigtable::ClusterConfig::SSD}}}));
+  future.get();
+  auto after = registry.Snapshot();
+
+  auto delta = [&before, &after](std::string const& name) {
+    return after.counters[name] - before.counters[name];
+  };
+  EXPECT_EQ(1U, delta("bigtable.GetOperation.operations"));
+  EXPECT_EQ(2U, delta("bigtable.GetOperation.attempts"));
+  EXPECT_EQ(1U, delta("bigtable.GetOperation.retries"));
+  EXPECT_EQ(0U, delta("bigtable.GetOperation.errors"));
+  EXPECT_EQ(1U, after.histograms["bigtable.GetOperation.latency"].count -
+                    before.histograms["bigtable.GetOperation.latency"].count);
+  EXPECT_EQ(
+      2U, after.histograms["bigtable.GetOperation.attempt_latency"].count -
+              before.histograms["bigtable.GetOperation.attempt_latency"].count);
+}
+
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 /// @test Failures in `bigtable::InstanceAdmin::CreateInstance`.
 TEST_F(InstanceAdminTest, CreateInstanceRequestFailure) {
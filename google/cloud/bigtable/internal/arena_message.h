@@ -0,0 +1,63 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ARENA_MESSAGE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ARENA_MESSAGE_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <google/protobuf/arena.h>
+#include <google/protobuf/message_lite.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Deletes protobuf messages allocated on the heap, ignores those on an arena.
+ *
+ * Messages allocated on a `google::protobuf::Arena` are released, all at
+ * once, when the arena is destroyed.
+ */
+struct ArenaAwareDelete {
+  void operator()(google::protobuf::MessageLite* message) const {
+    if (message != nullptr and message->GetArena() == nullptr) {
+      delete message;
+    }
+  }
+};
+
+/// A smart pointer for messages that may be allocated on an arena.
+template <typename Message>
+using ArenaMessagePtr = std::unique_ptr<Message, ArenaAwareDelete>;
+
+/**
+ * Create a protobuf message on @p arena, or on the heap if @p arena is null.
+ *
+ * The arena, if any, must outlive the returned pointer.
+ */
+template <typename Message>
+ArenaMessagePtr<Message> MakeArenaMessage(google::protobuf::Arena* arena) {
+  return ArenaMessagePtr<Message>(
+      google::protobuf::Arena::CreateMessage<Message>(arena));
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ARENA_MESSAGE_H_
@@ -0,0 +1,184 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/async_bulk_apply.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/internal/retry_budget.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace btproto = google::bigtable::v2;
+
+AsyncRetryBulkApply::AsyncRetryBulkApply(
+    std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+    std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+    IdempotentMutationPolicy& idempotent_policy,
+    MetadataUpdatePolicy metadata_update_policy,
+    std::shared_ptr<DataClient> client,
+    bigtable::AppProfileId const& app_profile_id,
+    bigtable::TableId const& table_name, BulkMutation&& mut, Callback callback)
+    : rpc_retry_policy_(std::move(rpc_retry_policy)),
+      rpc_backoff_policy_(std::move(rpc_backoff_policy)),
+      metadata_update_policy_(std::move(metadata_update_policy)),
+      client_(std::move(client)),
+      mutator_(app_profile_id, table_name, idempotent_policy,
+               std::forward<BulkMutation>(mut)),
+      callback_(std::move(callback)),
+      mutation_count_(0),
+      overloaded_(false) {}
+
+std::shared_ptr<AsyncOperation> AsyncRetryBulkApply::Start(
+    CompletionQueue& cq) {
+  StartIteration(cq);
+  return shared_from_this();
+}
+
+void AsyncRetryBulkApply::StartIteration(CompletionQueue& cq) {
+  if (not mutator_.HasPendingMutations()) {
+    Finish(cq, grpc::Status::OK);
+    return;
+  }
+  // Wait until the (shared) rate limiter admits these mutations, without
+  // blocking the completion queue thread.
+  limiter_ = client_->mutation_rate_limiter();
+  if (limiter_) {
+    mutation_count_ = mutator_.PendingMutationCount();
+    auto delay =
+        limiter_->Reserve(mutation_count_, MutationRateLimiter::Clock::now());
+    if (delay.count() > 0) {
+      auto self = shared_from_this();
+      auto step = NextStep();
+      auto op = cq.MakeRelativeTimer(
+          delay, [self](CompletionQueue& cq, AsyncTimerResult&, bool ok) {
+            self->OnAdmitted(cq, ok);
+          });
+      TrackStep(step, std::move(op));
+      return;
+    }
+  }
+  StartRequest(cq);
+}
+
+void AsyncRetryBulkApply::OnAdmitted(CompletionQueue& cq, bool ok) {
+  if (not ok or cancelled()) {
+    Finish(cq, grpc::Status(grpc::StatusCode::CANCELLED,
+                            "pending operation cancelled"));
+    return;
+  }
+  StartRequest(cq);
+}
+
+void AsyncRetryBulkApply::StartRequest(CompletionQueue& cq) {
+  overloaded_ = false;
+  attempt_start_ = MutationRateLimiter::Clock::now();
+  auto context = bigtable::internal::make_unique<grpc::ClientContext>();
+  rpc_retry_policy_->Setup(*context);
+  rpc_backoff_policy_->Setup(*context);
+  metadata_update_policy_.Setup(*context);
+
+  auto self = shared_from_this();
+  auto step = NextStep();
+  auto op = cq.MakeStreamingReadRpc(
+      *client_, &DataClient::PrepareAsyncMutateRows,
+      mutator_.PrepareForRequest(), std::move(context),
+      [self](CompletionQueue&, grpc::ClientContext&,
+             btproto::MutateRowsResponse& response) {
+        for (auto const& entry : response.entries()) {
+          self->overloaded_ =
+              self->overloaded_ or
+              MutationRateLimiter::IsOverload(
+                  static_cast<grpc::StatusCode>(entry.status().code()));
+        }
+        self->mutator_.ProcessResponse(response);
+      },
+      [self](CompletionQueue& cq, grpc::ClientContext&, grpc::Status& status) {
+        self->OnFinish(cq, status);
+      });
+  TrackStep(step, std::move(op));
+}
+
+void AsyncRetryBulkApply::OnFinish(CompletionQueue& cq, grpc::Status& status) {
+  mutator_.FinishRequest();
+  if (limiter_) {
+    auto const now = MutationRateLimiter::Clock::now();
+    if (overloaded_ or MutationRateLimiter::IsOverload(status.error_code())) {
+      limiter_->OnOverload(now);
+    } else if (status.ok()) {
+      limiter_->OnSuccess(
+          mutation_count_,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              now - attempt_start_),
+          now);
+    }
+  }
+  if (status.ok()) {
+    google::cloud::internal::DefaultRetryBudget().OnSuccess();
+  }
+  if (not status.ok() and
+      (cancelled() or not rpc_retry_policy_->OnFailure(status))) {
+    Finish(cq, status);
+    return;
+  }
+  if (not mutator_.HasPendingMutations()) {
+    Finish(cq, status);
+    return;
+  }
+  if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+    std::string message = google::cloud::internal::kRetryBudgetExhausted;
+    message += " in Table::AsyncBulkApply()";
+    if (not status.ok()) {
+      message += ": " + status.error_message();
+    }
+    Finish(cq, grpc::Status(status.ok() ? grpc::StatusCode::INTERNAL
+                                        : status.error_code(),
+                            std::move(message)));
+    return;
+  }
+  auto delay = rpc_backoff_policy_->OnCompletion(status);
+  auto self = shared_from_this();
+  auto step = NextStep();
+  auto op = cq.MakeRelativeTimer(
+      delay, [self](CompletionQueue& cq, AsyncTimerResult&, bool ok) {
+        self->OnTimer(cq, ok);
+      });
+  TrackStep(step, std::move(op));
+}
+
+void AsyncRetryBulkApply::OnTimer(CompletionQueue& cq, bool ok) {
+  if (not ok or cancelled()) {
+    Finish(cq, grpc::Status(grpc::StatusCode::CANCELLED,
+                            "pending operation cancelled"));
+    return;
+  }
+  StartIteration(cq);
+}
+
+void AsyncRetryBulkApply::Finish(CompletionQueue& cq, grpc::Status status) {
+  auto failures = mutator_.ExtractFinalFailures();
+  if (status.ok() and not failures.empty()) {
+    status = grpc::Status(
+        grpc::StatusCode::INTERNAL,
+        "Permanent (or too many transient) errors in Table::AsyncBulkApply()");
+  }
+  callback_(cq, failures, status);
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,92 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_BULK_APPLY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_BULK_APPLY_H_
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/data_client.h"
+#include "google/cloud/bigtable/internal/async_retry_operation.h"
+#include "google/cloud/bigtable/internal/bulk_mutator.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Keep the state for `noex::Table::AsyncBulkApply()`.
+ *
+ * This is the asynchronous analogue of the loop in `noex::Table::BulkApply()`:
+ * each attempt sends the pending mutations using a `MutateRows` streaming RPC,
+ * the responses are processed as they arrive, and any mutations that failed
+ * with transient errors are retried after a backoff timer in the completion
+ * queue expires.  If the client has a `MutationRateLimiter` each attempt waits
+ * (using a timer in the completion queue) until the limiter admits its
+ * mutations, and reports back its latency or any overload errors.
+ */
+class AsyncRetryBulkApply
+    : public AsyncRetryOperation,
+      public std::enable_shared_from_this<AsyncRetryBulkApply> {
+ public:
+  using Callback = std::function<void(
+      CompletionQueue&, std::vector<FailedMutation>&, grpc::Status&)>;
+
+  AsyncRetryBulkApply(std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+                      std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+                      IdempotentMutationPolicy& idempotent_policy,
+                      MetadataUpdatePolicy metadata_update_policy,
+                      std::shared_ptr<DataClient> client,
+                      bigtable::AppProfileId const& app_profile_id,
+                      bigtable::TableId const& table_name, BulkMutation&& mut,
+                      Callback callback);
+
+  /// Start the first attempt, return a handle to cancel the operation.
+  std::shared_ptr<AsyncOperation> Start(CompletionQueue& cq);
+
+ private:
+  void StartIteration(CompletionQueue& cq);
+  void OnAdmitted(CompletionQueue& cq, bool ok);
+  void StartRequest(CompletionQueue& cq);
+  void OnFinish(CompletionQueue& cq, grpc::Status& status);
+  void OnTimer(CompletionQueue& cq, bool ok);
+  void Finish(CompletionQueue& cq, grpc::Status status);
+
+  std::unique_ptr<RPCRetryPolicy> rpc_retry_policy_;
+  std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
+  MetadataUpdatePolicy metadata_update_policy_;
+  std::shared_ptr<DataClient> client_;
+  BulkMutator mutator_;
+  Callback callback_;
+
+  //@{
+  /// @name The throttling state for the current attempt.
+  std::shared_ptr<MutationRateLimiter> limiter_;
+  std::size_t mutation_count_;
+  MutationRateLimiter::Clock::time_point attempt_start_;
+  bool overloaded_;
+  //@}
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_BULK_APPLY_H_
@@ -0,0 +1,64 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/async_retry_operation.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+void AsyncRetryOperation::Cancel() {
+  std::shared_ptr<AsyncOperation> current;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    cancelled_ = true;
+    current = current_;
+  }
+  if (current) {
+    current->Cancel();
+  }
+}
+
+bool AsyncRetryOperation::cancelled() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return cancelled_;
+}
+
+std::uint64_t AsyncRetryOperation::NextStep() {
+  std::lock_guard<std::mutex> lk(mu_);
+  current_.reset();
+  return ++step_;
+}
+
+void AsyncRetryOperation::TrackStep(std::uint64_t step,
+                                    std::shared_ptr<AsyncOperation> op) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (step != step_) {
+    // The step completed, and the operation moved on, before we got here.
+    return;
+  }
+  current_ = op;
+  bool const cancelled = cancelled_;
+  lk.unlock();
+  if (cancelled) {
+    op->Cancel();
+  }
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,71 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_OPERATION_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_OPERATION_H_
+
+#include "google/cloud/bigtable/async_operation.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Keep track of the current step in a multi-step asynchronous operation.
+ *
+ * Asynchronous operations with retries are a sequence of steps: an RPC, a
+ * backoff timer, another RPC, and so forth. Each step is started from the
+ * callback of the previous step, possibly in a different thread than the one
+ * that started the previous step. This class keeps track of the current step,
+ * so the application can cancel the operation at any point.
+ *
+ * Derived classes must call `NextStep()` before starting a new step, and then
+ * `TrackStep()` with the value returned by `NextStep()` and the new step. If
+ * the step completes (and starts another step) before `TrackStep()` is called
+ * the stale step is ignored.
+ */
+class AsyncRetryOperation : public AsyncOperation {
+ public:
+  AsyncRetryOperation() : cancelled_(false), step_(0) {}
+
+  void Cancel() override;
+
+ protected:
+  /// Return true if the application cancelled the operation.
+  bool cancelled() const;
+
+  /// Prepare to start a new step, return its identifier.
+  std::uint64_t NextStep();
+
+  /// Keep track of the operation for @p step, cancel it if needed.
+  void TrackStep(std::uint64_t step, std::shared_ptr<AsyncOperation> op);
+
+ private:
+  mutable std::mutex mu_;
+  bool cancelled_;
+  std::uint64_t step_;
+  std::shared_ptr<AsyncOperation> current_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_OPERATION_H_
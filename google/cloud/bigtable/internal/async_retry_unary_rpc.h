@@ -0,0 +1,182 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_UNARY_RPC_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_UNARY_RPC_H_
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/internal/async_retry_operation.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/internal/retry_budget.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Make an asynchronous unary RPC with retries.
+ *
+ * This is the asynchronous analogue of `UnaryClientUtils::MakeCall()`: the RPC
+ * is retried until it succeeds, or until the policies in effect tell us to
+ * stop. Instead of blocking a thread while waiting for the backoff period, the
+ * class schedules a timer in the completion queue, and starts the next attempt
+ * from the timer callback.
+ *
+ * @tparam Client the type of the object holding the asynchronous RPC wrappers,
+ *     typically `bigtable::DataClient`.
+ * @tparam Request the request type for the RPC.
+ * @tparam Response the response type for the RPC.
+ */
+template <typename Client, typename Request, typename Response>
+class AsyncRetryUnaryRpc
+    : public AsyncRetryOperation,
+      public std::enable_shared_from_this<
+          AsyncRetryUnaryRpc<Client, Request, Response>> {
+ public:
+  using MemberFunction = std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<Response>> (Client::*)(
+      grpc::ClientContext*, Request const&, grpc::CompletionQueue*);
+  using Callback =
+      std::function<void(CompletionQueue&, Response&, grpc::Status&)>;
+
+  /**
+   * Create the operation, call `Start()` to initiate it.
+   *
+   * @param error_message include this message in the status reported on
+   *     permanent errors.
+   * @param rpc_retry_policy controls the number of retries and their duration.
+   * @param rpc_backoff_policy controls the delay between retries.
+   * @param is_idempotent if false the RPC is not retried.
+   * @param metadata_update_policy to keep metadata like
+   *     x-goog-request-params.
+   * @param client the object that holds the asynchronous RPC wrappers.
+   * @param call the pointer to the member function to call.
+   * @param request an initialized request parameter for the RPC.
+   * @param callback called once the operation completes.
+   */
+  AsyncRetryUnaryRpc(char const* error_message,
+                     std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+                     std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+                     bool is_idempotent,
+                     MetadataUpdatePolicy metadata_update_policy,
+                     std::shared_ptr<Client> client, MemberFunction call,
+                     Request&& request, Callback callback)
+      : error_message_(error_message),
+        rpc_retry_policy_(std::move(rpc_retry_policy)),
+        rpc_backoff_policy_(std::move(rpc_backoff_policy)),
+        is_idempotent_(is_idempotent),
+        metadata_update_policy_(std::move(metadata_update_policy)),
+        client_(std::move(client)),
+        call_(call),
+        request_(std::move(request)),
+        callback_(std::move(callback)) {}
+
+  /// Start the first attempt, return a handle to cancel the operation.
+  std::shared_ptr<AsyncOperation> Start(CompletionQueue& cq) {
+    StartIteration(cq);
+    return this->shared_from_this();
+  }
+
+ private:
+  void StartIteration(CompletionQueue& cq) {
+    auto context = bigtable::internal::make_unique<grpc::ClientContext>();
+    rpc_retry_policy_->Setup(*context);
+    rpc_backoff_policy_->Setup(*context);
+    metadata_update_policy_.Setup(*context);
+
+    auto self = this->shared_from_this();
+    auto step = NextStep();
+    auto op = cq.MakeUnaryRpc(
+        *client_, call_, request_, std::move(context),
+        [self](CompletionQueue& cq, grpc::ClientContext&, Response& response,
+               grpc::Status& status) {
+          self->OnCompletion(cq, response, status);
+        });
+    TrackStep(step, std::move(op));
+  }
+
+  void OnCompletion(CompletionQueue& cq, Response& response,
+                    grpc::Status& status) {
+    if (status.ok()) {
+      google::cloud::internal::DefaultRetryBudget().OnSuccess();
+      callback_(cq, response, status);
+      return;
+    }
+    if (not is_idempotent_ or cancelled() or
+        not rpc_retry_policy_->OnFailure(status)) {
+      ReportError(cq, response, status);
+      return;
+    }
+    if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+      grpc::Status exhausted(
+          status.error_code(),
+          std::string(google::cloud::internal::kRetryBudgetExhausted) + ": " +
+              status.error_message(),
+          status.error_details());
+      ReportError(cq, response, exhausted);
+      return;
+    }
+    auto delay = rpc_backoff_policy_->OnCompletion(status);
+    auto self = this->shared_from_this();
+    auto step = NextStep();
+    auto op = cq.MakeRelativeTimer(
+        delay, [self](CompletionQueue& cq, AsyncTimerResult&, bool ok) {
+          self->OnTimer(cq, ok);
+        });
+    TrackStep(step, std::move(op));
+  }
+
+  void OnTimer(CompletionQueue& cq, bool ok) {
+    if (not ok or cancelled()) {
+      Response response;
+      grpc::Status status(grpc::StatusCode::CANCELLED,
+                          "pending operation cancelled");
+      ReportError(cq, response, status);
+      return;
+    }
+    StartIteration(cq);
+  }
+
+  void ReportError(CompletionQueue& cq, Response& response,
+                   grpc::Status const& status) {
+    std::string full_message = error_message_;
+    full_message += "(" + metadata_update_policy_.value() + ") ";
+    full_message += status.error_message();
+    grpc::Status result(status.error_code(), full_message,
+                        status.error_details());
+    callback_(cq, response, result);
+  }
+
+  char const* error_message_;
+  std::unique_ptr<RPCRetryPolicy> rpc_retry_policy_;
+  std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
+  bool is_idempotent_;
+  MetadataUpdatePolicy metadata_update_policy_;
+  std::shared_ptr<Client> client_;
+  MemberFunction call_;
+  Request request_;
+  Callback callback_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_RETRY_UNARY_RPC_H_
@@ -0,0 +1,179 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/async_row_reader.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/internal/retry_budget.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace btproto = google::bigtable::v2;
+
+// Defined here because it is odr-used.
+std::int64_t constexpr AsyncRowReader::NO_ROWS_LIMIT;
+
+AsyncRowReader::AsyncRowReader(
+    std::shared_ptr<DataClient> client, bigtable::AppProfileId app_profile_id,
+    bigtable::TableId table_name, RowSet row_set, std::int64_t rows_limit,
+    Filter filter, std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+    std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+    MetadataUpdatePolicy metadata_update_policy,
+    std::unique_ptr<ReadRowsParserFactory> parser_factory, RowCallback on_row,
+    FinishCallback on_finish)
+    : client_(std::move(client)),
+      app_profile_id_(std::move(app_profile_id)),
+      table_name_(std::move(table_name)),
+      row_set_(std::move(row_set)),
+      rows_limit_(rows_limit),
+      filter_(std::move(filter)),
+      rpc_retry_policy_(std::move(rpc_retry_policy)),
+      rpc_backoff_policy_(std::move(rpc_backoff_policy)),
+      metadata_update_policy_(std::move(metadata_update_policy)),
+      parser_factory_(std::move(parser_factory)),
+      on_row_(std::move(on_row)),
+      on_finish_(std::move(on_finish)),
+      rows_count_(0) {}
+
+std::shared_ptr<AsyncOperation> AsyncRowReader::Start(CompletionQueue& cq) {
+  StartIteration(cq);
+  return shared_from_this();
+}
+
+void AsyncRowReader::StartIteration(CompletionQueue& cq) {
+  btproto::ReadRowsRequest request;
+  bigtable::internal::SetCommonTableOperationRequest<btproto::ReadRowsRequest>(
+      request, app_profile_id_.get(), table_name_.get());
+  auto row_set_proto = row_set_.as_proto();
+  request.mutable_rows()->Swap(&row_set_proto);
+  auto filter_proto = filter_.as_proto();
+  request.mutable_filter()->Swap(&filter_proto);
+  if (rows_limit_ != NO_ROWS_LIMIT) {
+    request.set_rows_limit(rows_limit_ - rows_count_);
+  }
+
+  auto context = bigtable::internal::make_unique<grpc::ClientContext>();
+  rpc_retry_policy_->Setup(*context);
+  rpc_backoff_policy_->Setup(*context);
+  metadata_update_policy_.Setup(*context);
+
+  parser_ = parser_factory_->Create();
+  parser_status_ = grpc::Status::OK;
+
+  auto self = shared_from_this();
+  auto step = NextStep();
+  auto op = cq.MakeStreamingReadRpc(
+      *client_, &DataClient::PrepareAsyncReadRows, request, std::move(context),
+      [self](CompletionQueue& cq, grpc::ClientContext& context,
+             btproto::ReadRowsResponse& response) {
+        self->OnRead(cq, context, response);
+      },
+      [self](CompletionQueue& cq, grpc::ClientContext&, grpc::Status& status) {
+        self->OnFinish(cq, status);
+      });
+  TrackStep(step, std::move(op));
+}
+
+void AsyncRowReader::OnRead(CompletionQueue& cq, grpc::ClientContext& context,
+                            btproto::ReadRowsResponse& response) {
+  if (not parser_status_.ok()) {
+    // The stream is being cancelled, discard any remaining data.
+    return;
+  }
+  for (auto& chunk : *response.mutable_chunks()) {
+    parser_->HandleChunk(std::move(chunk), parser_status_);
+    while (parser_status_.ok() and parser_->HasNext()) {
+      Row row = parser_->Next(parser_status_);
+      if (not parser_status_.ok()) {
+        break;
+      }
+      ++rows_count_;
+      last_read_row_key_ = std::string(row.row_key());
+      on_row_(cq, std::move(row));
+    }
+    if (not parser_status_.ok()) {
+      context.TryCancel();
+      return;
+    }
+  }
+}
+
+void AsyncRowReader::OnFinish(CompletionQueue& cq, grpc::Status status) {
+  if (not parser_status_.ok()) {
+    status = parser_status_;
+  } else if (status.ok()) {
+    parser_->HandleEndOfStream(status);
+  }
+  if (status.ok()) {
+    google::cloud::internal::DefaultRetryBudget().OnSuccess();
+    on_finish_(cq, status);
+    return;
+  }
+
+  // In the unlikely case when we have already reached the requested number of
+  // rows and still receive an error (the parser can report an error at end of
+  // stream for example), there is no need to retry and we have no good value
+  // for rows_limit anyway.
+  if (rows_limit_ != NO_ROWS_LIMIT and rows_limit_ <= rows_count_) {
+    on_finish_(cq, status);
+    return;
+  }
+  if (not last_read_row_key_.empty()) {
+    // We've returned some rows and need to make sure we don't request them
+    // again.
+    row_set_ = row_set_.Intersect(RowRange::Open(last_read_row_key_, ""));
+  }
+  // If we receive an error, but the retriable set is empty, stop.
+  if (row_set_.IsEmpty() or cancelled() or
+      not rpc_retry_policy_->OnFailure(status)) {
+    on_finish_(cq, status);
+    return;
+  }
+  if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+    grpc::Status exhausted(
+        status.error_code(),
+        std::string(google::cloud::internal::kRetryBudgetExhausted) + ": " +
+            status.error_message());
+    on_finish_(cq, exhausted);
+    return;
+  }
+
+  auto delay = rpc_backoff_policy_->OnCompletion(status);
+  auto self = shared_from_this();
+  auto step = NextStep();
+  auto op = cq.MakeRelativeTimer(
+      delay, [self](CompletionQueue& cq, AsyncTimerResult&, bool ok) {
+        self->OnTimer(cq, ok);
+      });
+  TrackStep(step, std::move(op));
+}
+
+void AsyncRowReader::OnTimer(CompletionQueue& cq, bool ok) {
+  if (not ok or cancelled()) {
+    grpc::Status status(grpc::StatusCode::CANCELLED,
+                        "pending operation cancelled");
+    on_finish_(cq, status);
+    return;
+  }
+  StartIteration(cq);
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
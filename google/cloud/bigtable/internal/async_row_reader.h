@@ -0,0 +1,102 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_READER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_READER_H_
+
+#include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/data_client.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/internal/async_retry_operation.h"
+#include "google/cloud/bigtable/internal/readrowsparser.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/table_strong_types.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Keep the state for `noex::Table::AsyncReadRows()`.
+ *
+ * This is the asynchronous analogue of `bigtable::RowReader`: rows are parsed
+ * as the `ReadRows` responses arrive, and delivered to the application via a
+ * callback. If the stream fails with a transient error the read is resumed,
+ * after a backoff timer in the completion queue expires, starting after the
+ * last row delivered to the application.
+ */
+class AsyncRowReader : public AsyncRetryOperation,
+                       public std::enable_shared_from_this<AsyncRowReader> {
+ public:
+  /// A constant for the magic value that means "no limit, get all rows".
+  static std::int64_t constexpr NO_ROWS_LIMIT = 0;
+
+  using RowCallback = std::function<void(CompletionQueue&, Row)>;
+  using FinishCallback = std::function<void(CompletionQueue&, grpc::Status&)>;
+
+  AsyncRowReader(std::shared_ptr<DataClient> client,
+                 bigtable::AppProfileId app_profile_id,
+                 bigtable::TableId table_name, RowSet row_set,
+                 std::int64_t rows_limit, Filter filter,
+                 std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+                 std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+                 MetadataUpdatePolicy metadata_update_policy,
+                 std::unique_ptr<ReadRowsParserFactory> parser_factory,
+                 RowCallback on_row, FinishCallback on_finish);
+
+  /// Start the first attempt, return a handle to cancel the operation.
+  std::shared_ptr<AsyncOperation> Start(CompletionQueue& cq);
+
+ private:
+  void StartIteration(CompletionQueue& cq);
+  void OnRead(CompletionQueue& cq, grpc::ClientContext& context,
+              google::bigtable::v2::ReadRowsResponse& response);
+  void OnFinish(CompletionQueue& cq, grpc::Status status);
+  void OnTimer(CompletionQueue& cq, bool ok);
+
+  std::shared_ptr<DataClient> client_;
+  bigtable::AppProfileId app_profile_id_;
+  bigtable::TableId table_name_;
+  RowSet row_set_;
+  std::int64_t rows_limit_;
+  Filter filter_;
+  std::unique_ptr<RPCRetryPolicy> rpc_retry_policy_;
+  std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
+  MetadataUpdatePolicy metadata_update_policy_;
+  std::unique_ptr<ReadRowsParserFactory> parser_factory_;
+  RowCallback on_row_;
+  FinishCallback on_finish_;
+
+  std::unique_ptr<ReadRowsParser> parser_;
+  /// Any error reported by the parser in the current attempt.
+  grpc::Status parser_status_;
+  /// Number of rows delivered to the application so far.
+  std::int64_t rows_count_;
+  /// Holds the last read row key, for retries.
+  std::string last_read_row_key_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_READER_H_
@@ -13,10 +13,20 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/internal/bulk_mutator.h"
+#include "google/cloud/bigtable/internal/rpc_metrics.h"
 #include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/table_strong_types.h"
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/tracing.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
 #include <numeric>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -29,7 +39,16 @@ namespace btproto = google::bigtable::v2;
 BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
                          bigtable::TableId const& table_name,
                          IdempotentMutationPolicy& idempotent_policy,
-                         BulkMutation&& mut) {
+                         BulkMutation&& mut)
+    : BulkMutator(app_profile_id, table_name, idempotent_policy,
+                  std::move(mut), false) {}
+
+BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
+                         bigtable::TableId const& table_name,
+                         IdempotentMutationPolicy& idempotent_policy,
+                         BulkMutation&& mut, bool use_arena,
+                         int original_index_offset)
+    : arena_(use_arena ? new google::protobuf::Arena : nullptr) {
   // Every time the client library calls MakeOneRequest(), the data in the
   // "pending_*" variables initializes the next request.  So in the constructor
   // we start by putting the data on the "pending_*" variables.
@@ -44,7 +63,7 @@ BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
   // in the original sequence provided by the user.  So this vector maps from
   // the index in the current array to the index in the original array.
   pending_annotations_.reserve(pending_mutations_.entries_size());
-  int index = 0;
+  int index = original_index_offset;
   for (auto const& e : pending_mutations_.entries()) {
     // This is a giant && across all the mutations for each row.
     auto r = std::all_of(e.mutations().begin(), e.mutations().end(),
@@ -55,20 +74,382 @@ BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
   }
 }
 
+std::size_t BulkMutator::PendingMutationCount() const {
+  return std::accumulate(
+      pending_mutations_.entries().begin(), pending_mutations_.entries().end(),
+      std::size_t(0),
+      [](std::size_t a, btproto::MutateRowsRequest::Entry const& e) {
+        return a + e.mutations_size();
+      });
+}
+
 grpc::Status BulkMutator::MakeOneRequest(bigtable::DataClient& client,
                                          grpc::ClientContext& client_context) {
   PrepareForRequest();
+  auto& metrics = RpcMetrics<btproto::MutateRowsRequest>();
+  google::cloud::internal::LatencyTimer timer(metrics.attempt_latency);
+  metrics.attempts.Increment();
+  auto const request_bytes = mutations_.ByteSizeLong();
+  metrics.bytes_sent.Increment(request_bytes);
+  google::cloud::internal::Span span;
+  if (auto* parent = google::cloud::internal::CurrentSpan()) {
+    span = google::cloud::internal::Span("attempt", *parent);
+  }
+  span.SetAttribute("mutations",
+                    static_cast<std::int64_t>(mutations_.entries_size()));
+  span.SetAttribute("bytes_sent", static_cast<std::int64_t>(request_bytes));
+  google::cloud::internal::CurrentSpanScope scope(span);
   // Send the request to the server and read the resulting result stream.
   auto stream = client.MutateRows(&client_context, mutations_);
-  btproto::MutateRowsResponse response;
-  while (stream->Read(&response)) {
-    ProcessResponse(response);
+  {
+    // Each response has an entry (and a status) per mutation, on the arena
+    // they are all released at once when the arena is reset.
+    auto response = MakeArenaMessage<btproto::MutateRowsResponse>(arena_.get());
+    while (stream->Read(response.get())) {
+      ProcessResponse(*response);
+    }
+  }
+  if (arena_) {
+    arena_->Reset();
   }
   FinishRequest();
-  return stream->Finish();
+  auto status = stream->Finish();
+  span.SetStatus(status.error_code(), status.error_message());
+  return status;
+}
+
+constexpr int BulkMutator::kMaxStreams;
+
+namespace {
+/**
+ * Send the mutations that become ready within this period in the same stream.
+ *
+ * The backoff policies add jitter, without this window each failed mutation
+ * would be resent in its own stream.  The mutations may be resent this much
+ * earlier than their backoff policy requires.
+ */
+auto constexpr kRetryBatchWindow = std::chrono::milliseconds(5);
+}  // namespace
+
+/**
+ * Keep the state of `BulkMutator::Run()`.
+ *
+ * A fixed pool of workers, including the calling thread, wait until some
+ * mutations are ready to be sent, and then send all of them in a single
+ * stream.  The streams report failed mutations as they arrive, each failed
+ * mutation is queued with the time it should be sent again, as determined by
+ * its backoff policy.
+ */
+class BulkMutator::Pipeline {
+ public:
+  Pipeline(BulkMutator& mutator, bigtable::DataClient& client,
+           RPCRetryPolicy const& retry_policy,
+           RPCBackoffPolicy const& backoff_policy,
+           MetadataUpdatePolicy const& metadata_update_policy)
+      : mutator_(mutator),
+        client_(client),
+        retry_policy_(retry_policy),
+        backoff_policy_(backoff_policy),
+        metadata_update_policy_(metadata_update_policy),
+        parent_span_(google::cloud::internal::CurrentSpan()) {}
+
+  grpc::Status Run();
+
+ private:
+  /// A mutation waiting to be sent, or in flight.
+  struct PendingEntry {
+    btproto::MutateRowsRequest::Entry entry;
+    Annotations annotation;
+    /// The policies for this mutation, created on its first failure.
+    std::unique_ptr<RPCRetryPolicy> retry_policy;
+    std::unique_ptr<RPCBackoffPolicy> backoff_policy;
+    std::chrono::steady_clock::time_point ready_at;
+    /// The last error for this mutation.
+    grpc::Status last_status;
+  };
+
+  /// Send the mutations as they become ready, until all of them are done.
+  void Worker();
+
+  /// Send @p batch in a single stream, called without holding `mu_`.
+  void RunStream(std::vector<PendingEntry> batch, std::int64_t attempt);
+
+  /// Start a child of the operation span, if there is one.
+  google::cloud::internal::Span ChildSpan(char const* name) const {
+    if (parent_span_ == nullptr) {
+      return google::cloud::internal::Span();
+    }
+    return google::cloud::internal::Span(name, *parent_span_);
+  }
+
+  /// Retry @p pending after its backoff period, or give up on it.
+  void OnFailure(PendingEntry pending, grpc::Status const& status);
+
+  /// Report @p pending as a permanent failure.
+  void GiveUp(PendingEntry pending, google::rpc::Status status);
+
+  BulkMutator& mutator_;
+  bigtable::DataClient& client_;
+  RPCRetryPolicy const& retry_policy_;
+  RPCBackoffPolicy const& backoff_policy_;
+  MetadataUpdatePolicy const& metadata_update_policy_;
+  /// The span for the operation, the streams run in other threads.
+  google::cloud::internal::Span const* parent_span_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<PendingEntry> queue_;
+  int in_flight_ = 0;
+  std::int64_t attempt_ = 0;
+  grpc::Status status_;
+};
+
+grpc::Status BulkMutator::Pipeline::Run() {
+  auto const start = std::chrono::steady_clock::now();
+  queue_.reserve(mutator_.pending_mutations_.entries_size());
+  int index = 0;
+  for (auto& entry : *mutator_.pending_mutations_.mutable_entries()) {
+    queue_.emplace_back(PendingEntry{{},
+                                     mutator_.pending_annotations_[index++],
+                                     nullptr, nullptr, start,
+                                     grpc::Status()});
+    queue_.back().entry.Swap(&entry);
+  }
+  mutator_.pending_mutations_.clear_entries();
+  mutator_.pending_annotations_.clear();
+
+  // Each worker has at most one stream open, there is no need for more
+  // workers than mutations.
+  auto const worker_count =
+      (std::min)(static_cast<std::size_t>(kMaxStreams), queue_.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < worker_count; ++i) {
+    workers.emplace_back(&Pipeline::Worker, this);
+  }
+  Worker();
+  for (auto& t : workers) {
+    t.join();
+  }
+  return status_;
+}
+
+void BulkMutator::Pipeline::Worker() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    if (queue_.empty()) {
+      if (in_flight_ == 0) {
+        // Nothing left to send, and no stream can fail more mutations.
+        cv_.notify_all();
+        return;
+      }
+      cv_.wait(lk);
+      continue;
+    }
+    // Move the mutations ready to send, or about to be, to the end of the
+    // queue.
+    auto const now = std::chrono::steady_clock::now();
+    auto const deadline = now + kRetryBatchWindow;
+    auto ready = std::stable_partition(
+        queue_.begin(), queue_.end(),
+        [deadline](PendingEntry const& p) { return deadline < p.ready_at; });
+    if (ready == queue_.end()) {
+      auto next = std::min_element(queue_.begin(), queue_.end(),
+                                   [](PendingEntry const& a,
+                                      PendingEntry const& b) {
+                                     return a.ready_at < b.ready_at;
+                                   });
+      auto const wake_at = next->ready_at - kRetryBatchWindow;
+      auto backoff_span = ChildSpan("backoff");
+      backoff_span.SetAttribute(
+          "delay_us", std::chrono::duration_cast<std::chrono::microseconds>(
+                          wake_at - now));
+      cv_.wait_until(lk, wake_at);
+      continue;
+    }
+    std::vector<PendingEntry> batch(std::make_move_iterator(ready),
+                                    std::make_move_iterator(queue_.end()));
+    queue_.erase(ready, queue_.end());
+    // Each stream with previously failed mutations is a retry, and needs a
+    // token from the (process-wide) retry budget.
+    bool const is_retry = std::any_of(
+        batch.begin(), batch.end(),
+        [](PendingEntry const& p) { return p.retry_policy != nullptr; });
+    if (is_retry and
+        not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+      for (auto& pending : batch) {
+        google::rpc::Status rpc_status;
+        rpc_status.set_code(pending.last_status.error_code());
+        rpc_status.set_message(
+            std::string(google::cloud::internal::kRetryBudgetExhausted) +
+            ": " + pending.last_status.error_message());
+        status_ = grpc::Status(pending.last_status.error_code(),
+                               rpc_status.message());
+        GiveUp(std::move(pending), std::move(rpc_status));
+      }
+      continue;
+    }
+    if (is_retry) {
+      RpcMetrics<btproto::MutateRowsRequest>().retries.Increment();
+    }
+    ++in_flight_;
+    auto const attempt = ++attempt_;
+    lk.unlock();
+    RunStream(std::move(batch), attempt);
+    lk.lock();
+  }
 }
 
-void BulkMutator::PrepareForRequest() {
+void BulkMutator::Pipeline::RunStream(std::vector<PendingEntry> batch,
+                                     std::int64_t attempt) {
+  btproto::MutateRowsRequest request;
+  bigtable::internal::SetCommonTableOperationRequest<
+      btproto::MutateRowsRequest>(
+      request, mutator_.pending_mutations_.app_profile_id(),
+      mutator_.pending_mutations_.table_name());
+  for (auto& pending : batch) {
+    request.add_entries()->Swap(&pending.entry);
+  }
+  std::vector<bool> has_result(batch.size());
+
+  // Wait until the (shared) rate limiter admits these mutations.
+  auto limiter = client_.mutation_rate_limiter();
+  std::size_t mutation_count = 0;
+  if (limiter) {
+    for (auto const& entry : request.entries()) {
+      mutation_count += entry.mutations_size();
+    }
+    limiter->Acquire(mutation_count);
+  }
+  bool overloaded = false;
+  auto const start = MutationRateLimiter::Clock::now();
+
+  auto& metrics = RpcMetrics<btproto::MutateRowsRequest>();
+  metrics.attempts.Increment();
+  auto const request_bytes = request.ByteSizeLong();
+  metrics.bytes_sent.Increment(request_bytes);
+  auto span = ChildSpan("attempt");
+  span.SetAttribute("attempt", attempt);
+  span.SetAttribute("mutations",
+                    static_cast<std::int64_t>(request.entries_size()));
+  span.SetAttribute("bytes_sent", static_cast<std::int64_t>(request_bytes));
+  google::cloud::internal::CurrentSpanScope scope(span);
+
+  grpc::ClientContext client_context;
+  backoff_policy_.Setup(client_context);
+  retry_policy_.Setup(client_context);
+  metadata_update_policy_.Setup(client_context);
+  auto stream = client_.MutateRows(&client_context, request);
+  std::unique_ptr<google::protobuf::Arena> arena(
+      mutator_.arena_ ? new google::protobuf::Arena : nullptr);
+  {
+    auto response = MakeArenaMessage<btproto::MutateRowsResponse>(arena.get());
+    while (stream->Read(response.get())) {
+      std::lock_guard<std::mutex> lk(mu_);
+      for (auto& entry : *response->mutable_entries()) {
+        auto index = entry.index();
+        if (index < 0 or batch.size() <= std::size_t(index) or
+            has_result[index]) {
+          // TODO(#72) - decide how this is logged.
+          continue;
+        }
+        has_result[index] = true;
+        auto const code = static_cast<grpc::StatusCode>(entry.status().code());
+        if (grpc::StatusCode::OK == code) {
+          continue;
+        }
+        overloaded = overloaded or MutationRateLimiter::IsOverload(code);
+        auto& pending = batch[index];
+        pending.entry.Swap(request.mutable_entries(index));
+        if (SafeGrpcRetry::IsTransientFailure(code) and
+            pending.annotation.is_idempotent) {
+          OnFailure(std::move(pending),
+                    grpc::Status(code, entry.status().message()));
+        } else {
+          GiveUp(std::move(pending), std::move(*entry.mutable_status()));
+        }
+      }
+      // Wake up the main loop, it may need to send the failed mutations.
+      cv_.notify_one();
+    }
+  }
+  auto status = stream->Finish();
+  auto const now = MutationRateLimiter::Clock::now();
+  metrics.attempt_latency.Record(now - start);
+  span.SetStatus(status.error_code(), status.error_message());
+  if (status.ok()) {
+    google::cloud::internal::DefaultRetryBudget().OnSuccess();
+  }
+  if (limiter) {
+    if (overloaded or MutationRateLimiter::IsOverload(status.error_code())) {
+      limiter->OnOverload(now);
+    } else if (status.ok()) {
+      limiter->OnSuccess(
+          mutation_count,
+          std::chrono::duration_cast<std::chrono::microseconds>(now - start),
+          now);
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  for (std::size_t index = 0; index != batch.size(); ++index) {
+    if (has_result[index]) {
+      continue;
+    }
+    // The mutations with unknown state are retried if they are idempotent,
+    // otherwise they are reported back with an OK status.
+    auto& pending = batch[index];
+    pending.entry.Swap(request.mutable_entries(static_cast<int>(index)));
+    if (pending.annotation.is_idempotent) {
+      OnFailure(std::move(pending), status);
+      continue;
+    }
+    google::rpc::Status ok_status;
+    ok_status.set_code(grpc::StatusCode::OK);
+    GiveUp(std::move(pending), std::move(ok_status));
+  }
+  --in_flight_;
+  cv_.notify_all();
+}
+
+void BulkMutator::Pipeline::OnFailure(PendingEntry pending,
+                                      grpc::Status const& status) {
+  if (not pending.retry_policy) {
+    pending.retry_policy = retry_policy_.clone();
+    pending.backoff_policy = backoff_policy_.clone();
+  }
+  // A stream that finishes with OK but without results for some mutations
+  // does not count against their retry policy, as in MakeOneRequest().
+  if (not status.ok() and not pending.retry_policy->OnFailure(status)) {
+    status_ = status;
+    google::rpc::Status rpc_status;
+    rpc_status.set_code(status.error_code());
+    rpc_status.set_message(status.error_message());
+    GiveUp(std::move(pending), std::move(rpc_status));
+    return;
+  }
+  pending.ready_at = std::chrono::steady_clock::now() +
+                     pending.backoff_policy->OnCompletion(status);
+  pending.last_status = status;
+  queue_.emplace_back(std::move(pending));
+}
+
+void BulkMutator::Pipeline::GiveUp(PendingEntry pending,
+                                   google::rpc::Status status) {
+  mutator_.failures_.emplace_back(SingleRowMutation(std::move(pending.entry)),
+                                  std::move(status),
+                                  pending.annotation.original_index);
+}
+
+grpc::Status BulkMutator::Run(
+    bigtable::DataClient& client, RPCRetryPolicy const& retry_policy,
+    RPCBackoffPolicy const& backoff_policy,
+    MetadataUpdatePolicy const& metadata_update_policy) {
+  return Pipeline(*this, client, retry_policy, backoff_policy,
+                  metadata_update_policy)
+      .Run();
+}
+
+btproto::MutateRowsRequest const& BulkMutator::PrepareForRequest() {
   mutations_.Swap(&pending_mutations_);
   annotations_.swap(pending_annotations_);
   for (auto& a : annotations_) {
@@ -79,6 +460,7 @@ void BulkMutator::PrepareForRequest() {
       btproto::MutateRowsRequest>(
       pending_mutations_, mutations_.app_profile_id(), mutations_.table_name());
   pending_annotations_ = {};
+  return mutations_;
 }
 
 void BulkMutator::ProcessResponse(
@@ -149,13 +531,72 @@ std::vector<FailedMutation> BulkMutator::ExtractFinalFailures() {
   std::vector<FailedMutation> result(std::move(failures_));
   google::rpc::Status ok_status;
   ok_status.set_code(grpc::StatusCode::OK);
+  // The mutations still pending (typically because the retry policy was
+  // exhausted) are reported with their index in the original request, so the
+  // caller can match them with the mutations it provided.
+  int index = 0;
   for (auto& mutation : *pending_mutations_.mutable_entries()) {
     result.emplace_back(
-        FailedMutation(SingleRowMutation(std::move(mutation)), ok_status));
+        FailedMutation(SingleRowMutation(std::move(mutation)), ok_status,
+                       pending_annotations_[index++].original_index));
   }
   return result;
 }
 
+std::vector<BulkMutationPiece> SplitBulkMutation(BulkMutation&& mut,
+                                                 std::size_t max_mutations,
+                                                 std::size_t max_bytes) {
+  std::vector<BulkMutationPiece> pieces;
+  btproto::MutateRowsRequest request;
+  mut.MoveTo(&request);
+  // This computes (and caches) the size of each entry, so the loop below can
+  // use GetCachedSize() instead of walking the protos again.
+  auto const total_bytes = request.ByteSizeLong();
+  auto const total_mutations = std::accumulate(
+      request.entries().begin(), request.entries().end(), std::size_t(0),
+      [](std::size_t a, btproto::MutateRowsRequest::Entry const& e) {
+        return a + e.mutations_size();
+      });
+  if (request.entries_size() == 0) {
+    return pieces;
+  }
+  if (total_mutations <= max_mutations and total_bytes <= max_bytes) {
+    BulkMutation piece;
+    for (auto& entry : *request.mutable_entries()) {
+      piece.emplace_back(SingleRowMutation(std::move(entry)));
+    }
+    pieces.emplace_back(BulkMutationPiece{std::move(piece), 0});
+    return pieces;
+  }
+
+  BulkMutation piece;
+  std::size_t piece_mutations = 0;
+  std::size_t piece_bytes = 0;
+  int piece_offset = 0;
+  int index = 0;
+  for (auto& entry : *request.mutable_entries()) {
+    std::size_t const mutations = entry.mutations_size();
+    // The entries are a repeated field, each one has a tag and a length prefix
+    // in addition to its contents, 8 bytes is a generous estimate for those.
+    std::size_t const bytes = entry.GetCachedSize() + 8;
+    if (index != piece_offset and
+        (piece_mutations + mutations > max_mutations or
+         piece_bytes + bytes > max_bytes)) {
+      pieces.emplace_back(BulkMutationPiece{std::move(piece), piece_offset});
+      piece = BulkMutation();
+      piece_mutations = 0;
+      piece_bytes = 0;
+      piece_offset = index;
+    }
+    piece.emplace_back(SingleRowMutation(std::move(entry)));
+    piece_mutations += mutations;
+    piece_bytes += bytes;
+    ++index;
+  }
+  pieces.emplace_back(BulkMutationPiece{std::move(piece), piece_offset});
+  return pieces;
+}
+
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -18,6 +18,10 @@
 #include "google/cloud/bigtable/bigtable_strong_types.h"
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/idempotent_mutation_policy.h"
+#include "google/cloud/bigtable/internal/arena_message.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/table_strong_types.h"
 
 namespace google {
@@ -32,29 +36,93 @@ class BulkMutator {
               bigtable::TableId const& table_name,
               IdempotentMutationPolicy& idempotent_policy, BulkMutation&& mut);
 
+  /**
+   * Create a mutator that optionally allocates the responses on an arena.
+   *
+   * With @p use_arena set, `MakeOneRequest()` allocates the `MutateRows`
+   * responses on a `google::protobuf::Arena` owned by the mutator, and
+   * releases them all at once at the end of the request.  The requests are
+   * not allocated on the arena, they are moved from @p mut without copies.
+   *
+   * The failures are reported with their index in @p mut plus
+   * @p original_index_offset, this is used when a large `BulkMutation` is
+   * split into several pieces.
+   */
+  BulkMutator(bigtable::AppProfileId const& app_profile_id,
+              bigtable::TableId const& table_name,
+              IdempotentMutationPolicy& idempotent_policy, BulkMutation&& mut,
+              bool use_arena, int original_index_offset = 0);
+
   /// Return true if there are pending mutations in the mutator
   bool HasPendingMutations() const {
     return pending_mutations_.entries_size() != 0;
   }
 
+  /// Return the number of mutations (not rows) pending, to throttle requests.
+  std::size_t PendingMutationCount() const;
+
   /// Send one batch request to the given stub.
   grpc::Status MakeOneRequest(bigtable::DataClient& client,
                               grpc::ClientContext& client_context);
 
+  /**
+   * Send all the pending mutations, retrying each failed mutation separately.
+   *
+   * Unlike a loop around `MakeOneRequest()`, the mutations that fail with a
+   * transient error are sent again as soon as their own backoff period
+   * expires, in a new stream, without waiting for the other mutations in the
+   * same request.  The mutations that become ready at about the same time are
+   * sent in the same stream.  Each mutation gets its own copy of
+   * @p retry_policy and @p backoff_policy the first time it fails.  A pool of
+   * at most `kMaxStreams` threads (including the calling thread) sends the
+   * streams, so at most `kMaxStreams` streams are open at the same time.  If
+   * the client has a `MutationRateLimiter` each stream waits until the
+   * limiter admits its mutations, and reports back its latency or any
+   * overload errors.  Each stream that resends failed mutations needs a token
+   * from the process-wide retry budget, without it the mutations are reported
+   * as failed.
+   *
+   * @return the status of the last stream that failed with a non-retryable
+   *     error, or exhausted the retry policy of any mutation.  OK otherwise,
+   *     even if some mutations failed, use `ExtractFinalFailures()` to get
+   *     them.
+   */
+  grpc::Status Run(bigtable::DataClient& client,
+                   RPCRetryPolicy const& retry_policy,
+                   RPCBackoffPolicy const& backoff_policy,
+                   MetadataUpdatePolicy const& metadata_update_policy);
+
+  /// The maximum number of concurrent streams in `Run()`.
+  static constexpr int kMaxStreams = 4;
+
   /// Give up on any pending mutations, move them to the failures array.
   std::vector<FailedMutation> ExtractFinalFailures();
 
- private:
-  /// Get ready for a new request.
-  void PrepareForRequest();
+  //@{
+  /**
+   * @name The steps in `MakeOneRequest()`.
+   *
+   * The asynchronous version of `Table::BulkApply()` cannot use
+   * `MakeOneRequest()`, it calls these functions from the completion queue
+   * callbacks instead.
+   */
+  /// Get ready for a new request, return the request to send.
+  google::bigtable::v2::MutateRowsRequest const& PrepareForRequest();
 
   /// Process a single response.
   void ProcessResponse(google::bigtable::v2::MutateRowsResponse& response);
 
   /// A request has finished and we have processed all the responses.
   void FinishRequest();
+  //@}
 
  private:
+  /// The state for `Run()`.
+  class Pipeline;
+
+  /// The arena for the responses, null if disabled.
+  std::unique_ptr<google::protobuf::Arena> arena_;
+
   /// Accumulate any permanent failures and the list of mutations we gave up on.
   std::vector<FailedMutation> failures_;
 
@@ -90,6 +158,24 @@ class BulkMutator {
   /// Accumulate annotations for the next request.
   std::vector<Annotations> pending_annotations_;
 };
+
+/// A piece of a larger `BulkMutation`, see `SplitBulkMutation()`.
+struct BulkMutationPiece {
+  BulkMutation mutation;
+  /// The index of the first row of this piece in the original mutation.
+  int original_index_offset;
+};
+
+/**
+ * Split @p mut into pieces small enough to send in a single request.
+ *
+ * Each piece has at most @p max_mutations mutations and (approximately) at most
+ * @p max_bytes bytes, unless a single row exceeds the limits, in which case it
+ * is sent by itself.  The rows keep their relative order.
+ */
+std::vector<BulkMutationPiece> SplitBulkMutation(BulkMutation&& mut,
+                                                 std::size_t max_mutations,
+                                                 std::size_t max_bytes);
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -17,6 +17,9 @@
 #include "google/cloud/bigtable/testing/chrono_literals.h"
 #include "google/cloud/bigtable/testing/mock_data_client.h"
 #include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
+#include <future>
+#include <mutex>
+#include <vector>
 
 /// Define types and functions used in the tests.
 namespace {
@@ -414,3 +417,498 @@ TEST(MultipleRowsMutatorTest, RetryOnlyIdempotent) {
   EXPECT_EQ("baz", failures[1].mutation().row_key());
   EXPECT_EQ(grpc::StatusCode::OK, failures[1].status().error_code());
 }
+
+/// @test Verify that pending mutations are reported with their original index.
+TEST(MultipleRowsMutatorTest, ExtractFinalFailuresKeepsIndex) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  // The first mutation succeeds, the second one fails with a transient error,
+  // and then the retry policy is exhausted.
+  auto r1 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r1, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        {
+          auto& e = *r->add_entries();
+          e.set_index(0);
+          e.mutable_status()->set_code(grpc::StatusCode::OK);
+        }
+        {
+          auto& e = *r->add_entries();
+          e.set_index(1);
+          e.mutable_status()->set_code(grpc::StatusCode::UNAVAILABLE);
+        }
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r1, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke([&r1](grpc::ClientContext*,
+                             btproto::MutateRowsRequest const&) {
+        return r1.release()->AsUniqueMocked();
+      }));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut));
+
+  grpc::ClientContext context;
+  auto status = mutator.MakeOneRequest(client, context);
+  EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(mutator.HasPendingMutations());
+
+  auto failures = mutator.ExtractFinalFailures();
+  ASSERT_EQ(1UL, failures.size());
+  EXPECT_EQ(1, failures[0].original_index());
+  EXPECT_EQ("bar", failures[0].mutation().row_key());
+}
+
+/// @test Verify that MultipleRowsMutator allocates the responses on an arena.
+TEST(MultipleRowsMutatorTest, ResponsesOnArena) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}),
+      bt::SingleRowMutation("baz", {bt::SetCell("fam", "col", 0_ms, "v")}));
+
+  // The first RPC returns a recoverable failure for "foo", an unrecoverable
+  // failure for "bar", and success for "baz".
+  auto r1 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r1, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        EXPECT_NE(nullptr, r->GetArena());
+        auto& e0 = *r->add_entries();
+        e0.set_index(0);
+        e0.mutable_status()->set_code(grpc::StatusCode::UNAVAILABLE);
+        auto& e1 = *r->add_entries();
+        e1.set_index(1);
+        e1.mutable_status()->set_code(grpc::StatusCode::OUT_OF_RANGE);
+        e1.mutable_status()->set_message("bad bar");
+        auto& e2 = *r->add_entries();
+        e2.set_index(2);
+        e2.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r1, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  auto r2 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r2, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        EXPECT_NE(nullptr, r->GetArena());
+        auto& e = *r->add_entries();
+        e.set_index(0);
+        e.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r2, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke([&r1](grpc::ClientContext*,
+                             btproto::MutateRowsRequest const& request) {
+        EXPECT_EQ("foo/bar/baz/table", request.table_name());
+        EXPECT_EQ(3, request.entries_size());
+        return r1.release()->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([&r2](grpc::ClientContext*,
+                             btproto::MutateRowsRequest const& request) {
+        EXPECT_EQ("foo/bar/baz/table", request.table_name());
+        EXPECT_EQ(1, request.entries_size());
+        EXPECT_EQ("foo", request.entries(0).row_key());
+        return r2.release()->AsUniqueMocked();
+      }));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut), true);
+
+  for (int i = 0; i != 2; ++i) {
+    EXPECT_TRUE(mutator.HasPendingMutations());
+    grpc::ClientContext context;
+    auto status = mutator.MakeOneRequest(client, context);
+    EXPECT_TRUE(status.ok());
+  }
+  EXPECT_FALSE(mutator.HasPendingMutations());
+  auto failures = mutator.ExtractFinalFailures();
+  ASSERT_EQ(1UL, failures.size());
+  EXPECT_EQ(1, failures[0].original_index());
+  EXPECT_EQ("bar", failures[0].mutation().row_key());
+  EXPECT_EQ(grpc::StatusCode::OUT_OF_RANGE, failures[0].status().error_code());
+  EXPECT_EQ("bad bar", failures[0].status().error_message());
+}
+
+/// @test Verify that the failures are reported with the offset in the index.
+TEST(MultipleRowsMutatorTest, OriginalIndexOffset) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  auto reader = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*reader, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e = *r->add_entries();
+        e.set_index(1);
+        e.mutable_status()->set_code(grpc::StatusCode::OUT_OF_RANGE);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke(reader.release()->MakeMockReturner()));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(
+      bigtable::AppProfileId(""), bigtable::TableId("foo/bar/baz/table"),
+      *policy, std::move(mut), false, 40);
+
+  grpc::ClientContext context;
+  auto status = mutator.MakeOneRequest(client, context);
+  EXPECT_TRUE(status.ok());
+  auto failures = mutator.ExtractFinalFailures();
+  ASSERT_EQ(2UL, failures.size());
+  EXPECT_EQ(41, failures[0].original_index());
+  EXPECT_EQ("bar", failures[0].mutation().row_key());
+  EXPECT_EQ(grpc::StatusCode::OUT_OF_RANGE,
+            failures[0].status().error_code());
+  // The mutation without a result is not idempotent, it is given up on.
+  EXPECT_EQ(40, failures[1].original_index());
+  EXPECT_EQ("foo", failures[1].mutation().row_key());
+}
+
+/// @test Verify that Run() resends failed mutations while the stream is open.
+TEST(MultipleRowsMutatorTest, RunRetriesWithoutWaitingForStream) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  // The first stream reports a transient failure for "foo", and then blocks
+  // until "foo" is resent in a second stream.
+  std::promise<void> retry_sent;
+  auto r1 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r1, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e = *r->add_entries();
+        e.set_index(0);
+        e.mutable_status()->set_code(grpc::StatusCode::UNAVAILABLE);
+        return true;
+      }))
+      .WillOnce(Invoke([&retry_sent](btproto::MutateRowsResponse* r) {
+        retry_sent.get_future().wait();
+        auto& e = *r->add_entries();
+        e.set_index(1);
+        e.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r1, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  auto r2 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r2, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e = *r->add_entries();
+        e.set_index(0);
+        e.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r2, Finish()).WillOnce(Return(grpc::Status::OK));
+  auto* r2_ptr = r2.release();
+
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke(r1.release()->MakeMockReturner()))
+      .WillOnce(Invoke([&retry_sent, r2_ptr](
+                           grpc::ClientContext*,
+                           btproto::MutateRowsRequest const& request) {
+        EXPECT_EQ(1, request.entries_size());
+        EXPECT_EQ("foo", request.entries(0).row_key());
+        retry_sent.set_value();
+        return r2_ptr->AsUniqueMocked();
+      }));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut));
+  auto status =
+      mutator.Run(client, bt::LimitedErrorCountRetryPolicy(3),
+                  bt::ExponentialBackoffPolicy(10_us, 40_us),
+                  bt::MetadataUpdatePolicy("foo/bar/baz/table",
+                                           bt::MetadataParamTypes::TABLE_NAME));
+  EXPECT_TRUE(status.ok());
+  EXPECT_FALSE(mutator.HasPendingMutations());
+  EXPECT_TRUE(mutator.ExtractFinalFailures().empty());
+}
+
+/// @test Verify that Run() uses a separate retry policy for each mutation.
+TEST(MultipleRowsMutatorTest, RunRetryPolicyPerMutation) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  // "foo" always fails, "bar" fails twice and then succeeds.
+  std::mutex mu;
+  int bar_attempts = 0;
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillRepeatedly(Invoke([&](grpc::ClientContext*,
+                                 btproto::MutateRowsRequest const& request) {
+        btproto::MutateRowsResponse response;
+        for (int i = 0; i != request.entries_size(); ++i) {
+          auto& e = *response.add_entries();
+          e.set_index(i);
+          auto code = grpc::StatusCode::UNAVAILABLE;
+          if (request.entries(i).row_key() == "bar") {
+            std::lock_guard<std::mutex> lk(mu);
+            if (++bar_attempts == 3) {
+              code = grpc::StatusCode::OK;
+            }
+          }
+          e.mutable_status()->set_code(code);
+        }
+        auto stream = bigtable::internal::make_unique<MockMutateRowsReader>();
+        EXPECT_CALL(*stream, Read(_))
+            .WillOnce(Invoke([response](btproto::MutateRowsResponse* r) {
+              *r = response;
+              return true;
+            }))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut));
+  // Each mutation tolerates 2 failures.  The failures of "foo" must not
+  // exhaust the policy for "bar".
+  auto status =
+      mutator.Run(client, bt::LimitedErrorCountRetryPolicy(2),
+                  bt::ExponentialBackoffPolicy(10_us, 40_us),
+                  bt::MetadataUpdatePolicy("foo/bar/baz/table",
+                                           bt::MetadataParamTypes::TABLE_NAME));
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+  auto failures = mutator.ExtractFinalFailures();
+  ASSERT_EQ(1UL, failures.size());
+  EXPECT_EQ(0, failures[0].original_index());
+  EXPECT_EQ("foo", failures[0].mutation().row_key());
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, failures[0].status().error_code());
+  EXPECT_EQ(3, bar_attempts);
+}
+
+/// @test Verify that Run() resends the mutations that fail together in one
+/// stream.
+TEST(MultipleRowsMutatorTest, RunBatchesRetries) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}),
+      bt::SingleRowMutation("baz", {bt::SetCell("fam", "col", 0_ms, "quux")}));
+
+  // The first stream fails all the mutations, the second one succeeds.
+  std::mutex mu;
+  std::vector<int> request_sizes;
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillRepeatedly(Invoke([&](grpc::ClientContext*,
+                                 btproto::MutateRowsRequest const& request) {
+        bool first;
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          first = request_sizes.empty();
+          request_sizes.push_back(request.entries_size());
+        }
+        btproto::MutateRowsResponse response;
+        for (int i = 0; i != request.entries_size(); ++i) {
+          auto& e = *response.add_entries();
+          e.set_index(i);
+          e.mutable_status()->set_code(first ? grpc::StatusCode::UNAVAILABLE
+                                             : grpc::StatusCode::OK);
+        }
+        auto stream = bigtable::internal::make_unique<MockMutateRowsReader>();
+        EXPECT_CALL(*stream, Read(_))
+            .WillOnce(Invoke([response](btproto::MutateRowsResponse* r) {
+              *r = response;
+              return true;
+            }))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut));
+  auto status =
+      mutator.Run(client, bt::LimitedErrorCountRetryPolicy(3),
+                  bt::ExponentialBackoffPolicy(10_us, 40_us),
+                  bt::MetadataUpdatePolicy("foo/bar/baz/table",
+                                           bt::MetadataParamTypes::TABLE_NAME));
+  EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(mutator.ExtractFinalFailures().empty());
+  EXPECT_THAT(request_sizes, ElementsAre(3, 3));
+}
+
+namespace {
+/// A mock client that throttles mutations.
+class ThrottledDataClient : public bigtable::testing::MockDataClient {
+ public:
+  explicit ThrottledDataClient(bt::MutationThrottlingOptions const& options)
+      : limiter_(std::make_shared<bt::MutationRateLimiter>(options)) {}
+
+  std::shared_ptr<bt::MutationRateLimiter> mutation_rate_limiter() override {
+    return limiter_;
+  }
+
+ private:
+  std::shared_ptr<bt::MutationRateLimiter> limiter_;
+};
+}  // anonymous namespace
+
+/// @test Verify that Run() reports overloads to the rate limiter.
+TEST(MultipleRowsMutatorTest, RunThrottled) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  auto r1 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r1, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e0 = *r->add_entries();
+        e0.set_index(0);
+        e0.mutable_status()->set_code(grpc::StatusCode::UNAVAILABLE);
+        auto& e1 = *r->add_entries();
+        e1.set_index(1);
+        e1.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r1, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  auto r2 = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r2, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e = *r->add_entries();
+        e.set_index(0);
+        e.mutable_status()->set_code(grpc::StatusCode::OK);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r2, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  ThrottledDataClient client(bt::MutationThrottlingOptions()
+                                 .set_initial_rate(1000)
+                                 .set_additive_increase(10)
+                                 .set_latency_factor(0));
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke(r1.release()->MakeMockReturner()))
+      .WillOnce(Invoke(r2.release()->MakeMockReturner()));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut));
+  auto status =
+      mutator.Run(client, bt::LimitedErrorCountRetryPolicy(3),
+                  bt::ExponentialBackoffPolicy(10_us, 40_us),
+                  bt::MetadataUpdatePolicy("foo/bar/baz/table",
+                                           bt::MetadataParamTypes::TABLE_NAME));
+  EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(mutator.ExtractFinalFailures().empty());
+  // The first request halves the rate, the retry increases it.  The retry may
+  // complete before the first stream, so the order is not known.
+  auto limiter = client.mutation_rate_limiter();
+  EXPECT_EQ(1U, limiter->decrease_count());
+  EXPECT_LE(505.0, limiter->rate());
+  EXPECT_GE(510.0, limiter->rate());
+}
+
+namespace {
+/// Return the row keys in each piece, consuming the pieces.
+std::vector<std::vector<std::string>> PieceKeys(
+    std::vector<bt::internal::BulkMutationPiece>& pieces) {
+  std::vector<std::vector<std::string>> result;
+  for (auto& p : pieces) {
+    btproto::MutateRowsRequest request;
+    p.mutation.MoveTo(&request);
+    std::vector<std::string> keys;
+    for (auto const& e : request.entries()) {
+      keys.push_back(e.row_key());
+    }
+    result.push_back(std::move(keys));
+  }
+  return result;
+}
+}  // anonymous namespace
+
+/// @test Verify that SplitBulkMutation() keeps small mutations in one piece.
+TEST(SplitBulkMutationTest, Small) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      bt::SingleRowMutation("r1", {bt::SetCell("fam", "col", 0_ms, "v")}));
+  auto pieces = bt::internal::SplitBulkMutation(std::move(mut), 100, 1024);
+  ASSERT_EQ(1UL, pieces.size());
+  EXPECT_EQ(0, pieces[0].original_index_offset);
+  std::vector<std::vector<std::string>> expected{{"r0", "r1"}};
+  EXPECT_EQ(expected, PieceKeys(pieces));
+
+  EXPECT_TRUE(
+      bt::internal::SplitBulkMutation(bt::BulkMutation(), 100, 1024).empty());
+}
+
+/// @test Verify that SplitBulkMutation() limits the mutations per piece.
+TEST(SplitBulkMutationTest, MaxMutations) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "col", 0_ms, "v"),
+                                   bt::SetCell("fam", "col", 1_ms, "v")}),
+      bt::SingleRowMutation("r1", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      bt::SingleRowMutation("r2", {bt::SetCell("fam", "col", 0_ms, "v"),
+                                   bt::SetCell("fam", "col", 1_ms, "v"),
+                                   bt::SetCell("fam", "col", 2_ms, "v")}),
+      bt::SingleRowMutation("r3", {bt::SetCell("fam", "col", 0_ms, "v")}));
+  auto pieces = bt::internal::SplitBulkMutation(std::move(mut), 3, 1 << 20);
+  ASSERT_EQ(3UL, pieces.size());
+  EXPECT_EQ(0, pieces[0].original_index_offset);
+  EXPECT_EQ(2, pieces[1].original_index_offset);
+  EXPECT_EQ(3, pieces[2].original_index_offset);
+  std::vector<std::vector<std::string>> expected{{"r0", "r1"}, {"r2"}, {"r3"}};
+  EXPECT_EQ(expected, PieceKeys(pieces));
+
+  // A row with more mutations than the limit is sent by itself.
+  bt::BulkMutation large(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      bt::SingleRowMutation("r1", {bt::SetCell("fam", "col", 0_ms, "v"),
+                                   bt::SetCell("fam", "col", 1_ms, "v")}),
+      bt::SingleRowMutation("r2", {bt::SetCell("fam", "col", 0_ms, "v")}));
+  pieces = bt::internal::SplitBulkMutation(std::move(large), 1, 1 << 20);
+  expected = {{"r0"}, {"r1"}, {"r2"}};
+  EXPECT_EQ(expected, PieceKeys(pieces));
+}
+
+/// @test Verify that SplitBulkMutation() limits the bytes per piece.
+TEST(SplitBulkMutationTest, MaxBytes) {
+  std::string const value(100, 'x');
+  bt::BulkMutation mut;
+  for (int i = 0; i != 10; ++i) {
+    mut.emplace_back(bt::SingleRowMutation(
+        "r" + std::to_string(i), {bt::SetCell("fam", "col", 0_ms, value)}));
+  }
+  auto pieces = bt::internal::SplitBulkMutation(std::move(mut), 1000, 600);
+  ASSERT_EQ(3UL, pieces.size());
+  EXPECT_EQ(0, pieces[0].original_index_offset);
+  EXPECT_EQ(4, pieces[1].original_index_offset);
+  EXPECT_EQ(8, pieces[2].original_index_offset);
+  auto keys = PieceKeys(pieces);
+  EXPECT_EQ(4UL, keys[0].size());
+  EXPECT_EQ(4UL, keys[1].size());
+  EXPECT_EQ("r9", keys[2].back());
+}
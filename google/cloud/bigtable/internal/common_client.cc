@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 
 #include "google/cloud/bigtable/internal/common_client.h"
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -19,22 +20,74 @@ namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 
+std::shared_ptr<grpc::Channel> CreateChannel(
+    std::string const& endpoint, bigtable::ClientOptions const& options,
+    std::size_t id, std::size_t generation) {
+  auto args = options.channel_arguments();
+  if (not options.connection_pool_name().empty()) {
+    args.SetString("cbt-c++/connection-pool-name",
+                   options.connection_pool_name());
+  }
+  args.SetInt("cbt-c++/connection-pool-id", static_cast<int>(id));
+  // gRPC shares the connections between channels with the same arguments, a
+  // replacement channel must use different arguments to get a new connection.
+  if (generation != 0) {
+    args.SetInt("cbt-c++/connection-generation", static_cast<int>(generation));
+  }
+  return grpc::CreateCustomChannel(endpoint, options.credentials(), args);
+}
+
 std::vector<std::shared_ptr<grpc::Channel>> CreateChannelPool(
     std::string const& endpoint, bigtable::ClientOptions const& options) {
   std::vector<std::shared_ptr<grpc::Channel>> result;
   for (std::size_t i = 0; i != options.connection_pool_size(); ++i) {
-    auto args = options.channel_arguments();
-    if (not options.connection_pool_name().empty()) {
-      args.SetString("cbt-c++/connection-pool-name",
-                     options.connection_pool_name());
-    }
-    args.SetInt("cbt-c++/connection-pool-id", static_cast<int>(i));
-    result.push_back(
-        grpc::CreateCustomChannel(endpoint, options.credentials(), args));
+    result.push_back(CreateChannel(endpoint, options, i, 0));
   }
   return result;
 }
 
+namespace {
+/// Assign the threads to the `ReaderRegistry` slots in round-robin order.
+std::size_t CurrentThreadSlot() {
+  static std::atomic<std::size_t> next_slot(0);
+  thread_local std::size_t const slot = next_slot.fetch_add(1);
+  return slot;
+}
+}  // namespace
+
+constexpr std::size_t ReaderRegistry::kSlotCount;
+
+ReaderRegistry::ReaderRegistry() : epoch_(0) {
+  for (auto& slot : slots_) {
+    slot.counters[0].store(0);
+    slot.counters[1].store(0);
+  }
+}
+
+ReaderRegistry::Guard::Guard(ReaderRegistry& registry)
+    : counter_(registry.slots_[CurrentThreadSlot() % kSlotCount]
+                   .counters[registry.epoch_.load()]) {
+  counter_.fetch_add(1);
+}
+
+void ReaderRegistry::WaitForReaders() {
+  // A reader that loaded the old pointer incremented the counter for the
+  // epoch current at the time of the swap, waiting for that epoch is enough
+  // for it.  However, a reader may load the epoch just before a flip and
+  // increment the counter after, and thus be counted in the other epoch.
+  // Flipping twice waits for both epochs, and new readers always use the
+  // current epoch, so they do not starve the writer.
+  for (int i = 0; i != 2; ++i) {
+    int const old_epoch = epoch_.load();
+    epoch_.store(1 - old_epoch);
+    for (auto& slot : slots_) {
+      while (slot.counters[old_epoch].load() != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
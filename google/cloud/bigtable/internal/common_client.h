@@ -15,8 +15,20 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMMON_CLIENT_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMMON_CLIENT_H_
 
+#include "google/cloud/bigtable/channel_selection_policy.h"
 #include "google/cloud/bigtable/client_options.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/tracing.h"
 #include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -24,10 +36,106 @@ namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 
+/**
+ * Create the channel for the @p id element in a pool.
+ *
+ * Channels with a different @p generation use different connections, even if
+ * their @p id is the same.
+ */
+std::shared_ptr<grpc::Channel> CreateChannel(
+    std::string const& endpoint, bigtable::ClientOptions const& options,
+    std::size_t id, std::size_t generation);
+
 /// Create a pool of grpc::Channel objects based on the client options.
 std::vector<std::shared_ptr<grpc::Channel>> CreateChannelPool(
     std::string const& endpoint, bigtable::ClientOptions const& options);
 
+/**
+ * Track the threads reading an atomically swapped pointer.
+ *
+ * Readers create a `Guard` before loading the pointer, and destroy it once
+ * they are done with the pointee.  A writer swaps the pointer and then calls
+ * `WaitForReaders()` before deleting the old value, this function returns once
+ * every reader that could have loaded the old value is done.
+ *
+ * Readers never block, they just increment (and later decrement) a counter.
+ * The counters are striped across threads to avoid contention on a single
+ * cache line, and split by epoch so new readers do not delay the writer.
+ * Writers must be serialized by the caller.
+ */
+class ReaderRegistry {
+ public:
+  ReaderRegistry();
+  ReaderRegistry(ReaderRegistry const&) = delete;
+  ReaderRegistry& operator=(ReaderRegistry const&) = delete;
+
+  /// Mark the current thread as a reader while this object is alive.
+  class Guard {
+   public:
+    explicit Guard(ReaderRegistry& registry);
+    ~Guard() { counter_.fetch_sub(1); }
+    Guard(Guard const&) = delete;
+    Guard& operator=(Guard const&) = delete;
+
+   private:
+    std::atomic<int>& counter_;
+  };
+
+  /// Block until all the readers that started before this call are done.
+  void WaitForReaders();
+
+ private:
+  static constexpr std::size_t kSlotCount = 16;
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  /// The counters used by a subset of the threads, one per epoch.
+  struct Slot {
+    std::atomic<int> counters[2];
+    char padding[kCacheLineSize - 2 * sizeof(std::atomic<int>)];
+  };
+
+  std::atomic<int> epoch_;
+  Slot slots_[kSlotCount];
+};
+
+/**
+ * Count an RPC as outstanding on its channel while this object is alive.
+ *
+ * The counters are used by the `ChannelSelectionPolicy` to avoid channels
+ * with many outstanding (possibly stuck) RPCs.
+ */
+class RpcTracker {
+ public:
+  RpcTracker() = default;
+  explicit RpcTracker(std::shared_ptr<std::atomic<long>> counter)
+      : counter_(std::move(counter)) {
+    if (counter_) {
+      counter_->fetch_add(1);
+    }
+  }
+  ~RpcTracker() { Release(); }
+
+  RpcTracker(RpcTracker&&) noexcept = default;
+  RpcTracker& operator=(RpcTracker&& rhs) noexcept {
+    Release();
+    counter_ = std::move(rhs.counter_);
+    return *this;
+  }
+
+  RpcTracker(RpcTracker const&) = delete;
+  RpcTracker& operator=(RpcTracker const&) = delete;
+
+ private:
+  void Release() {
+    if (counter_) {
+      counter_->fetch_sub(1);
+      counter_.reset();
+    }
+  }
+
+  std::shared_ptr<std::atomic<long>> counter_;
+};
+
 /**
  * Refactor implementation of `bigtable::{Data,Admin,InstanceAdmin}Client`.
  *
@@ -39,6 +147,18 @@ std::vector<std::shared_ptr<grpc::Channel>> CreateChannelPool(
  * The class exposes the channels because they are needed for clients that
  * use more than one type of Stub.
  *
+ * The channel for each call is chosen by the `ChannelSelectionPolicy`
+ * configured in the `ClientOptions`.  Clients that want the policy to see the
+ * load on each channel use `StartRpc()`, and keep the returned tracker until
+ * the RPC completes.
+ *
+ * `Stub()` and `Channel()` are called for every RPC, so they do not lock: the
+ * channels and stubs are kept in an immutable snapshot, which is swapped
+ * atomically when the connections are created or reset.
+ *
+ * If the `ClientOptions` configure a channel refresh period, a background
+ * thread replaces each channel before the service closes it for its age.
+ *
  * @tparam Traits encapsulates variations between the clients.  Currently, which
  *   `*_endpoint()` member function is used.
  * @tparam Interface the gRPC object returned by `Stub()`.
@@ -52,8 +172,34 @@ class CommonClient {
   using ChannelPtr = std::shared_ptr<grpc::Channel>;
   //@}
 
+  /// The stub for the next RPC, and the tracker counting the RPC.
+  struct TrackedStub {
+    StubPtr stub;
+    RpcTracker tracker;
+  };
+
   CommonClient(bigtable::ClientOptions options)
-      : options_(std::move(options)), current_index_(0) {}
+      : options_(std::move(options)),
+        policy_(options_.channel_selection_policy().clone()),
+        connections_(nullptr),
+        shutdown_(false),
+        generation_(0) {
+    if (options_.max_channel_refresh_period().count() > 0) {
+      refresher_ = std::thread([this] { RefreshLoop(); });
+    }
+  }
+
+  ~CommonClient() {
+    if (refresher_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lk(refresh_mu_);
+        shutdown_ = true;
+      }
+      refresh_cv_.notify_one();
+      refresher_.join();
+    }
+    delete connections_.load();
+  }
 
   /**
    * Reset the channel and stub.
@@ -64,74 +210,291 @@ class CommonClient {
    */
   void reset() {
     std::lock_guard<std::mutex> lk(mu_);
-    stubs_.clear();
+    std::unique_ptr<Connections const> old(connections_.exchange(nullptr));
+    readers_.WaitForReaders();
   }
 
   /// Return the next Stub to make a call.
   StubPtr Stub() {
-    std::unique_lock<std::mutex> lk(mu_);
-    CheckConnections(lk);
-    auto stub = stubs_[GetIndex(lk)];
+    StubPtr stub;
+    while (not WithConnections([this, &stub](Connections const& c) {
+      stub = c.stubs[SelectIndex(c)];
+    })) {
+      CreateConnections();
+    }
     return stub;
   }
 
+  /**
+   * Return the next Stub to make a call, and count the call as outstanding.
+   *
+   * The call is counted against the stub's channel until the returned tracker
+   * is destroyed.
+   */
+  TrackedStub StartRpc() {
+    TrackedStub result;
+    while (not WithConnections([this, &result](Connections const& c) {
+      auto index = SelectIndex(c);
+      result.stub = c.stubs[index];
+      result.tracker = RpcTracker(c.outstanding_rpcs[index]);
+    })) {
+      CreateConnections();
+    }
+    return result;
+  }
+
   /// Return the next Channel to make a call.
   ChannelPtr Channel() {
-    std::unique_lock<std::mutex> lk(mu_);
-    CheckConnections(lk);
-    auto channel = channels_[GetIndex(lk)];
+    ChannelPtr channel;
+    while (not WithConnections([this, &channel](Connections const& c) {
+      channel = c.channels[SelectIndex(c)];
+    })) {
+      CreateConnections();
+    }
     return channel;
   }
 
+  /**
+   * Create the channels, if needed, and wait until all of them are connected.
+   *
+   * All the channels start connecting before this function waits on any of
+   * them, so the connections are established in parallel.
+   *
+   * @return the number of channels that were ready before @p deadline.
+   */
+  std::size_t WarmUp(std::chrono::system_clock::time_point deadline) {
+    std::vector<ChannelPtr> channels;
+    while (not WithConnections([&channels](Connections const& c) {
+      channels = c.channels;
+    })) {
+      CreateConnections();
+    }
+    for (auto const& channel : channels) {
+      channel->GetState(true);
+    }
+    std::size_t ready = 0;
+    for (auto const& channel : channels) {
+      if (channel->WaitForConnected(deadline)) {
+        ++ready;
+      }
+    }
+    return ready;
+  }
+
+  /// Return the number of ready channels, without creating or connecting any.
+  std::size_t ready_channel_count() {
+    std::size_t ready = 0;
+    WithConnections([&ready](Connections const& c) {
+      for (auto const& channel : c.channels) {
+        if (channel->GetState(false) == GRPC_CHANNEL_READY) {
+          ++ready;
+        }
+      }
+    });
+    return ready;
+  }
+
  private:
-  /// Make sure the connections exit, and create them if needed.
-  void CheckConnections(std::unique_lock<std::mutex>& lk) {
-    if (not stubs_.empty()) {
-      return;
+  /// An immutable snapshot of the channels, their stubs, and their load.
+  struct Connections {
+    std::vector<ChannelPtr> channels;
+    std::vector<StubPtr> stubs;
+    std::vector<std::shared_ptr<std::atomic<long>>> outstanding_rpcs;
+  };
+
+  /// Expose the connections to the `ChannelSelectionPolicy`.
+  class Pool : public ChannelSelectionPolicy::ChannelPool {
+   public:
+    explicit Pool(Connections const& c) : c_(c) {}
+
+    std::size_t size() const override { return c_.channels.size(); }
+    long outstanding_rpcs(std::size_t index) const override {
+      return c_.outstanding_rpcs[index]->load(std::memory_order_relaxed);
+    }
+    bool is_ready(std::size_t index) const override {
+      return c_.channels[index]->GetState(true) == GRPC_CHANNEL_READY;
+    }
+
+   private:
+    Connections const& c_;
+  };
+
+  /**
+   * Call @p f with the current connections, if any.
+   *
+   * @return false if the connections have not been created.
+   */
+  template <typename Functor>
+  bool WithConnections(Functor&& f) {
+    ReaderRegistry::Guard guard(readers_);
+    Connections const* connections = connections_.load();
+    if (connections == nullptr) {
+      return false;
     }
-    // Release the lock while making remote calls.  gRPC uses the current
+    f(*connections);
+    return true;
+  }
+
+  /// Create the connections, unless some other thread did already.
+  void CreateConnections() {
+    // Do not hold the lock while making remote calls.  gRPC uses the current
     // thread to make remote connections (and probably authenticate), holding
-    // a lock for long operations like that is a bad practice.  Releasing
-    // the lock here can result in wasted work, but that is a smaller problem
-    // than a deadlock or an unbounded priority inversion.
+    // a lock for long operations like that is a bad practice.  This can result
+    // in wasted work, but that is a smaller problem than a deadlock or an
+    // unbounded priority inversion.
     // Note that only one connection per application is created by gRPC, even
     // if multiple threads are calling this function at the same time. gRPC
     // only opens one socket per destination+attributes combo, we artificially
     // introduce attributes in the implementation of CreateChannelPool() to
     // create one socket per element in the pool.
-    lk.unlock();
-    auto channels = CreateChannelPool(Traits::Endpoint(options_), options_);
-    std::vector<StubPtr> tmp;
-    std::transform(channels.begin(), channels.end(), std::back_inserter(tmp),
+    std::unique_ptr<Connections> tmp(new Connections);
+    tmp->channels = CreateChannelPool(Traits::Endpoint(options_), options_);
+    std::transform(tmp->channels.begin(), tmp->channels.end(),
+                   std::back_inserter(tmp->stubs),
                    [](std::shared_ptr<grpc::Channel> ch) {
                      return Interface::NewStub(ch);
                    });
-    lk.lock();
-    if (stubs_.empty()) {
-      channels.swap(channels_);
-      tmp.swap(stubs_);
-      current_index_ = 0;
+    for (std::size_t i = 0; i != tmp->channels.size(); ++i) {
+      tmp->outstanding_rpcs.push_back(std::make_shared<std::atomic<long>>(0));
+    }
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (connections_.load() == nullptr) {
+        connections_.store(tmp.release());
+      }
+    }
+    // Wake up the refresher, it waits for the pool to exist.  Taking the lock
+    // guarantees the notification is not lost if it is about to wait.
+    { std::lock_guard<std::mutex> lk(refresh_mu_); }
+    refresh_cv_.notify_one();
+  }
+
+  /// Replace the channels as they age, until the client is destroyed.
+  void RefreshLoop() {
+    using clock = std::chrono::steady_clock;
+    auto generator = google::cloud::internal::MakeDefaultPRNG();
+    std::uniform_int_distribution<long> distribution(
+        static_cast<long>(options_.min_channel_refresh_period().count()),
+        static_cast<long>(options_.max_channel_refresh_period().count()));
+    auto next_refresh = [&generator, &distribution] {
+      return clock::now() + std::chrono::milliseconds(distribution(generator));
+    };
+
+    // The time to refresh each channel.  The ages are random, so the channels
+    // created together are not all replaced at the same time.
+    std::vector<clock::time_point> deadlines;
+    std::unique_lock<std::mutex> lk(refresh_mu_);
+    while (not shutdown_) {
+      std::size_t size = 0;
+      WithConnections(
+          [&size](Connections const& c) { size = c.channels.size(); });
+      if (deadlines.size() != size) {
+        deadlines.clear();
+        std::generate_n(std::back_inserter(deadlines), size, next_refresh);
+      }
+      if (deadlines.empty()) {
+        // The pool is created by the first RPC, `CreateConnections()` wakes
+        // up this thread when that happens.
+        refresh_cv_.wait(lk);
+        continue;
+      }
+      auto oldest = std::min_element(deadlines.begin(), deadlines.end());
+      if (refresh_cv_.wait_until(lk, *oldest, [this] { return shutdown_; })) {
+        break;
+      }
+      auto index = static_cast<std::size_t>(oldest - deadlines.begin());
+      lk.unlock();
+      // If the replacement cannot connect keep the old channel, it may still
+      // work, and try again later.
+      RefreshChannel(index);
+      lk.lock();
+      *oldest = next_refresh();
     }
   }
 
-  /// Get the current index for round-robin over connections.
-  std::size_t GetIndex(std::unique_lock<std::mutex>& lk) {
-    std::size_t current = current_index_++;
-    // Round robin through the connections.
-    if (current_index_ >= stubs_.size()) {
-      current_index_ = 0;
+  /// Replace the channel at @p index with a new, connected, channel.
+  bool RefreshChannel(std::size_t index) {
+    auto channel = CreateChannel(Traits::Endpoint(options_), options_, index,
+                                 ++generation_);
+    // Connect in short slices, so the destructor does not wait for long.
+    auto const give_up =
+        std::chrono::system_clock::now() + std::chrono::seconds(30);
+    channel->GetState(true);
+    while (not channel->WaitForConnected(std::min(
+        give_up,
+        std::chrono::system_clock::now() + std::chrono::milliseconds(100)))) {
+      std::lock_guard<std::mutex> lk(refresh_mu_);
+      if (shutdown_ or std::chrono::system_clock::now() >= give_up) {
+        return false;
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(mu_);
+    Connections const* current = connections_.load();
+    if (current == nullptr or index >= current->channels.size()) {
+      return false;
     }
-    return current;
+    std::unique_ptr<Connections> tmp(new Connections(*current));
+    tmp->channels[index] = channel;
+    tmp->stubs[index] = Interface::NewStub(channel);
+    tmp->outstanding_rpcs[index] = std::make_shared<std::atomic<long>>(0);
+    // The RPCs started on the old channel hold a reference to it, they drain
+    // there and the channel is released when the last one completes.
+    std::unique_ptr<Connections const> old(
+        connections_.exchange(tmp.release()));
+    readers_.WaitForReaders();
+    return true;
+  }
+
+  /// Use the policy to pick the connection for the next call.
+  std::size_t SelectIndex(Connections const& c) {
+    auto index = policy_->Select(Pool(c)) % c.channels.size();
+    if (auto* span = google::cloud::internal::CurrentSpan()) {
+      span->SetAttribute("channel_index", static_cast<std::int64_t>(index));
+    }
+    return index;
   }
 
  private:
+  /// Serializes the changes to `connections_`.
   std::mutex mu_;
   ClientOptions options_;
-  std::vector<ChannelPtr> channels_;
-  std::vector<StubPtr> stubs_;
-  std::size_t current_index_;
+  std::unique_ptr<ChannelSelectionPolicy> policy_;
+  std::atomic<Connections const*> connections_;
+  ReaderRegistry readers_;
+
+  //@{
+  /// @name The channel refresher state.
+  std::mutex refresh_mu_;
+  std::condition_variable refresh_cv_;
+  bool shutdown_;
+  std::size_t generation_;
+  std::thread refresher_;
+  //@}
 };
 
+/**
+ * Connect all the channels of @p client in a background thread.
+ *
+ * Unlike the futures returned by `std::async()`, the returned future does not
+ * block in its destructor, so applications can discard it.  The background
+ * thread holds a reference to @p client until all the channels are connected,
+ * or @p timeout expires.
+ *
+ * @tparam Client a type with a `std::size_t ConnectAll(milliseconds)` member
+ *     function.
+ */
+template <typename Client>
+std::future<std::size_t> AsyncConnectAll(std::shared_ptr<Client> client,
+                                         std::chrono::milliseconds timeout) {
+  auto ready = std::make_shared<std::promise<std::size_t>>();
+  auto result = ready->get_future();
+  std::thread([client, ready, timeout] {
+    ready->set_value(client->ConnectAll(timeout));
+  }).detach();
+  return result;
+}
+
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
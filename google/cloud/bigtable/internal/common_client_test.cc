@@ -0,0 +1,245 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/common_client.h"
+#include "google/cloud/bigtable/internal/tracked_stream.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <grpcpp/server_builder.h>
+#include <gmock/gmock.h>
+#include <future>
+#include <set>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+
+namespace {
+struct TestTraits {
+  static std::string const& Endpoint(bigtable::ClientOptions& options) {
+    return options.data_endpoint();
+  }
+};
+
+using TestClient =
+    bigtable::internal::CommonClient<TestTraits,
+                                     google::bigtable::v2::Bigtable>;
+
+using Stub = google::bigtable::v2::Bigtable::StubInterface;
+
+bigtable::ClientOptions TestOptions(std::size_t pool_size) {
+  return bigtable::ClientOptions(grpc::InsecureChannelCredentials())
+      .set_data_endpoint("localhost:1")
+      .set_connection_pool_size(pool_size);
+}
+}  // namespace
+
+/// @test Verify that CommonClient round-robins over the channels and stubs.
+TEST(CommonClientTest, RoundRobin) {
+  TestClient client(TestOptions(3));
+
+  std::set<grpc::Channel*> channels;
+  for (int i = 0; i != 6; ++i) {
+    channels.insert(client.Channel().get());
+  }
+  EXPECT_EQ(3U, channels.size());
+
+  std::set<google::bigtable::v2::Bigtable::StubInterface*> stubs;
+  for (int i = 0; i != 6; ++i) {
+    stubs.insert(client.Stub().get());
+  }
+  EXPECT_EQ(3U, stubs.size());
+}
+
+/// @test Verify that CommonClient::reset() creates new connections.
+TEST(CommonClientTest, Reset) {
+  TestClient client(TestOptions(1));
+  auto channel0 = client.Channel();
+  auto stub0 = client.Stub();
+  EXPECT_EQ(channel0.get(), client.Channel().get());
+  EXPECT_EQ(stub0.get(), client.Stub().get());
+
+  client.reset();
+  EXPECT_NE(channel0.get(), client.Channel().get());
+  EXPECT_NE(stub0.get(), client.Stub().get());
+}
+
+/// @test Verify that CommonClient can be used while other threads reset it.
+TEST(CommonClientTest, ConcurrentReset) {
+  TestClient client(TestOptions(2));
+  std::atomic<bool> done(false);
+  std::vector<std::thread> readers;
+  for (int i = 0; i != 4; ++i) {
+    readers.emplace_back([&client, &done]() {
+      while (not done.load()) {
+        EXPECT_TRUE(client.Stub());
+        EXPECT_TRUE(client.Channel());
+      }
+    });
+  }
+  for (int i = 0; i != 20; ++i) {
+    client.reset();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+  EXPECT_TRUE(client.Stub());
+}
+
+/// @test Verify that ReaderRegistry waits for the active readers.
+TEST(CommonClientTest, ReaderRegistryWaitsForReaders) {
+  bigtable::internal::ReaderRegistry registry;
+  // Without readers this should return immediately.
+  registry.WaitForReaders();
+
+  std::atomic<bool> reader_done(false);
+  std::promise<void> entered;
+  std::promise<void> release;
+  std::thread reader([&]() {
+    bigtable::internal::ReaderRegistry::Guard guard(registry);
+    entered.set_value();
+    release.get_future().wait();
+    reader_done.store(true);
+  });
+  entered.get_future().wait();
+
+  std::thread writer([&]() {
+    registry.WaitForReaders();
+    EXPECT_TRUE(reader_done.load());
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  release.set_value();
+  writer.join();
+  reader.join();
+}
+
+/// @test Verify that StartRpc() avoids the channels with outstanding RPCs.
+TEST(CommonClientTest, StartRpcTracksOutstandingRpcs) {
+  // The channels never connect, the policy falls back to the least loaded
+  // channel among all of them.
+  TestClient client(TestOptions(3).set_channel_selection_policy(
+      bigtable::LeastOutstandingRpcsChannelSelection()));
+
+  auto rpc0 = client.StartRpc();
+  auto rpc1 = client.StartRpc();
+  auto rpc2 = client.StartRpc();
+  std::set<Stub*> busy{rpc0.stub.get(), rpc1.stub.get(), rpc2.stub.get()};
+  EXPECT_EQ(3U, busy.size());
+
+  // Complete one RPC, the next RPC must use its channel.
+  Stub* released = rpc1.stub.get();
+  rpc1.tracker = bigtable::internal::RpcTracker();
+  for (int i = 0; i != 5; ++i) {
+    EXPECT_EQ(released, client.StartRpc().stub.get());
+  }
+}
+
+/// @test Verify that tracked streams count the RPC until they finish.
+TEST(CommonClientTest, TrackedStreamReleasesOnFinish) {
+  auto counter = std::make_shared<std::atomic<long>>(0);
+  auto* reader = new bigtable::testing::MockReadRowsReader;
+  EXPECT_CALL(*reader, Read(::testing::_)).WillOnce(::testing::Return(false));
+  EXPECT_CALL(*reader, Finish()).WillOnce(::testing::Return(grpc::Status::OK));
+
+  auto stream = bigtable::internal::MakeTrackedStream(
+      reader->AsUniqueMocked(), bigtable::internal::RpcTracker(counter));
+  EXPECT_EQ(1, counter->load());
+  google::bigtable::v2::ReadRowsResponse response;
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_EQ(1, counter->load());
+  EXPECT_TRUE(stream->Finish().ok());
+  EXPECT_EQ(0, counter->load());
+  stream.reset();
+  EXPECT_EQ(0, counter->load());
+}
+
+/// @test Verify that tracked streams count the RPC until they are deleted.
+TEST(CommonClientTest, TrackedStreamReleasesOnDelete) {
+  auto counter = std::make_shared<std::atomic<long>>(0);
+  auto stream = bigtable::internal::MakeTrackedStream(
+      (new bigtable::testing::MockReadRowsReader)->AsUniqueMocked(),
+      bigtable::internal::RpcTracker(counter));
+  EXPECT_EQ(1, counter->load());
+  stream.reset();
+  EXPECT_EQ(0, counter->load());
+}
+
+/// @test Verify that WarmUp() connects all the channels in the pool.
+TEST(CommonClientTest, WarmUpConnectsAllChannels) {
+  google::bigtable::v2::Bigtable::Service service;
+  int port = 0;
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(),
+                           &port);
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+  ASSERT_NE(0, port);
+
+  TestClient client(TestOptions(3).set_data_endpoint("localhost:" +
+                                                     std::to_string(port)));
+  EXPECT_EQ(0U, client.ready_channel_count());
+  EXPECT_EQ(3U, client.WarmUp(std::chrono::system_clock::now() +
+                              std::chrono::seconds(10)));
+  EXPECT_EQ(3U, client.ready_channel_count());
+
+  server->Shutdown();
+}
+
+/// @test Verify that WarmUp() gives up at the deadline.
+TEST(CommonClientTest, WarmUpTimeout) {
+  TestClient client(TestOptions(2));
+  EXPECT_EQ(0U, client.WarmUp(std::chrono::system_clock::now() +
+                              std::chrono::milliseconds(50)));
+  EXPECT_EQ(0U, client.ready_channel_count());
+}
+
+/// @test Verify that the refresher replaces the channels in the pool.
+TEST(CommonClientTest, RefreshReplacesChannels) {
+  google::bigtable::v2::Bigtable::Service service;
+  int port = 0;
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(),
+                           &port);
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+  ASSERT_NE(0, port);
+
+  TestClient client(
+      TestOptions(1)
+          .set_data_endpoint("localhost:" + std::to_string(port))
+          .set_channel_refresh_period(std::chrono::milliseconds(10),
+                                      std::chrono::milliseconds(20)));
+  auto initial = client.Channel();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (client.Channel() == initial and
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  auto replacement = client.Channel();
+  EXPECT_NE(initial, replacement);
+  // The replacement is connected before it is added to the pool.
+  EXPECT_EQ(GRPC_CHANNEL_READY, replacement->GetState(false));
+
+  server->Shutdown();
+}
+
+/// @test Verify that the refresher keeps the channels that cannot be replaced.
+TEST(CommonClientTest, RefreshKeepsChannelsOnConnectFailure) {
+  TestClient client(TestOptions(1).set_channel_refresh_period(
+      std::chrono::milliseconds(10), std::chrono::milliseconds(20)));
+  auto initial = client.Channel();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(initial, client.Channel());
+}
@@ -0,0 +1,187 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/completion_queue_impl.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/internal/throw_delegate.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+void AsyncTimerFunctor::Set(grpc::CompletionQueue& cq, void* tag) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (alarm_) {
+    alarm_->Set(&cq, timer_.deadline, tag);
+  }
+}
+
+void AsyncTimerFunctor::Fail(CompletionQueue& cq) { Notify(cq, false); }
+
+void AsyncTimerFunctor::Cancel() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (alarm_) {
+    alarm_->Cancel();
+  }
+}
+
+bool AsyncTimerFunctor::Notify(CompletionQueue& cq, bool ok) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    alarm_.reset();
+  }
+  // Release the callback, it often holds a reference to the object that owns
+  // this timer.
+  Callback callback;
+  callback.swap(callback_);
+  callback(cq, timer_, ok);
+  return true;
+}
+
+void CompletionQueueImpl::Run(CompletionQueue& cq) {
+  void* tag;
+  bool ok;
+  while (cq_.Next(&tag, &ok)) {
+    Notify(cq, tag, ok);
+  }
+}
+
+void CompletionQueueImpl::Shutdown() {
+  std::vector<std::shared_ptr<AsyncGrpcOperation>> pending;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_) {
+      return;
+    }
+    shutdown_ = true;
+    ShutdownIfIdle();
+    pending.reserve(pending_ops_.size());
+    for (auto& kv : pending_ops_) {
+      if (starting_ops_.count(kv.first) == 0) {
+        pending.push_back(kv.second);
+      }
+    }
+  }
+  // Cancel the operations outside the lock, the `grpc::CompletionQueue` is
+  // shut down once all of them report their completion. The operations that
+  // are starting are cancelled by `StartOperation()`.
+  for (auto& op : pending) {
+    op->Cancel();
+  }
+}
+
+std::unique_ptr<grpc::Alarm> CompletionQueueImpl::CreateAlarm() const {
+  return bigtable::internal::make_unique<grpc::Alarm>();
+}
+
+bool CompletionQueueImpl::StartOperation(
+    std::shared_ptr<AsyncGrpcOperation> op,
+    std::function<void(void*)> const& start) {
+  void* tag = op.get();
+  auto const key = reinterpret_cast<std::intptr_t>(tag);
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_) {
+      return false;
+    }
+    auto ins = pending_ops_.emplace(key, op);
+    if (not ins.second) {
+      google::cloud::internal::RaiseRuntimeError(
+          "assertion failure: duplicate operation tag in CompletionQueue");
+    }
+    starting_ops_.insert(key);
+  }
+  // Start the operation without holding the lock, so threads starting RPCs do
+  // not serialize on it. `Shutdown()` does not cancel the operations that are
+  // starting, and does not shut down the `grpc::CompletionQueue` until they
+  // have started; if it was called meanwhile, the operation is cancelled here.
+  start(tag);
+  bool cancel;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    starting_ops_.erase(key);
+    cancel = shutdown_;
+    ShutdownIfIdle();
+  }
+  if (cancel) {
+    op->Cancel();
+  }
+  return true;
+}
+
+void CompletionQueueImpl::SimulateCompletion(CompletionQueue& cq,
+                                             AsyncGrpcOperation* op, bool ok) {
+  Notify(cq, op, ok);
+}
+
+std::size_t CompletionQueueImpl::size() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return pending_ops_.size();
+}
+
+std::vector<std::shared_ptr<AsyncGrpcOperation>>
+CompletionQueueImpl::pending_operations() const {
+  std::vector<std::shared_ptr<AsyncGrpcOperation>> result;
+  std::lock_guard<std::mutex> lk(mu_);
+  result.reserve(pending_ops_.size());
+  for (auto const& kv : pending_ops_) {
+    result.push_back(kv.second);
+  }
+  return result;
+}
+
+std::shared_ptr<AsyncGrpcOperation> CompletionQueueImpl::FindOperation(
+    void* tag) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto loc = pending_ops_.find(reinterpret_cast<std::intptr_t>(tag));
+  if (pending_ops_.end() == loc) {
+    google::cloud::internal::RaiseRuntimeError(
+        "assertion failure: searching for async op tag in CompletionQueue");
+  }
+  return loc->second;
+}
+
+void CompletionQueueImpl::Notify(CompletionQueue& cq, void* tag, bool ok) {
+  auto op = FindOperation(tag);
+  if (op->Notify(cq, ok)) {
+    ForgetOperation(tag);
+  }
+}
+
+void CompletionQueueImpl::ForgetOperation(void* tag) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto const num_erased =
+      pending_ops_.erase(reinterpret_cast<std::intptr_t>(tag));
+  if (1 != num_erased) {
+    google::cloud::internal::RaiseRuntimeError(
+        "assertion failure: searching for async op tag when trying to "
+        "unregister");
+  }
+  ShutdownIfIdle();
+}
+
+void CompletionQueueImpl::ShutdownIfIdle() {
+  if (shutdown_ and not cq_shutdown_ and pending_ops_.empty() and
+      starting_ops_.empty()) {
+    cq_shutdown_ = true;
+    cq_.Shutdown();
+  }
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
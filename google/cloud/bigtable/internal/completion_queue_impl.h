@@ -0,0 +1,322 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMPLETION_QUEUE_IMPL_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMPLETION_QUEUE_IMPL_H_
+
+#include "google/cloud/bigtable/async_operation.h"
+#include "google/cloud/bigtable/version.h"
+#include <grpcpp/alarm.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/async_stream.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+class CompletionQueue;
+namespace internal {
+/**
+ * The interface used by `CompletionQueueImpl` to notify completed operations.
+ *
+ * Each asynchronous operation registered in the `CompletionQueueImpl` is
+ * wrapped by an object implementing this interface. The completion queue calls
+ * `Notify()` every time gRPC reports an event for the operation.
+ */
+class AsyncGrpcOperation : public AsyncOperation {
+ public:
+  /**
+   * Notifies the operation that one of its gRPC events completed.
+   *
+   * @param cq the completion queue reporting the event.
+   * @param ok the `ok` value reported by gRPC for the event.
+   * @return true if the operation is finished and can be discarded, false if
+   *     the operation has started another gRPC event with the same tag.
+   */
+  virtual bool Notify(CompletionQueue& cq, bool ok) = 0;
+};
+
+/// Wrap a timer and its callback.
+class AsyncTimerFunctor : public AsyncGrpcOperation {
+ public:
+  using Callback = std::function<void(CompletionQueue&, AsyncTimerResult&,
+                                      bool)>;
+
+  AsyncTimerFunctor(Callback callback,
+                    std::chrono::system_clock::time_point deadline,
+                    std::unique_ptr<grpc::Alarm> alarm)
+      : callback_(std::move(callback)),
+        timer_{deadline},
+        alarm_(std::move(alarm)) {}
+
+  /// Start the timer using @p tag.
+  void Set(grpc::CompletionQueue& cq, void* tag);
+
+  /// Report the timer as cancelled without starting it.
+  void Fail(CompletionQueue& cq);
+
+  void Cancel() override;
+  bool Notify(CompletionQueue& cq, bool ok) override;
+
+ private:
+  std::mutex mu_;
+  Callback callback_;
+  AsyncTimerResult timer_;
+  std::unique_ptr<grpc::Alarm> alarm_;
+};
+
+/**
+ * Wrap a unary RPC and its callback.
+ *
+ * @tparam Response the response type for the RPC.
+ */
+template <typename Response>
+class AsyncUnaryRpcFunctor : public AsyncGrpcOperation {
+ public:
+  using Callback = std::function<void(CompletionQueue&, grpc::ClientContext&,
+                                      Response&, grpc::Status&)>;
+
+  explicit AsyncUnaryRpcFunctor(Callback callback)
+      : callback_(std::move(callback)) {}
+
+  /**
+   * Start the RPC, using the member function @p async_call in @p client.
+   *
+   * @tparam Client the type of the object holding the asynchronous RPC
+   *     wrappers, typically `bigtable::DataClient`.
+   * @tparam MemberFunction the type of the member function in `Client`.
+   * @tparam Request the request type for the RPC.
+   */
+  template <typename Client, typename MemberFunction, typename Request>
+  void Set(Client& client, MemberFunction async_call, Request const& request,
+           std::unique_ptr<grpc::ClientContext> context,
+           grpc::CompletionQueue& cq, void* tag) {
+    context_ = std::move(context);
+    reader_ = (client.*async_call)(context_.get(), request, &cq);
+    reader_->Finish(&response_, &status_, tag);
+  }
+
+  /// Report an error without starting the RPC.
+  void Fail(CompletionQueue& cq, std::unique_ptr<grpc::ClientContext> context,
+            grpc::Status status) {
+    context_ = std::move(context);
+    status_ = std::move(status);
+    Notify(cq, false);
+  }
+
+  void Cancel() override { context_->TryCancel(); }
+
+  bool Notify(CompletionQueue& cq, bool) override {
+    // The callback often holds a reference to the object that owns this
+    // operation, release it once it is no longer needed to break the cycle.
+    Callback callback;
+    callback.swap(callback_);
+    callback(cq, *context_, response_, status_);
+    return true;
+  }
+
+ private:
+  Callback callback_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Response>> reader_;
+  Response response_;
+  grpc::Status status_;
+};
+
+/**
+ * Wrap a streaming read RPC and its callbacks.
+ *
+ * gRPC only allows one outstanding `Read()` per stream, so all the events for
+ * the stream (start, reads, and finish) reuse the same tag.
+ *
+ * @tparam Response the response type for the RPC.
+ */
+template <typename Response>
+class AsyncReadStreamFunctor : public AsyncGrpcOperation {
+ public:
+  using ReadCallback =
+      std::function<void(CompletionQueue&, grpc::ClientContext&, Response&)>;
+  using FinishCallback = std::function<void(
+      CompletionQueue&, grpc::ClientContext&, grpc::Status&)>;
+
+  AsyncReadStreamFunctor(ReadCallback on_read, FinishCallback on_finish)
+      : on_read_(std::move(on_read)),
+        on_finish_(std::move(on_finish)),
+        state_(State::kStarting),
+        tag_(nullptr) {}
+
+  /**
+   * Start the RPC, using the member function @p prepare_call in @p client.
+   *
+   * The member function must return a `grpc::ClientAsyncReaderInterface<>`
+   * that has not been started, i.e., it must wrap one of the `PrepareAsync*`
+   * member functions in the gRPC generated stubs.
+   */
+  template <typename Client, typename MemberFunction, typename Request>
+  void Set(Client& client, MemberFunction prepare_call, Request const& request,
+           std::unique_ptr<grpc::ClientContext> context,
+           grpc::CompletionQueue& cq, void* tag) {
+    context_ = std::move(context);
+    tag_ = tag;
+    reader_ = (client.*prepare_call)(context_.get(), request, &cq);
+    reader_->StartCall(tag_);
+  }
+
+  /// Report an error without starting the RPC.
+  void Fail(CompletionQueue& cq, std::unique_ptr<grpc::ClientContext> context,
+            grpc::Status status) {
+    context_ = std::move(context);
+    status_ = std::move(status);
+    state_ = State::kFinishing;
+    Notify(cq, true);
+  }
+
+  void Cancel() override { context_->TryCancel(); }
+
+  bool Notify(CompletionQueue& cq, bool ok) override {
+    switch (state_) {
+      case State::kStarting:
+      case State::kReading:
+        if (state_ == State::kReading and ok) {
+          on_read_(cq, *context_, response_);
+          response_ = {};
+        }
+        if (not ok) {
+          state_ = State::kFinishing;
+          reader_->Finish(&status_, tag_);
+          return false;
+        }
+        state_ = State::kReading;
+        reader_->Read(&response_, tag_);
+        return false;
+      case State::kFinishing:
+        break;
+    }
+    // Release the callbacks, they often hold a reference to the object that
+    // owns this operation.
+    ReadCallback on_read;
+    on_read.swap(on_read_);
+    FinishCallback on_finish;
+    on_finish.swap(on_finish_);
+    on_finish(cq, *context_, status_);
+    return true;
+  }
+
+ private:
+  enum class State { kStarting, kReading, kFinishing };
+
+  ReadCallback on_read_;
+  FinishCallback on_finish_;
+  State state_;
+  void* tag_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> reader_;
+  Response response_;
+  grpc::Status status_;
+};
+
+/**
+ * The implementation details for `bigtable::CompletionQueue`.
+ *
+ * This class owns the `grpc::CompletionQueue` and keeps the state for all the
+ * pending operations. Each operation is registered using the address of its
+ * wrapper object as the gRPC tag.
+ *
+ * Shutting down the queue cancels all pending operations, and then shuts down
+ * the `grpc::CompletionQueue` once those operations report their completion.
+ * No new operations can be started after `Shutdown()` is called.
+ *
+ * The class has virtual functions so tests can override how timers are
+ * created, and then simulate the completion of operations without a running
+ * gRPC server.
+ */
+class CompletionQueueImpl {
+ public:
+  CompletionQueueImpl() : shutdown_(false), cq_shutdown_(false) {}
+  virtual ~CompletionQueueImpl() = default;
+
+  /// Run the event loop until the queue is shut down.
+  void Run(CompletionQueue& cq);
+
+  /// Cancel all pending operations and shut down the queue.
+  void Shutdown();
+
+  /// Create a new alarm object.
+  virtual std::unique_ptr<grpc::Alarm> CreateAlarm() const;
+
+  /// The underlying gRPC completion queue.
+  grpc::CompletionQueue& cq() { return cq_; }
+
+  /**
+   * Register @p op and start it.
+   *
+   * @param op the operation to register.
+   * @param start a function to start the operation, it receives the tag that
+   *     must be used for all the gRPC events of the operation.
+   * @return false if the queue is shutting down, in which case @p start is
+   *     not called.
+   */
+  bool StartOperation(std::shared_ptr<AsyncGrpcOperation> op,
+                      std::function<void(void*)> const& start);
+
+ protected:
+  /// Simulate the completion of a pending operation, for use in tests.
+  void SimulateCompletion(CompletionQueue& cq, AsyncGrpcOperation* op,
+                          bool ok);
+
+  /// The number of pending operations, for use in tests.
+  std::size_t size() const;
+
+  /// The pending operations, for use in tests.
+  std::vector<std::shared_ptr<AsyncGrpcOperation>> pending_operations() const;
+
+ private:
+  /// Find the operation associated with @p tag.
+  std::shared_ptr<AsyncGrpcOperation> FindOperation(void* tag);
+
+  /// Handle a completion event reported by gRPC, or a simulated one.
+  void Notify(CompletionQueue& cq, void* tag, bool ok);
+
+  /// Remove the operation associated with @p tag.
+  void ForgetOperation(void* tag);
+
+  /// Shut down the `grpc::CompletionQueue` if `Shutdown()` was called and no
+  /// operations are pending, must be called with `mu_` held.
+  void ShutdownIfIdle();
+
+  grpc::CompletionQueue cq_;
+  mutable std::mutex mu_;
+  bool shutdown_;
+  bool cq_shutdown_;
+  std::unordered_map<std::intptr_t, std::shared_ptr<AsyncGrpcOperation>>
+      pending_ops_;
+  /// The tags of the pending operations that `StartOperation()` is starting.
+  std::unordered_set<std::intptr_t> starting_ops_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMPLETION_QUEUE_IMPL_H_
@@ -0,0 +1,43 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/name_interner.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+// Some compilers need an out-of-class definition for odr-used constants.
+std::size_t constexpr NameInterner::DEFAULT_MAX_SIZE;
+
+CellView::Buffer NameInterner::Intern(std::string* name) {
+  auto it = names_->find(*name);
+  if (it != names_->end()) {
+    // The aliasing constructor shares ownership of the table, and the
+    // elements in an unordered_set are stable, even if it rehashes.
+    return CellView::Buffer(names_, &*it);
+  }
+  if (names_->size() >= max_size_) {
+    return std::make_shared<std::string const>(std::move(*name));
+  }
+  it = names_->insert(std::move(*name)).first;
+  return CellView::Buffer(names_, &*it);
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,74 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_NAME_INTERNER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_NAME_INTERNER_H_
+
+#include "google/cloud/bigtable/cell_view.h"
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Stores a single copy of each family and column name seen by a reader.
+ *
+ * A scan typically returns the same few family and column names in every
+ * row. The parser uses this class to share a single buffer for each name
+ * across all the rows returned by a reader, instead of storing a copy in each
+ * row.
+ *
+ * The buffers returned by `Intern()` keep the whole table alive, so the table
+ * stops growing after `max_size` names, and any new names get their own
+ * buffer.
+ *
+ * This class is not thread-safe, but the buffers it returns can be used from
+ * any thread.
+ */
+class NameInterner {
+ public:
+  /// The default value for the maximum number of interned names.
+  static std::size_t constexpr DEFAULT_MAX_SIZE = 4096;
+
+  explicit NameInterner(std::size_t max_size = DEFAULT_MAX_SIZE)
+      : max_size_(max_size),
+        names_(std::make_shared<std::unordered_set<std::string>>()) {}
+
+  /**
+   * Return a shared buffer with the contents of @p name.
+   *
+   * The contents of @p name are moved (and thus @p name is left in an
+   * unspecified state) if the name has not been seen before.
+   */
+  CellView::Buffer Intern(std::string* name);
+
+  /// The number of interned names.
+  std::size_t size() const { return names_->size(); }
+
+ private:
+  std::size_t max_size_;
+  std::shared_ptr<std::unordered_set<std::string>> names_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_NAME_INTERNER_H_
@@ -0,0 +1,60 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/name_interner.h"
+#include <gtest/gtest.h>
+
+using google::cloud::bigtable::internal::NameInterner;
+
+/// @test Verify that the same name is stored only once.
+TEST(NameInternerTest, Simple) {
+  NameInterner interner;
+  std::string n1 = "fam";
+  std::string n2 = "fam";
+  std::string n3 = "col";
+  auto b1 = interner.Intern(&n1);
+  auto b2 = interner.Intern(&n2);
+  auto b3 = interner.Intern(&n3);
+  EXPECT_EQ("fam", *b1);
+  EXPECT_EQ("col", *b3);
+  EXPECT_EQ(b1.get(), b2.get());
+  EXPECT_NE(b1.get(), b3.get());
+  EXPECT_EQ(2U, interner.size());
+}
+
+/// @test Verify that the buffers outlive the interner.
+TEST(NameInternerTest, BuffersOutliveInterner) {
+  std::shared_ptr<std::string const> buffer;
+  {
+    NameInterner interner;
+    std::string name = "qualifier";
+    buffer = interner.Intern(&name);
+  }
+  EXPECT_EQ("qualifier", *buffer);
+}
+
+/// @test Verify that the interner stops growing at its maximum size.
+TEST(NameInternerTest, MaxSize) {
+  NameInterner interner(2);
+  std::vector<std::shared_ptr<std::string const>> buffers;
+  for (auto const* name : {"c0", "c1", "c2", "c2", "c0"}) {
+    std::string tmp = name;
+    buffers.emplace_back(interner.Intern(&tmp));
+  }
+  EXPECT_EQ(2U, interner.size());
+  EXPECT_EQ("c2", *buffers[2]);
+  EXPECT_EQ("c2", *buffers[3]);
+  EXPECT_NE(buffers[2].get(), buffers[3].get());
+  EXPECT_EQ(buffers[0].get(), buffers[4].get());
+}
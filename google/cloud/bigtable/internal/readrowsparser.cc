@@ -22,6 +22,19 @@ inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 using google::bigtable::v2::ReadRowsResponse_CellChunk;
 
+namespace {
+/// Take the contents of @p value, without copying the bytes, and share them.
+CellView::Buffer MakeBuffer(std::string* value) {
+  return std::make_shared<std::string const>(std::move(*value));
+}
+
+CellView::Buffer const& EmptyBuffer() {
+  static auto const* const empty =
+      new CellView::Buffer(std::make_shared<std::string const>());
+  return *empty;
+}
+}  // namespace
+
 void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
                                  grpc::Status& status) {
   if (end_of_stream_) {
@@ -50,11 +63,13 @@ void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
                             "New column family must specify qualifier");
       return;
     }
-    chunk.mutable_family_name()->mutable_value()->swap(cell_.family);
+    cell_.family =
+        interner_->Intern(chunk.mutable_family_name()->mutable_value());
   }
 
   if (chunk.has_qualifier()) {
-    chunk.mutable_qualifier()->mutable_value()->swap(cell_.column);
+    cell_.column =
+        interner_->Intern(chunk.mutable_qualifier()->mutable_value());
   }
 
   if (cell_first_chunk_) {
@@ -154,19 +169,67 @@ Row ReadRowsParser::Next(grpc::Status& status) {
   }
   row_ready_ = false;
 
-  Row row(std::move(row_key_), std::move(cells_));
+  std::vector<Cell> cells;
+  cells.reserve(cells_.size());
+  for (auto& cell : cells_) {
+    cells.emplace_back(row_key_, *cell.family, *cell.column, cell.timestamp,
+                       std::move(cell.value), std::move(cell.labels));
+  }
+  cells_.clear();
+  Row row(std::move(row_key_), std::move(cells));
   row_key_.clear();
 
   return row;
 }
 
-Cell ReadRowsParser::MovePartialToCell() {
-  // The row, family, and column are explicitly copied because the
-  // ReadRows v2 may reuse them in future chunks. See the CellChunk
-  // message comments in bigtable.proto.
-  Cell cell(cell_.row, cell_.family, cell_.column, cell_.timestamp,
-            std::move(cell_.value), std::move(cell_.labels));
+RowView ReadRowsParser::NextView(grpc::Status& status) {
+  if (not row_ready_) {
+    status =
+        grpc::Status(grpc::StatusCode::INTERNAL, "Next with row not ready");
+    return RowView(EmptyBuffer(), {});
+  }
+  row_ready_ = false;
+
+  auto row_key = MakeBuffer(&row_key_);
+  std::vector<CellView> cells;
+  cells.reserve(cells_.size());
+  for (auto& cell : cells_) {
+    cells.emplace_back(row_key, std::move(cell.family), std::move(cell.column),
+                       cell.timestamp, MakeBuffer(&cell.value),
+                       std::move(cell.labels));
+  }
+  cells_.clear();
+  row_key_.clear();
+
+  return RowView(std::move(row_key), std::move(cells));
+}
+
+void ReadRowsParser::AppendNextRow(RowBatch& batch, grpc::Status& status) {
+  if (not row_ready_) {
+    status =
+        grpc::Status(grpc::StatusCode::INTERNAL, "Next with row not ready");
+    return;
+  }
+  row_ready_ = false;
+
+  batch.AddRow(row_key_);
+  for (auto const& cell : cells_) {
+    batch.AddCell(*cell.family, *cell.column, cell.timestamp, cell.value);
+  }
+  cells_.clear();
+  row_key_.clear();
+}
+
+ReadRowsParser::PendingCell ReadRowsParser::MovePartialToCell() {
+  // The family and column are shared, not moved, because the ReadRows v2
+  // may reuse them in future chunks. See the CellChunk message comments in
+  // bigtable.proto.
+  PendingCell cell{cell_.family ? cell_.family : EmptyBuffer(),
+                   cell_.column ? cell_.column : EmptyBuffer(),
+                   cell_.timestamp, std::move(cell_.value),
+                   std::move(cell_.labels)};
   cell_.value.clear();
+  cell_.labels.clear();
   return cell;
 }
 }  // namespace internal
@@ -17,7 +17,10 @@
 
 #include "google/cloud/bigtable/cell.h"
 #include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/internal/name_interner.h"
 #include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_batch.h"
+#include "google/cloud/bigtable/row_view.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
 #include <vector>
 
@@ -50,8 +53,17 @@ namespace internal {
  */
 class ReadRowsParser {
  public:
-  ReadRowsParser()
-      : row_key_(""),
+  ReadRowsParser() : ReadRowsParser(std::make_shared<NameInterner>()) {}
+
+  /**
+   * Create a parser that shares family and column names using @p interner.
+   *
+   * Sharing the interner across the parsers created by a reader (one for each
+   * retry) stores each name only once for all the rows in the reader.
+   */
+  explicit ReadRowsParser(std::shared_ptr<NameInterner> interner)
+      : interner_(std::move(interner)),
+        row_key_(""),
         cells_(),
         cell_first_chunk_(true),
         cell_(),
@@ -97,31 +109,65 @@ class ReadRowsParser {
    */
   virtual Row Next(grpc::Status& status);
 
+  /**
+   * Extract the data in a row without copying it.
+   *
+   * This is an alternative to Next(), the returned row shares the buffers
+   * received in the response chunks: the row key is stored once for all the
+   * cells, the family and qualifier names are shared with all the rows
+   * using the same `NameInterner`, and the values are moved from the chunks.
+   *
+   * @throws std::runtime_error if HasNext() is false.
+   */
+  virtual RowView NextView(grpc::Status& status);
+
+  /**
+   * Append the data in a row to @p batch.
+   *
+   * This is an alternative to Next(), the row data is copied directly into
+   * the batch buffers, without creating any intermediate `Row` or `Cell`
+   * objects.
+   *
+   * @throws std::runtime_error if HasNext() is false.
+   */
+  virtual void AppendNextRow(RowBatch& batch, grpc::Status& status);
+
  private:
   /// Holds partially formed data until a full Row is ready.
   struct ParseCell {
     std::string row;
-    std::string family;
-    std::string column;
+    CellView::Buffer family;
+    CellView::Buffer column;
     int64_t timestamp;
     std::string value;
     std::vector<std::string> labels;
   };
 
   /**
-   * Moves partial results into a Cell class.
+   * A parsed cell, the row key is stored only once in `row_key_`.
    *
-   * Also helps handle string ownership correctly. The value is moved
-   * when converting to a result cell, but the key, family and column
-   * are copied, because they are possibly reused by following cells.
+   * The family and column are shared with the following cells until the
+   * response chunks change them.
    */
-  Cell MovePartialToCell();
+  struct PendingCell {
+    CellView::Buffer family;
+    CellView::Buffer column;
+    int64_t timestamp;
+    std::string value;
+    std::vector<std::string> labels;
+  };
+
+  /// Moves partial results into a PendingCell.
+  PendingCell MovePartialToCell();
+
+  /// Stores the family and column names.
+  std::shared_ptr<NameInterner> interner_;
 
   /// Row key for the current row.
   std::string row_key_;
 
   /// Parsed cells of a yet unfinished row.
-  std::vector<Cell> cells_;
+  std::vector<PendingCell> cells_;
 
   /// Is the next incoming chunk the first in a cell?
   bool cell_first_chunk_;
@@ -142,12 +188,17 @@ class ReadRowsParser {
 /// Factory for creating parser instances, defined for testability.
 class ReadRowsParserFactory {
  public:
+  ReadRowsParserFactory() : interner_(std::make_shared<NameInterner>()) {}
   virtual ~ReadRowsParserFactory() = default;
 
   /// Returns a newly created parser instance.
   virtual std::unique_ptr<ReadRowsParser> Create() {
-    return bigtable::internal::make_unique<ReadRowsParser>();
+    return bigtable::internal::make_unique<ReadRowsParser>(interner_);
   }
+
+ private:
+  /// All the parsers created by this factory share the family/column names.
+  std::shared_ptr<NameInterner> interner_;
 };
 }  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
@@ -23,6 +23,7 @@
 
 using google::bigtable::v2::ReadRowsResponse_CellChunk;
 using google::cloud::bigtable::internal::ReadRowsParser;
+using google::cloud::bigtable::internal::ReadRowsParserFactory;
 
 TEST(ReadRowsParserTest, NoChunksNoRowsSucceeds) {
   grpc::Status status;
@@ -161,6 +162,171 @@ TEST(ReadRowsParserTest, SingleChunkValueIsMoved) {
   EXPECT_EQ(data_ptr, r.cells().begin()->value().data());
 }
 
+TEST(ReadRowsParserTest, NextViewSharesBuffers) {
+  using google::protobuf::TextFormat;
+  ReadRowsParser parser;
+  std::vector<std::string> chunk_strings = {
+      R"(
+    row_key: "RK"
+    family_name: < value: "F">
+    qualifier: < value: "C">
+    timestamp_micros: 42
+    value: "V1"
+    )",
+      R"(
+    timestamp_micros: 41
+    value: "V2"
+    )",
+      R"(
+    qualifier: < value: "D">
+    timestamp_micros: 40
+    commit_row: true
+    )"};
+
+  std::string value(1024, 'a');  // avoid any small value optimizations
+  auto* data_ptr = value.data();
+  grpc::Status status;
+  for (auto const& chunk_string : chunk_strings) {
+    ReadRowsResponse_CellChunk chunk;
+    ASSERT_TRUE(TextFormat::ParseFromString(chunk_string, &chunk));
+    if (chunk.commit_row()) {
+      chunk.mutable_value()->swap(value);
+    }
+    parser.HandleChunk(std::move(chunk), status);
+    EXPECT_TRUE(status.ok());
+  }
+  ASSERT_TRUE(parser.HasNext());
+  auto row = parser.NextView(status);
+  EXPECT_TRUE(status.ok());
+  EXPECT_FALSE(parser.HasNext());
+
+  EXPECT_EQ("RK", row.row_key());
+  ASSERT_EQ(3U, row.cells().size());
+  auto const& c0 = row.cells()[0];
+  auto const& c1 = row.cells()[1];
+  auto const& c2 = row.cells()[2];
+  EXPECT_EQ("V1", c0.value());
+  EXPECT_EQ("V2", c1.value());
+  EXPECT_EQ(42, c0.timestamp().count());
+  EXPECT_EQ(41, c1.timestamp().count());
+  EXPECT_EQ(40, c2.timestamp().count());
+
+  // All the cells share the row key, the first two share the column too.
+  EXPECT_EQ(row.row_key_buffer(), c0.row_key_buffer());
+  EXPECT_EQ(row.row_key_buffer(), c2.row_key_buffer());
+  EXPECT_EQ(c0.family_name_buffer(), c2.family_name_buffer());
+  EXPECT_EQ(c0.column_qualifier_buffer(), c1.column_qualifier_buffer());
+  EXPECT_EQ("C", c1.column_qualifier());
+  EXPECT_EQ("D", c2.column_qualifier());
+
+  // The value is moved from the chunk, not copied.
+  EXPECT_EQ(data_ptr, c2.value().data());
+
+  auto copy = row.ToRow();
+  EXPECT_EQ("RK", copy.row_key());
+  ASSERT_EQ(3U, copy.cells().size());
+  EXPECT_EQ("D", copy.cells()[2].column_qualifier());
+  EXPECT_EQ(std::string(1024, 'a'), copy.cells()[2].value());
+}
+
+TEST(ReadRowsParserTest, NamesAreSharedAcrossRowsAndParsers) {
+  using google::protobuf::TextFormat;
+  ReadRowsParserFactory factory;
+  std::vector<google::cloud::bigtable::RowView> rows;
+  for (auto const* key : {"R1", "R2"}) {
+    // Each row uses a new parser, as RowReader does when it retries.
+    auto parser = factory.Create();
+    ReadRowsResponse_CellChunk chunk;
+    ASSERT_TRUE(TextFormat::ParseFromString(R"(
+      family_name: < value: "F">
+      qualifier: < value: "C">
+      timestamp_micros: 42
+      value: "V"
+      commit_row: true
+      )",
+                                            &chunk));
+    chunk.set_row_key(key);
+    grpc::Status status;
+    parser->HandleChunk(std::move(chunk), status);
+    EXPECT_TRUE(status.ok());
+    ASSERT_TRUE(parser->HasNext());
+    rows.emplace_back(parser->NextView(status));
+    EXPECT_TRUE(status.ok());
+  }
+  ASSERT_EQ(1U, rows[0].cells().size());
+  ASSERT_EQ(1U, rows[1].cells().size());
+  auto const& c0 = rows[0].cells()[0];
+  auto const& c1 = rows[1].cells()[0];
+  EXPECT_EQ("R1", c0.row_key());
+  EXPECT_EQ("R2", c1.row_key());
+  EXPECT_EQ(c0.family_name_buffer().get(), c1.family_name_buffer().get());
+  EXPECT_EQ(c0.column_qualifier_buffer().get(),
+            c1.column_qualifier_buffer().get());
+}
+
+TEST(ReadRowsParserTest, AppendNextRowFillsBatch) {
+  using google::protobuf::TextFormat;
+  ReadRowsParser parser;
+  std::vector<std::string> chunk_strings = {
+      R"(
+    row_key: "R1"
+    family_name: < value: "F">
+    qualifier: < value: "C1">
+    timestamp_micros: 42
+    value: "V1"
+    )",
+      R"(
+    qualifier: < value: "C2">
+    timestamp_micros: 41
+    value: "V2"
+    commit_row: true
+    )",
+      R"(
+    row_key: "R2"
+    family_name: < value: "G">
+    qualifier: < value: "C3">
+    timestamp_micros: 40
+    value: "V3"
+    commit_row: true
+    )"};
+
+  google::cloud::bigtable::RowBatch batch;
+  grpc::Status status;
+  for (auto const& chunk_string : chunk_strings) {
+    ReadRowsResponse_CellChunk chunk;
+    ASSERT_TRUE(TextFormat::ParseFromString(chunk_string, &chunk));
+    parser.HandleChunk(std::move(chunk), status);
+    EXPECT_TRUE(status.ok());
+    if (parser.HasNext()) {
+      parser.AppendNextRow(batch, status);
+      EXPECT_TRUE(status.ok());
+    }
+  }
+  EXPECT_FALSE(parser.HasNext());
+
+  ASSERT_EQ(2U, batch.size());
+  EXPECT_EQ("R1R2", batch.row_keys());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 3}), batch.cell_offsets());
+  EXPECT_EQ("FFG", batch.families());
+  EXPECT_EQ("C1C2C3", batch.qualifiers());
+  EXPECT_EQ("V1V2V3", batch.values());
+  EXPECT_EQ((std::vector<std::int64_t>{42, 41, 40}), batch.timestamps());
+
+  parser.AppendNextRow(batch, status);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(2U, batch.size());
+}
+
+TEST(ReadRowsParserTest, NextViewWithNoDataFails) {
+  ReadRowsParser parser;
+  grpc::Status status;
+  parser.HandleEndOfStream(status);
+  EXPECT_TRUE(status.ok());
+  auto row = parser.NextView(status);
+  EXPECT_FALSE(status.ok());
+  EXPECT_TRUE(row.cells().empty());
+}
+
 // **** Acceptance tests helpers ****
 
 namespace google {
@@ -0,0 +1,108 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/row_prefetch_queue.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+bool RowPrefetchQueue::Push(Row row) {
+  auto size = RowSize(row);
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this, size] {
+    return cancelled_ or rows_.empty() or
+           (rows_.size() < max_rows_ and bytes_ + size <= max_bytes_);
+  });
+  if (cancelled_) {
+    return false;
+  }
+  rows_.emplace_back(std::move(row));
+  bytes_ += size;
+  cv_.notify_all();
+  return true;
+}
+
+void RowPrefetchQueue::Close(grpc::Status status, bool unretriable) {
+  std::unique_lock<std::mutex> lk(mu_);
+  closed_ = true;
+  status_ = std::move(status);
+  unretriable_ = unretriable;
+  context_ = nullptr;
+  cv_.notify_all();
+}
+
+bool RowPrefetchQueue::Pop(OptionalRow& row) {
+  row.reset();
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return cancelled_ or closed_ or not rows_.empty(); });
+  if (rows_.empty()) {
+    return false;
+  }
+  bytes_ -= RowSize(rows_.front());
+  row.emplace(std::move(rows_.front()));
+  rows_.pop_front();
+  cv_.notify_all();
+  return true;
+}
+
+void RowPrefetchQueue::Cancel() {
+  std::unique_lock<std::mutex> lk(mu_);
+  cancelled_ = true;
+  rows_.clear();
+  bytes_ = 0;
+  if (context_ != nullptr) {
+    context_->TryCancel();
+  }
+  cv_.notify_all();
+}
+
+void RowPrefetchQueue::RegisterContext(grpc::ClientContext* context) {
+  std::unique_lock<std::mutex> lk(mu_);
+  context_ = context;
+  if (cancelled_) {
+    context_->TryCancel();
+  }
+}
+
+bool RowPrefetchQueue::cancelled() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return cancelled_;
+}
+
+grpc::Status RowPrefetchQueue::status() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return status_;
+}
+
+bool RowPrefetchQueue::unretriable() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return unretriable_;
+}
+
+std::size_t RowPrefetchQueue::RowSize(Row const& row) {
+  std::size_t size = row.row_key().size();
+  for (auto const& cell : row.cells()) {
+    size += cell.family_name().size() + cell.column_qualifier().size() +
+            cell.value().size() + sizeof(cell);
+  }
+  return size;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,114 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_PREFETCH_QUEUE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_PREFETCH_QUEUE_H_
+
+#include "google/cloud/bigtable/internal/rowreaderiterator.h"
+#include "google/cloud/bigtable/row.h"
+#include <grpcpp/grpcpp.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * A bounded queue of rows between a producer and a consumer thread.
+ *
+ * `RowReader` uses this class to read rows in a background thread (the
+ * producer) while the application processes them (the consumer). The queue is
+ * bounded by the number of rows and by their (approximate) size in bytes; a
+ * single row larger than the byte limit is still accepted if the queue is
+ * empty.
+ *
+ * The queue also coordinates cancellation: the producer registers the
+ * `grpc::ClientContext` of each request, and `Cancel()` cancels the current
+ * one, as well as any context registered afterwards.
+ */
+class RowPrefetchQueue {
+ public:
+  RowPrefetchQueue(std::size_t max_rows, std::size_t max_bytes)
+      : max_rows_(max_rows),
+        max_bytes_(max_bytes),
+        bytes_(0),
+        closed_(false),
+        cancelled_(false),
+        unretriable_(false),
+        context_(nullptr) {}
+
+  /**
+   * Add a row to the queue, blocking while the queue is full.
+   *
+   * @return false if the queue was cancelled, the row is discarded.
+   */
+  bool Push(Row row);
+
+  /**
+   * Signal that the producer has no more rows.
+   *
+   * @param status the final status of the read.
+   * @param unretriable true if the read failed with an error that the retry
+   *     policy did not retry, the consumer may want to raise an exception.
+   */
+  void Close(grpc::Status status, bool unretriable);
+
+  /**
+   * Take the next row from the queue, blocking until one is available.
+   *
+   * @return false if the queue is closed and there are no more rows.
+   */
+  bool Pop(OptionalRow& row);
+
+  /// Cancel the queue and the current request, wakes up any blocked thread.
+  void Cancel();
+
+  /// Set the context of the current request, cancels it if needed.
+  void RegisterContext(grpc::ClientContext* context);
+
+  bool cancelled() const;
+
+  /// The status passed to Close(), OK if the queue is not closed.
+  grpc::Status status() const;
+
+  /// True if Close() was called with `unretriable == true`.
+  bool unretriable() const;
+
+  /// The size of a row, as counted towards the byte limit.
+  static std::size_t RowSize(Row const& row);
+
+ private:
+  std::size_t const max_rows_;
+  std::size_t const max_bytes_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Row> rows_;
+  std::size_t bytes_;
+  bool closed_;
+  bool cancelled_;
+  bool unretriable_;
+  grpc::Status status_;
+  grpc::ClientContext* context_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ROW_PREFETCH_QUEUE_H_
@@ -0,0 +1,107 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/row_prefetch_queue.h"
+#include <gtest/gtest.h>
+#include <future>
+
+namespace bigtable = google::cloud::bigtable;
+using bigtable::internal::OptionalRow;
+using bigtable::internal::RowPrefetchQueue;
+
+namespace {
+bigtable::Row MakeRow(std::string key, std::size_t value_size) {
+  return bigtable::Row(
+      key, {bigtable::Cell(key, "fam", "col", 0, std::string(value_size, 'x'),
+                           {})});
+}
+}  // namespace
+
+/// @test Verify that rows are returned in order and the status is reported.
+TEST(RowPrefetchQueueTest, Simple) {
+  RowPrefetchQueue queue(10, 1024 * 1024);
+  EXPECT_TRUE(queue.Push(MakeRow("r1", 10)));
+  EXPECT_TRUE(queue.Push(MakeRow("r2", 10)));
+  queue.Close(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again"), true);
+
+  OptionalRow row;
+  ASSERT_TRUE(queue.Pop(row));
+  EXPECT_EQ("r1", row->row_key());
+  ASSERT_TRUE(queue.Pop(row));
+  EXPECT_EQ("r2", row->row_key());
+  EXPECT_FALSE(queue.Pop(row));
+  EXPECT_FALSE(row.has_value());
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, queue.status().error_code());
+  EXPECT_TRUE(queue.unretriable());
+}
+
+/// @test Verify that Push() blocks when the row limit is reached.
+TEST(RowPrefetchQueueTest, BlocksOnMaxRows) {
+  RowPrefetchQueue queue(1, 1024 * 1024);
+  EXPECT_TRUE(queue.Push(MakeRow("r1", 10)));
+  auto pushed = std::async(std::launch::async,
+                           [&queue] { return queue.Push(MakeRow("r2", 10)); });
+  EXPECT_EQ(std::future_status::timeout,
+            pushed.wait_for(std::chrono::milliseconds(50)));
+
+  OptionalRow row;
+  ASSERT_TRUE(queue.Pop(row));
+  EXPECT_EQ("r1", row->row_key());
+  EXPECT_TRUE(pushed.get());
+  ASSERT_TRUE(queue.Pop(row));
+  EXPECT_EQ("r2", row->row_key());
+}
+
+/// @test Verify that Push() blocks when the byte limit is reached.
+TEST(RowPrefetchQueueTest, BlocksOnMaxBytes) {
+  auto row_size = RowPrefetchQueue::RowSize(MakeRow("r1", 1000));
+  RowPrefetchQueue queue(100, row_size + 10);
+  // A row larger than the limit is accepted if the queue is empty.
+  EXPECT_TRUE(queue.Push(MakeRow("r0", 2000)));
+  auto pushed = std::async(std::launch::async, [&queue] {
+    return queue.Push(MakeRow("r1", 1000));
+  });
+  EXPECT_EQ(std::future_status::timeout,
+            pushed.wait_for(std::chrono::milliseconds(50)));
+
+  OptionalRow row;
+  ASSERT_TRUE(queue.Pop(row));
+  EXPECT_EQ("r0", row->row_key());
+  EXPECT_TRUE(pushed.get());
+}
+
+/// @test Verify that Cancel() unblocks the producer and the consumer.
+TEST(RowPrefetchQueueTest, Cancel) {
+  RowPrefetchQueue queue(1, 1024 * 1024);
+  EXPECT_TRUE(queue.Push(MakeRow("r1", 10)));
+  auto pushed = std::async(std::launch::async,
+                           [&queue] { return queue.Push(MakeRow("r2", 10)); });
+  queue.Cancel();
+  EXPECT_FALSE(pushed.get());
+  EXPECT_TRUE(queue.cancelled());
+
+  OptionalRow row;
+  EXPECT_FALSE(queue.Pop(row));
+}
+
+/// @test Verify that contexts registered after Cancel() are cancelled.
+TEST(RowPrefetchQueueTest, RegisterContextAfterCancel) {
+  RowPrefetchQueue queue(1, 1024 * 1024);
+  grpc::ClientContext before;
+  queue.RegisterContext(&before);
+  queue.Cancel();
+  grpc::ClientContext after;
+  queue.RegisterContext(&after);
+  EXPECT_TRUE(queue.cancelled());
+}
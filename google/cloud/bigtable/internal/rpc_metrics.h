@@ -0,0 +1,56 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RPC_METRICS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RPC_METRICS_H_
+
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/operation_metrics.h"
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Return the metrics for the RPC using @p Request.
+ *
+ * The metrics are named after the request, for example,
+ * `bigtable.CheckAndMutateRow.latency` for `CheckAndMutateRowRequest`.
+ *
+ * @tparam Request the protobuf message type of the RPC request.
+ */
+template <typename Request>
+google::cloud::internal::OperationMetrics& RpcMetrics() {
+  static auto* const metrics = [] {
+    std::string name(Request::descriptor()->name());
+    std::string const suffix = "Request";
+    if (name.size() > suffix.size() and
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+            0) {
+      name.resize(name.size() - suffix.size());
+    }
+    return new google::cloud::internal::OperationMetrics("bigtable." + name);
+  }();
+  return *metrics;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RPC_METRICS_H_
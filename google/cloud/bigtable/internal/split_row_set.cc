@@ -0,0 +1,83 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/split_row_set.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+std::vector<RowSet> SplitRowSet(RowSet const& row_set,
+                                std::vector<std::string> split_points) {
+  split_points.erase(
+      std::remove(split_points.begin(), split_points.end(), std::string()),
+      split_points.end());
+  std::sort(split_points.begin(), split_points.end());
+  split_points.erase(std::unique(split_points.begin(), split_points.end()),
+                     split_points.end());
+
+  std::vector<RowSet> shards;
+  auto add_shard = [&shards, &row_set](bigtable::RowRange const& range) {
+    auto shard = row_set.Intersect(range);
+    if (not shard.IsEmpty()) {
+      shards.emplace_back(std::move(shard));
+    }
+  };
+  if (split_points.empty()) {
+    add_shard(bigtable::RowRange::InfiniteRange());
+    return shards;
+  }
+  add_shard(bigtable::RowRange::RightOpen("", split_points.front()));
+  for (std::size_t i = 1; i != split_points.size(); ++i) {
+    add_shard(
+        bigtable::RowRange::RightOpen(split_points[i - 1], split_points[i]));
+  }
+  add_shard(bigtable::RowRange::StartingAt(split_points.back()));
+  return shards;
+}
+
+std::vector<RowSet> SplitRowKeys(std::vector<std::string> row_keys,
+                                 std::size_t max_bytes) {
+  std::sort(row_keys.begin(), row_keys.end());
+  row_keys.erase(std::unique(row_keys.begin(), row_keys.end()),
+                 row_keys.end());
+
+  std::vector<RowSet> result;
+  RowSet current;
+  std::size_t current_bytes = 0;
+  for (auto& key : row_keys) {
+    // Count at least one byte for each key, the empty key still takes space
+    // in the request.
+    auto const key_bytes = (std::max)(key.size(), std::size_t(1));
+    if (current_bytes != 0 and current_bytes + key_bytes > max_bytes) {
+      result.emplace_back(std::move(current));
+      current = RowSet();
+      current_bytes = 0;
+    }
+    current_bytes += key_bytes;
+    current.Append(std::move(key));
+  }
+  if (current_bytes != 0) {
+    result.emplace_back(std::move(current));
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
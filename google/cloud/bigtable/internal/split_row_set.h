@@ -0,0 +1,58 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SPLIT_ROW_SET_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SPLIT_ROW_SET_H_
+
+#include "google/cloud/bigtable/row_set.h"
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Split @p row_set into disjoint shards at the given split points.
+ *
+ * The split points are typically the row keys returned by
+ * `Table::SampleRows()`. They need not be sorted or unique, and the empty key
+ * (which `SampleRows()` uses to represent the end of the table) is ignored.
+ * The split points partition the key space into `[-inf, k1)`, `[k1, k2)`, ...,
+ * `[kn, +inf)`; each shard is the intersection of @p row_set with one of these
+ * ranges. Empty shards are not returned, and the shards are returned in row
+ * key order.
+ */
+std::vector<RowSet> SplitRowSet(RowSet const& row_set,
+                                std::vector<std::string> split_points);
+
+/**
+ * Split a list of row keys into row sets of bounded size.
+ *
+ * The keys are sorted and deduplicated, and then split into consecutive
+ * groups whose keys add up to at most @p max_bytes.  A key larger than
+ * @p max_bytes is placed in a group by itself.  The groups are returned in row
+ * key order.
+ */
+std::vector<RowSet> SplitRowKeys(std::vector<std::string> row_keys,
+                                 std::size_t max_bytes);
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SPLIT_ROW_SET_H_
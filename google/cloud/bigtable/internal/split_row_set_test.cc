@@ -0,0 +1,105 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/split_row_set.h"
+#include <gmock/gmock.h>
+
+namespace bigtable = google::cloud::bigtable;
+using bigtable::RowRange;
+using bigtable::RowSet;
+using bigtable::internal::SplitRowKeys;
+using bigtable::internal::SplitRowSet;
+
+/// Define helper types and functions for this test.
+namespace {
+/// Return the ranges in @p shards, to simplify the comparisons.
+std::vector<RowRange> Ranges(std::vector<RowSet> const& shards) {
+  std::vector<RowRange> result;
+  for (auto const& s : shards) {
+    auto proto = s.as_proto();
+    for (auto const& r : proto.row_ranges()) {
+      result.emplace_back(RowRange(r));
+    }
+  }
+  return result;
+}
+}  // anonymous namespace
+
+/// @test Verify that a RowSet with all rows is split at each point.
+TEST(SplitRowSetTest, AllRows) {
+  auto shards = SplitRowSet(RowSet(), {"c", "a", "b", "", "b"});
+  ASSERT_EQ(4U, shards.size());
+  auto ranges = Ranges(shards);
+  ASSERT_EQ(4U, ranges.size());
+  EXPECT_EQ(RowRange::RightOpen("", "a"), ranges[0]);
+  EXPECT_EQ(RowRange::RightOpen("a", "b"), ranges[1]);
+  EXPECT_EQ(RowRange::RightOpen("b", "c"), ranges[2]);
+  EXPECT_EQ(RowRange::StartingAt("c"), ranges[3]);
+}
+
+/// @test Verify that no split points return a single shard.
+TEST(SplitRowSetTest, NoSplitPoints) {
+  auto shards = SplitRowSet(RowSet(RowRange::Range("a", "k")), {""});
+  ASSERT_EQ(1U, shards.size());
+  auto ranges = Ranges(shards);
+  ASSERT_EQ(1U, ranges.size());
+  EXPECT_EQ(RowRange::Range("a", "k"), ranges[0]);
+}
+
+/// @test Verify that shards outside the RowSet are discarded.
+TEST(SplitRowSetTest, DiscardEmptyShards) {
+  auto shards = SplitRowSet(RowSet(RowRange::Range("d", "f")),
+                            {"b", "c", "e", "g", "h"});
+  ASSERT_EQ(2U, shards.size());
+  auto ranges = Ranges(shards);
+  ASSERT_EQ(2U, ranges.size());
+  EXPECT_EQ(RowRange::Range("d", "e"), ranges[0]);
+  EXPECT_EQ(RowRange::Range("e", "f"), ranges[1]);
+}
+
+/// @test Verify that row keys are assigned to the right shard.
+TEST(SplitRowSetTest, RowKeys) {
+  auto shards = SplitRowSet(RowSet("a1", "b1", "b2", "c1"), {"b", "c"});
+  ASSERT_EQ(3U, shards.size());
+  EXPECT_THAT(shards[0].as_proto().row_keys(), ::testing::ElementsAre("a1"));
+  EXPECT_THAT(shards[1].as_proto().row_keys(),
+              ::testing::ElementsAre("b1", "b2"));
+  EXPECT_THAT(shards[2].as_proto().row_keys(), ::testing::ElementsAre("c1"));
+}
+
+/// @test Verify that row keys are sorted, deduplicated and split by size.
+TEST(SplitRowSetTest, SplitRowKeys) {
+  auto shards = SplitRowKeys({"d1", "a1", "c1", "b1", "a1", "e1"}, 4);
+  ASSERT_EQ(3U, shards.size());
+  EXPECT_THAT(shards[0].as_proto().row_keys(),
+              ::testing::ElementsAre("a1", "b1"));
+  EXPECT_THAT(shards[1].as_proto().row_keys(),
+              ::testing::ElementsAre("c1", "d1"));
+  EXPECT_THAT(shards[2].as_proto().row_keys(), ::testing::ElementsAre("e1"));
+}
+
+/// @test Verify that keys larger than the limit get their own shard.
+TEST(SplitRowSetTest, SplitRowKeysLargeKey) {
+  auto shards = SplitRowKeys({"a", "bbbbbb", "c"}, 4);
+  ASSERT_EQ(3U, shards.size());
+  EXPECT_THAT(shards[0].as_proto().row_keys(), ::testing::ElementsAre("a"));
+  EXPECT_THAT(shards[1].as_proto().row_keys(),
+              ::testing::ElementsAre("bbbbbb"));
+  EXPECT_THAT(shards[2].as_proto().row_keys(), ::testing::ElementsAre("c"));
+}
+
+/// @test Verify that an empty key list produces no shards.
+TEST(SplitRowSetTest, SplitRowKeysEmpty) {
+  EXPECT_TRUE(SplitRowKeys({}, 4).empty());
+}
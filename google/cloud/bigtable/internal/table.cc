@@ -13,9 +13,24 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/bigtable/internal/arena_message.h"
+#include "google/cloud/bigtable/internal/async_bulk_apply.h"
+#include "google/cloud/bigtable/internal/async_retry_unary_rpc.h"
+#include "google/cloud/bigtable/internal/async_row_reader.h"
 #include "google/cloud/bigtable/internal/bulk_mutator.h"
 #include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/internal/rpc_metrics.h"
+#include "google/cloud/bigtable/internal/split_row_set.h"
 #include "google/cloud/bigtable/internal/unary_client_utils.h"
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/internal/timer_service.h"
+#include "google/cloud/tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 
@@ -31,6 +46,45 @@ using ClientUtils = bigtable::internal::noex::UnaryClientUtils<DataClient>;
 static_assert(std::is_copy_assignable<bigtable::noex::Table>::value,
               "bigtable::noex::Table must be CopyAssignable");
 
+namespace {
+/// Convert the row in a `ReadModifyWriteRowResponse` to a `bigtable::Row`.
+Row TransformReadModifyWriteRowResponse(
+    btproto::ReadModifyWriteRowResponse& response) {
+  std::vector<bigtable::Cell> cells;
+  auto& row = *response.mutable_row();
+  for (auto& family : *row.mutable_families()) {
+    for (auto& column : *family.mutable_columns()) {
+      for (auto& cell : *column.mutable_cells()) {
+        std::vector<std::string> labels;
+        std::move(cell.mutable_labels()->begin(), cell.mutable_labels()->end(),
+                  std::back_inserter(labels));
+        bigtable::Cell new_cell(row.key(), family.name(), column.qualifier(),
+                                cell.timestamp_micros(),
+                                std::move(*cell.mutable_value()),
+                                std::move(labels));
+
+        cells.emplace_back(std::move(new_cell));
+      }
+    }
+  }
+
+  return Row(std::move(*row.mutable_key()), std::move(cells));
+}
+
+/// Return the row keys in @p mut, the mutations are left unchanged.
+std::vector<std::string> BulkMutationRowKeys(BulkMutation& mut) {
+  btproto::MutateRowsRequest request;
+  mut.MoveTo(&request);
+  std::vector<std::string> row_keys;
+  row_keys.reserve(request.entries_size());
+  for (auto& entry : *request.mutable_entries()) {
+    row_keys.push_back(entry.row_key());
+    mut.emplace_back(SingleRowMutation(std::move(entry)));
+  }
+  return row_keys;
+}
+}  // anonymous namespace
+
 // Call the `google.bigtable.v2.Bigtable.MutateRow` RPC repeatedly until
 // successful, or until the policies in effect tell us to stop.
 std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
@@ -53,6 +107,14 @@ std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
                     return idempotent_policy->is_idempotent(m);
                   });
 
+  auto& metrics =
+      bigtable::internal::RpcMetrics<btproto::MutateRowRequest>();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
+  auto const request_bytes = request.ByteSizeLong();
+  google::cloud::internal::Span span(metrics.name);
+  std::int64_t attempt = 0;
+
   btproto::MutateRowResponse response;
   std::vector<FailedMutation> failures;
   grpc::Status status;
@@ -61,34 +123,148 @@ std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
     rpc_policy->Setup(client_context);
     backoff_policy->Setup(client_context);
     metadata_update_policy_.Setup(client_context);
-    status = client_->MutateRow(&client_context, request, &response);
+    metrics.attempts.Increment();
+    metrics.bytes_sent.Increment(request_bytes);
+    {
+      google::cloud::internal::Span attempt_span("attempt", span);
+      attempt_span.SetAttribute("attempt", ++attempt);
+      attempt_span.SetAttribute("bytes_sent",
+                                static_cast<std::int64_t>(request_bytes));
+      google::cloud::internal::CurrentSpanScope scope(attempt_span);
+      google::cloud::internal::LatencyTimer attempt_timer(
+          metrics.attempt_latency);
+      status = client_->MutateRow(&client_context, request, &response);
+      attempt_span.SetStatus(status.error_code(), status.error_message());
+    }
+    span.SetAttribute("attempts", attempt);
+    span.SetStatus(status.error_code(), status.error_message());
     if (status.ok()) {
+      google::cloud::internal::DefaultRetryBudget().OnSuccess();
+      InvalidateCachedRow(request.row_key());
       return failures;
     }
     // It is up to the policy to terminate this loop, it could run
     // forever, but that would be a bad policy (pun intended).
-    if (not rpc_policy->OnFailure(status) or not is_idempotent) {
+    bool const retry = rpc_policy->OnFailure(status) and is_idempotent;
+    bool const budget_exhausted =
+        retry and not google::cloud::internal::DefaultRetryBudget().TryRetry();
+    if (not retry or budget_exhausted) {
+      metrics.errors.Increment();
+      // The mutation may have been applied, even if the RPC failed.
+      InvalidateCachedRow(request.row_key());
       google::rpc::Status rpc_status;
       rpc_status.set_code(status.error_code());
-      rpc_status.set_message(status.error_message());
+      rpc_status.set_message(
+          budget_exhausted
+              ? std::string(google::cloud::internal::kRetryBudgetExhausted) +
+                    ": " + status.error_message()
+              : status.error_message());
       failures.emplace_back(SingleRowMutation(std::move(request)), rpc_status,
                             0);
-      status = grpc::Status(
-          status.error_code(),
-          "Permanent (or too many transient) errors in Table::Apply()");
       return failures;
     }
+    metrics.retries.Increment();
     auto delay = backoff_policy->OnCompletion(status);
+    google::cloud::internal::Span backoff_span("backoff", span);
+    backoff_span.SetAttribute("delay_us", delay);
     std::this_thread::sleep_for(delay);
   }
 }
 
+// Split the mutation in pieces that fit in a single request, and apply the
+// pieces concurrently.  Each piece has its own retry loop, so a piece that
+// fails does not stop the others.
+std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
+                                             grpc::Status& status) {
+  // The attempts, and their latency, are recorded by each stream in the
+  // `BulkMutator`.
+  auto& metrics =
+      bigtable::internal::RpcMetrics<btproto::MutateRowsRequest>();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
+  // The `BulkMutator` creates the attempt spans as children of the current
+  // span, in each thread applying a piece.
+  google::cloud::internal::Span span(metrics.name);
+  // Any of the mutations may have been applied, even if the RPCs failed.
+  std::vector<std::string> row_keys;
+  if (row_cache_) {
+    row_keys = BulkMutationRowKeys(mut);
+  }
+  auto invalidate = [this, &row_keys] {
+    for (auto const& row_key : row_keys) {
+      InvalidateCachedRow(row_key);
+    }
+  };
+  auto pieces = bigtable::internal::SplitBulkMutation(
+      std::move(mut), bulk_apply_options_.max_mutations_per_request(),
+      bulk_apply_options_.max_request_bytes());
+  span.SetAttribute("pieces", static_cast<std::int64_t>(pieces.size()));
+  status = grpc::Status::OK;
+  if (pieces.size() == 1U) {
+    google::cloud::internal::CurrentSpanScope scope(span);
+    auto failures =
+        BulkApplyPiece(std::move(pieces.front().mutation),
+                       pieces.front().original_index_offset, status);
+    invalidate();
+    if (not failures.empty()) {
+      metrics.errors.Increment();
+    }
+    span.SetAttribute("failures", static_cast<std::int64_t>(failures.size()));
+    span.SetStatus(status.error_code(), status.error_message());
+    return failures;
+  }
+
+  std::atomic<std::size_t> next_piece(0);
+  std::mutex mu;
+  std::vector<FailedMutation> failures;
+  auto worker = [&]() {
+    google::cloud::internal::CurrentSpanScope scope(span);
+    for (auto piece = next_piece++; piece < pieces.size();
+         piece = next_piece++) {
+      grpc::Status piece_status;
+      auto piece_failures =
+          BulkApplyPiece(std::move(pieces[piece].mutation),
+                         pieces[piece].original_index_offset, piece_status);
+      std::lock_guard<std::mutex> lk(mu);
+      std::move(piece_failures.begin(), piece_failures.end(),
+                std::back_inserter(failures));
+      if (status.ok()) {
+        status = std::move(piece_status);
+      }
+    }
+  };
+
+  auto const thread_count = (std::min)(
+      (std::max)(bulk_apply_options_.max_parallelism(), std::size_t(1)),
+      pieces.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  invalidate();
+  std::sort(failures.begin(), failures.end(),
+            [](FailedMutation const& a, FailedMutation const& b) {
+              return a.original_index() < b.original_index();
+            });
+  if (not failures.empty()) {
+    metrics.errors.Increment();
+  }
+  span.SetAttribute("failures", static_cast<std::int64_t>(failures.size()));
+  span.SetStatus(status.error_code(), status.error_message());
+  return failures;
+}
+
 // Call the `google.bigtable.v2.Bigtable.MutateRows` RPC repeatedly until
 // successful, or until the policies in effect tell us to stop.  When the RPC
 // is partially successful, this function retries only the mutations that did
-// not succeed.
-std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
-                                             grpc::Status& status) {
+// not succeed, each one as soon as its own backoff period expires.
+std::vector<FailedMutation> Table::BulkApplyPiece(BulkMutation&& mut,
+                                                  int original_index_offset,
+                                                  grpc::Status& status) {
   // Copy the policies in effect for this operation.  Many policy classes change
   // their state as the operation makes progress (or fails to make progress), so
   // we need fresh instances.
@@ -96,21 +272,12 @@ std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
   auto retry_policy = rpc_retry_policy_->clone();
   auto idemponent_policy = idempotent_mutation_policy_->clone();
 
-  bigtable::internal::BulkMutator mutator(app_profile_id_, table_name_,
-                                          *idemponent_policy,
-                                          std::forward<BulkMutation>(mut));
-  while (mutator.HasPendingMutations()) {
-    grpc::ClientContext client_context;
-    backoff_policy->Setup(client_context);
-    retry_policy->Setup(client_context);
-    metadata_update_policy_.Setup(client_context);
-    status = mutator.MakeOneRequest(*client_, client_context);
-    if (not status.ok() and not retry_policy->OnFailure(status)) {
-      break;
-    }
-    auto delay = backoff_policy->OnCompletion(status);
-    std::this_thread::sleep_for(delay);
-  }
+  bigtable::internal::BulkMutator mutator(
+      app_profile_id_, table_name_, *idemponent_policy,
+      std::forward<BulkMutation>(mut), use_protobuf_arenas_,
+      original_index_offset);
+  status = mutator.Run(*client_, *retry_policy, *backoff_policy,
+                       metadata_update_policy_);
   auto failures = mutator.ExtractFinalFailures();
   if (not status.ok()) {
     return failures;
@@ -124,6 +291,9 @@ std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
 }
 
 RowReader Table::ReadRows(RowSet row_set, Filter filter, bool raise_on_error) {
+  if (normalize_row_sets_) {
+    row_set.Normalize();
+  }
   return RowReader(client_, app_profile_id_, table_name_, std::move(row_set),
                    RowReader::NO_ROWS_LIMIT, std::move(filter),
                    rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
@@ -135,6 +305,9 @@ RowReader Table::ReadRows(RowSet row_set, Filter filter, bool raise_on_error) {
 
 RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                           Filter filter, bool raise_on_error) {
+  if (normalize_row_sets_) {
+    row_set.Normalize();
+  }
   return RowReader(client_, app_profile_id_, table_name_, std::move(row_set),
                    rows_limit, std::move(filter), rpc_retry_policy_->clone(),
                    rpc_backoff_policy_->clone(), metadata_update_policy_,
@@ -143,12 +316,204 @@ RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                    raise_on_error);
 }
 
+grpc::Status Table::ReadRowsParallel(
+    RowSet row_set, Filter filter, std::size_t max_parallelism,
+    std::function<void(std::size_t, Row)> const& callback) {
+  grpc::Status status;
+  auto samples = SampleRows<std::vector>(status);
+  if (not status.ok()) {
+    return status;
+  }
+  std::vector<std::string> split_points;
+  split_points.reserve(samples.size());
+  for (auto& sample : samples) {
+    split_points.emplace_back(std::move(sample.row_key));
+  }
+  auto const shards =
+      bigtable::internal::SplitRowSet(row_set, std::move(split_points));
+
+  // Each worker reads one shard at a time, using its own stream, until all the
+  // shards are consumed. Each shard is read using a RowReader, so it has its
+  // own retry and resume logic. The first error stops all the workers. An
+  // exception (typically raised by the callback) also stops all the workers,
+  // and it is rethrown on the calling thread once they are all done.
+  std::atomic<std::size_t> next_shard(0);
+  std::atomic<bool> failed(false);
+  std::mutex mu;
+  grpc::Status first_error;
+  std::exception_ptr first_exception;
+  auto read_shards = [&]() {
+    for (auto shard = next_shard++; shard < shards.size() and not failed;
+         shard = next_shard++) {
+      auto reader = ReadRows(shards[shard], filter);
+      for (auto& row : reader) {
+        if (failed) {
+          reader.Cancel();
+          break;
+        }
+        callback(shard, std::move(row));
+      }
+      auto shard_status = reader.Finish();
+      if (not shard_status.ok() and not failed.exchange(true)) {
+        std::lock_guard<std::mutex> lk(mu);
+        first_error = std::move(shard_status);
+      }
+    }
+  };
+  auto worker = [&]() {
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    try {
+      read_shards();
+    } catch (...) {
+      std::lock_guard<std::mutex> lk(mu);
+      if (not first_exception) {
+        first_exception = std::current_exception();
+      }
+      failed = true;
+    }
+#else
+    read_shards();
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  };
+
+  auto const thread_count =
+      (std::min)(std::max(max_parallelism, std::size_t(1)), shards.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+  return first_error;
+}
+
+std::vector<Row> Table::ReadRows(std::vector<std::string> row_keys,
+                                 Filter filter, MultiGetOptions const& options,
+                                 grpc::Status& status) {
+  auto const batches = bigtable::internal::SplitRowKeys(
+      std::move(row_keys), options.max_request_bytes());
+  bool const key_order =
+      options.row_order() == MultiGetOptions::RowOrder::kKeyOrder;
+
+  // Same approach as ReadRowsParallel(): each worker reads one batch at a
+  // time using a RowReader, which resumes after the last row received if the
+  // stream fails.  In key order the rows of each batch are kept separately and
+  // concatenated at the end, the batches are already sorted.
+  std::vector<std::vector<Row>> batch_rows(key_order ? batches.size() : 0);
+  std::vector<Row> result;
+  std::atomic<std::size_t> next_batch(0);
+  std::atomic<bool> failed(false);
+  std::mutex mu;
+  grpc::Status first_error;
+  auto worker = [&]() {
+    for (auto batch = next_batch++; batch < batches.size() and not failed;
+         batch = next_batch++) {
+      auto reader = ReadRows(batches[batch], filter);
+      for (auto& row : reader) {
+        if (failed) {
+          reader.Cancel();
+          break;
+        }
+        if (key_order) {
+          batch_rows[batch].emplace_back(std::move(row));
+          continue;
+        }
+        std::lock_guard<std::mutex> lk(mu);
+        result.emplace_back(std::move(row));
+      }
+      auto batch_status = reader.Finish();
+      if (not batch_status.ok() and not failed.exchange(true)) {
+        std::lock_guard<std::mutex> lk(mu);
+        first_error = std::move(batch_status);
+      }
+    }
+  };
+
+  auto const thread_count = (std::min)(
+      (std::max)(options.max_parallelism(), std::size_t(1)), batches.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  status = std::move(first_error);
+  for (auto& rows : batch_rows) {
+    std::move(rows.begin(), rows.end(), std::back_inserter(result));
+  }
+  return result;
+}
+
 std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter,
                                     grpc::Status& status) {
+  if (not row_cache_) {
+    return ReadRowUncached(std::move(row_key), std::move(filter), status);
+  }
+  auto const filter_key = filter.as_proto().SerializeAsString();
+  std::pair<bool, Row> result(false, Row("", {}));
+  std::uint64_t token;
+  if (row_cache_->Lookup(row_key, filter_key, result, token)) {
+    return result;
+  }
+  result = ReadRowUncached(row_key, std::move(filter), status);
+  if (status.ok()) {
+    row_cache_->Insert(row_key, filter_key, result, token);
+  }
+  return result;
+}
+
+std::pair<bool, Row> Table::ReadRowUncached(std::string row_key, Filter filter,
+                                            grpc::Status& status) {
+  // The hedged requests and the retry loop share the policies, so the failed
+  // hedged requests count as attempts of the operation.
+  auto rpc_policy = rpc_retry_policy_->clone();
+  auto backoff_policy = rpc_backoff_policy_->clone();
+  if (hedging_policy_) {
+    internal::OptionalRow row;
+    grpc::Status hedge_status;
+    status = HedgedReadRow(row_key, filter, *rpc_policy, row, hedge_status);
+    if (status.ok()) {
+      if (not row.has_value()) {
+        return std::make_pair(false, Row("", {}));
+      }
+      return std::make_pair(true, std::move(row).value());
+    }
+    // Neither request succeeded, report both failures to the policy, and then
+    // retry (after the backoff) as the retry loop would.
+    bool retry = rpc_policy->OnFailure(status);
+    if (not hedge_status.ok()) {
+      retry = rpc_policy->OnFailure(hedge_status) and retry;
+    }
+    if (not retry) {
+      status = grpc::Status(status.error_code(),
+                            "Unretriable error: " + status.error_message());
+      return std::make_pair(false, Row("", {}));
+    }
+    if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+      status = grpc::Status(
+          status.error_code(),
+          std::string(google::cloud::internal::kRetryBudgetExhausted) + ": " +
+              status.error_message());
+      return std::make_pair(false, Row("", {}));
+    }
+    std::this_thread::sleep_for(backoff_policy->OnCompletion(status));
+    status = grpc::Status();
+  }
   RowSet row_set(std::move(row_key));
   std::int64_t const rows_limit = 1;
-  RowReader reader =
-      ReadRows(std::move(row_set), rows_limit, std::move(filter));
+  RowReader reader(client_, app_profile_id_, table_name_, std::move(row_set),
+                   rows_limit, std::move(filter), std::move(rpc_policy),
+                   std::move(backoff_policy), metadata_update_policy_,
+                   bigtable::internal::make_unique<
+                       bigtable::internal::ReadRowsParserFactory>(),
+                   false);
   auto it = reader.begin();
   if (it == reader.end()) {
     status = reader.Finish();
@@ -164,6 +529,136 @@ std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter,
   return result;
 }
 
+grpc::Status Table::HedgedReadRow(std::string const& row_key,
+                                  Filter const& filter,
+                                  RPCRetryPolicy const& rpc_policy,
+                                  internal::OptionalRow& row,
+                                  grpc::Status& hedge_status) {
+  btproto::ReadRowsRequest request;
+  bigtable::internal::SetCommonTableOperationRequest<btproto::ReadRowsRequest>(
+      request, app_profile_id_.get(), table_name_.get());
+  request.mutable_rows()->add_row_keys(row_key);
+  *request.mutable_filter() = filter.as_proto();
+  request.set_rows_limit(1);
+
+  struct Attempt {
+    grpc::ClientContext context;
+    grpc::Status status;
+    internal::OptionalRow row;
+    bool done = false;
+  };
+  Attempt attempts[2];
+  for (auto& attempt : attempts) {
+    rpc_policy.Setup(attempt.context);
+    metadata_update_policy_.Setup(attempt.context);
+  }
+  std::mutex mu;
+  std::condition_variable cv;
+  Attempt* winner = nullptr;
+
+  // Each attempt runs to completion, the first one to succeed cancels the
+  // other.  ClientContext::TryCancel() is safe to call from any thread, even
+  // before the call starts.
+  auto run = [this, &request, &attempts, &mu, &cv, &winner](int index) {
+    Attempt& attempt = attempts[index];
+    auto status = ReadRowOnce(attempt.context, request, attempt.row);
+    std::lock_guard<std::mutex> lk(mu);
+    attempt.status = std::move(status);
+    attempt.done = true;
+    if (attempt.status.ok() and winner == nullptr) {
+      winner = &attempt;
+      attempts[1 - index].context.TryCancel();
+    }
+    cv.notify_all();
+  };
+
+  // Most requests complete before the hedging delay, use a (shared) timer to
+  // start the hedge, and only create a thread for it when it is needed.
+  auto const start = std::chrono::steady_clock::now();
+  auto const delay = hedging_policy_->OnRequest();
+  std::thread hedge;
+  bool timer_done = false;
+  auto& timers = google::cloud::internal::DefaultTimerService();
+  auto timer = timers.Schedule(
+      start + delay,
+      [this, &attempts, &mu, &cv, &run, &hedge, &timer_done](bool expired) {
+        std::lock_guard<std::mutex> lk(mu);
+        timer_done = true;
+        cv.notify_all();
+        if (not expired or attempts[0].done or not hedging_policy_->OnHedge()) {
+          return;
+        }
+        // The pool selects a channel for each RPC, so (unless the pool has a
+        // single channel) the hedge uses a different channel than the
+        // original.
+        hedge = std::thread(run, 1);
+      });
+  run(0);
+  if (not timers.Cancel(timer)) {
+    // The timer expired, wait until its callback decides whether to hedge.
+    std::unique_lock<std::mutex> lk(mu);
+    cv.wait(lk, [&timer_done] { return timer_done; });
+  }
+  if (hedge.joinable()) {
+    hedge.join();
+  }
+
+  if (winner == nullptr) {
+    hedge_status = attempts[1].status;
+    return attempts[0].status;
+  }
+  hedging_policy_->OnSuccess(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start));
+  row = std::move(winner->row);
+  return grpc::Status();
+}
+
+grpc::Status Table::ReadRowOnce(grpc::ClientContext& context,
+                                btproto::ReadRowsRequest const& request,
+                                internal::OptionalRow& row) {
+  auto stream = client_->ReadRows(&context, request);
+  bigtable::internal::ReadRowsParser parser;
+  btproto::ReadRowsResponse response;
+  grpc::Status status;
+  while (status.ok() and stream->Read(&response)) {
+    for (auto& chunk : *response.mutable_chunks()) {
+      parser.HandleChunk(std::move(chunk), status);
+      if (not status.ok()) {
+        break;
+      }
+      if (not parser.HasNext()) {
+        continue;
+      }
+      if (row.has_value()) {
+        status = grpc::Status(
+            grpc::StatusCode::INTERNAL,
+            "internal error - ReadRows returned 2 rows in ReadRow()");
+        break;
+      }
+      row.emplace(parser.Next(status));
+      if (not status.ok()) {
+        break;
+      }
+    }
+  }
+  if (not status.ok()) {
+    row.reset();
+    context.TryCancel();
+    while (stream->Read(&response)) {
+    }
+    (void)stream->Finish();
+    return status;
+  }
+  status = stream->Finish();
+  if (not status.ok()) {
+    row.reset();
+    return status;
+  }
+  parser.HandleEndOfStream(status);
+  return status;
+}
+
 bool Table::CheckAndMutateRow(std::string row_key, Filter filter,
                               std::vector<Mutation> true_mutations,
                               std::vector<Mutation> false_mutations,
@@ -184,39 +679,29 @@ bool Table::CheckAndMutateRow(std::string row_key, Filter filter,
       *client_, rpc_retry_policy_->clone(), metadata_update_policy_,
       &DataClient::CheckAndMutateRow, request, "Table::CheckAndMutateRow",
       status);
+  InvalidateCachedRow(request.row_key());
 
   return response.predicate_matched();
 }
 
 Row Table::CallReadModifyWriteRowRequest(
     btproto::ReadModifyWriteRowRequest const& request, grpc::Status& status) {
-  auto response = ClientUtils::MakeNonIdemponentCall(
+  std::unique_ptr<google::protobuf::Arena> arena;
+  if (use_protobuf_arenas_) {
+    arena = bigtable::internal::make_unique<google::protobuf::Arena>();
+  }
+  auto response =
+      bigtable::internal::MakeArenaMessage<btproto::ReadModifyWriteRowResponse>(
+          arena.get());
+  ClientUtils::MakeNonIdemponentCall(
       *client_, rpc_retry_policy_->clone(), metadata_update_policy_,
       &DataClient::ReadModifyWriteRow, request, "ReadModifyWriteRowRequest",
-      status);
+      status, response.get());
+  InvalidateCachedRow(request.row_key());
   if (not status.ok()) {
     return Row("", {});
   }
-
-  std::vector<bigtable::Cell> cells;
-  auto& row = *response.mutable_row();
-  for (auto& family : *row.mutable_families()) {
-    for (auto& column : *family.mutable_columns()) {
-      for (auto& cell : *column.mutable_cells()) {
-        std::vector<std::string> labels;
-        std::move(cell.mutable_labels()->begin(), cell.mutable_labels()->end(),
-                  std::back_inserter(labels));
-        bigtable::Cell new_cell(row.key(), family.name(), column.qualifier(),
-                                cell.timestamp_micros(),
-                                std::move(*cell.mutable_value()),
-                                std::move(labels));
-
-        cells.emplace_back(std::move(new_cell));
-      }
-    }
-  }
-
-  return Row(std::move(*row.mutable_key()), std::move(cells));
+  return TransformReadModifyWriteRowResponse(*response);
 }
 
 // Call the `google.bigtable.v2.Bigtable.SampleRowKeys` RPC until
@@ -237,35 +722,251 @@ void Table::SampleRowsImpl(
       btproto::SampleRowKeysRequest>(request, app_profile_id_.get(),
                                      table_name_.get());
 
+  auto& metrics =
+      bigtable::internal::RpcMetrics<btproto::SampleRowKeysRequest>();
+  google::cloud::internal::LatencyTimer timer(metrics.latency);
+  metrics.operations.Increment();
+  google::cloud::internal::Span span(metrics.name);
+  std::int64_t attempt = 0;
+
   while (true) {
     grpc::ClientContext client_context;
     backoff_policy->Setup(client_context);
     retry_policy->Setup(client_context);
     metadata_update_policy_.Setup(client_context);
 
+    metrics.attempts.Increment();
+    google::cloud::internal::Span attempt_span("attempt", span);
+    attempt_span.SetAttribute("attempt", ++attempt);
+    google::cloud::internal::CurrentSpanScope scope(attempt_span);
+    auto const attempt_start = std::chrono::steady_clock::now();
     auto stream = client_->SampleRowKeys(&client_context, request);
+    std::int64_t samples = 0;
     while (stream->Read(&response)) {
       // Assuming collection will be either list or vector.
       bigtable::RowKeySample row_sample;
       row_sample.offset_bytes = response.offset_bytes();
       row_sample.row_key = std::move(*response.mutable_row_key());
       inserter(std::move(row_sample));
+      ++samples;
     }
     status = stream->Finish();
+    metrics.attempt_latency.Record(std::chrono::steady_clock::now() -
+                                   attempt_start);
+    attempt_span.SetAttribute("samples", samples);
+    attempt_span.SetStatus(status.error_code(), status.error_message());
+    attempt_span.End();
+    span.SetAttribute("attempts", attempt);
+    span.SetStatus(status.error_code(), status.error_message());
     if (status.ok()) {
+      google::cloud::internal::DefaultRetryBudget().OnSuccess();
       break;
     }
     if (not retry_policy->OnFailure(status)) {
+      metrics.errors.Increment();
       status = grpc::Status(grpc::StatusCode::INTERNAL,
                             "No more retries allowed as per policy.");
       return;
     }
+    if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+      metrics.errors.Increment();
+      status = grpc::Status(
+          status.error_code(),
+          std::string(google::cloud::internal::kRetryBudgetExhausted) +
+              " in Table::SampleRows(): " + status.error_message());
+      return;
+    }
+    metrics.retries.Increment();
     clearer();
     auto delay = backoff_policy->OnCompletion(status);
+    google::cloud::internal::Span backoff_span("backoff", span);
+    backoff_span.SetAttribute("delay_us", delay);
     std::this_thread::sleep_for(delay);
   }
 }
 
+std::shared_ptr<AsyncOperation> Table::AsyncApply(
+    SingleRowMutation&& mut, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, grpc::Status&)> callback) {
+  auto idempotent_policy = idempotent_mutation_policy_->clone();
+
+  btproto::MutateRowRequest request;
+  bigtable::internal::SetCommonTableOperationRequest<btproto::MutateRowRequest>(
+      request, app_profile_id_.get(), table_name_.get());
+  mut.MoveTo(request);
+  // The callback may run after this object is deleted, keep the cache alive.
+  auto cache = row_cache_;
+  auto row_key = request.row_key();
+
+  bool const is_idempotent =
+      std::all_of(request.mutations().begin(), request.mutations().end(),
+                  [&idempotent_policy](btproto::Mutation const& m) {
+                    return idempotent_policy->is_idempotent(m);
+                  });
+
+  using Retry =
+      bigtable::internal::AsyncRetryUnaryRpc<DataClient,
+                                             btproto::MutateRowRequest,
+                                             btproto::MutateRowResponse>;
+  auto op = std::make_shared<Retry>(
+      "Table::AsyncApply", rpc_retry_policy_->clone(),
+      rpc_backoff_policy_->clone(), is_idempotent, metadata_update_policy_,
+      client_, &DataClient::AsyncMutateRow, std::move(request),
+      [cache, row_key, callback](CompletionQueue& cq,
+                                 btproto::MutateRowResponse&,
+                                 grpc::Status& status) {
+        if (cache) {
+          cache->Invalidate(row_key);
+        }
+        callback(cq, status);
+      });
+  return op->Start(cq);
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncBulkApply(
+    BulkMutation&& mut, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, std::vector<FailedMutation>&,
+                       grpc::Status&)>
+        callback) {
+  auto idempotent_policy = idempotent_mutation_policy_->clone();
+  if (row_cache_) {
+    // The callback may run after this object is deleted, keep the cache alive.
+    auto row_keys = BulkMutationRowKeys(mut);
+    auto cache = row_cache_;
+    auto wrapped = std::move(callback);
+    callback = [cache, row_keys, wrapped](CompletionQueue& cq,
+                                          std::vector<FailedMutation>& failed,
+                                          grpc::Status& status) {
+      for (auto const& row_key : row_keys) {
+        cache->Invalidate(row_key);
+      }
+      wrapped(cq, failed, status);
+    };
+  }
+  auto op = std::make_shared<bigtable::internal::AsyncRetryBulkApply>(
+      rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
+      *idempotent_policy, metadata_update_policy_, client_, app_profile_id_,
+      table_name_, std::forward<BulkMutation>(mut), std::move(callback));
+  return op->Start(cq);
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncReadRows(
+    RowSet row_set, Filter filter, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, Row)> on_row,
+    std::function<void(CompletionQueue&, grpc::Status&)> on_finish) {
+  return AsyncReadRows(std::move(row_set), RowReader::NO_ROWS_LIMIT,
+                       std::move(filter), cq, std::move(on_row),
+                       std::move(on_finish));
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncReadRows(
+    RowSet row_set, std::int64_t rows_limit, Filter filter,
+    CompletionQueue& cq, std::function<void(CompletionQueue&, Row)> on_row,
+    std::function<void(CompletionQueue&, grpc::Status&)> on_finish) {
+  auto op = std::make_shared<bigtable::internal::AsyncRowReader>(
+      client_, app_profile_id_, table_name_, std::move(row_set), rows_limit,
+      std::move(filter), rpc_retry_policy_->clone(),
+      rpc_backoff_policy_->clone(), metadata_update_policy_,
+      bigtable::internal::make_unique<
+          bigtable::internal::ReadRowsParserFactory>(),
+      std::move(on_row), std::move(on_finish));
+  return op->Start(cq);
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncReadRow(
+    std::string row_key, Filter filter, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, std::pair<bool, Row>, grpc::Status&)>
+        callback) {
+  // The callbacks run in sequence, in the completion queue threads, they can
+  // share the result without additional synchronization.
+  auto rows = std::make_shared<std::vector<Row>>();
+  RowSet row_set(std::move(row_key));
+  std::int64_t const rows_limit = 1;
+  return AsyncReadRows(
+      std::move(row_set), rows_limit, std::move(filter), cq,
+      [rows](CompletionQueue&, Row row) { rows->emplace_back(std::move(row)); },
+      [rows, callback](CompletionQueue& cq, grpc::Status& status) {
+        if (not status.ok() or rows->empty()) {
+          callback(cq, std::make_pair(false, Row("", {})), status);
+          return;
+        }
+        if (rows->size() != 1U) {
+          grpc::Status error(
+              grpc::StatusCode::INTERNAL,
+              "internal error - AsyncReadRows returned 2 rows in "
+              "AsyncReadRow()");
+          callback(cq, std::make_pair(false, Row("", {})), error);
+          return;
+        }
+        callback(cq, std::make_pair(true, std::move(rows->front())), status);
+      });
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncCheckAndMutateRow(
+    std::string row_key, Filter filter, std::vector<Mutation> true_mutations,
+    std::vector<Mutation> false_mutations, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, bool, grpc::Status&)> callback) {
+  btproto::CheckAndMutateRowRequest request;
+  auto cache = row_cache_;
+  request.set_row_key(row_key);
+  bigtable::internal::SetCommonTableOperationRequest<
+      btproto::CheckAndMutateRowRequest>(request, app_profile_id_.get(),
+                                         table_name_.get());
+  *request.mutable_predicate_filter() = filter.as_proto_move();
+  for (auto& m : true_mutations) {
+    *request.add_true_mutations() = std::move(m.op);
+  }
+  for (auto& m : false_mutations) {
+    *request.add_false_mutations() = std::move(m.op);
+  }
+
+  using Retry = bigtable::internal::AsyncRetryUnaryRpc<
+      DataClient, btproto::CheckAndMutateRowRequest,
+      btproto::CheckAndMutateRowResponse>;
+  bool const is_idempotent = false;
+  auto op = std::make_shared<Retry>(
+      "Table::AsyncCheckAndMutateRow", rpc_retry_policy_->clone(),
+      rpc_backoff_policy_->clone(), is_idempotent, metadata_update_policy_,
+      client_, &DataClient::AsyncCheckAndMutateRow, std::move(request),
+      [cache, row_key, callback](CompletionQueue& cq,
+                                 btproto::CheckAndMutateRowResponse& response,
+                                 grpc::Status& status) {
+        if (cache) {
+          cache->Invalidate(row_key);
+        }
+        callback(cq, response.predicate_matched(), status);
+      });
+  return op->Start(cq);
+}
+
+std::shared_ptr<AsyncOperation> Table::AsyncReadModifyWriteRowImpl(
+    btproto::ReadModifyWriteRowRequest request, CompletionQueue& cq,
+    std::function<void(CompletionQueue&, Row, grpc::Status&)> callback) {
+  using Retry = bigtable::internal::AsyncRetryUnaryRpc<
+      DataClient, btproto::ReadModifyWriteRowRequest,
+      btproto::ReadModifyWriteRowResponse>;
+  bool const is_idempotent = false;
+  auto cache = row_cache_;
+  auto row_key = request.row_key();
+  auto op = std::make_shared<Retry>(
+      "Table::AsyncReadModifyWriteRow", rpc_retry_policy_->clone(),
+      rpc_backoff_policy_->clone(), is_idempotent, metadata_update_policy_,
+      client_, &DataClient::AsyncReadModifyWriteRow, std::move(request),
+      [cache, row_key, callback](CompletionQueue& cq,
+                                 btproto::ReadModifyWriteRowResponse& response,
+                                 grpc::Status& status) {
+        if (cache) {
+          cache->Invalidate(row_key);
+        }
+        if (not status.ok()) {
+          callback(cq, Row("", {}), status);
+          return;
+        }
+        callback(cq, TransformReadModifyWriteRowResponse(response), status);
+      });
+  return op->Start(cq);
+}
+
 }  // namespace noex
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
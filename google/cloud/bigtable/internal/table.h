@@ -15,13 +15,19 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TABLE_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TABLE_H_
 
+#include "google/cloud/bigtable/async_operation.h"
 #include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/bulk_apply_options.h"
+#include "google/cloud/bigtable/completion_queue.h"
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/hedging_policy.h"
 #include "google/cloud/bigtable/idempotent_mutation_policy.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/multi_get_options.h"
 #include "google/cloud/bigtable/mutations.h"
 #include "google/cloud/bigtable/read_modify_write_rule.h"
+#include "google/cloud/bigtable/row_cache.h"
 #include "google/cloud/bigtable/row_reader.h"
 #include "google/cloud/bigtable/row_set.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
@@ -124,6 +130,48 @@ class Table {
 
   std::string const& table_name() const { return table_name_.get(); }
 
+  /// Allocate the response protos on arenas, see `bigtable::Table`.
+  Table& set_use_protobuf_arenas(bool value) {
+    use_protobuf_arenas_ = value;
+    return *this;
+  }
+  bool use_protobuf_arenas() const { return use_protobuf_arenas_; }
+
+  /// Normalize the row sets in `ReadRows()`, see `bigtable::Table`.
+  Table& set_normalize_row_sets(bool value) {
+    normalize_row_sets_ = value;
+    return *this;
+  }
+  bool normalize_row_sets() const { return normalize_row_sets_; }
+
+  /// Split and parallelize `BulkApply()`, see `bigtable::Table`.
+  Table& set_bulk_apply_options(BulkApplyOptions const& options) {
+    bulk_apply_options_ = options;
+    return *this;
+  }
+  BulkApplyOptions const& bulk_apply_options() const {
+    return bulk_apply_options_;
+  }
+
+  /// Hedge the `ReadRow()` requests, see `bigtable::Table`.
+  Table& set_hedging_policy(HedgingPolicy const& policy) {
+    hedging_policy_ = policy.clone();
+    return *this;
+  }
+  /// Disable hedging for `ReadRow()`.
+  Table& clear_hedging_policy() {
+    hedging_policy_.reset();
+    return *this;
+  }
+  bool has_hedging_policy() const { return hedging_policy_ != nullptr; }
+
+  /// Cache the results of `ReadRow()`, see `bigtable::Table`.
+  Table& set_row_cache(std::shared_ptr<RowCache> cache) {
+    row_cache_ = std::move(cache);
+    return *this;
+  }
+  std::shared_ptr<RowCache> const& row_cache() const { return row_cache_; }
+
   //@{
   /**
    * @name No exception versions of Table::*
@@ -143,6 +191,14 @@ class Table {
   RowReader ReadRows(RowSet row_set, std::int64_t rows_limit, Filter filter,
                      bool raise_on_error = false);
 
+  grpc::Status ReadRowsParallel(
+      RowSet row_set, Filter filter, std::size_t max_parallelism,
+      std::function<void(std::size_t, Row)> const& callback);
+
+  std::vector<Row> ReadRows(std::vector<std::string> row_keys, Filter filter,
+                            MultiGetOptions const& options,
+                            grpc::Status& status);
+
   std::pair<bool, Row> ReadRow(std::string row_key, Filter filter,
                                grpc::Status& status);
 
@@ -194,6 +250,83 @@ class Table {
 
   //@}
 
+  //@{
+  /**
+   * @name Asynchronous versions of the data operations.
+   *
+   * These functions start the operation and return immediately, the callback
+   * is invoked, in one of the threads running `cq.Run()`, once the operation
+   * completes. Retries and backoff are scheduled as timers in @p cq, no thread
+   * is blocked while the operation is pending.
+   *
+   * The returned `AsyncOperation` can be used to cancel the operation, the
+   * callback is invoked even if the operation is cancelled.
+   *
+   * If @p cq is shut down the operation fails with `CANCELLED`, and the
+   * callback is invoked in the calling thread, before the function returns.
+   */
+  std::shared_ptr<AsyncOperation> AsyncApply(
+      SingleRowMutation&& mut, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, grpc::Status&)> callback);
+
+  std::shared_ptr<AsyncOperation> AsyncBulkApply(
+      BulkMutation&& mut, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, std::vector<FailedMutation>&,
+                         grpc::Status&)>
+          callback);
+
+  std::shared_ptr<AsyncOperation> AsyncReadRows(
+      RowSet row_set, Filter filter, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, Row)> on_row,
+      std::function<void(CompletionQueue&, grpc::Status&)> on_finish);
+
+  std::shared_ptr<AsyncOperation> AsyncReadRows(
+      RowSet row_set, std::int64_t rows_limit, Filter filter,
+      CompletionQueue& cq, std::function<void(CompletionQueue&, Row)> on_row,
+      std::function<void(CompletionQueue&, grpc::Status&)> on_finish);
+
+  std::shared_ptr<AsyncOperation> AsyncReadRow(
+      std::string row_key, Filter filter, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, std::pair<bool, Row>,
+                         grpc::Status&)>
+          callback);
+
+  std::shared_ptr<AsyncOperation> AsyncCheckAndMutateRow(
+      std::string row_key, Filter filter, std::vector<Mutation> true_mutations,
+      std::vector<Mutation> false_mutations, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, bool, grpc::Status&)> callback);
+
+  template <typename... Args>
+  std::shared_ptr<AsyncOperation> AsyncReadModifyWriteRow(
+      std::string row_key, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, Row, grpc::Status&)> callback,
+      bigtable::ReadModifyWriteRule rule, Args&&... rules) {
+    ::google::bigtable::v2::ReadModifyWriteRowRequest request;
+    request.set_row_key(std::move(row_key));
+    bigtable::internal::SetCommonTableOperationRequest<
+        ::google::bigtable::v2::ReadModifyWriteRowRequest>(
+        request, app_profile_id_.get(), table_name_.get());
+
+    // Generate a better compile time error message than the default one
+    // if the types do not match
+    static_assert(
+        bigtable::internal::conjunction<
+            std::is_convertible<Args, bigtable::ReadModifyWriteRule>...>::value,
+        "The arguments passed to AsyncReadModifyWriteRow(row_key,...) must be "
+        "convertible to bigtable::ReadModifyWriteRule");
+
+    *request.add_rules() = rule.as_proto_move();
+    std::initializer_list<bigtable::ReadModifyWriteRule> rule_list{
+        std::forward<Args>(rules)...};
+    for (auto args_rule : rule_list) {
+      *request.add_rules() = args_rule.as_proto_move();
+    }
+
+    return AsyncReadModifyWriteRowImpl(std::move(request), cq,
+                                       std::move(callback));
+  }
+  //@}
+
  private:
   /**
    * Send request ReadModifyWriteRowRequest to modify the row and get it back
@@ -202,6 +335,12 @@ class Table {
       ::google::bigtable::v2::ReadModifyWriteRowRequest const& request,
       grpc::Status& status);
 
+  /// Start the asynchronous ReadModifyWriteRow RPC for a prepared request.
+  std::shared_ptr<AsyncOperation> AsyncReadModifyWriteRowImpl(
+      ::google::bigtable::v2::ReadModifyWriteRowRequest request,
+      CompletionQueue& cq,
+      std::function<void(CompletionQueue&, Row, grpc::Status&)> callback);
+
   /**
    * Refactor implementation to `.cc` file.
    *
@@ -215,6 +354,41 @@ class Table {
       std::function<void(bigtable::RowKeySample)> const& inserter,
       std::function<void()> const& clearer, grpc::Status& status);
 
+  /// Implement `ReadRow()`, bypassing the row cache.
+  std::pair<bool, Row> ReadRowUncached(std::string row_key, Filter filter,
+                                       grpc::Status& status);
+
+  /// Discard the cached results for a row modified by this table.
+  void InvalidateCachedRow(std::string const& row_key) {
+    if (row_cache_) {
+      row_cache_->Invalidate(row_key);
+    }
+  }
+
+  /**
+   * Read a single row, sending a second request if the first one is slow.
+   *
+   * Each request is attempted once, with the deadline set by @p rpc_policy,
+   * the caller retries if both fail.  In that case the function returns the
+   * status of the first request, and @p hedge_status receives the status of
+   * the second one (OK if it was not sent).
+   */
+  grpc::Status HedgedReadRow(std::string const& row_key, Filter const& filter,
+                             RPCRetryPolicy const& rpc_policy,
+                             internal::OptionalRow& row,
+                             grpc::Status& hedge_status);
+
+  /// Apply a piece of the mutations in `BulkApply()`, with its own retries.
+  std::vector<FailedMutation> BulkApplyPiece(BulkMutation&& mut,
+                                             int original_index_offset,
+                                             grpc::Status& status);
+
+  /// Make a single `ReadRows` request for (at most) one row.
+  grpc::Status ReadRowOnce(
+      grpc::ClientContext& context,
+      ::google::bigtable::v2::ReadRowsRequest const& request,
+      internal::OptionalRow& row);
+
   std::shared_ptr<DataClient> client_;
   bigtable::AppProfileId app_profile_id_;
   bigtable::TableId table_name_;
@@ -222,6 +396,11 @@ class Table {
   std::shared_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
   MetadataUpdatePolicy metadata_update_policy_;
   std::shared_ptr<IdempotentMutationPolicy> idempotent_mutation_policy_;
+  bool use_protobuf_arenas_ = false;
+  bool normalize_row_sets_ = false;
+  BulkApplyOptions bulk_apply_options_;
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
+  std::shared_ptr<RowCache> row_cache_;
 };
 
 }  // namespace noex
@@ -0,0 +1,114 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TRACKED_STREAM_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TRACKED_STREAM_H_
+
+#include "google/cloud/bigtable/internal/common_client.h"
+#include <grpcpp/impl/codegen/async_stream.h>
+#include <grpcpp/impl/codegen/sync_stream.h>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Wrap a streaming read RPC to count it as outstanding until it finishes.
+ *
+ * Streaming RPCs outlive the call to the stub, so the `RpcTracker` for them
+ * must be held by the stream itself.
+ */
+template <typename Response>
+class TrackedClientReader : public grpc::ClientReaderInterface<Response> {
+ public:
+  TrackedClientReader(
+      std::unique_ptr<grpc::ClientReaderInterface<Response>> impl,
+      RpcTracker tracker)
+      : impl_(std::move(impl)), tracker_(std::move(tracker)) {}
+
+  grpc::Status Finish() override {
+    auto status = impl_->Finish();
+    tracker_ = RpcTracker();
+    return status;
+  }
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return impl_->NextMessageSize(sz);
+  }
+  bool Read(Response* msg) override { return impl_->Read(msg); }
+  void WaitForInitialMetadata() override { impl_->WaitForInitialMetadata(); }
+
+ private:
+  std::unique_ptr<grpc::ClientReaderInterface<Response>> impl_;
+  RpcTracker tracker_;
+};
+
+/**
+ * Wrap an asynchronous streaming read RPC to count it as outstanding.
+ *
+ * The completion queue deletes the stream once the RPC finishes, so the RPC
+ * is counted until then.
+ */
+template <typename Response>
+class TrackedClientAsyncReader
+    : public grpc::ClientAsyncReaderInterface<Response> {
+ public:
+  TrackedClientAsyncReader(
+      std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> impl,
+      RpcTracker tracker)
+      : impl_(std::move(impl)), tracker_(std::move(tracker)) {}
+
+  void StartCall(void* tag) override { impl_->StartCall(tag); }
+  void ReadInitialMetadata(void* tag) override {
+    impl_->ReadInitialMetadata(tag);
+  }
+  void Read(Response* msg, void* tag) override { impl_->Read(msg, tag); }
+  void Finish(grpc::Status* status, void* tag) override {
+    impl_->Finish(status, tag);
+  }
+
+ private:
+  std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> impl_;
+  RpcTracker tracker_;
+};
+
+//@{
+/// @name Wrap a stream to count its RPC as outstanding.
+template <typename Response>
+std::unique_ptr<grpc::ClientReaderInterface<Response>> MakeTrackedStream(
+    std::unique_ptr<grpc::ClientReaderInterface<Response>> impl,
+    RpcTracker tracker) {
+  return std::unique_ptr<grpc::ClientReaderInterface<Response>>(
+      new TrackedClientReader<Response>(std::move(impl), std::move(tracker)));
+}
+
+template <typename Response>
+std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> MakeTrackedStream(
+    std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> impl,
+    RpcTracker tracker) {
+  return std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>>(
+      new TrackedClientAsyncReader<Response>(std::move(impl),
+                                             std::move(tracker)));
+}
+//@}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TRACKED_STREAM_H_
@@ -16,9 +16,12 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_UNARY_CLIENT_UTILS_H_
 
 #include "google/cloud/bigtable/internal/grpc_error_delegate.h"
+#include "google/cloud/bigtable/internal/rpc_metrics.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/tracing.h"
 #include <thread>
 
 namespace google {
@@ -169,28 +172,62 @@ struct UnaryClientUtils {
            typename CheckSignature<MemberFunction>::RequestType const& request,
            char const* error_message, grpc::Status& status,
            bool retry_on_failure) {
+    using RequestType = typename CheckSignature<MemberFunction>::RequestType;
+    auto& metrics = RpcMetrics<RequestType>();
+    google::cloud::internal::LatencyTimer timer(metrics.latency);
+    metrics.operations.Increment();
+    google::cloud::internal::Span span(metrics.name);
+    std::int64_t attempt = 0;
     typename CheckSignature<MemberFunction>::ResponseType response;
     do {
       grpc::ClientContext client_context;
       rpc_policy.Setup(client_context);
       backoff_policy.Setup(client_context);
       metadata_update_policy.Setup(client_context);
-      // Call the pointer to member function.
-      status = (client.*function)(&client_context, request, &response);
+      metrics.attempts.Increment();
+      {
+        google::cloud::internal::Span attempt_span("attempt", span);
+        attempt_span.SetAttribute("attempt", ++attempt);
+        google::cloud::internal::CurrentSpanScope scope(attempt_span);
+        google::cloud::internal::LatencyTimer attempt_timer(
+            metrics.attempt_latency);
+        // Call the pointer to member function.
+        status = (client.*function)(&client_context, request, &response);
+        attempt_span.SetStatus(status.error_code(), status.error_message());
+      }
       if (status.ok()) {
+        google::cloud::internal::DefaultRetryBudget().OnSuccess();
         break;
       }
-      if (not rpc_policy.OnFailure(status)) {
+      bool const retry = rpc_policy.OnFailure(status);
+      bool const budget_exhausted =
+          retry and retry_on_failure and
+          not google::cloud::internal::DefaultRetryBudget().TryRetry();
+      if (not retry or budget_exhausted) {
+        metrics.errors.Increment();
         std::string full_message = error_message;
         full_message += "(" + metadata_update_policy.value() + ") ";
+        if (budget_exhausted) {
+          full_message += google::cloud::internal::kRetryBudgetExhausted;
+          full_message += ": ";
+        }
         full_message += status.error_message();
         status = grpc::Status(status.error_code(), full_message,
                               status.error_details());
         break;
       }
+      if (retry_on_failure) {
+        metrics.retries.Increment();
+      } else {
+        metrics.errors.Increment();
+      }
       auto delay = backoff_policy.OnCompletion(status);
+      google::cloud::internal::Span backoff_span("backoff", span);
+      backoff_span.SetAttribute("delay_us", delay);
       std::this_thread::sleep_for(delay);
     } while (retry_on_failure);
+    span.SetAttribute("attempts", attempt);
+    span.SetStatus(status.error_code(), status.error_message());
     return response;
   }
 
@@ -228,23 +265,69 @@ struct UnaryClientUtils {
       typename CheckSignature<MemberFunction>::RequestType const& request,
       char const* error_message, grpc::Status& status) {
     typename CheckSignature<MemberFunction>::ResponseType response;
+    MakeNonIdemponentCall(client, std::move(rpc_policy),
+                          metadata_update_policy, function, request,
+                          error_message, status, &response);
+    return response;
+  }
 
+  /**
+   * Call a simple unary RPC with no retry, storing the result in @p response.
+   *
+   * This implements `MakeNonIdemponentCall()`, but the caller controls where
+   * the response is allocated, for example, on a `google::protobuf::Arena`.
+   *
+   * @tparam MemberFunction the signature of the member function.
+   * @param client the object that holds the gRPC stub.
+   * @param rpc_policy the policy to control timeouts.
+   * @param metadata_update_policy to keep metadata like
+   *     x-goog-request-params.
+   * @param function the pointer to the member function to call.
+   * @param request an initialized request parameter for the RPC.
+   * @param error_message include this message in any exception or error log.
+   * @param response where the RPC stores its response.
+   */
+  template <typename MemberFunction>
+  static typename std::enable_if<CheckSignature<MemberFunction>::value>::type
+  MakeNonIdemponentCall(
+      ClientType& client, std::unique_ptr<bigtable::RPCRetryPolicy> rpc_policy,
+      bigtable::MetadataUpdatePolicy const& metadata_update_policy,
+      MemberFunction function,
+      typename CheckSignature<MemberFunction>::RequestType const& request,
+      char const* error_message, grpc::Status& status,
+      typename CheckSignature<MemberFunction>::ResponseType* response) {
+    using RequestType = typename CheckSignature<MemberFunction>::RequestType;
+    auto& metrics = RpcMetrics<RequestType>();
+    metrics.operations.Increment();
+    metrics.attempts.Increment();
+    // Without retries the operation span is also the attempt span.
+    google::cloud::internal::Span span(metrics.name);
+    span.SetAttribute("attempt", std::int64_t(1));
     grpc::ClientContext client_context;
 
     // Policies can set timeouts so allowing them to update context
     rpc_policy->Setup(client_context);
     metadata_update_policy.Setup(client_context);
-    // Call the pointer to member function.
-    status = (client.*function)(&client_context, request, &response);
+    auto const start = std::chrono::steady_clock::now();
+    {
+      google::cloud::internal::CurrentSpanScope scope(span);
+      // Call the pointer to member function.
+      status = (client.*function)(&client_context, request, response);
+    }
+    span.SetStatus(status.error_code(), status.error_message());
+    // Without retries the operation and the attempt are the same.
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    metrics.latency.Record(elapsed);
+    metrics.attempt_latency.Record(elapsed);
 
     if (not status.ok()) {
+      metrics.errors.Increment();
       std::string full_message = error_message;
       full_message += "(" + metadata_update_policy.value() + ") ";
       full_message += status.error_message();
       status = grpc::Status(status.error_code(), full_message,
                             status.error_details());
     }
-    return response;
   }
 };
 
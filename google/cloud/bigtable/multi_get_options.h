@@ -0,0 +1,79 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MULTI_GET_OPTIONS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MULTI_GET_OPTIONS_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Configure how `Table::ReadRows()` reads a list of row keys.
+ *
+ * The keys are sorted, duplicates removed, and split into requests of at most
+ * `max_request_bytes()` worth of keys.  Up to `max_parallelism()` requests
+ * run at the same time, each on its own stream.
+ */
+class MultiGetOptions {
+ public:
+  /// The order of the returned rows.
+  enum class RowOrder {
+    /// Sorted by row key.
+    kKeyOrder,
+    /// In the order they were received, interleaving the concurrent requests.
+    kCompletionOrder,
+  };
+
+  MultiGetOptions()
+      : max_request_bytes_(256 * 1024),
+        max_parallelism_(8),
+        row_order_(RowOrder::kKeyOrder) {}
+
+  /// Limit the size of the row keys in each request.
+  MultiGetOptions& set_max_request_bytes(std::size_t value) {
+    max_request_bytes_ = value;
+    return *this;
+  }
+  std::size_t max_request_bytes() const { return max_request_bytes_; }
+
+  /// Limit the number of concurrent requests.
+  MultiGetOptions& set_max_parallelism(std::size_t value) {
+    max_parallelism_ = value;
+    return *this;
+  }
+  std::size_t max_parallelism() const { return max_parallelism_; }
+
+  /// Choose the order of the returned rows.
+  MultiGetOptions& set_row_order(RowOrder value) {
+    row_order_ = value;
+    return *this;
+  }
+  RowOrder row_order() const { return row_order_; }
+
+ private:
+  std::size_t max_request_bytes_;
+  std::size_t max_parallelism_;
+  RowOrder row_order_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MULTI_GET_OPTIONS_H_
@@ -0,0 +1,212 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/mutation_batcher.h"
+#include <algorithm>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Bigtable rejects requests with more than 100,000 mutations, stay well
+/// below that limit to keep the latency for each batch low.
+std::size_t const kDefaultMaxMutationsPerBatch = 1000;
+std::size_t const kDefaultMaxSizePerBatch = 16 * 1024 * 1024UL;
+std::size_t const kDefaultMaxBatches = 8;
+std::size_t const kDefaultMaxOutstandingSize = 64 * 1024 * 1024UL;
+}  // anonymous namespace
+
+MutationBatcher::Options::Options()
+    : max_mutations_per_batch_(kDefaultMaxMutationsPerBatch),
+      max_size_per_batch_(kDefaultMaxSizePerBatch),
+      max_batches_(kDefaultMaxBatches),
+      max_outstanding_size_(kDefaultMaxOutstandingSize) {}
+
+// The batcher cannot make progress if any limit is zero, so the setters
+// enforce a minimum of 1.
+MutationBatcher::Options&
+MutationBatcher::Options::set_max_mutations_per_batch(std::size_t value) {
+  max_mutations_per_batch_ = std::max(std::size_t(1), value);
+  return *this;
+}
+
+MutationBatcher::Options& MutationBatcher::Options::set_max_size_per_batch(
+    std::size_t value) {
+  max_size_per_batch_ = std::max(std::size_t(1), value);
+  return *this;
+}
+
+MutationBatcher::Options& MutationBatcher::Options::set_max_batches(
+    std::size_t value) {
+  max_batches_ = std::max(std::size_t(1), value);
+  return *this;
+}
+
+MutationBatcher::Options& MutationBatcher::Options::set_max_outstanding_size(
+    std::size_t value) {
+  max_outstanding_size_ = std::max(std::size_t(1), value);
+  return *this;
+}
+
+MutationBatcher::PendingSingleRowMutation::PendingSingleRowMutation(
+    SingleRowMutation mut, AdmissionCallback on_admission,
+    CompletionCallback on_completion)
+    : on_admission(std::move(on_admission)),
+      on_completion(std::move(on_completion)) {
+  mut.MoveTo(&entry);
+  request_size = entry.ByteSizeLong();
+}
+
+MutationBatcher::MutationBatcher(Table table, Options options)
+    : table_(std::move(table)),
+      options_(std::move(options)),
+      cur_batch_(std::make_shared<Batch>()),
+      num_outstanding_batches_(0),
+      outstanding_size_(0),
+      num_requests_pending_(0) {}
+
+void MutationBatcher::AsyncApply(CompletionQueue& cq, SingleRowMutation mut,
+                                 AdmissionCallback on_admission,
+                                 CompletionCallback on_completion) {
+  PendingSingleRowMutation pending(std::move(mut), std::move(on_admission),
+                                   std::move(on_completion));
+  std::unique_lock<std::mutex> lk(mu_);
+  ++num_requests_pending_;
+  pending_mutations_.push_back(std::move(pending));
+  AdmitAndFlush(cq, std::move(lk));
+}
+
+void MutationBatcher::Apply(CompletionQueue& cq, SingleRowMutation mut,
+                            CompletionCallback on_completion) {
+  std::promise<void> admitted;
+  AsyncApply(cq, std::move(mut),
+             [&admitted](CompletionQueue&) { admitted.set_value(); },
+             std::move(on_completion));
+  admitted.get_future().wait();
+}
+
+void MutationBatcher::AsyncWaitForNoPendingRequests(
+    CompletionQueue& cq, NoPendingCallback callback) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (num_requests_pending_ != 0) {
+      no_pending_callbacks_.emplace_back(std::move(callback));
+      return;
+    }
+  }
+  callback(cq);
+}
+
+bool MutationBatcher::HasSpaceFor(PendingSingleRowMutation const& mut) const {
+  // A mutation larger than the limits is admitted when nothing else is
+  // outstanding, otherwise it could never be sent.
+  if (outstanding_size_ != 0 and
+      outstanding_size_ + mut.request_size > options_.max_outstanding_size()) {
+    return false;
+  }
+  if (cur_batch_->callbacks.empty()) {
+    return true;
+  }
+  return cur_batch_->callbacks.size() < options_.max_mutations_per_batch() and
+         cur_batch_->requests_size + mut.request_size <=
+             options_.max_size_per_batch();
+}
+
+void MutationBatcher::AdmitAndFlush(CompletionQueue& cq,
+                                    std::unique_lock<std::mutex> lk) {
+  Actions actions;
+  while (true) {
+    while (not pending_mutations_.empty() and
+           HasSpaceFor(pending_mutations_.front())) {
+      auto& mut = pending_mutations_.front();
+      outstanding_size_ += mut.request_size;
+      cur_batch_->requests_size += mut.request_size;
+      cur_batch_->requests.emplace_back(
+          SingleRowMutation(std::move(mut.entry)));
+      cur_batch_->callbacks.emplace_back(std::move(mut.on_completion));
+      actions.admitted.emplace_back(std::move(mut.on_admission));
+      pending_mutations_.pop_front();
+    }
+    // Send the current batch if there is room for it, and then try to admit
+    // more mutations in the new batch.
+    if (cur_batch_->callbacks.empty() or
+        num_outstanding_batches_ >= options_.max_batches()) {
+      break;
+    }
+    ++num_outstanding_batches_;
+    actions.batches.emplace_back(std::move(cur_batch_));
+    cur_batch_ = std::make_shared<Batch>();
+  }
+  if (num_requests_pending_ == 0) {
+    actions.no_pending.swap(no_pending_callbacks_);
+  }
+  lk.unlock();
+
+  // The callbacks may start new operations, or complete inline if the
+  // completion queue is shutting down, so they are invoked without holding
+  // the lock.  The mutations are admitted before their batches are sent, a
+  // batch that fails inline must not report a completion before the
+  // admission.
+  for (auto& callback : actions.admitted) {
+    callback(cq);
+  }
+  for (auto& batch : actions.batches) {
+    FlushBatch(cq, std::move(batch));
+  }
+  for (auto& callback : actions.no_pending) {
+    callback(cq);
+  }
+}
+
+void MutationBatcher::FlushBatch(CompletionQueue& cq,
+                                 std::shared_ptr<Batch> batch) {
+  table_.AsyncBulkApply(
+      std::move(batch->requests), cq,
+      [this, batch](CompletionQueue& cq, std::vector<FailedMutation>& failures,
+                    grpc::Status& status) {
+        OnBatchComplete(cq, *batch, failures, status);
+      });
+}
+
+void MutationBatcher::OnBatchComplete(CompletionQueue& cq, Batch& batch,
+                                      std::vector<FailedMutation>& failures,
+                                      grpc::Status& status) {
+  std::vector<grpc::Status> results(batch.callbacks.size());
+  for (auto const& failure : failures) {
+    auto index = failure.original_index();
+    if (index < 0 or batch.callbacks.size() <= std::size_t(index)) {
+      continue;
+    }
+    // Mutations with an unknown result are reported with an OK status in
+    // `failures`, use the status for the batch in that case, which is never
+    // OK when there are failures.
+    results[index] = failure.status().ok() ? status : failure.status();
+  }
+  for (std::size_t i = 0; i != batch.callbacks.size(); ++i) {
+    batch.callbacks[i](cq, results[i]);
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  --num_outstanding_batches_;
+  outstanding_size_ -= batch.requests_size;
+  num_requests_pending_ -= batch.callbacks.size();
+  AdmitAndFlush(cq, std::move(lk));
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
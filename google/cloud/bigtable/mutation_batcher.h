@@ -0,0 +1,198 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_BATCHER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_BATCHER_H_
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/mutations.h"
+#include "google/cloud/bigtable/table.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Batch single row mutations into bulk mutations, with flow control.
+ *
+ * Applications that write many independent rows, often from many threads,
+ * can use this class instead of building `BulkMutation` objects themselves.
+ * Mutations are packed into `MutateRows` requests, bounded by the number of
+ * entries and the size of the request, and sent using
+ * `Table::AsyncBulkApply()`, with the usual retry and idempotency policies.
+ *
+ * Batches are sent as soon as there is capacity to send them, so mutations
+ * are only accumulated while the maximum number of batches is outstanding.
+ * The total size of the admitted but not yet completed mutations is bounded.
+ * Mutations over that limit are queued until there is room for them; the
+ * application is notified when each mutation is admitted, and again when it
+ * completes.
+ *
+ * @par Thread-safety
+ * Instances of this class are safe to use from multiple threads. The
+ * `MutationBatcher` must outlive all the operations started through it, use
+ * `AsyncWaitForNoPendingRequests()` before destroying it.
+ */
+class MutationBatcher {
+ public:
+  /// Configure the flow control and batching limits.
+  class Options {
+   public:
+    Options();
+
+    /// The maximum number of mutations in a single batch.
+    std::size_t max_mutations_per_batch() const {
+      return max_mutations_per_batch_;
+    }
+    Options& set_max_mutations_per_batch(std::size_t value);
+
+    /// The maximum size (in bytes) of the request for a single batch.
+    std::size_t max_size_per_batch() const { return max_size_per_batch_; }
+    Options& set_max_size_per_batch(std::size_t value);
+
+    /// The maximum number of batches sent but not yet completed.
+    std::size_t max_batches() const { return max_batches_; }
+    Options& set_max_batches(std::size_t value);
+
+    /// The maximum size (in bytes) of admitted but not completed mutations.
+    std::size_t max_outstanding_size() const { return max_outstanding_size_; }
+    Options& set_max_outstanding_size(std::size_t value);
+
+   private:
+    std::size_t max_mutations_per_batch_;
+    std::size_t max_size_per_batch_;
+    std::size_t max_batches_;
+    std::size_t max_outstanding_size_;
+  };
+
+  /// Called when a mutation is admitted, i.e., the batcher took ownership.
+  using AdmissionCallback = std::function<void(CompletionQueue&)>;
+
+  /// Called with the final status of each mutation.
+  using CompletionCallback =
+      std::function<void(CompletionQueue&, grpc::Status&)>;
+
+  /// Called once there are no pending or outstanding mutations.
+  using NoPendingCallback = std::function<void(CompletionQueue&)>;
+
+  explicit MutationBatcher(Table table, Options options = Options());
+
+  /**
+   * Asynchronously apply a single row mutation.
+   *
+   * @param cq the completion queue used to send the batches, the application
+   *     must ensure that one or more threads are blocked on `cq.Run()`.
+   * @param mut the mutation, the batcher takes ownership of its contents.
+   * @param on_admission called once the mutation is admitted. If there is
+   *     room for the mutation this happens before `AsyncApply()` returns, in
+   *     the calling thread. Otherwise it is called from the thread that
+   *     completes the batch that made room for it.
+   * @param on_completion called with the final status of the mutation, in one
+   *     of the threads running `cq.Run()`. If @p cq is shut down the batch
+   *     fails with `CANCELLED`, and this is called in the thread sending the
+   *     batch, possibly before `AsyncApply()` returns. It is always called
+   *     after @p on_admission.
+   */
+  void AsyncApply(CompletionQueue& cq, SingleRowMutation mut,
+                  AdmissionCallback on_admission,
+                  CompletionCallback on_completion);
+
+  /**
+   * Apply a single row mutation, blocking until the mutation is admitted.
+   *
+   * This function provides backpressure for applications that produce
+   * mutations faster than they can be sent. It must not be called from the
+   * threads running `cq.Run()`, as those threads are needed to make room for
+   * the mutation.
+   */
+  void Apply(CompletionQueue& cq, SingleRowMutation mut,
+             CompletionCallback on_completion);
+
+  /**
+   * Asynchronously wait until all the mutations have completed.
+   *
+   * @param callback called once there are no pending or outstanding
+   *     mutations. If that is already the case it is called before this
+   *     function returns.
+   */
+  void AsyncWaitForNoPendingRequests(CompletionQueue& cq,
+                                     NoPendingCallback callback);
+
+ private:
+  /// A mutation waiting to be admitted.
+  struct PendingSingleRowMutation {
+    PendingSingleRowMutation(SingleRowMutation mut,
+                             AdmissionCallback on_admission,
+                             CompletionCallback on_completion);
+
+    google::bigtable::v2::MutateRowsRequest::Entry entry;
+    std::size_t request_size;
+    AdmissionCallback on_admission;
+    CompletionCallback on_completion;
+  };
+
+  /// A batch of admitted mutations.
+  struct Batch {
+    Batch() : requests_size(0) {}
+
+    std::size_t requests_size;
+    BulkMutation requests;
+    /// The completion callbacks, indexed by their position in `requests`.
+    std::vector<CompletionCallback> callbacks;
+  };
+
+  /// The operations to run once the lock is released.
+  struct Actions {
+    std::vector<std::shared_ptr<Batch>> batches;
+    std::vector<AdmissionCallback> admitted;
+    std::vector<NoPendingCallback> no_pending;
+  };
+
+  /// Return true if @p mut can be added to the current batch.
+  bool HasSpaceFor(PendingSingleRowMutation const& mut) const;
+
+  /// Admit as many pending mutations as possible, and send full batches.
+  void AdmitAndFlush(CompletionQueue& cq, std::unique_lock<std::mutex> lk);
+
+  /// Send @p batch using `Table::AsyncBulkApply()`.
+  void FlushBatch(CompletionQueue& cq, std::shared_ptr<Batch> batch);
+
+  /// Report the results for each mutation in @p batch.
+  void OnBatchComplete(CompletionQueue& cq, Batch& batch,
+                       std::vector<FailedMutation>& failures,
+                       grpc::Status& status);
+
+  Table table_;
+  Options options_;
+
+  std::mutex mu_;
+  std::shared_ptr<Batch> cur_batch_;
+  std::size_t num_outstanding_batches_;
+  std::size_t outstanding_size_;
+  std::size_t num_requests_pending_;
+  std::deque<PendingSingleRowMutation> pending_mutations_;
+  std::vector<NoPendingCallback> no_pending_callbacks_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_BATCHER_H_
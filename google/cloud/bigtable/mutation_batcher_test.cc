@@ -0,0 +1,316 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/mutation_batcher.h"
+#include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::chrono_literals;
+
+/// Define helper types and functions for this test.
+namespace {
+class MutationBatcherTest : public bigtable::testing::TableTestFixture {};
+
+using MockReader =
+    bigtable::testing::MockClientAsyncReader<btproto::MutateRowsResponse>;
+
+/**
+ * Return a mock stream that answers @p request.
+ *
+ * The rows in @p failed_keys fail with a permanent error, all other rows
+ * succeed.
+ */
+MockReader::UniquePtr MakeReader(btproto::MutateRowsRequest const& request,
+                                 std::vector<std::string> failed_keys = {}) {
+  using namespace ::testing;
+  btproto::MutateRowsResponse response;
+  for (int i = 0; i != request.entries_size(); ++i) {
+    auto& entry = *response.add_entries();
+    entry.set_index(i);
+    auto const& key = request.entries(i).row_key();
+    bool failed = std::find(failed_keys.begin(), failed_keys.end(), key) !=
+                  failed_keys.end();
+    entry.mutable_status()->set_code(
+        failed ? grpc::StatusCode::PERMISSION_DENIED : grpc::StatusCode::OK);
+  }
+  auto reader = new MockReader;
+  EXPECT_CALL(*reader, StartCall(_)).Times(1);
+  EXPECT_CALL(*reader, Read(_, _))
+      .WillOnce(Invoke([response](btproto::MutateRowsResponse* r, void*) {
+        *r = response;
+      }))
+      .WillOnce(Return());
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce(Invoke([](grpc::Status* s, void*) { *s = grpc::Status::OK; }));
+  return reader->AsUniqueMocked();
+}
+
+/// Simulate the events for a stream created by `MakeReader()`.
+void SimulateStream(bigtable::testing::MockCompletionQueue& impl,
+                    bigtable::CompletionQueue& cq) {
+  impl.SimulateCompletion(cq, true);   // StartCall()
+  impl.SimulateCompletion(cq, true);   // Read() returns the response
+  impl.SimulateCompletion(cq, false);  // Read() reports end of stream
+  impl.SimulateCompletion(cq, true);   // Finish()
+}
+
+bigtable::SingleRowMutation MakeMutation(std::string key) {
+  return bigtable::SingleRowMutation(
+      std::move(key), {bigtable::SetCell("fam", "col", 0_ms, "value")});
+}
+
+/// Keep track of the callbacks for a single mutation.
+struct MutationState {
+  bool admitted = false;
+  bool completed = false;
+  grpc::Status status;
+};
+
+void AsyncApply(bigtable::MutationBatcher& batcher,
+                bigtable::CompletionQueue& cq, std::string key,
+                MutationState& state) {
+  batcher.AsyncApply(
+      cq, MakeMutation(std::move(key)),
+      [&state](bigtable::CompletionQueue&) { state.admitted = true; },
+      [&state](bigtable::CompletionQueue&, grpc::Status& status) {
+        state.completed = true;
+        state.status = status;
+      });
+}
+}  // anonymous namespace
+
+/// @test Verify that a single mutation is sent immediately.
+TEST_F(MutationBatcherTest, Trivial) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.entries_size());
+        return MakeReader(request);
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::MutationBatcher batcher(table_);
+
+  MutationState state;
+  AsyncApply(batcher, cq, "foo", state);
+  EXPECT_TRUE(state.admitted);
+  EXPECT_FALSE(state.completed);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(state.completed);
+  EXPECT_TRUE(state.status.ok());
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that mutations are batched while other batches are in flight.
+TEST_F(MutationBatcherTest, BatchesWhileOutstanding) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.entries_size());
+        return MakeReader(request);
+      }))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(2, request.entries_size());
+        return MakeReader(request);
+      }))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.entries_size());
+        return MakeReader(request);
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::MutationBatcher batcher(
+      table_, bigtable::MutationBatcher::Options()
+                  .set_max_batches(1)
+                  .set_max_mutations_per_batch(2));
+
+  std::vector<MutationState> states(4);
+  for (std::size_t i = 0; i != states.size(); ++i) {
+    AsyncApply(batcher, cq, "row-" + std::to_string(i), states[i]);
+  }
+  // The first mutation is sent immediately, the next two wait in the current
+  // batch, and the last one does not fit in it.
+  EXPECT_TRUE(states[0].admitted);
+  EXPECT_TRUE(states[1].admitted);
+  EXPECT_TRUE(states[2].admitted);
+  EXPECT_FALSE(states[3].admitted);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(states[0].completed);
+  EXPECT_FALSE(states[1].completed);
+  EXPECT_TRUE(states[3].admitted);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(states[1].completed);
+  EXPECT_TRUE(states[2].completed);
+  EXPECT_FALSE(states[3].completed);
+
+  SimulateStream(*impl, cq);
+  for (auto const& s : states) {
+    EXPECT_TRUE(s.completed);
+    EXPECT_TRUE(s.status.ok());
+  }
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that mutations over the outstanding size limit wait.
+TEST_F(MutationBatcherTest, FlowControl) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([](grpc::ClientContext*,
+                                btproto::MutateRowsRequest const& request,
+                                grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.entries_size());
+        return MakeReader(request);
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  // Any mutation is larger than 1 byte, so only one is admitted at a time.
+  bigtable::MutationBatcher batcher(
+      table_, bigtable::MutationBatcher::Options().set_max_outstanding_size(1));
+
+  MutationState s0;
+  MutationState s1;
+  AsyncApply(batcher, cq, "foo", s0);
+  AsyncApply(batcher, cq, "bar", s1);
+  EXPECT_TRUE(s0.admitted);
+  EXPECT_FALSE(s1.admitted);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(s0.completed);
+  EXPECT_TRUE(s1.admitted);
+  EXPECT_FALSE(s1.completed);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(s1.completed);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that each mutation receives its own result.
+TEST_F(MutationBatcherTest, PerMutationResults) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        return MakeReader(request);
+      }))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ(2, request.entries_size());
+        return MakeReader(request, {"bad"});
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::MutationBatcher batcher(
+      table_, bigtable::MutationBatcher::Options().set_max_batches(1));
+
+  MutationState first;
+  MutationState good;
+  MutationState bad;
+  AsyncApply(batcher, cq, "first", first);
+  AsyncApply(batcher, cq, "bad", bad);
+  AsyncApply(batcher, cq, "good", good);
+
+  SimulateStream(*impl, cq);
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(first.status.ok());
+  EXPECT_TRUE(good.status.ok());
+  EXPECT_TRUE(bad.completed);
+  EXPECT_EQ(grpc::StatusCode::PERMISSION_DENIED, bad.status.error_code());
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that AsyncWaitForNoPendingRequests() waits for all mutations.
+TEST_F(MutationBatcherTest, WaitForNoPendingRequests) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          btproto::MutateRowsRequest const& request,
+                          grpc::CompletionQueue*) {
+        return MakeReader(request);
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bigtable::MutationBatcher batcher(table_);
+
+  bool no_pending = false;
+  batcher.AsyncWaitForNoPendingRequests(
+      cq, [&no_pending](bigtable::CompletionQueue&) { no_pending = true; });
+  EXPECT_TRUE(no_pending);
+
+  MutationState state;
+  AsyncApply(batcher, cq, "foo", state);
+  no_pending = false;
+  batcher.AsyncWaitForNoPendingRequests(
+      cq, [&no_pending](bigtable::CompletionQueue&) { no_pending = true; });
+  EXPECT_FALSE(no_pending);
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(state.completed);
+  EXPECT_TRUE(no_pending);
+}
+
+/// @test Verify that mutations are admitted before they fail on shutdown.
+TEST_F(MutationBatcherTest, AdmissionBeforeCompletionOnShutdown) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _)).Times(0);
+
+  bigtable::CompletionQueue cq;
+  std::thread t([&cq]() { cq.Run(); });
+  cq.Shutdown();
+  t.join();
+
+  bigtable::MutationBatcher batcher(table_);
+  std::vector<std::string> events;
+  grpc::Status status;
+  batcher.AsyncApply(
+      cq, MakeMutation("foo"),
+      [&events](bigtable::CompletionQueue&) {
+        events.emplace_back("admitted");
+      },
+      [&events, &status](bigtable::CompletionQueue&, grpc::Status& s) {
+        events.emplace_back("completed");
+        status = s;
+      });
+  EXPECT_THAT(events, ElementsAre("admitted", "completed"));
+  EXPECT_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+}
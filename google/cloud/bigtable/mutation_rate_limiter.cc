@@ -0,0 +1,131 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
+#include <algorithm>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// The weight of each new sample in the smoothed latency.
+constexpr double kLatencyAlpha = 0.2;
+/// How fast the baseline latency follows increases in the latency.
+constexpr double kBaselineAlpha = 0.01;
+}  // anonymous namespace
+
+MutationRateLimiter::MutationRateLimiter(MutationThrottlingOptions options)
+    : options_(std::move(options)),
+      rate_((std::min)(options_.max_rate(),
+                       (std::max)(options_.min_rate(),
+                                  options_.initial_rate()))),
+      tokens_(rate_),
+      last_refill_(Clock::now()),
+      last_decrease_(),
+      decrease_count_(0),
+      latency_(0.0),
+      baseline_latency_(0.0) {}
+
+void MutationRateLimiter::Acquire(std::size_t mutations) {
+  auto delay = Reserve(mutations, Clock::now());
+  if (delay.count() > 0) {
+    std::this_thread::sleep_for(delay);
+  }
+}
+
+std::chrono::microseconds MutationRateLimiter::Reserve(std::size_t mutations,
+                                                       Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  Refill(now);
+  // The bucket may go into debt, so a request larger than the bucket is not
+  // blocked forever.  The next requests wait until the debt is repaid.
+  std::chrono::microseconds delay(0);
+  if (tokens_ < 0) {
+    delay = std::chrono::microseconds(
+        static_cast<std::chrono::microseconds::rep>(-tokens_ / rate_ * 1.0E6));
+  }
+  tokens_ -= static_cast<double>(mutations);
+  return delay;
+}
+
+void MutationRateLimiter::OnSuccess(std::size_t mutations,
+                                    std::chrono::microseconds latency,
+                                    Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (options_.latency_factor() > 0 and mutations > 0) {
+    auto const sample = static_cast<double>(latency.count()) /
+                        static_cast<double>(mutations);
+    if (latency_ == 0.0) {
+      latency_ = sample;
+      baseline_latency_ = sample;
+    } else {
+      latency_ += kLatencyAlpha * (sample - latency_);
+      // The baseline drops immediately, but rises slowly, so it tracks the
+      // lowest recent latency.
+      if (sample < baseline_latency_) {
+        baseline_latency_ = sample;
+      } else {
+        baseline_latency_ += kBaselineAlpha * (sample - baseline_latency_);
+      }
+    }
+    if (latency_ > options_.latency_factor() * baseline_latency_) {
+      Decrease(now);
+      return;
+    }
+  }
+  rate_ = (std::min)(options_.max_rate(), rate_ + options_.additive_increase());
+}
+
+void MutationRateLimiter::OnOverload(Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  Decrease(now);
+}
+
+double MutationRateLimiter::rate() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return rate_;
+}
+
+std::size_t MutationRateLimiter::decrease_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return decrease_count_;
+}
+
+void MutationRateLimiter::Refill(Clock::time_point now) {
+  if (now <= last_refill_) {
+    return;
+  }
+  std::chrono::duration<double> elapsed = now - last_refill_;
+  last_refill_ = now;
+  tokens_ = (std::min)(rate_, tokens_ + elapsed.count() * rate_);
+}
+
+void MutationRateLimiter::Decrease(Clock::time_point now) {
+  if (decrease_count_ != 0 and
+      now - last_decrease_ < options_.decrease_interval()) {
+    return;
+  }
+  last_decrease_ = now;
+  ++decrease_count_;
+  rate_ = (std::max)(options_.min_rate(),
+                     rate_ * options_.multiplicative_decrease());
+  tokens_ = (std::min)(tokens_, rate_);
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
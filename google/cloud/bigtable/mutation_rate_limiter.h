@@ -0,0 +1,188 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_RATE_LIMITER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_RATE_LIMITER_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <grpcpp/support/status_code_enum.h>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Configure the adaptive throttling of mutations, see `MutationRateLimiter`.
+ *
+ * The rates are in mutations per second.
+ */
+class MutationThrottlingOptions {
+ public:
+  MutationThrottlingOptions()
+      : initial_rate_(10000.0),
+        min_rate_(100.0),
+        max_rate_(1000000.0),
+        additive_increase_(1000.0),
+        multiplicative_decrease_(0.5),
+        latency_factor_(3.0),
+        decrease_interval_(std::chrono::milliseconds(500)) {}
+
+  /// The rate before any feedback from the service.
+  MutationThrottlingOptions& set_initial_rate(double value) {
+    initial_rate_ = value;
+    return *this;
+  }
+  double initial_rate() const { return initial_rate_; }
+
+  /// The rate is never reduced below this value.
+  MutationThrottlingOptions& set_min_rate(double value) {
+    min_rate_ = value;
+    return *this;
+  }
+  double min_rate() const { return min_rate_; }
+
+  /// The rate is never increased above this value.
+  MutationThrottlingOptions& set_max_rate(double value) {
+    max_rate_ = value;
+    return *this;
+  }
+  double max_rate() const { return max_rate_; }
+
+  /// Increase the rate by this amount after each successful request.
+  MutationThrottlingOptions& set_additive_increase(double value) {
+    additive_increase_ = value;
+    return *this;
+  }
+  double additive_increase() const { return additive_increase_; }
+
+  /// Multiply the rate by this factor, in (0, 1), when the service overloads.
+  MutationThrottlingOptions& set_multiplicative_decrease(double value) {
+    multiplicative_decrease_ = value;
+    return *this;
+  }
+  double multiplicative_decrease() const { return multiplicative_decrease_; }
+
+  /**
+   * Treat the latency as an overload when it exceeds the baseline by this
+   * factor.
+   *
+   * The latency is measured per mutation, and compared against the lowest
+   * recent value.  Use 0 to ignore the latency.
+   */
+  MutationThrottlingOptions& set_latency_factor(double value) {
+    latency_factor_ = value;
+    return *this;
+  }
+  double latency_factor() const { return latency_factor_; }
+
+  /**
+   * Decrease the rate at most once per interval.
+   *
+   * A single overload typically fails many concurrent requests, they should
+   * result in a single decrease.
+   */
+  MutationThrottlingOptions& set_decrease_interval(
+      std::chrono::milliseconds value) {
+    decrease_interval_ = value;
+    return *this;
+  }
+  std::chrono::milliseconds decrease_interval() const {
+    return decrease_interval_;
+  }
+
+ private:
+  double initial_rate_;
+  double min_rate_;
+  double max_rate_;
+  double additive_increase_;
+  double multiplicative_decrease_;
+  double latency_factor_;
+  std::chrono::milliseconds decrease_interval_;
+};
+
+/**
+ * Adapt the rate of mutations to the capacity of the service.
+ *
+ * This class implements additive increase, multiplicative decrease (AIMD):
+ * the allowed rate grows by a constant after each successful `MutateRows`
+ * request, and it is multiplied by a factor smaller than 1 when the service
+ * reports an overload (`UNAVAILABLE` or `RESOURCE_EXHAUSTED`), or when the
+ * latency rises well above its baseline.  Each request reserves capacity for
+ * its mutations from a token bucket refilled at the current rate, the bucket
+ * holds at most one second worth of mutations.
+ *
+ * A `DataClient` configured with `ClientOptions::set_mutation_throttling()`
+ * owns one of these objects, shared by all the tables that use the client.
+ *
+ * @par Thread-safety
+ * All the member functions are thread-safe.
+ */
+class MutationRateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit MutationRateLimiter(
+      MutationThrottlingOptions options = MutationThrottlingOptions());
+
+  /// Block until @p mutations can be sent.
+  void Acquire(std::size_t mutations);
+
+  /// Reserve capacity for @p mutations, return how long to wait before sending.
+  std::chrono::microseconds Reserve(std::size_t mutations,
+                                    Clock::time_point now);
+
+  /// Report a request for @p mutations that succeeded after @p latency.
+  void OnSuccess(std::size_t mutations, std::chrono::microseconds latency,
+                 Clock::time_point now);
+
+  /// Report a request that found the service overloaded.
+  void OnOverload(Clock::time_point now);
+
+  /// Return true if @p code indicates that the service is overloaded.
+  static bool IsOverload(grpc::StatusCode code) {
+    return code == grpc::StatusCode::UNAVAILABLE or
+           code == grpc::StatusCode::RESOURCE_EXHAUSTED;
+  }
+
+  /// The current rate, in mutations per second.
+  double rate() const;
+
+  /// The number of times the rate was decreased.
+  std::size_t decrease_count() const;
+
+ private:
+  void Refill(Clock::time_point now);
+  void Decrease(Clock::time_point now);
+
+  MutationThrottlingOptions const options_;
+  mutable std::mutex mu_;
+  double rate_;
+  double tokens_;
+  Clock::time_point last_refill_;
+  Clock::time_point last_decrease_;
+  std::size_t decrease_count_;
+  /// The per-mutation latency, in microseconds, smoothed and baseline.
+  double latency_;
+  double baseline_latency_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_MUTATION_RATE_LIMITER_H_
@@ -0,0 +1,114 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
+#include <gmock/gmock.h>
+
+namespace bigtable = google::cloud::bigtable;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using Clock = bigtable::MutationRateLimiter::Clock;
+
+namespace {
+bigtable::MutationThrottlingOptions TestOptions() {
+  return bigtable::MutationThrottlingOptions()
+      .set_initial_rate(1000)
+      .set_min_rate(100)
+      .set_max_rate(1200)
+      .set_additive_increase(50)
+      .set_multiplicative_decrease(0.5)
+      .set_latency_factor(0)
+      .set_decrease_interval(milliseconds(100));
+}
+}  // anonymous namespace
+
+/// @test Verify that the rate grows additively, up to the maximum.
+TEST(MutationRateLimiterTest, AdditiveIncrease) {
+  bigtable::MutationRateLimiter limiter(TestOptions());
+  EXPECT_DOUBLE_EQ(1000.0, limiter.rate());
+  auto now = Clock::now();
+  limiter.OnSuccess(10, microseconds(100), now);
+  EXPECT_DOUBLE_EQ(1050.0, limiter.rate());
+  for (int i = 0; i != 10; ++i) {
+    limiter.OnSuccess(10, microseconds(100), now);
+  }
+  EXPECT_DOUBLE_EQ(1200.0, limiter.rate());
+  EXPECT_EQ(0U, limiter.decrease_count());
+}
+
+/// @test Verify that overloads cut the rate, at most once per interval.
+TEST(MutationRateLimiterTest, MultiplicativeDecrease) {
+  bigtable::MutationRateLimiter limiter(TestOptions());
+  auto now = Clock::now();
+  limiter.OnOverload(now);
+  EXPECT_DOUBLE_EQ(500.0, limiter.rate());
+  // Overloads reported by concurrent requests count only once.
+  limiter.OnOverload(now + milliseconds(10));
+  EXPECT_DOUBLE_EQ(500.0, limiter.rate());
+  limiter.OnOverload(now + milliseconds(110));
+  EXPECT_DOUBLE_EQ(250.0, limiter.rate());
+  limiter.OnOverload(now + milliseconds(220));
+  limiter.OnOverload(now + milliseconds(330));
+  EXPECT_DOUBLE_EQ(100.0, limiter.rate());
+  EXPECT_EQ(4U, limiter.decrease_count());
+}
+
+/// @test Verify that rising latencies cut the rate.
+TEST(MutationRateLimiterTest, LatencyDecrease) {
+  bigtable::MutationRateLimiter limiter(TestOptions().set_latency_factor(2.0));
+  auto now = Clock::now();
+  for (int i = 0; i != 4; ++i) {
+    limiter.OnSuccess(100, microseconds(1000), now);
+  }
+  EXPECT_DOUBLE_EQ(1200.0, limiter.rate());
+  // A single slow request is smoothed out.
+  limiter.OnSuccess(100, microseconds(2500), now);
+  EXPECT_EQ(0U, limiter.decrease_count());
+  // But a sustained increase is not.
+  for (int i = 0; i != 10; ++i) {
+    limiter.OnSuccess(100, microseconds(5000), now);
+  }
+  EXPECT_EQ(1U, limiter.decrease_count());
+  EXPECT_GT(1200.0, limiter.rate());
+}
+
+/// @test Verify that the requests are admitted at the current rate.
+TEST(MutationRateLimiterTest, Reserve) {
+  bigtable::MutationRateLimiter limiter(TestOptions());
+  auto now = Clock::now();
+  // The bucket starts with one second worth of mutations, and can go into
+  // debt, so the first requests are not delayed.
+  EXPECT_EQ(0, limiter.Reserve(600, now).count());
+  EXPECT_EQ(0, limiter.Reserve(600, now).count());
+  // The next request waits until the debt is repaid: 200 mutations at 1000
+  // mutations per second.
+  EXPECT_EQ(200000, limiter.Reserve(100, now).count());
+  // After one second there are 700 tokens available.
+  auto later = now + std::chrono::seconds(1);
+  EXPECT_EQ(0, limiter.Reserve(700, later).count());
+  // A lower rate results in longer delays.
+  limiter.OnOverload(later);
+  EXPECT_EQ(0, limiter.Reserve(500, later).count());
+  EXPECT_EQ(1000000, limiter.Reserve(1, later).count());
+}
+
+/// @test Verify the overload status codes.
+TEST(MutationRateLimiterTest, IsOverload) {
+  using bigtable::MutationRateLimiter;
+  EXPECT_TRUE(MutationRateLimiter::IsOverload(grpc::StatusCode::UNAVAILABLE));
+  EXPECT_TRUE(
+      MutationRateLimiter::IsOverload(grpc::StatusCode::RESOURCE_EXHAUSTED));
+  EXPECT_FALSE(MutationRateLimiter::IsOverload(grpc::StatusCode::OK));
+  EXPECT_FALSE(MutationRateLimiter::IsOverload(grpc::StatusCode::NOT_FOUND));
+}
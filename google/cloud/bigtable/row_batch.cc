@@ -0,0 +1,61 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_batch.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+RowBatch::RowBatch() : cell_offsets_(1, 0) {}
+
+Row RowBatch::row(std::size_t i) const {
+  auto key = row_key(i);
+  std::vector<Cell> cells;
+  cells.reserve(cell_offsets_[i + 1] - cell_offsets_[i]);
+  for (auto c = cell_offsets_[i]; c != cell_offsets_[i + 1]; ++c) {
+    cells.emplace_back(key, families_.Get(c), qualifiers_.Get(c),
+                       timestamps_[c], values_.Get(c),
+                       std::vector<std::string>{});
+  }
+  return Row(std::move(key), std::move(cells));
+}
+
+void RowBatch::Clear() {
+  row_keys_.Clear();
+  cell_offsets_.resize(1);
+  families_.Clear();
+  qualifiers_.Clear();
+  values_.Clear();
+  timestamps_.clear();
+}
+
+void RowBatch::AddRow(std::string const& row_key) {
+  row_keys_.Append(row_key);
+  cell_offsets_.push_back(cell_offsets_.back());
+}
+
+void RowBatch::AddCell(std::string const& family, std::string const& qualifier,
+                       std::int64_t timestamp, std::string const& value) {
+  families_.Append(family);
+  qualifiers_.Append(qualifier);
+  values_.Append(value);
+  timestamps_.push_back(timestamp);
+  ++cell_offsets_.back();
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
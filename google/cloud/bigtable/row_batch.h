@@ -0,0 +1,138 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_BATCH_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_BATCH_H_
+
+#include "google/cloud/bigtable/row.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * A column-oriented representation of a sequence of Bigtable rows.
+ *
+ * Instead of one `Row` object (with one `Cell` object per cell) for each row,
+ * a `RowBatch` stores the data for all its rows in a few contiguous buffers:
+ *
+ * - The row keys are concatenated in `row_keys()`, the key for row `i` is
+ *   the range `[row_key_offsets()[i], row_key_offsets()[i + 1])`.
+ * - The cells for row `i` are the cells with indices in the range
+ *   `[cell_offsets()[i], cell_offsets()[i + 1])`.
+ * - The family names, column qualifiers and values of the cells are
+ *   concatenated in `families()`, `qualifiers()` and `values()`, with the
+ *   same offset scheme as the row keys.
+ * - The timestamps (in microseconds) of the cells are in `timestamps()`.
+ *
+ * Applications can process these buffers with cache-friendly loops, or pass
+ * them to other libraries without copying. Reusing a `RowBatch` (see
+ * `RowReader::NextBatch()`) reuses its buffers. Cell labels are not
+ * included in a `RowBatch`.
+ */
+class RowBatch {
+ public:
+  RowBatch();
+
+  /// The number of rows in the batch.
+  std::size_t size() const { return cell_offsets_.size() - 1; }
+
+  /// True if the batch has no rows.
+  bool empty() const { return size() == 0; }
+
+  /// The total number of cells in the batch.
+  std::size_t cell_count() const { return timestamps_.size(); }
+
+  //@{
+  /// @name Row data.
+  std::string const& row_keys() const { return row_keys_.data; }
+  std::vector<std::size_t> const& row_key_offsets() const {
+    return row_keys_.offsets;
+  }
+  std::vector<std::size_t> const& cell_offsets() const {
+    return cell_offsets_;
+  }
+  //@}
+
+  //@{
+  /// @name Cell data.
+  std::string const& families() const { return families_.data; }
+  std::vector<std::size_t> const& family_offsets() const {
+    return families_.offsets;
+  }
+  std::string const& qualifiers() const { return qualifiers_.data; }
+  std::vector<std::size_t> const& qualifier_offsets() const {
+    return qualifiers_.offsets;
+  }
+  std::string const& values() const { return values_.data; }
+  std::vector<std::size_t> const& value_offsets() const {
+    return values_.offsets;
+  }
+  std::vector<std::int64_t> const& timestamps() const { return timestamps_; }
+  //@}
+
+  /// Return a copy of the key for row @p i.
+  std::string row_key(std::size_t i) const { return row_keys_.Get(i); }
+
+  /// Return a copy of row @p i.
+  Row row(std::size_t i) const;
+
+  /// Remove all the rows, but keep the allocated buffers.
+  void Clear();
+
+  /// Add a new row, with no cells, to the batch.
+  void AddRow(std::string const& row_key);
+
+  /// Add a cell to the last row in the batch.
+  void AddCell(std::string const& family, std::string const& qualifier,
+               std::int64_t timestamp, std::string const& value);
+
+ private:
+  /// A sequence of strings, concatenated in a single buffer.
+  struct Arena {
+    Arena() : offsets(1, 0) {}
+
+    void Append(std::string const& value) {
+      data.append(value);
+      offsets.push_back(data.size());
+    }
+    std::string Get(std::size_t i) const {
+      return data.substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    void Clear() {
+      data.clear();
+      offsets.resize(1);
+    }
+
+    std::string data;
+    std::vector<std::size_t> offsets;
+  };
+
+  Arena row_keys_;
+  std::vector<std::size_t> cell_offsets_;
+  Arena families_;
+  Arena qualifiers_;
+  Arena values_;
+  std::vector<std::int64_t> timestamps_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_BATCH_H_
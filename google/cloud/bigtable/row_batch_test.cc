@@ -0,0 +1,92 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_batch.h"
+#include <gtest/gtest.h>
+
+namespace bigtable = google::cloud::bigtable;
+
+/// @test Verify that an empty RowBatch has no rows or cells.
+TEST(RowBatchTest, Empty) {
+  bigtable::RowBatch batch;
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(0U, batch.size());
+  EXPECT_EQ(0U, batch.cell_count());
+  EXPECT_EQ(std::vector<std::size_t>{0}, batch.cell_offsets());
+  EXPECT_EQ(std::vector<std::size_t>{0}, batch.row_key_offsets());
+}
+
+/// @test Verify the column-oriented layout of a RowBatch.
+TEST(RowBatchTest, Layout) {
+  bigtable::RowBatch batch;
+  batch.AddRow("r1");
+  batch.AddCell("fam", "c1", 10, "v1");
+  batch.AddCell("fam", "c2", 20, "value2");
+  batch.AddRow("row2");
+  batch.AddRow("r3");
+  batch.AddCell("f", "c3", 30, "v3");
+
+  EXPECT_EQ(3U, batch.size());
+  EXPECT_EQ(3U, batch.cell_count());
+  EXPECT_EQ("r1row2r3", batch.row_keys());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 6, 8}), batch.row_key_offsets());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 2, 3}), batch.cell_offsets());
+  EXPECT_EQ("famfamf", batch.families());
+  EXPECT_EQ((std::vector<std::size_t>{0, 3, 6, 7}), batch.family_offsets());
+  EXPECT_EQ("c1c2c3", batch.qualifiers());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 4, 6}), batch.qualifier_offsets());
+  EXPECT_EQ("v1value2v3", batch.values());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 8, 10}), batch.value_offsets());
+  EXPECT_EQ((std::vector<std::int64_t>{10, 20, 30}), batch.timestamps());
+  EXPECT_EQ("row2", batch.row_key(1));
+}
+
+/// @test Verify the conversion from RowBatch to Row.
+TEST(RowBatchTest, ConvertToRow) {
+  bigtable::RowBatch batch;
+  batch.AddRow("r1");
+  batch.AddRow("r2");
+  batch.AddCell("fam", "c1", 10, "v1");
+  batch.AddCell("fam", "c2", 20, "v2");
+
+  auto r0 = batch.row(0);
+  EXPECT_EQ("r1", r0.row_key());
+  EXPECT_TRUE(r0.cells().empty());
+
+  auto r1 = batch.row(1);
+  EXPECT_EQ("r2", r1.row_key());
+  ASSERT_EQ(2U, r1.cells().size());
+  EXPECT_EQ("r2", r1.cells()[0].row_key());
+  EXPECT_EQ("fam", r1.cells()[0].family_name());
+  EXPECT_EQ("c1", r1.cells()[0].column_qualifier());
+  EXPECT_EQ(10, r1.cells()[0].timestamp().count());
+  EXPECT_EQ("v1", r1.cells()[0].value());
+  EXPECT_EQ("v2", r1.cells()[1].value());
+}
+
+/// @test Verify that Clear() removes all the rows.
+TEST(RowBatchTest, Clear) {
+  bigtable::RowBatch batch;
+  batch.AddRow("r1");
+  batch.AddCell("fam", "c1", 10, "v1");
+  batch.Clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(0U, batch.cell_count());
+  EXPECT_TRUE(batch.values().empty());
+
+  batch.AddRow("r2");
+  batch.AddCell("fam", "c2", 20, "v2");
+  EXPECT_EQ(1U, batch.size());
+  EXPECT_EQ("v2", batch.row(0).cells()[0].value());
+}
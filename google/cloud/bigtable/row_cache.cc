@@ -0,0 +1,171 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_cache.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Estimate the memory used by a cached result.
+std::size_t EstimateSize(std::string const& row_key, std::string const& filter,
+                         Row const& row) {
+  // Each entry is in a list and two hash maps, and has a copy of the keys in
+  // each one.  The exact overhead depends on the library, this is close
+  // enough.
+  std::size_t size = 128 + 3 * (row_key.size() + filter.size());
+  for (auto const& cell : row.cells()) {
+    size += sizeof(Cell) + cell.row_key().size() + cell.family_name().size() +
+            cell.column_qualifier().size() + cell.value().size();
+    for (auto const& label : cell.labels()) {
+      size += sizeof(std::string) + label.size();
+    }
+  }
+  return size;
+}
+}  // anonymous namespace
+
+RowCache::RowCache(std::size_t max_bytes, std::chrono::milliseconds ttl,
+                   std::size_t shard_count)
+    : max_shard_bytes_(max_bytes / (std::max)(shard_count, std::size_t(1))),
+      ttl_(ttl) {
+  if (shard_count == 0) {
+    google::cloud::internal::RaiseRangeError(
+        "RowCache requires shard_count > 0");
+  }
+  for (std::size_t i = 0; i != shard_count; ++i) {
+    shards_.emplace_back(new Shard);
+  }
+}
+
+bool RowCache::Lookup(std::string const& row_key, std::string const& filter,
+                      std::pair<bool, Row>& result, std::uint64_t& token) {
+  auto& shard = ShardFor(row_key);
+  std::lock_guard<std::mutex> lk(shard.mu);
+  token = shard.generation;
+  auto row = shard.index.find(row_key);
+  if (row == shard.index.end()) {
+    ++shard.misses;
+    return false;
+  }
+  auto loc = row->second.find(filter);
+  if (loc == row->second.end()) {
+    ++shard.misses;
+    return false;
+  }
+  auto entry = loc->second;
+  if (entry->expiration <= std::chrono::steady_clock::now()) {
+    ++shard.expirations;
+    ++shard.misses;
+    Erase(shard, entry);
+    return false;
+  }
+  ++shard.hits;
+  shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+  result = entry->result;
+  return true;
+}
+
+void RowCache::Insert(std::string const& row_key, std::string const& filter,
+                      std::pair<bool, Row> const& result,
+                      std::uint64_t token) {
+  auto const bytes = EstimateSize(row_key, filter, result.second);
+  if (bytes > max_shard_bytes_) {
+    return;
+  }
+  auto& shard = ShardFor(row_key);
+  std::lock_guard<std::mutex> lk(shard.mu);
+  if (shard.generation != token) {
+    return;
+  }
+  auto& filters = shard.index[row_key];
+  auto loc = filters.find(filter);
+  if (loc != filters.end()) {
+    // Another thread cached the same result, keep the newest.
+    Erase(shard, loc->second);
+  }
+  shard.lru.push_front(Entry{row_key, filter, result,
+                             std::chrono::steady_clock::now() + ttl_, bytes});
+  shard.index[row_key][filter] = shard.lru.begin();
+  shard.bytes += bytes;
+  while (shard.bytes > max_shard_bytes_) {
+    ++shard.evictions;
+    Erase(shard, std::prev(shard.lru.end()));
+  }
+}
+
+void RowCache::Invalidate(std::string const& row_key) {
+  auto& shard = ShardFor(row_key);
+  std::lock_guard<std::mutex> lk(shard.mu);
+  ++shard.generation;
+  auto row = shard.index.find(row_key);
+  if (row == shard.index.end()) {
+    return;
+  }
+  std::vector<EntryList::iterator> entries;
+  for (auto const& kv : row->second) {
+    entries.push_back(kv.second);
+  }
+  for (auto entry : entries) {
+    ++shard.invalidations;
+    Erase(shard, entry);
+  }
+}
+
+void RowCache::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    ++shard->generation;
+    shard->lru.clear();
+    shard->index.clear();
+    shard->bytes = 0;
+  }
+}
+
+RowCache::Stats RowCache::stats() const {
+  Stats stats{0, 0, 0, 0, 0, 0, 0};
+  for (auto const& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.evictions += shard->evictions;
+    stats.expirations += shard->expirations;
+    stats.invalidations += shard->invalidations;
+    stats.entries += shard->lru.size();
+    stats.bytes += shard->bytes;
+  }
+  return stats;
+}
+
+RowCache::Shard& RowCache::ShardFor(std::string const& row_key) const {
+  return *shards_[std::hash<std::string>()(row_key) % shards_.size()];
+}
+
+void RowCache::Erase(Shard& shard, EntryList::iterator entry) {
+  auto row = shard.index.find(entry->row_key);
+  row->second.erase(entry->filter);
+  if (row->second.empty()) {
+    shard.index.erase(row);
+  }
+  shard.bytes -= entry->bytes;
+  shard.lru.erase(entry);
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
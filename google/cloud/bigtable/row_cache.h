@@ -0,0 +1,143 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
+
+#include "google/cloud/bigtable/row.h"
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * A client-side cache for the results of `Table::ReadRow()`.
+ *
+ * The cache keeps the most recently used rows, up to a total (approximate)
+ * size in bytes, and for at most the configured time-to-live.  The results
+ * are keyed by the row key and the filter, and rows that do not exist are
+ * cached too.  The writes made through the `Table` using the cache
+ * invalidate the rows they modify, but changes made by other clients are only
+ * visible once the cached results expire.
+ *
+ * The cache is divided in shards, each with its own lock, so many threads can
+ * use it concurrently.  A cache should be used by a single table (and its
+ * copies), the entries do not include the table name.
+ */
+class RowCache {
+ public:
+  /// The cache counters, see `stats()`.
+  struct Stats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+    std::uint64_t expirations;
+    std::uint64_t invalidations;
+    std::size_t entries;
+    std::size_t bytes;
+  };
+
+  /**
+   * Create a cache.
+   *
+   * @param max_bytes the maximum size of the cached rows, evenly split across
+   *     the shards.
+   * @param ttl how long are the results kept in the cache.
+   * @param shard_count the number of shards, larger values reduce the
+   *     contention between threads.
+   */
+  RowCache(std::size_t max_bytes, std::chrono::milliseconds ttl,
+           std::size_t shard_count = 16);
+
+  RowCache(RowCache const&) = delete;
+  RowCache& operator=(RowCache const&) = delete;
+
+  /**
+   * Find the result of a previous `ReadRow()`.
+   *
+   * @param token on a miss, set to the value to pass to `Insert()`.
+   * @return true if @p result was found in the cache.
+   */
+  bool Lookup(std::string const& row_key, std::string const& filter,
+              std::pair<bool, Row>& result, std::uint64_t& token);
+
+  /**
+   * Cache the result of a `ReadRow()`.
+   *
+   * The result is discarded if the row was invalidated after the `Lookup()`
+   * that returned @p token, as the result may predate the invalidating write.
+   */
+  void Insert(std::string const& row_key, std::string const& filter,
+              std::pair<bool, Row> const& result, std::uint64_t token);
+
+  /// Discard all the results for @p row_key.
+  void Invalidate(std::string const& row_key);
+
+  /// Discard all the results.
+  void Clear();
+
+  /// Return the current counters.
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::string row_key;
+    std::string filter;
+    std::pair<bool, Row> result;
+    std::chrono::steady_clock::time_point expiration;
+    std::size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    std::mutex mu;
+    /// The entries, in most recently used order.
+    EntryList lru;
+    /// The entries for each row key, indexed by filter.
+    std::unordered_map<std::string,
+                       std::unordered_map<std::string, EntryList::iterator>>
+        index;
+    std::size_t bytes = 0;
+    /// Incremented by each invalidation, see `Insert()`.
+    std::uint64_t generation = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t expirations = 0;
+    std::uint64_t invalidations = 0;
+  };
+
+  Shard& ShardFor(std::string const& row_key) const;
+  static void Erase(Shard& shard, EntryList::iterator entry);
+
+  std::size_t const max_shard_bytes_;
+  std::chrono::milliseconds const ttl_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
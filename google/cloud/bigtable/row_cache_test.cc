@@ -0,0 +1,151 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_cache.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+
+namespace {
+std::pair<bool, bigtable::Row> MakeRow(std::string const& key,
+                                       std::string const& value) {
+  return std::make_pair(
+      true, bigtable::Row(key, {bigtable::Cell(key, "fam", "col", 0, value,
+                                               {})}));
+}
+}  // anonymous namespace
+
+/// @test Verify that the cache returns the inserted results.
+TEST(RowCacheTest, HitAndMiss) {
+  bigtable::RowCache cache(1024 * 1024, std::chrono::minutes(5));
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+  cache.Insert("r1", "f1", MakeRow("r1", "v1"), token);
+
+  EXPECT_TRUE(cache.Lookup("r1", "f1", result, token));
+  EXPECT_TRUE(result.first);
+  EXPECT_EQ("r1", result.second.row_key());
+  ASSERT_EQ(1U, result.second.cells().size());
+  EXPECT_EQ("v1", result.second.cells()[0].value());
+
+  // The filter is part of the key.
+  EXPECT_FALSE(cache.Lookup("r1", "f2", result, token));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.hits);
+  EXPECT_EQ(2U, stats.misses);
+  EXPECT_EQ(1U, stats.entries);
+  EXPECT_LT(0U, stats.bytes);
+}
+
+/// @test Verify that missing rows are cached too.
+TEST(RowCacheTest, CachesMissingRows) {
+  bigtable::RowCache cache(1024 * 1024, std::chrono::minutes(5));
+  std::pair<bool, bigtable::Row> result(true, bigtable::Row("x", {}));
+  std::uint64_t token;
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+  cache.Insert("r1", "f1", std::make_pair(false, bigtable::Row("", {})),
+               token);
+  EXPECT_TRUE(cache.Lookup("r1", "f1", result, token));
+  EXPECT_FALSE(result.first);
+}
+
+/// @test Verify that the results expire.
+TEST(RowCacheTest, Expiration) {
+  bigtable::RowCache cache(1024 * 1024, std::chrono::milliseconds(5));
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+  cache.Insert("r1", "f1", MakeRow("r1", "v1"), token);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.expirations);
+  EXPECT_EQ(0U, stats.entries);
+  EXPECT_EQ(0U, stats.bytes);
+}
+
+/// @test Verify that the least recently used results are evicted.
+TEST(RowCacheTest, EvictsLeastRecentlyUsed) {
+  // Use a single shard, so the eviction order is predictable.
+  bigtable::RowCache cache(2500, std::chrono::minutes(5), 1);
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  std::string const value(400, 'x');
+  for (auto const& key : {"r1", "r2", "r3"}) {
+    EXPECT_FALSE(cache.Lookup(key, "f", result, token));
+    cache.Insert(key, "f", MakeRow(key, value), token);
+  }
+  // Use r1, so r2 is the least recently used.
+  EXPECT_TRUE(cache.Lookup("r1", "f", result, token));
+  EXPECT_FALSE(cache.Lookup("r4", "f", result, token));
+  cache.Insert("r4", "f", MakeRow("r4", value), token);
+
+  EXPECT_FALSE(cache.Lookup("r2", "f", result, token));
+  EXPECT_TRUE(cache.Lookup("r1", "f", result, token));
+  EXPECT_TRUE(cache.Lookup("r4", "f", result, token));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.evictions);
+  EXPECT_GE(2500U, stats.bytes);
+}
+
+/// @test Verify that results larger than the cache are not inserted.
+TEST(RowCacheTest, SkipsLargeRows) {
+  bigtable::RowCache cache(1024, std::chrono::minutes(5), 1);
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  EXPECT_FALSE(cache.Lookup("r1", "f", result, token));
+  cache.Insert("r1", "f", MakeRow("r1", std::string(2048, 'x')), token);
+  EXPECT_FALSE(cache.Lookup("r1", "f", result, token));
+  EXPECT_EQ(0U, cache.stats().entries);
+}
+
+/// @test Verify that Invalidate() discards all the results for a row.
+TEST(RowCacheTest, Invalidate) {
+  bigtable::RowCache cache(1024 * 1024, std::chrono::minutes(5));
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  for (auto const& filter : {"f1", "f2"}) {
+    EXPECT_FALSE(cache.Lookup("r1", filter, result, token));
+    cache.Insert("r1", filter, MakeRow("r1", "v1"), token);
+  }
+  EXPECT_FALSE(cache.Lookup("r2", "f1", result, token));
+  cache.Insert("r2", "f1", MakeRow("r2", "v2"), token);
+
+  cache.Invalidate("r1");
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+  EXPECT_FALSE(cache.Lookup("r1", "f2", result, token));
+  EXPECT_TRUE(cache.Lookup("r2", "f1", result, token));
+  EXPECT_EQ(2U, cache.stats().invalidations);
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Lookup("r2", "f1", result, token));
+  EXPECT_EQ(0U, cache.stats().entries);
+}
+
+/// @test Verify that results read before an invalidation are not cached.
+TEST(RowCacheTest, InvalidateDiscardsPendingInserts) {
+  bigtable::RowCache cache(1024 * 1024, std::chrono::minutes(5));
+  std::pair<bool, bigtable::Row> result(false, bigtable::Row("", {}));
+  std::uint64_t token;
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+  // A write completes while the read is in flight.
+  cache.Invalidate("r1");
+  cache.Insert("r1", "f1", MakeRow("r1", "stale"), token);
+  EXPECT_FALSE(cache.Lookup("r1", "f1", result, token));
+}
@@ -20,23 +20,6 @@ namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace btproto = ::google::bigtable::v2;
 
-namespace {
-
-/// Returns true iff a < b and there is no string c such that a < c < b.
-inline bool Consecutive(std::string const& a, std::string const& b) {
-  // The only way for two strings to be consecutive is for the
-  // second to be equal to the first with an appended zero char.
-  if (b.length() != a.length() + 1) {
-    return false;
-  }
-  if (b.back() != '\0') {
-    return false;
-  }
-  return b.compare(0, a.length(), a) == 0;
-}
-
-}  // anonymous namespace
-
 bool RowRange::IsEmpty() const {
   std::string unused;
   // We do not want to copy the strings unnecessarily, so initialize a reference
@@ -112,6 +95,18 @@ bool RowRange::AboveEnd(std::string const& key) const {
   return false;
 }
 
+bool RowRange::Consecutive(std::string const& a, std::string const& b) {
+  // The only way for two strings to be consecutive is for the
+  // second to be equal to the first with an appended zero char.
+  if (b.length() != a.length() + 1) {
+    return false;
+  }
+  if (b.back() != '\0') {
+    return false;
+  }
+  return b.compare(0, a.length(), a) == 0;
+}
+
 std::pair<bool, RowRange> RowRange::Intersect(RowRange const& range) const {
   if (range.IsEmpty()) {
     return std::make_pair(false, RowRange::Empty());
@@ -158,9 +158,15 @@ class RowRange {
   friend std::ostream& operator<<(std::ostream& os, RowRange const& x);
 
  private:
+  /// `RowSet::Normalize()` uses the range comparison helpers.
+  friend class RowSet;
+
   /// Private to avoid mistaken creation of uninitialized ranges.
   RowRange() {}
 
+  /// Returns true iff a < b and there is no string c such that a < c < b.
+  static bool Consecutive(std::string const& a, std::string const& b);
+
   /// Return true if @p key is below the start.
   bool BelowStart(std::string const& key) const;
 
@@ -14,8 +14,11 @@
 
 #include "google/cloud/bigtable/row_reader.h"
 #include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/internal/rpc_metrics.h"
 #include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/internal/retry_budget.h"
 #include "google/cloud/internal/throw_delegate.h"
+#include <algorithm>
 #include <thread>
 
 namespace google {
@@ -46,6 +49,27 @@ static_assert(std::is_same<decltype(++std::declval<RowReader::iterator>()),
               "++it when it is of RowReader::iterator type must be a "
               "RowReader::iterator &>");
 
+namespace {
+/// The metrics for `ReadRows`, including the rows and cells received.
+struct ReadRowsMetrics {
+  ReadRowsMetrics()
+      : rpc(internal::RpcMetrics<google::bigtable::v2::ReadRowsRequest>()),
+        rows(google::cloud::DefaultMetricsRegistry().GetCounter(
+            "bigtable.ReadRows.rows")),
+        cells(google::cloud::DefaultMetricsRegistry().GetCounter(
+            "bigtable.ReadRows.cells")) {}
+
+  google::cloud::internal::OperationMetrics& rpc;
+  google::cloud::Counter& rows;
+  google::cloud::Counter& cells;
+};
+
+ReadRowsMetrics& Metrics() {
+  static auto* const metrics = new ReadRowsMetrics;
+  return *metrics;
+}
+}  // namespace
+
 RowReader::RowReader(
     std::shared_ptr<DataClient> client, bigtable::TableId table_name,
     RowSet row_set, std::int64_t rows_limit, Filter filter,
@@ -108,9 +132,28 @@ RowReader::RowReader(
       operation_cancelled_(false),
       processed_chunks_count_(0),
       rows_count_(0),
+      cells_count_(0),
+      attempt_count_(0),
+      attempt_bytes_received_(0),
       status_(grpc::Status::OK),
       raise_on_error_(raise_on_error),
-      error_retrieved_(raise_on_error) {}
+      error_retrieved_(raise_on_error),
+      unretriable_failure_(false) {}
+
+RowReader::PrefetchOptions::PrefetchOptions()
+    : max_rows_(100), max_bytes_(16 * 1024 * 1024) {}
+
+RowReader::PrefetchOptions& RowReader::PrefetchOptions::set_max_rows(
+    std::size_t value) {
+  max_rows_ = std::max(value, std::size_t(1));
+  return *this;
+}
+
+RowReader::PrefetchOptions& RowReader::PrefetchOptions::set_max_bytes(
+    std::size_t value) {
+  max_bytes_ = std::max(value, std::size_t(1));
+  return *this;
+}
 
 // The name must be all lowercase to work with range-for loops.
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -127,6 +170,9 @@ RowReader::iterator RowReader::begin() {
   if (not stream_) {
     MakeRequest();
   }
+  if (prefetch_ and not prefetch_thread_.joinable()) {
+    prefetch_thread_ = std::thread(&RowReader::PrefetchLoop, this);
+  }
   // Increment the iterator to read a row.
   return ++internal::RowReaderIterator(this, false);
 }
@@ -146,8 +192,9 @@ void RowReader::MakeRequest() {
   bigtable::internal::SetCommonTableOperationRequest<
       google::bigtable::v2::ReadRowsRequest>(request, app_profile_id_.get(),
                                              table_name_.get());
-  auto row_set_proto = row_set_.as_proto();
-  request.mutable_rows()->Swap(&row_set_proto);
+  // The request is serialized before `ReadRows()` returns, so the row set is
+  // swapped in, and back out after the call, instead of copying it.
+  request.mutable_rows()->Swap(&row_set_.row_set_);
 
   auto filter_proto = filter_.as_proto();
   request.mutable_filter()->Swap(&filter_proto);
@@ -156,11 +203,29 @@ void RowReader::MakeRequest() {
     request.set_rows_limit(rows_limit_ - rows_count_);
   }
 
-  context_ = bigtable::internal::make_unique<grpc::ClientContext>();
-  retry_policy_->Setup(*context_);
-  backoff_policy_->Setup(*context_);
-  metadata_update_policy_.Setup(*context_);
-  stream_ = client_->ReadRows(context_.get(), request);
+  auto context = bigtable::internal::make_unique<grpc::ClientContext>();
+  retry_policy_->Setup(*context);
+  backoff_policy_->Setup(*context);
+  metadata_update_policy_.Setup(*context);
+  if (prefetch_) {
+    // Cancel() may be called from the application thread at any time.
+    prefetch_->RegisterContext(context.get());
+  }
+  context_ = std::move(context);
+  attempt_start_ = std::chrono::steady_clock::now();
+  if (not stream_) {
+    operation_start_ = attempt_start_;
+    operation_span_ = google::cloud::internal::Span(Metrics().rpc.name);
+  }
+  Metrics().rpc.attempts.Increment();
+  attempt_span_ = google::cloud::internal::Span("attempt", operation_span_);
+  attempt_span_.SetAttribute("attempt", ++attempt_count_);
+  attempt_bytes_received_ = 0;
+  {
+    google::cloud::internal::CurrentSpanScope scope(attempt_span_);
+    stream_ = client_->ReadRows(context_.get(), request);
+  }
+  request.mutable_rows()->Swap(&row_set_.row_set_);
   stream_is_open_ = true;
 
   parser_ = parser_factory_->Create();
@@ -175,16 +240,120 @@ bool RowReader::NextChunk() {
       response_ = {};
       return false;
     }
+    auto const bytes = response_.ByteSizeLong();
+    Metrics().rpc.bytes_received.Increment(bytes);
+    attempt_bytes_received_ += static_cast<std::int64_t>(bytes);
   }
   return true;
 }
 
+void RowReader::FinishAttempt(grpc::Status const& status) {
+  attempt_end_ = std::chrono::steady_clock::now();
+  Metrics().rpc.attempt_latency.Record(attempt_end_ - attempt_start_);
+  attempt_span_.SetAttribute("bytes_received", attempt_bytes_received_);
+  attempt_span_.SetStatus(status.error_code(), status.error_message());
+  attempt_span_.End();
+}
+
 void RowReader::Advance(internal::OptionalRow& row) {
+  if (not prefetch_) {
+    ReadNextRow(row);
+    return;
+  }
+  if (prefetch_->Pop(row)) {
+    return;
+  }
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  if (prefetch_->cancelled()) {
+    return;
+  }
+  status_ = prefetch_->status();
+  if (raise_on_error_ and prefetch_->unretriable()) {
+    google::cloud::internal::RaiseRuntimeError("Unretriable error: " +
+                                               status_.error_message());
+  }
+}
+
+void RowReader::ReadNextRow(internal::OptionalRow& row) {
+  row.reset();
+  if (not AdvanceParser()) {
+    return;
+  }
+  grpc::Status status;
+  Row parsed_row = parser_->Next(status);
+  if (not status.ok()) {
+    status_ = status;
+    return;
+  }
+  row.emplace(std::move(parsed_row));
+  ++rows_count_;
+  last_read_row_key_ = std::string(row.value().row_key());
+}
+
+bool RowReader::NextView(RowView& row) {
+  if (not PrepareDirectRead() or not AdvanceParser()) {
+    return false;
+  }
+  grpc::Status status;
+  RowView parsed_row = parser_->NextView(status);
+  if (not status.ok()) {
+    status_ = status;
+    return false;
+  }
+  ++rows_count_;
+  last_read_row_key_ = parsed_row.row_key();
+  row = std::move(parsed_row);
+  return true;
+}
+
+bool RowReader::NextBatch(RowBatch& batch, std::size_t max_rows) {
+  batch.Clear();
+  if (not PrepareDirectRead()) {
+    return false;
+  }
+  while (batch.size() < max_rows and AdvanceParser()) {
+    grpc::Status status;
+    parser_->AppendNextRow(batch, status);
+    if (not status.ok()) {
+      status_ = status;
+      break;
+    }
+    ++rows_count_;
+    // Retries in the next AdvanceParser() call must skip this row.
+    last_read_row_key_ = batch.row_key(batch.size() - 1);
+  }
+  return not batch.empty();
+}
+
+bool RowReader::PrepareDirectRead() {
+  if (operation_cancelled_) {
+    if (raise_on_error_) {
+      google::cloud::internal::RaiseRuntimeError(
+          "Operation already cancelled.");
+    }
+    status_ = grpc::Status::CANCELLED;
+    return false;
+  }
+  if (not stream_) {
+    MakeRequest();
+    return true;
+  }
+  return stream_is_open_ or parser_->HasNext();
+}
+
+bool RowReader::AdvanceParser() {
   while (true) {
     grpc::Status status;
-    status_ = status = AdvanceOrFail(row);
+    status_ = status = AdvanceOrFail();
     if (status.ok()) {
-      return;
+      return parser_->HasNext();
+    }
+    if (stream_is_open_) {
+      // The stream is still open if the parser failed, the attempt is over
+      // nonetheless.
+      FinishAttempt(status);
     }
 
     // In the unlikely case when we have already reached the requested
@@ -192,42 +361,72 @@ void RowReader::Advance(internal::OptionalRow& row) {
     // an error at end of stream for example), there is no need to
     // retry and we have no good value for rows_limit anyway.
     if (rows_limit_ != NO_ROWS_LIMIT and rows_limit_ <= rows_count_) {
-      return;
+      return false;
     }
 
     if (not last_read_row_key_.empty()) {
       // We've returned some rows and need to make sure we don't
       // request them again.
-      row_set_ = row_set_.Intersect(RowRange::Open(last_read_row_key_, ""));
+      row_set_.ResumeAfter(last_read_row_key_);
     }
 
     // If we receive an error, but the retriable set is empty, stop.
     if (row_set_.IsEmpty()) {
-      return;
+      return false;
     }
 
-    if (not status.ok() and not retry_policy_->OnFailure(status)) {
+    if (prefetch_ and prefetch_->cancelled()) {
+      return false;
+    }
+
+    bool retry = retry_policy_->OnFailure(status);
+    auto& budget = google::cloud::internal::DefaultRetryBudget();
+    if (retry and not budget.TryRetry()) {
+      // Too many requests in this process are retrying, give up, and report
+      // the reason in the error.
+      retry = false;
+      status_ = status = grpc::Status(
+          status.error_code(),
+          std::string(google::cloud::internal::kRetryBudgetExhausted) + ": " +
+              status.error_message());
+    }
+    if (not retry) {
+      Metrics().rpc.errors.Increment();
+      if (prefetch_) {
+        // Let the thread iterating over the results raise the error.
+        unretriable_failure_ = true;
+        return false;
+      }
       if (raise_on_error_) {
         google::cloud::internal::RaiseRuntimeError("Unretriable error: " +
                                                    status.error_message());
         /*NOTREACHED*/
       }
-      return;
+      return false;
     }
 
+    Metrics().rpc.retries.Increment();
     auto delay = backoff_policy_->OnCompletion(status);
-    std::this_thread::sleep_for(delay);
+    {
+      google::cloud::internal::Span backoff_span("backoff", operation_span_);
+      backoff_span.SetAttribute("delay_us", delay);
+      std::this_thread::sleep_for(delay);
+    }
 
     // If we reach this place, we failed and need to restart the call.
     MakeRequest();
   }
 }
 
-grpc::Status RowReader::AdvanceOrFail(internal::OptionalRow& row) {
+grpc::Status RowReader::AdvanceOrFail() {
   grpc::Status status;
-  row.reset();
   while (not parser_->HasNext()) {
     if (NextChunk()) {
+      auto const& chunk = response_.chunks(processed_chunks_count_);
+      // The last (or only) piece of each cell has no value_size.
+      if (chunk.value_size() == 0 and not chunk.reset_row()) {
+        ++cells_count_;
+      }
       parser_->HandleChunk(
           std::move(*(response_.mutable_chunks(processed_chunks_count_))),
           status);
@@ -242,30 +441,63 @@ grpc::Status RowReader::AdvanceOrFail(internal::OptionalRow& row) {
     // fails during cleanup.
     stream_is_open_ = false;
     status = stream_->Finish();
+    FinishAttempt(status);
     if (not status.ok()) {
       return status;
     }
+    google::cloud::internal::DefaultRetryBudget().OnSuccess();
     parser_->HandleEndOfStream(status);
     return status;
   }
 
   // We have a complete row in the parser.
-  Row parsed_row = parser_->Next(status);
-  if (not status.ok()) {
-    return status;
+  return status;
+}
+
+grpc::Status RowReader::Finish() {
+  error_retrieved_ = true;
+  if (prefetch_thread_.joinable()) {
+    return prefetch_->status();
   }
-  row.emplace(std::move(parsed_row));
-  ++rows_count_;
-  last_read_row_key_ = std::string(row.value().row_key());
+  return status_;
+}
 
-  return status;
+void RowReader::EnablePrefetch(PrefetchOptions options) {
+  prefetch_ = bigtable::internal::make_unique<internal::RowPrefetchQueue>(
+      options.max_rows(), options.max_bytes());
+}
+
+void RowReader::PrefetchLoop() {
+  while (true) {
+    internal::OptionalRow row;
+    unretriable_failure_ = false;
+    ReadNextRow(row);
+    if (not row) {
+      if (prefetch_->cancelled()) {
+        // Cancelling the request is not an error, same as without prefetch.
+        status_ = grpc::Status::OK;
+      }
+      prefetch_->Close(status_, unretriable_failure_);
+      return;
+    }
+    if (not prefetch_->Push(std::move(*row))) {
+      prefetch_->Close(grpc::Status::OK, false);
+      return;
+    }
+  }
 }
 
 void RowReader::Cancel() {
   operation_cancelled_ = true;
+  if (prefetch_thread_.joinable()) {
+    prefetch_->Cancel();
+    prefetch_thread_.join();
+  }
   if (not stream_is_open_) {
     return;
   }
+  // The attempt, and the operation, end when the application stops reading.
+  attempt_end_ = std::chrono::steady_clock::now();
   context_->TryCancel();
 
   // Also drain any data left unread
@@ -278,8 +510,25 @@ void RowReader::Cancel() {
 }
 
 RowReader::~RowReader() {
-  // Make sure we don't leave open streams.
+  // Make sure we don't leave open streams. This also stops the prefetch
+  // thread, if any, before the metrics below read its state.
   Cancel();
+  if (stream_) {
+    auto& metrics = Metrics();
+    metrics.rpc.operations.Increment();
+    // The operation ends with its last attempt, `Cancel()` ends any attempt
+    // still open.
+    metrics.rpc.latency.Record(attempt_end_ - operation_start_);
+    metrics.rows.Increment(static_cast<std::uint64_t>(rows_count_));
+    metrics.cells.Increment(static_cast<std::uint64_t>(cells_count_));
+    // An attempt interrupted by `Cancel()` ends with the operation.
+    attempt_span_.End();
+    operation_span_.SetAttribute("attempts", attempt_count_);
+    operation_span_.SetAttribute("rows", rows_count_);
+    operation_span_.SetAttribute("cells", cells_count_);
+    operation_span_.SetStatus(status_.error_code(), status_.error_message());
+    operation_span_.End();
+  }
   if (not raise_on_error_ and not error_retrieved_ and not status_.ok()) {
     google::cloud::internal::RaiseRuntimeError(
         "Exception is disabled and error is not retrieved");
@@ -19,17 +19,22 @@
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/filters.h"
 #include "google/cloud/bigtable/internal/readrowsparser.h"
+#include "google/cloud/bigtable/internal/row_prefetch_queue.h"
 #include "google/cloud/bigtable/internal/rowreaderiterator.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
 #include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_batch.h"
 #include "google/cloud/bigtable/row_set.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/table_strong_types.h"
+#include "google/cloud/tracing.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
 #include <grpcpp/grpcpp.h>
+#include <chrono>
 #include <cinttypes>
 #include <iterator>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -50,6 +55,24 @@ class RowReader {
    */
   static std::int64_t constexpr NO_ROWS_LIMIT = 0;
 
+  /// Configure the read-ahead buffer used by `EnablePrefetch()`.
+  class PrefetchOptions {
+   public:
+    PrefetchOptions();
+
+    /// The maximum number of rows read ahead of the application.
+    std::size_t max_rows() const { return max_rows_; }
+    PrefetchOptions& set_max_rows(std::size_t value);
+
+    /// The maximum size (in bytes, approximately) of the rows read ahead.
+    std::size_t max_bytes() const { return max_bytes_; }
+    PrefetchOptions& set_max_bytes(std::size_t value);
+
+   private:
+    std::size_t max_rows_;
+    std::size_t max_bytes_;
+  };
+
   RowReader(std::shared_ptr<DataClient> client, bigtable::TableId table_name,
             RowSet row_set, std::int64_t rows_limit, Filter filter,
             std::unique_ptr<RPCRetryPolicy> retry_policy,
@@ -82,6 +105,13 @@ class RowReader {
             std::unique_ptr<internal::ReadRowsParserFactory> parser_factory,
             bool raise_on_error);
 
+  /**
+   * Move constructor.
+   *
+   * Note that any iterators, and the background thread started by
+   * `EnablePrefetch()`, refer to the original object. Do not move a
+   * `RowReader` after calling `begin()`.
+   */
   RowReader(RowReader&& rhs) noexcept = default;
 
   ~RowReader();
@@ -116,10 +146,59 @@ class RowReader {
    */
   void Cancel();
 
-  grpc::Status Finish() {
-    error_retrieved_ = true;
-    return status_;
-  }
+  grpc::Status Finish();
+
+  /**
+   * Read rows in a background thread, ahead of the application.
+   *
+   * By default the rows are read from the stream, parsed and assembled in the
+   * thread incrementing the iterator, so the application and the network take
+   * turns. With prefetching enabled, `begin()` starts a thread that keeps a
+   * bounded queue of rows ready for the iterators. Retries, `Cancel()` and
+   * `Finish()` work as usual, and errors are reported in the thread iterating
+   * over the results.
+   *
+   * Must be called before `begin()`. Prefetching is not used by `NextView()`.
+   */
+  void EnablePrefetch(PrefetchOptions options = PrefetchOptions());
+
+  /**
+   * Read the next row without copying its data.
+   *
+   * This is an alternative to iterating over the reader. The returned rows
+   * share their buffers, see `RowView` for details. Do not mix calls to this
+   * function with iterators over the same reader.
+   *
+   * Retry and backoff policies are honored.
+   *
+   * @param row receives the next row on success, it is unchanged on failure or
+   *     if there are no more rows.
+   * @return false if there are no more rows or if the read failed, use
+   *     `Finish()` to find out which.
+   *
+   * @throws std::runtime_error if the read failed after retries, unless the
+   *     reader was created with `raise_on_error == false`.
+   */
+  bool NextView(RowView& row);
+
+  /**
+   * Read up to @p max_rows rows into a column-oriented batch.
+   *
+   * This is an alternative to iterating over the reader, the parser copies
+   * the data directly into the buffers of @p batch, see `RowBatch` for
+   * details. The batch is cleared first, reusing it across calls reuses its
+   * buffers. Do not mix calls to this function with iterators over the same
+   * reader.
+   *
+   * Retry and backoff policies are honored.
+   *
+   * @return false if there are no more rows (@p batch is empty), or if the read
+   *     failed, use `Finish()` to find out which.
+   *
+   * @throws std::runtime_error if the read failed after retries, unless the
+   *     reader was created with `raise_on_error == false`.
+   */
+  bool NextBatch(RowBatch& batch, std::size_t max_rows);
 
  private:
   /**
@@ -132,8 +211,29 @@ class RowReader {
    */
   void Advance(internal::OptionalRow& row);
 
-  /// Called by Advance(), does not handle retries.
-  grpc::Status AdvanceOrFail(internal::OptionalRow& row);
+  /// Read the next row from the stream, Advance() without prefetching.
+  void ReadNextRow(internal::OptionalRow& row);
+
+  /**
+   * Start the stream, if needed, for NextView() and NextBatch().
+   *
+   * Returns false if the reader is cancelled or the stream is finished.
+   */
+  bool PrepareDirectRead();
+
+  /// The body of the background thread started by `EnablePrefetch()`.
+  void PrefetchLoop();
+
+  /**
+   * Read data until the parser has a complete row, retrying on failures.
+   *
+   * Returns true if `parser_` has a row, false if there are no more rows or
+   * the read failed.
+   */
+  bool AdvanceParser();
+
+  /// Called by AdvanceParser(), does not handle retries.
+  grpc::Status AdvanceOrFail();
 
   /**
    * Move the `processed_chunks_count_` index to the next chunk,
@@ -151,6 +251,9 @@ class RowReader {
   /// Sends the ReadRows request to the stub.
   void MakeRequest();
 
+  /// Record the latency and @p status of the attempt, which just finished.
+  void FinishAttempt(grpc::Status const& status);
+
   std::shared_ptr<DataClient> client_;
   bigtable::AppProfileId app_profile_id_;
   bigtable::TableId table_name_;
@@ -180,10 +283,27 @@ class RowReader {
   std::int64_t rows_count_;
   /// Holds the last read row key, for retries.
   std::string last_read_row_key_;
+  /// Number of cells received so far, only used for metrics.
+  std::int64_t cells_count_;
+
+  std::chrono::steady_clock::time_point operation_start_;
+  std::chrono::steady_clock::time_point attempt_start_;
+  /// When the last attempt finished (or was cancelled), if any.
+  std::chrono::steady_clock::time_point attempt_end_;
+  std::int64_t attempt_count_;
+  /// The bytes received in the current attempt, only used for tracing.
+  std::int64_t attempt_bytes_received_;
+  google::cloud::internal::Span operation_span_;
+  google::cloud::internal::Span attempt_span_;
 
   grpc::Status status_;
   bool raise_on_error_;
   bool error_retrieved_;
+  /// Set when the retry policy gives up, only used with prefetching.
+  bool unretriable_failure_;
+
+  std::unique_ptr<internal::RowPrefetchQueue> prefetch_;
+  std::thread prefetch_thread_;
 };
 
 }  // namespace BIGTABLE_CLIENT_NS
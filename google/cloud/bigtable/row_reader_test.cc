@@ -63,6 +63,17 @@ class ReadRowsParserMock : public bigtable::internal::ReadRowsParser {
     return row;
   }
 
+  void AppendNextRow(bigtable::RowBatch& batch,
+                     grpc::Status& status) override {
+    batch.AddRow(Next(status).row_key());
+  }
+
+  bigtable::RowView NextView(grpc::Status& status) override {
+    Row row = Next(status);
+    return bigtable::RowView(
+        std::make_shared<std::string const>(row.row_key()), {});
+  }
+
   void SetRows(std::initializer_list<std::string> l) {
     std::transform(l.begin(), l.end(), std::back_inserter(rows_),
                    [](std::string const& s) -> Row {
@@ -862,3 +873,302 @@ TEST_F(RowReaderTest, FailedStreamRetryNewContext) {
   EXPECT_EQ(it->row_key(), "r1");
   EXPECT_EQ(++it, reader.end());
 }
+
+TEST_F(RowReaderTest, NextViewReadsRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1", "r2"});
+  EXPECT_CALL(*parser, HandleEndOfStreamHook(_)).Times(1);
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+
+  bigtable::RowView row(std::make_shared<std::string const>(), {});
+  ASSERT_TRUE(reader.NextView(row));
+  EXPECT_EQ("r1", row.row_key());
+  ASSERT_TRUE(reader.NextView(row));
+  EXPECT_EQ("r2", row.row_key());
+  EXPECT_FALSE(reader.NextView(row));
+  EXPECT_EQ("r2", row.row_key());
+  // Calling again after the end of the stream is harmless.
+  EXPECT_FALSE(reader.NextView(row));
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, NextViewRetriesSkipAlreadyReadRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1"});
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(2)))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::INTERNAL, "retry")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook(_)).WillOnce(Return(true));
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook(_))
+        .WillOnce(Return(std::chrono::milliseconds(0)));
+
+    auto stream_retry = new MockReadRowsReader;  // the stub will free it
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(1)))
+        .WillOnce(Invoke(stream_retry->MakeMockReturner()));
+    EXPECT_CALL(*stream_retry, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream_retry, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet("r1", "r2"),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+
+  bigtable::RowView row(std::make_shared<std::string const>(), {});
+  ASSERT_TRUE(reader.NextView(row));
+  EXPECT_EQ("r1", row.row_key());
+  EXPECT_FALSE(reader.NextView(row));
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, PrefetchReadsAllRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1", "r2", "r3"});
+  EXPECT_CALL(*parser, HandleEndOfStreamHook(_)).Times(1);
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+  reader.EnablePrefetch(bigtable::RowReader::PrefetchOptions().set_max_rows(1));
+
+  std::vector<std::string> keys;
+  for (auto const& row : reader) {
+    keys.push_back(row.row_key());
+  }
+  EXPECT_EQ((std::vector<std::string>{"r1", "r2", "r3"}), keys);
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, PrefetchRetriesSkipAlreadyReadRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1"});
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(2)))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::INTERNAL, "retry")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook(_)).WillOnce(Return(true));
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook(_))
+        .WillOnce(Return(std::chrono::milliseconds(0)));
+
+    auto stream_retry = new MockReadRowsReader;  // the stub will free it
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(1)))
+        .WillOnce(Invoke(stream_retry->MakeMockReturner()));
+    EXPECT_CALL(*stream_retry, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream_retry, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet("r1", "r2"),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+  reader.EnablePrefetch();
+
+  auto it = reader.begin();
+  EXPECT_NE(it, reader.end());
+  EXPECT_EQ(it->row_key(), "r1");
+  EXPECT_EQ(++it, reader.end());
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, PrefetchFailedStreamWithNoRetryNoExcept) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::INTERNAL, "retry")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook(_)).WillOnce(Return(false));
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook(_)).Times(0);
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_), false);
+  reader.EnablePrefetch();
+
+  EXPECT_EQ(reader.begin(), reader.end());
+  grpc::Status status = reader.Finish();
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, status.error_code());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST_F(RowReaderTest, PrefetchFailedStreamWithNoRetryThrows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::INTERNAL, "retry")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook(_)).WillOnce(Return(false));
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook(_)).Times(0);
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+  reader.EnablePrefetch();
+
+  EXPECT_THROW(reader.begin(), std::exception);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+TEST_F(RowReaderTest, PrefetchCancelStopsProducer) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1", "r2", "r3", "r4"});
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    // The producer blocks on the full queue, so the only Read() call is to
+    // drain the stream in Cancel().
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::CANCELLED));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+  reader.EnablePrefetch(bigtable::RowReader::PrefetchOptions().set_max_rows(1));
+
+  auto it = reader.begin();
+  EXPECT_NE(it, reader.end());
+  EXPECT_EQ(it->row_key(), "r1");
+  reader.Cancel();
+  EXPECT_EQ(++it, reader.end());
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, NextBatchReadsRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1", "r2", "r3"});
+  EXPECT_CALL(*parser, HandleEndOfStreamHook(_)).Times(1);
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, _))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet(),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+
+  bigtable::RowBatch batch;
+  ASSERT_TRUE(reader.NextBatch(batch, 2));
+  EXPECT_EQ("r1r2", batch.row_keys());
+  ASSERT_TRUE(reader.NextBatch(batch, 2));
+  EXPECT_EQ("r3", batch.row_keys());
+  EXPECT_FALSE(reader.NextBatch(batch, 2));
+  EXPECT_TRUE(batch.empty());
+  EXPECT_FALSE(reader.NextBatch(batch, 2));
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(RowReaderTest, NextBatchRetriesSkipAlreadyReadRows) {
+  auto* stream = new MockReadRowsReader;  // wrapped in unique_ptr by ReadRows
+  auto parser = bigtable::internal::make_unique<ReadRowsParserMock>();
+  parser->SetRows({"r1"});
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(2)))
+        .WillOnce(Invoke(stream->MakeMockReturner()));
+
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(true));
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish())
+        .WillOnce(Return(grpc::Status(grpc::StatusCode::INTERNAL, "retry")));
+
+    EXPECT_CALL(*retry_policy_, OnFailureHook(_)).WillOnce(Return(true));
+    EXPECT_CALL(*backoff_policy_, OnCompletionHook(_))
+        .WillOnce(Return(std::chrono::milliseconds(0)));
+
+    auto stream_retry = new MockReadRowsReader;  // the stub will free it
+    EXPECT_CALL(*client_, ReadRows(_, RequestWithRowKeysCount(1)))
+        .WillOnce(Invoke(stream_retry->MakeMockReturner()));
+    EXPECT_CALL(*stream_retry, Read(_)).WillOnce(Return(false));
+    EXPECT_CALL(*stream_retry, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+
+  parser_factory_->AddParser(std::move(parser));
+  bigtable::RowReader reader(
+      client_, bigtable::TableId(""), bigtable::RowSet("r1", "r2"),
+      bigtable::RowReader::NO_ROWS_LIMIT, bigtable::Filter::PassAllFilter(),
+      std::move(retry_policy_), std::move(backoff_policy_),
+      metadata_update_policy_, std::move(parser_factory_));
+
+  bigtable::RowBatch batch;
+  ASSERT_TRUE(reader.NextBatch(batch, 10));
+  EXPECT_EQ("r1", batch.row_keys());
+  EXPECT_FALSE(reader.NextBatch(batch, 10));
+  EXPECT_TRUE(reader.Finish().ok());
+}
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/row_set.h"
+#include <algorithm>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -20,6 +22,86 @@ namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace btproto = ::google::bigtable::v2;
 
+namespace {
+/// Return true if all the keys in @p range are at or before @p row_key.
+bool EndsAtOrBefore(btproto::RowRange const& range,
+                    std::string const& row_key) {
+  switch (range.end_key_case()) {
+    case btproto::RowRange::kEndKeyClosed:
+      return range.end_key_closed() <= row_key;
+    case btproto::RowRange::kEndKeyOpen:
+      return range.end_key_open() <= row_key;
+    default:
+      return false;
+  }
+}
+
+/// Return true if some keys in @p range are at or before @p row_key.
+bool StartsAtOrBefore(btproto::RowRange const& range,
+                      std::string const& row_key) {
+  switch (range.start_key_case()) {
+    case btproto::RowRange::kStartKeyClosed:
+      return range.start_key_closed() <= row_key;
+    case btproto::RowRange::kStartKeyOpen:
+      return range.start_key_open() < row_key;
+    default:
+      return true;
+  }
+}
+
+/// Compare the start of two ranges, a range without a start is the smallest.
+int CompareStarts(btproto::RowRange const& a, btproto::RowRange const& b) {
+  if (a.start_key_case() == btproto::RowRange::START_KEY_NOT_SET or
+      b.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) {
+    return (b.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) -
+           (a.start_key_case() == btproto::RowRange::START_KEY_NOT_SET);
+  }
+  bool const a_open = a.start_key_case() == btproto::RowRange::kStartKeyOpen;
+  bool const b_open = b.start_key_case() == btproto::RowRange::kStartKeyOpen;
+  auto const& a_key = a_open ? a.start_key_open() : a.start_key_closed();
+  auto const& b_key = b_open ? b.start_key_open() : b.start_key_closed();
+  int cmp = a_key.compare(b_key);
+  if (cmp != 0) {
+    return cmp;
+  }
+  // A closed start includes the key, so it is smaller than an open start.
+  return static_cast<int>(a_open) - static_cast<int>(b_open);
+}
+
+/// Compare the end of two ranges, a range without an end is the largest.
+int CompareEnds(btproto::RowRange const& a, btproto::RowRange const& b) {
+  if (a.end_key_case() == btproto::RowRange::END_KEY_NOT_SET or
+      b.end_key_case() == btproto::RowRange::END_KEY_NOT_SET) {
+    return (a.end_key_case() == btproto::RowRange::END_KEY_NOT_SET) -
+           (b.end_key_case() == btproto::RowRange::END_KEY_NOT_SET);
+  }
+  bool const a_open = a.end_key_case() == btproto::RowRange::kEndKeyOpen;
+  bool const b_open = b.end_key_case() == btproto::RowRange::kEndKeyOpen;
+  auto const& a_key = a_open ? a.end_key_open() : a.end_key_closed();
+  auto const& b_key = b_open ? b.end_key_open() : b.end_key_closed();
+  int cmp = a_key.compare(b_key);
+  if (cmp != 0) {
+    return cmp;
+  }
+  // An open end excludes the key, so it is smaller than a closed end.
+  return static_cast<int>(b_open) - static_cast<int>(a_open);
+}
+
+/// Extend the end of @p range to the end of @p source.
+void SetEnd(btproto::RowRange& range, btproto::RowRange const& source) {
+  switch (source.end_key_case()) {
+    case btproto::RowRange::kEndKeyClosed:
+      range.set_end_key_closed(source.end_key_closed());
+      break;
+    case btproto::RowRange::kEndKeyOpen:
+      range.set_end_key_open(source.end_key_open());
+      break;
+    default:
+      range.clear_end_key();
+  }
+}
+}  // namespace
+
 RowSet RowSet::Intersect(bigtable::RowRange const& range) const {
   // Special case: "all rows", return the argument range.
   if (row_set_.row_keys().empty() and row_set_.row_ranges().empty()) {
@@ -48,6 +130,138 @@ RowSet RowSet::Intersect(bigtable::RowRange const& range) const {
   return result;
 }
 
+void RowSet::ResumeAfter(std::string const& row_key) {
+  // Special case: "all rows", the result is the rows after `row_key`.
+  if (row_set_.row_keys().empty() and row_set_.row_ranges().empty()) {
+    *row_set_.add_row_ranges() = RowRange::Open(row_key, "").as_proto_move();
+    return;
+  }
+
+  auto& keys = *row_set_.mutable_row_keys();
+  if (not keys_sorted_) {
+    std::sort(keys.begin(), keys.end());
+    keys_sorted_ = true;
+  }
+  auto first = std::upper_bound(keys.begin(), keys.end(), row_key);
+  keys.DeleteSubrange(0, static_cast<int>(first - keys.begin()));
+
+  // There are (usually) few ranges, and they may overlap, so they are not
+  // sorted.  Compact the ranges with keys after `row_key` in place, and trim
+  // those that start at or before it.
+  auto& ranges = *row_set_.mutable_row_ranges();
+  int kept = 0;
+  for (int i = 0; i != ranges.size(); ++i) {
+    auto& range = *ranges.Mutable(i);
+    if (EndsAtOrBefore(range, row_key)) {
+      continue;
+    }
+    if (StartsAtOrBefore(range, row_key)) {
+      range.set_start_key_open(row_key);
+    }
+    ranges.SwapElements(kept++, i);
+  }
+  ranges.DeleteSubrange(kept, ranges.size() - kept);
+
+  // Another special case: a RowSet() with no entries means "all rows", but we
+  // want "no rows".
+  if (keys.empty() and ranges.empty()) {
+    *row_set_.add_row_ranges() = RowRange::Empty().as_proto_move();
+  }
+}
+
+bool RowSet::Mergeable(btproto::RowRange const& range,
+                       btproto::RowRange const& next) {
+  if (range.end_key_case() == btproto::RowRange::END_KEY_NOT_SET or
+      next.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) {
+    return true;
+  }
+  bool const end_closed =
+      range.end_key_case() == btproto::RowRange::kEndKeyClosed;
+  bool const start_closed =
+      next.start_key_case() == btproto::RowRange::kStartKeyClosed;
+  auto const& end = end_closed ? range.end_key_closed() : range.end_key_open();
+  auto const& start =
+      start_closed ? next.start_key_closed() : next.start_key_open();
+  int cmp = start.compare(end);
+  if (cmp < 0) {
+    return true;
+  }
+  if (cmp == 0) {
+    // Only `(a, k)` and `(k, b)` leave a gap, the key `k` itself.
+    return end_closed or start_closed;
+  }
+  // `[a, k]` and `[k + '\0', b]` have no keys between them.
+  return end_closed and start_closed and RowRange::Consecutive(end, start);
+}
+
+void RowSet::Normalize() {
+  // Special case: "all rows" is already minimal.
+  if (row_set_.row_keys().empty() and row_set_.row_ranges().empty()) {
+    return;
+  }
+
+  // Sort the non-empty ranges by their start, and merge each range with the
+  // previous one if they overlap or are adjacent.
+  auto& ranges = *row_set_.mutable_row_ranges();
+  int kept = 0;
+  for (int i = 0; i != ranges.size(); ++i) {
+    if (RowRange(ranges.Get(i)).IsEmpty()) {
+      continue;
+    }
+    ranges.SwapElements(kept++, i);
+  }
+  ranges.DeleteSubrange(kept, ranges.size() - kept);
+  std::sort(ranges.begin(), ranges.end(),
+            [](btproto::RowRange const& a, btproto::RowRange const& b) {
+              return CompareStarts(a, b) < 0;
+            });
+  int merged = 0;
+  for (int i = 0; i != ranges.size(); ++i) {
+    if (merged != 0 and Mergeable(ranges.Get(merged - 1), ranges.Get(i))) {
+      auto& last = *ranges.Mutable(merged - 1);
+      if (CompareEnds(last, ranges.Get(i)) < 0) {
+        SetEnd(last, ranges.Get(i));
+      }
+      continue;
+    }
+    ranges.SwapElements(merged++, i);
+  }
+  ranges.DeleteSubrange(merged, ranges.size() - merged);
+
+  // Sort and deduplicate the keys, then drop the keys in some range.  The
+  // ranges are sorted and disjoint, so a single pass finds them.
+  auto& keys = *row_set_.mutable_row_keys();
+  std::sort(keys.begin(), keys.end());
+  auto const unique_count =
+      static_cast<int>(std::unique(keys.begin(), keys.end()) - keys.begin());
+  keys.DeleteSubrange(unique_count, keys.size() - unique_count);
+  keys_sorted_ = true;
+  std::vector<RowRange> sorted;
+  sorted.reserve(ranges.size());
+  for (auto const& r : ranges) {
+    sorted.emplace_back(r);
+  }
+  kept = 0;
+  auto range = sorted.begin();
+  for (int i = 0; i != keys.size(); ++i) {
+    auto const& key = keys.Get(i);
+    while (range != sorted.end() and range->AboveEnd(key)) {
+      ++range;
+    }
+    if (range != sorted.end() and range->Contains(key)) {
+      continue;
+    }
+    keys.SwapElements(kept++, i);
+  }
+  keys.DeleteSubrange(kept, keys.size() - kept);
+
+  // Another special case: a RowSet() with no entries means "all rows", but the
+  // set only contained empty ranges, so we want "no rows".
+  if (keys.empty() and ranges.empty()) {
+    *row_set_.add_row_ranges() = RowRange::Empty().as_proto_move();
+  }
+}
+
 bool RowSet::IsEmpty() const {
   if (row_set_.row_keys_size() > 0) {
     return false;
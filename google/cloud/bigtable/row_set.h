@@ -22,6 +22,8 @@ namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+class RowReader;
+
 /**
  * Represent a (possibly non-continuous) set of row keys.
  *
@@ -57,6 +59,7 @@ class RowSet {
    */
   void Append(std::string row_key) {
     *row_set_.add_row_keys() = std::move(row_key);
+    keys_sorted_ = false;
   }
 
   /**
@@ -68,6 +71,31 @@ class RowSet {
    */
   RowSet Intersect(bigtable::RowRange const& range) const;
 
+  /**
+   * Modify this object to contain only the keys and ranges after @p row_key.
+   *
+   * This has the same effect as `*this = Intersect(RowRange::Open(row_key,
+   * ""))`, but it modifies the set in place.  The row keys are sorted on the
+   * first call, after that skipping the keys already read is a binary search,
+   * and the remaining keys and ranges are not copied.  `RowReader` calls this
+   * function each time it resumes a stream, so retrying a read of a large
+   * set of keys does not copy (or scan) the whole set on each attempt.
+   */
+  void ResumeAfter(std::string const& row_key);
+
+  /**
+   * Rewrite the set as the minimal, ordered, set of keys and ranges.
+   *
+   * The keys are sorted and deduplicated, and the keys contained in some
+   * range are removed.  Empty ranges are removed, and the ranges that overlap
+   * (or are adjacent) are merged.  The result contains exactly the same rows,
+   * but the request is smaller, and the server does not scan any row twice.
+   * Applications that generate row sets, for example, from a query plan, can
+   * call this before `Table::ReadRows()`, or use
+   * `Table::set_normalize_row_sets()` to normalize all the row sets.
+   */
+  void Normalize();
+
   /**
    * Returns true if the set is empty.
    *
@@ -106,8 +134,21 @@ class RowSet {
   /// Terminate the recursion.
   void AppendAll() {}
 
+  /**
+   * Return true if @p next overlaps, or is adjacent to, @p range.
+   *
+   * The caller guarantees that @p next does not start before @p range.
+   */
+  static bool Mergeable(::google::bigtable::v2::RowRange const& range,
+                        ::google::bigtable::v2::RowRange const& next);
+
  private:
+  /// Swaps the set in and out of each request, to avoid copying it.
+  friend class RowReader;
+
   ::google::bigtable::v2::RowSet row_set_;
+  /// Set by `ResumeAfter()`, the row keys in `row_set_` are sorted.
+  bool keys_sorted_ = false;
 };
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
@@ -117,3 +117,136 @@ TEST(RowSetTest, IntersectWithDisjointIsEmpty) {
   EXPECT_TRUE(
       RowSet("a", R::Range("a", "b")).Intersect(R::Range("c", "d")).IsEmpty());
 }
+
+TEST(RowSetTest, ResumeAfterDefaultSet) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set;
+  row_set.ResumeAfter("m");
+  auto proto = row_set.as_proto();
+  EXPECT_TRUE(proto.row_keys().empty());
+  ASSERT_EQ(1, proto.row_ranges_size());
+  EXPECT_EQ(R::Open("m", ""), R(proto.row_ranges(0)));
+}
+
+/// @test Verify that ResumeAfter() has the same effect as Intersect().
+TEST(RowSetTest, ResumeAfterMatchesIntersect) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet const row_set("zzz", R::Range("a", "c"), "foo", "b",
+                                 R::LeftOpen("k", "m"), R::StartingAt("x"),
+                                 "b", R::Closed("d", "f"));
+
+  for (std::string key : {"a", "b", "c", "e", "f", "foo", "l", "x", "zzz"}) {
+    SCOPED_TRACE("resume after " + key);
+    auto expected = row_set.Intersect(R::Open(key, "")).as_proto();
+    auto actual = row_set;
+    actual.ResumeAfter(key);
+    auto proto = actual.as_proto();
+
+    std::vector<std::string> expected_keys(expected.row_keys().begin(),
+                                           expected.row_keys().end());
+    std::sort(expected_keys.begin(), expected_keys.end());
+    EXPECT_THAT(proto.row_keys(), ::testing::ElementsAreArray(expected_keys));
+    ASSERT_EQ(expected.row_ranges_size(), proto.row_ranges_size());
+    for (int i = 0; i != proto.row_ranges_size(); ++i) {
+      EXPECT_EQ(R(expected.row_ranges(i)), R(proto.row_ranges(i)));
+    }
+  }
+}
+
+TEST(RowSetTest, ResumeAfterIncremental) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set("r3", "r1", "r4", "r2", R::Range("s", "t"));
+  row_set.ResumeAfter("r1");
+  EXPECT_THAT(row_set.as_proto().row_keys(),
+              ::testing::ElementsAre("r2", "r3", "r4"));
+  // Keys appended later are sorted again on the next call.
+  row_set.Append("r0");
+  row_set.Append("r5");
+  row_set.ResumeAfter("r3");
+  EXPECT_THAT(row_set.as_proto().row_keys(),
+              ::testing::ElementsAre("r4", "r5"));
+  ASSERT_EQ(1, row_set.as_proto().row_ranges_size());
+  row_set.ResumeAfter("s1");
+  EXPECT_TRUE(row_set.as_proto().row_keys().empty());
+  EXPECT_EQ(R::Open("s1", "t"), R(row_set.as_proto().row_ranges(0)));
+  EXPECT_FALSE(row_set.IsEmpty());
+}
+
+TEST(RowSetTest, ResumeAfterLastIsEmpty) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set("a", "b", R::Range("c", "d"));
+  row_set.ResumeAfter("d");
+  EXPECT_TRUE(row_set.IsEmpty());
+}
+
+TEST(RowSetTest, NormalizeDefaultSet) {
+  bigtable::RowSet row_set;
+  row_set.Normalize();
+  auto proto = row_set.as_proto();
+  EXPECT_TRUE(proto.row_keys().empty());
+  EXPECT_TRUE(proto.row_ranges().empty());
+}
+
+TEST(RowSetTest, NormalizeKeys) {
+  bigtable::RowSet row_set("c", "a", "b", "a", "c");
+  row_set.Normalize();
+  auto proto = row_set.as_proto();
+  EXPECT_THAT(proto.row_keys(), ::testing::ElementsAre("a", "b", "c"));
+  EXPECT_TRUE(proto.row_ranges().empty());
+}
+
+/// @test Verify that overlapping and adjacent ranges are merged.
+TEST(RowSetTest, NormalizeRanges) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set(
+      R::Range("m", "p"), R::Range("a", "c"), R::Closed("b", "d"),
+      R::Range("d", "f"),  // overlaps [b, d] at "d"
+      R::Range("g", "h"), R::Closed("h", "i"),  // adjacent at "h"
+      R::Open("j", "k"), R::Open("k", "l"),       // gap at "k"
+      R::Closed("x", "y"), R::Closed(std::string("y\0", 2), "z"),  // adjacent
+      R::Empty(), R::Range("q", "q"), R::Range("n", "o"));
+  row_set.Normalize();
+  auto proto = row_set.as_proto();
+  EXPECT_TRUE(proto.row_keys().empty());
+  std::vector<R> actual;
+  for (auto const& r : proto.row_ranges()) {
+    actual.emplace_back(r);
+  }
+  EXPECT_THAT(actual,
+              ::testing::ElementsAre(R::Range("a", "f"), R::Closed("g", "i"),
+                                     R::Open("j", "k"), R::Open("k", "l"),
+                                     R::Range("m", "p"), R::Closed("x", "z")));
+}
+
+TEST(RowSetTest, NormalizeUnboundedRanges) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set(R::StartingAt("m"), R::EndingAt("c"),
+                           R::Range("b", "d"), R::Range("x", "y"), "z", "a");
+  row_set.Normalize();
+  auto proto = row_set.as_proto();
+  EXPECT_TRUE(proto.row_keys().empty());
+  ASSERT_EQ(2, proto.row_ranges_size());
+  EXPECT_EQ(btproto::RowRange::START_KEY_NOT_SET,
+            proto.row_ranges(0).start_key_case());
+  EXPECT_EQ("d", proto.row_ranges(0).end_key_open());
+  EXPECT_EQ(R::StartingAt("m"), R(proto.row_ranges(1)));
+}
+
+TEST(RowSetTest, NormalizeDropsKeysInRanges) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set("f", R::Range("b", "d"), "d", "a", "b", "c",
+                           R::LeftOpen("e", "g"), "e", "g", "h");
+  row_set.Normalize();
+  auto proto = row_set.as_proto();
+  EXPECT_THAT(proto.row_keys(), ::testing::ElementsAre("a", "d", "e", "h"));
+  ASSERT_EQ(2, proto.row_ranges_size());
+  EXPECT_EQ(R::Range("b", "d"), R(proto.row_ranges(0)));
+  EXPECT_EQ(R::LeftOpen("e", "g"), R(proto.row_ranges(1)));
+}
+
+TEST(RowSetTest, NormalizeEmptyRangesIsEmpty) {
+  using R = bigtable::RowRange;
+  bigtable::RowSet row_set(R::Empty(), R::Range("b", "a"));
+  row_set.Normalize();
+  EXPECT_TRUE(row_set.IsEmpty());
+}
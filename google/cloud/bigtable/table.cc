@@ -78,6 +78,28 @@ RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                         true);
 }
 
+void Table::ReadRowsParallel(
+    RowSet row_set, Filter filter, std::size_t max_parallelism,
+    std::function<void(std::size_t shard, Row row)> const& callback) {
+  auto status = impl_.ReadRowsParallel(std::move(row_set), std::move(filter),
+                                       max_parallelism, callback);
+  if (not status.ok()) {
+    bigtable::internal::RaiseRpcError(status, status.error_message());
+  }
+}
+
+std::vector<Row> Table::ReadRows(std::vector<std::string> row_keys,
+                                 Filter filter,
+                                 MultiGetOptions const& options) {
+  grpc::Status status;
+  auto result =
+      impl_.ReadRows(std::move(row_keys), std::move(filter), options, status);
+  if (not status.ok()) {
+    bigtable::internal::RaiseRpcError(status, status.error_message());
+  }
+  return result;
+}
+
 std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter) {
   grpc::Status status;
   auto result = impl_.ReadRow(std::move(row_key), std::move(filter), status);
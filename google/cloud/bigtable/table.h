@@ -35,6 +35,10 @@ inline namespace BIGTABLE_CLIENT_NS {
  * The class deals with the most common transient failures, and retries the
  * underlying RPC calls subject to the policies configured by the application.
  * These policies are documented in`Table::Table()`.
+ *
+ * Each of these operations also has an asynchronous version, for example
+ * `Table::AsyncApply()`, which runs on a `bigtable::CompletionQueue` and
+ * reports the result via a callback instead of blocking the calling thread.
  */
 class Table {
  public:
@@ -184,6 +188,103 @@ class Table {
 
   std::string const& table_name() const { return impl_.table_name(); }
 
+  /**
+   * Allocate the response protos on `google::protobuf::Arena`s.
+   *
+   * When enabled, `BulkApply()` and `ReadModifyWriteRow()` allocate their
+   * response protos on an arena owned by each operation, and release them all
+   * at once when the operation completes. The `MutateRows` responses contain
+   * an entry per mutation, so this saves (at least) two allocations per
+   * mutation in large batches.
+   *
+   * The setting applies to operations started after this call, use a copy of
+   * the `Table` to configure it for a single operation.
+   */
+  Table& set_use_protobuf_arenas(bool value) {
+    impl_.set_use_protobuf_arenas(value);
+    return *this;
+  }
+  bool use_protobuf_arenas() const { return impl_.use_protobuf_arenas(); }
+
+  /**
+   * Normalize the row sets passed to `ReadRows()` before sending them.
+   *
+   * When enabled, `ReadRows()` calls `RowSet::Normalize()`, which sorts and
+   * deduplicates the keys, drops the keys already in some range, and merges
+   * the overlapping ranges.  This reads the same rows, but row sets generated
+   * by programs often have many redundant entries, and normalizing them
+   * reduces both the request size and the work in the server.
+   *
+   * The setting applies to operations started after this call, use a copy of
+   * the `Table` to configure it for a single operation.
+   */
+  Table& set_normalize_row_sets(bool value) {
+    impl_.set_normalize_row_sets(value);
+    return *this;
+  }
+  bool normalize_row_sets() const { return impl_.normalize_row_sets(); }
+
+  /**
+   * Configure how `BulkApply()` splits and sends large `BulkMutation`s.
+   *
+   * Large mutations are split into several `MutateRows` requests that fit the
+   * service limits, and up to `BulkApplyOptions::max_parallelism()` of them
+   * run at the same time.  The `DataClient` may send the concurrent requests
+   * on different channels.  Each request is retried independently, and any
+   * failures are reported with their index in the original mutation.
+   */
+  Table& set_bulk_apply_options(BulkApplyOptions const& options) {
+    impl_.set_bulk_apply_options(options);
+    return *this;
+  }
+  BulkApplyOptions const& bulk_apply_options() const {
+    return impl_.bulk_apply_options();
+  }
+
+  /**
+   * Hedge the `ReadRow()` requests.
+   *
+   * A hedged `ReadRow()` sends a second request, likely on a different
+   * channel, if there is no response after a delay.  It uses the first
+   * response and cancels the other request.  This trims the tail latency of
+   * point reads caused by a single slow server or connection.  The @p policy
+   * chooses the delay and caps the fraction of requests that are hedged.
+   *
+   * The table makes its own copy of @p policy, its state (for example, the
+   * observed latencies) is shared with any copies of this `Table`.  If both
+   * requests fail `ReadRow()` retries as usual.
+   */
+  Table& set_hedging_policy(HedgingPolicy const& policy) {
+    impl_.set_hedging_policy(policy);
+    return *this;
+  }
+  /// Stop hedging the `ReadRow()` requests.
+  Table& clear_hedging_policy() {
+    impl_.clear_hedging_policy();
+    return *this;
+  }
+  bool has_hedging_policy() const { return impl_.has_hedging_policy(); }
+
+  /**
+   * Cache the results of `ReadRow()` in @p cache.
+   *
+   * `ReadRow()` returns the cached result, if it has not expired, instead of
+   * making a request.  The writes made through this table, including the
+   * asynchronous ones, invalidate the cached results for the rows they modify
+   * when they complete, even if they fail.  The writes made by other clients
+   * are visible once the cached results expire, or after the application
+   * calls `RowCache::Invalidate()`.
+   *
+   * Use a different cache for each table, pass `nullptr` to disable caching.
+   */
+  Table& set_row_cache(std::shared_ptr<RowCache> cache) {
+    impl_.set_row_cache(std::move(cache));
+    return *this;
+  }
+  std::shared_ptr<RowCache> const& row_cache() const {
+    return impl_.row_cache();
+  }
+
   /**
    * Attempts to apply the mutation to a row.
    *
@@ -251,6 +352,51 @@ class Table {
    */
   RowReader ReadRows(RowSet row_set, std::int64_t rows_limit, Filter filter);
 
+  /**
+   * Reads a set of rows from the table, using multiple streams in parallel.
+   *
+   * The row set is split at the row keys returned by `SampleRows()`, and each
+   * resulting shard is read using its own stream. Up to @p max_parallelism
+   * shards are read at the same time, each in its own thread, and the
+   * requests are spread across the channels in the client's connection pool.
+   * Each shard is retried and resumed independently, using the same policies
+   * as `ReadRows()`.
+   *
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param max_parallelism the maximum number of shards read concurrently.
+   * @param callback invoked for each row, with the index of its shard. It is
+   *     called concurrently from multiple threads, but the rows for each
+   *     shard are delivered in order, from a single thread. The shards are
+   *     numbered in row key order.
+   *
+   * @throws std::exception if any shard fails, after the other shards stop.
+   */
+  void ReadRowsParallel(
+      RowSet row_set, Filter filter, std::size_t max_parallelism,
+      std::function<void(std::size_t shard, Row row)> const& callback);
+
+  /**
+   * Reads a list of rows from the table, using multiple streams in parallel.
+   *
+   * The keys are sorted and deduplicated, and split into requests of bounded
+   * size, so very long lists do not exceed the message size limits.  The
+   * requests run concurrently, spread across the channels in the client's
+   * connection pool.  Each request is retried using the same policies as
+   * `ReadRows()`, and a retry only requests the rows not yet received.
+   *
+   * @param row_keys the rows to read.  Rows that do not exist are not
+   *     returned.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param options the size of each request, the number of concurrent
+   *     requests, and the order of the returned rows.
+   *
+   * @throws std::exception if any request fails, after the others stop.
+   */
+  std::vector<Row> ReadRows(
+      std::vector<std::string> row_keys, Filter filter,
+      MultiGetOptions const& options = MultiGetOptions());
+
   /**
    * Read and return a single row from the table.
    *
@@ -346,6 +492,175 @@ class Table {
     return row;
   }
 
+  /**
+   * Asynchronously apply the mutation to a row.
+   *
+   * The operation is retried, subject to the policies in effect, but the
+   * backoff periods are timers in @p cq, no thread is blocked while the
+   * operation is pending.
+   *
+   * @param mut the mutation. Note that this function takes ownership (and
+   *     then discards) the data in the mutation.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param callback a functor to be called when the operation completes. It
+   *     receives the final status of the operation, errors are never raised
+   *     as exceptions.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncApply(
+      SingleRowMutation&& mut, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, grpc::Status&)> callback) {
+    return impl_.AsyncApply(std::move(mut), cq, std::move(callback));
+  }
+
+  /**
+   * Asynchronously apply mutations to multiple rows.
+   *
+   * @param mut the mutations, note that this function takes ownership (and
+   *     then discards) the data in the mutation.
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param callback a functor to be called when the operation completes. It
+   *     receives the mutations that could not be applied (with their index in
+   *     @p mut), and the final status of the operation.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncBulkApply(
+      BulkMutation&& mut, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, std::vector<FailedMutation>&,
+                         grpc::Status&)>
+          callback) {
+    return impl_.AsyncBulkApply(std::move(mut), cq, std::move(callback));
+  }
+
+  /**
+   * Asynchronously read a set of rows from the table.
+   *
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param on_row called for each row, in the order returned by the server.
+   *     Rows are not delivered more than once, even if the stream is retried.
+   * @param on_finish called once, after all the rows have been delivered, with
+   *     the final status of the operation.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncReadRows(
+      RowSet row_set, Filter filter, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, Row)> on_row,
+      std::function<void(CompletionQueue&, grpc::Status&)> on_finish) {
+    return impl_.AsyncReadRows(std::move(row_set), std::move(filter), cq,
+                               std::move(on_row), std::move(on_finish));
+  }
+
+  /**
+   * Asynchronously read a limited set of rows from the table.
+   *
+   * @param row_set the rows to read from.
+   * @param rows_limit the maximum number of rows to read.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param on_row called for each row, in the order returned by the server.
+   * @param on_finish called once, after all the rows have been delivered.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncReadRows(
+      RowSet row_set, std::int64_t rows_limit, Filter filter,
+      CompletionQueue& cq, std::function<void(CompletionQueue&, Row)> on_row,
+      std::function<void(CompletionQueue&, grpc::Status&)> on_finish) {
+    return impl_.AsyncReadRows(std::move(row_set), rows_limit,
+                               std::move(filter), cq, std::move(on_row),
+                               std::move(on_finish));
+  }
+
+  /**
+   * Asynchronously read a single row from the table.
+   *
+   * @param row_key the row to read.
+   * @param filter a filter expression, can be used to select a subset of the
+   *     column families and columns in the row.
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param callback receives the same `std::pair<bool, Row>` returned by
+   *     `ReadRow()`, and the status of the operation.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncReadRow(
+      std::string row_key, Filter filter, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, std::pair<bool, Row>,
+                         grpc::Status&)>
+          callback) {
+    return impl_.AsyncReadRow(std::move(row_key), std::move(filter), cq,
+                              std::move(callback));
+  }
+
+  /**
+   * Asynchronous atomic test-and-set for a row using filter expressions.
+   *
+   * This operation is not idempotent, it is never retried.
+   *
+   * @param row_key the row to modify.
+   * @param filter the filter expression.
+   * @param true_mutations the mutations for the "filter passed" case.
+   * @param false_mutations the mutations for the "filter did not pass" case.
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param callback receives true if the filter passed, and the status of the
+   *     operation.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  std::shared_ptr<AsyncOperation> AsyncCheckAndMutateRow(
+      std::string row_key, Filter filter, std::vector<Mutation> true_mutations,
+      std::vector<Mutation> false_mutations, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, bool, grpc::Status&)> callback) {
+    return impl_.AsyncCheckAndMutateRow(
+        std::move(row_key), std::move(filter), std::move(true_mutations),
+        std::move(false_mutations), cq, std::move(callback));
+  }
+
+  /**
+   * Asynchronously read and modify the row in the server.
+   *
+   * This operation is not idempotent, it is never retried.
+   *
+   * @param row_key the row to read
+   * @param cq the completion queue that will execute the asynchronous calls.
+   * @param callback receives the modified row, and the status of the
+   *     operation.
+   * @param rule the first rule to modify the row.
+   * @param rules zero or more additional rules to modify the row.
+   * @return a handle to cancel the operation.
+   *
+   * @note If @p cq is shut down the operation fails with `CANCELLED`, and the
+   *     callbacks are invoked in the calling thread, see `CompletionQueue`.
+   */
+  template <typename... Args>
+  std::shared_ptr<AsyncOperation> AsyncReadModifyWriteRow(
+      std::string row_key, CompletionQueue& cq,
+      std::function<void(CompletionQueue&, Row, grpc::Status&)> callback,
+      bigtable::ReadModifyWriteRule rule, Args&&... rules) {
+    return impl_.AsyncReadModifyWriteRow(std::move(row_key), cq,
+                                         std::move(callback), std::move(rule),
+                                         std::forward<Args>(rules)...);
+  }
+
  private:
   noex::Table impl_;
 };
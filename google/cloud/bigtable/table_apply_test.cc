@@ -14,7 +14,12 @@
 
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/drained_retry_budget.h"
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/metrics.h"
+#include "google/cloud/tracing.h"
+#include <mutex>
 
 namespace bigtable = google::cloud::bigtable;
 using namespace bigtable::chrono_literals;
@@ -72,6 +77,93 @@ TEST_F(TableApplyTest, Retry) {
       "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
 }
 
+/// @test Verify that Table::Apply() records its latency, attempts and retries.
+TEST_F(TableApplyTest, Metrics) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, MutateRow(_, _, _))
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")))
+      .WillOnce(Return(grpc::Status::OK));
+
+  auto& registry = google::cloud::DefaultMetricsRegistry();
+  auto before = registry.Snapshot();
+  table_.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  auto after = registry.Snapshot();
+
+  auto delta = [&before, &after](std::string const& name) {
+    return after.counters[name] - before.counters[name];
+  };
+  EXPECT_EQ(1U, delta("bigtable.MutateRow.operations"));
+  EXPECT_EQ(2U, delta("bigtable.MutateRow.attempts"));
+  EXPECT_EQ(1U, delta("bigtable.MutateRow.retries"));
+  EXPECT_EQ(0U, delta("bigtable.MutateRow.errors"));
+  EXPECT_LT(0U, delta("bigtable.MutateRow.bytes_sent"));
+  EXPECT_EQ(1U, after.histograms["bigtable.MutateRow.latency"].count -
+                    before.histograms["bigtable.MutateRow.latency"].count);
+  EXPECT_EQ(2U,
+            after.histograms["bigtable.MutateRow.attempt_latency"].count -
+                before.histograms["bigtable.MutateRow.attempt_latency"].count);
+}
+
+namespace {
+class CapturingSpanExporter : public google::cloud::SpanExporter {
+ public:
+  void Export(google::cloud::SpanData span) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    spans_.push_back(std::move(span));
+  }
+
+  std::vector<google::cloud::SpanData> spans() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return spans_;
+  }
+
+ private:
+  std::mutex mu_;
+  std::vector<google::cloud::SpanData> spans_;
+};
+}  // anonymous namespace
+
+/// @test Verify that Table::Apply() creates spans for each attempt and backoff.
+TEST_F(TableApplyTest, Tracing) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, MutateRow(_, _, _))
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")))
+      .WillOnce(Return(grpc::Status::OK));
+
+  auto exporter = std::make_shared<CapturingSpanExporter>();
+  google::cloud::SetSpanExporter(exporter);
+  table_.Apply(bigtable::SingleRowMutation(
+      "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+  google::cloud::ClearSpanExporter();
+
+  auto spans = exporter->spans();
+  ASSERT_EQ(4U, spans.size());
+  EXPECT_EQ("attempt", spans[0].name);
+  EXPECT_EQ(1, spans[0].int_attributes["attempt"]);
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, spans[0].status_code);
+  EXPECT_LT(0, spans[0].int_attributes["bytes_sent"]);
+  EXPECT_EQ("backoff", spans[1].name);
+  EXPECT_EQ(1U, spans[1].int_attributes.count("delay_us"));
+  EXPECT_EQ("attempt", spans[2].name);
+  EXPECT_EQ(2, spans[2].int_attributes["attempt"]);
+  EXPECT_EQ(grpc::StatusCode::OK, spans[2].status_code);
+
+  auto const& operation = spans[3];
+  EXPECT_EQ("bigtable.MutateRow", operation.name);
+  EXPECT_EQ(0U, operation.parent_span_id);
+  EXPECT_EQ(2, operation.int_attributes["attempts"]);
+  EXPECT_EQ(grpc::StatusCode::OK, operation.status_code);
+  for (std::size_t i = 0; i != 3; ++i) {
+    EXPECT_EQ(operation.trace_id, spans[i].trace_id);
+    EXPECT_EQ(operation.span_id, spans[i].parent_span_id);
+  }
+}
+
 /// @test Verify that Table::Apply() retries only idempotent mutations.
 TEST_F(TableApplyTest, RetryIdempotent) {
   using namespace ::testing;
@@ -100,3 +192,26 @@ TEST_F(TableApplyTest, RetryIdempotent) {
       "exceptions are disabled");
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that Table::Apply() stops retrying when the budget runs out.
+TEST_F(TableApplyTest, RetryBudgetExhausted) {
+  using namespace ::testing;
+
+  EXPECT_CALL(*client_, MutateRow(_, _, _))
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+
+  bigtable::testing::DrainedRetryBudget drained;
+  try {
+    table_.Apply(bigtable::SingleRowMutation(
+        "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}));
+    ADD_FAILURE() << "expected PermanentMutationFailure";
+  } catch (bigtable::PermanentMutationFailure const& ex) {
+    EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, ex.status().error_code());
+    EXPECT_THAT(ex.status().error_message(),
+                HasSubstr(google::cloud::internal::kRetryBudgetExhausted));
+    ASSERT_EQ(1UL, ex.failures().size());
+  }
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
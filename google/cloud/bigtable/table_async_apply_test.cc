@@ -0,0 +1,241 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/drained_retry_budget.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/internal/retry_budget.h"
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::chrono_literals;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableAsyncApplyTest : public bigtable::testing::TableTestFixture {};
+
+using MockReader =
+    bigtable::testing::MockAsyncResponseReader<btproto::MutateRowResponse>;
+
+/// Create a mock reader that returns @p code, the caller owns the mock.
+std::unique_ptr<MockReader> MakeReader(grpc::StatusCode code) {
+  using namespace ::testing;
+  auto reader = bigtable::internal::make_unique<MockReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke(
+          [code](btproto::MutateRowResponse*, grpc::Status* status, void*) {
+            *status = grpc::Status(code, "mocked-status");
+          }));
+  return reader;
+}
+}  // anonymous namespace
+
+/// @test Verify that Table::AsyncApply() works in a simple case.
+TEST_F(TableAsyncApplyTest, Simple) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(grpc::StatusCode::OK);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const& request,
+                                 grpc::CompletionQueue*) {
+        EXPECT_EQ("bar", request.row_key());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        called = true;
+      });
+  EXPECT_FALSE(called);
+  EXPECT_EQ(1U, impl->size());
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncApply() reports permanent failures.
+TEST_F(TableAsyncApplyTest, Failure) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(grpc::StatusCode::FAILED_PRECONDITION);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::FAILED_PRECONDITION, status.error_code());
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncApply() retries using a timer.
+TEST_F(TableAsyncApplyTest, Retry) {
+  using namespace ::testing;
+
+  auto r1 = MakeReader(grpc::StatusCode::UNAVAILABLE);
+  auto r2 = MakeReader(grpc::StatusCode::OK);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&r1](grpc::ClientContext*,
+                             btproto::MutateRowRequest const&,
+                             grpc::CompletionQueue*) {
+        return r1->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([&r2](grpc::ClientContext*,
+                             btproto::MutateRowRequest const&,
+                             grpc::CompletionQueue*) {
+        return r2->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);  // first attempt fails
+  EXPECT_FALSE(called);
+  EXPECT_EQ(1U, impl->size());          // the backoff timer is pending
+  impl->SimulateCompletion(cq, true);  // the timer expires
+  EXPECT_FALSE(called);
+  impl->SimulateCompletion(cq, true);  // second attempt succeeds
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncApply() does not retry non-idempotent rows.
+TEST_F(TableAsyncApplyTest, RetryIdempotent) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(grpc::StatusCode::UNAVAILABLE);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation("not-idempotent",
+                                  {bigtable::SetCell("fam", "col", "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that cancelling Table::AsyncApply() during backoff works.
+TEST_F(TableAsyncApplyTest, CancelDuringBackoff) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(grpc::StatusCode::UNAVAILABLE);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  auto op = table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);  // first attempt fails
+  EXPECT_FALSE(called);
+  op->Cancel();
+  impl->SimulateCompletion(cq, false);  // the timer is cancelled
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncApply() stops retrying when the budget runs
+/// out.
+TEST_F(TableAsyncApplyTest, RetryBudgetExhausted) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(grpc::StatusCode::UNAVAILABLE);
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bigtable::testing::DrainedRetryBudget drained;
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "bar", {bigtable::SetCell("fam", "col", 0_ms, "val")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+        EXPECT_THAT(status.error_message(),
+                    HasSubstr(google::cloud::internal::kRetryBudgetExhausted));
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);  // the attempt fails, no backoff timer
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
@@ -0,0 +1,271 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/mutation_rate_limiter.h"
+#include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::chrono_literals;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableAsyncBulkApplyTest : public bigtable::testing::TableTestFixture {};
+
+using MockReader =
+    bigtable::testing::MockClientAsyncReader<btproto::MutateRowsResponse>;
+
+/// Create a mock stream that returns @p response and then @p status.
+MockReader* MakeReader(btproto::MutateRowsResponse response,
+                       grpc::Status status) {
+  using namespace ::testing;
+  auto reader = new MockReader;
+  EXPECT_CALL(*reader, StartCall(_)).Times(1);
+  EXPECT_CALL(*reader, Read(_, _))
+      .WillOnce(Invoke([response](btproto::MutateRowsResponse* r, void*) {
+        *r = response;
+      }))
+      .WillOnce(Return());
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce(Invoke(
+          [status](grpc::Status* s, void*) { *s = status; }));
+  return reader;
+}
+
+btproto::MutateRowsResponse MakeResponse(
+    std::vector<std::pair<int, grpc::StatusCode>> const& entries) {
+  btproto::MutateRowsResponse response;
+  for (auto const& e : entries) {
+    auto& entry = *response.add_entries();
+    entry.set_index(e.first);
+    entry.mutable_status()->set_code(e.second);
+  }
+  return response;
+}
+
+/// Simulate the events for a stream created by `MakeReader()`.
+void SimulateStream(bigtable::testing::MockCompletionQueue& impl,
+                    bigtable::CompletionQueue& cq) {
+  impl.SimulateCompletion(cq, true);   // StartCall()
+  impl.SimulateCompletion(cq, true);   // Read() returns the response
+  impl.SimulateCompletion(cq, false);  // Read() reports end of stream
+  impl.SimulateCompletion(cq, true);   // Finish()
+}
+}  // anonymous namespace
+
+/// @test Verify that Table::AsyncBulkApply() works in a simple case.
+TEST_F(TableAsyncBulkApplyTest, Simple) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(MakeResponse({{0, grpc::StatusCode::OK},
+                                         {1, grpc::StatusCode::OK}}),
+                           grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([reader](grpc::ClientContext*,
+                                btproto::MutateRowsRequest const& request,
+                                grpc::CompletionQueue*) {
+        EXPECT_EQ(2, request.entries_size());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncBulkApply(
+      bigtable::BulkMutation(
+          bigtable::SingleRowMutation(
+              "foo", {bigtable::SetCell("fam", "col", 0_ms, "baz")}),
+          bigtable::SingleRowMutation(
+              "bar", {bigtable::SetCell("fam", "col", 0_ms, "qux")})),
+      cq,
+      [&called](bigtable::CompletionQueue&,
+                std::vector<bigtable::FailedMutation>& failures,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(failures.empty());
+        called = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncBulkApply() retries partial failures.
+TEST_F(TableAsyncBulkApplyTest, RetryPartialFailure) {
+  using namespace ::testing;
+
+  auto r1 = MakeReader(MakeResponse({{0, grpc::StatusCode::UNAVAILABLE},
+                                     {1, grpc::StatusCode::OK}}),
+                       grpc::Status::OK);
+  auto r2 = MakeReader(MakeResponse({{0, grpc::StatusCode::OK}}),
+                       grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([r1](grpc::ClientContext*,
+                            btproto::MutateRowsRequest const& request,
+                            grpc::CompletionQueue*) {
+        EXPECT_EQ(2, request.entries_size());
+        return r1->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([r2](grpc::ClientContext*,
+                            btproto::MutateRowsRequest const& request,
+                            grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.entries_size());
+        EXPECT_EQ("foo", request.entries(0).row_key());
+        return r2->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncBulkApply(
+      bigtable::BulkMutation(
+          bigtable::SingleRowMutation(
+              "foo", {bigtable::SetCell("fam", "col", 0_ms, "baz")}),
+          bigtable::SingleRowMutation(
+              "bar", {bigtable::SetCell("fam", "col", 0_ms, "qux")})),
+      cq,
+      [&called](bigtable::CompletionQueue&,
+                std::vector<bigtable::FailedMutation>& failures,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(failures.empty());
+        called = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_FALSE(called);
+  impl->SimulateCompletion(cq, true);  // the backoff timer
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncBulkApply() reports permanent failures.
+TEST_F(TableAsyncBulkApplyTest, PermanentFailure) {
+  using namespace ::testing;
+
+  auto reader =
+      MakeReader(MakeResponse({{0, grpc::StatusCode::OK},
+                               {1, grpc::StatusCode::FAILED_PRECONDITION}}),
+                 grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([reader](grpc::ClientContext*,
+                                btproto::MutateRowsRequest const&,
+                                grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncBulkApply(
+      bigtable::BulkMutation(
+          bigtable::SingleRowMutation(
+              "foo", {bigtable::SetCell("fam", "col", 0_ms, "baz")}),
+          bigtable::SingleRowMutation(
+              "bar", {bigtable::SetCell("fam", "col", 0_ms, "qux")})),
+      cq,
+      [&called](bigtable::CompletionQueue&,
+                std::vector<bigtable::FailedMutation>& failures,
+                grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::INTERNAL, status.error_code());
+        ASSERT_EQ(1U, failures.size());
+        EXPECT_EQ(1, failures[0].original_index());
+        called = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+namespace {
+/// A mock client that throttles mutations.
+class ThrottledDataClient : public bigtable::testing::MockDataClient {
+ public:
+  explicit ThrottledDataClient(
+      bigtable::MutationThrottlingOptions const& options)
+      : limiter_(std::make_shared<bigtable::MutationRateLimiter>(options)) {}
+
+  std::shared_ptr<bigtable::MutationRateLimiter> mutation_rate_limiter()
+      override {
+    return limiter_;
+  }
+
+ private:
+  std::shared_ptr<bigtable::MutationRateLimiter> limiter_;
+};
+}  // anonymous namespace
+
+/// @test Verify that Table::AsyncBulkApply() waits for the rate limiter.
+TEST_F(TableAsyncBulkApplyTest, Throttled) {
+  using namespace ::testing;
+
+  auto client = std::make_shared<ThrottledDataClient>(
+      bigtable::MutationThrottlingOptions()
+          .set_min_rate(1)
+          .set_initial_rate(1)
+          .set_additive_increase(10)
+          .set_latency_factor(0));
+  EXPECT_CALL(*client, project_id()).WillRepeatedly(ReturnRef(project_id_));
+  EXPECT_CALL(*client, instance_id()).WillRepeatedly(ReturnRef(instance_id_));
+  bigtable::Table table(client, kTableId);
+
+  // Put the limiter in debt, so the next request must wait.
+  auto limiter = client->mutation_rate_limiter();
+  limiter->Reserve(100, bigtable::MutationRateLimiter::Clock::now());
+
+  auto reader = MakeReader(MakeResponse({{0, grpc::StatusCode::OK}}),
+                           grpc::Status::OK);
+  EXPECT_CALL(*client, PrepareAsyncMutateRows(_, _, _))
+      .WillOnce(Invoke([reader](grpc::ClientContext*,
+                                btproto::MutateRowsRequest const&,
+                                grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table.AsyncBulkApply(
+      bigtable::BulkMutation(bigtable::SingleRowMutation(
+          "foo", {bigtable::SetCell("fam", "col", 0_ms, "baz")})),
+      cq,
+      [&called](bigtable::CompletionQueue&,
+                std::vector<bigtable::FailedMutation>& failures,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(failures.empty());
+        called = true;
+      });
+
+  // The request waits in a timer, it does not block this thread.
+  EXPECT_EQ(1U, impl->size());
+  impl->SimulateCompletion(cq, true);  // the limiter admits the mutations
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+  // The successful request increases the rate.
+  EXPECT_DOUBLE_EQ(11.0, limiter->rate());
+  EXPECT_EQ(0U, limiter->decrease_count());
+}
@@ -0,0 +1,158 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/testing/chrono_literals.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::chrono_literals;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableAsyncCheckAndMutateRowTest
+    : public bigtable::testing::TableTestFixture {};
+
+using MockCheckAndMutateReader = bigtable::testing::MockAsyncResponseReader<
+    btproto::CheckAndMutateRowResponse>;
+using MockReadModifyWriteReader = bigtable::testing::MockAsyncResponseReader<
+    btproto::ReadModifyWriteRowResponse>;
+}  // anonymous namespace
+
+/// @test Verify that Table::AsyncCheckAndMutateRow() works.
+TEST_F(TableAsyncCheckAndMutateRowTest, Simple) {
+  using namespace ::testing;
+
+  auto reader = bigtable::internal::make_unique<MockCheckAndMutateReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btproto::CheckAndMutateRowResponse* r,
+                          grpc::Status* status, void*) {
+        r->set_predicate_matched(true);
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*client_, AsyncCheckAndMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::CheckAndMutateRowRequest const& req,
+                                 grpc::CompletionQueue*) {
+        EXPECT_EQ("foo", req.row_key());
+        EXPECT_EQ(1, req.true_mutations_size());
+        EXPECT_EQ(1, req.false_mutations_size());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncCheckAndMutateRow(
+      "foo", bigtable::Filter::PassAllFilter(),
+      {bigtable::SetCell("fam", "col", 0_ms, "it was true")},
+      {bigtable::SetCell("fam", "col", 0_ms, "it was false")}, cq,
+      [&called](bigtable::CompletionQueue&, bool matched,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(matched);
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncCheckAndMutateRow() does not retry.
+TEST_F(TableAsyncCheckAndMutateRowTest, NoRetry) {
+  using namespace ::testing;
+
+  auto reader = bigtable::internal::make_unique<MockCheckAndMutateReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btproto::CheckAndMutateRowResponse*,
+                          grpc::Status* status, void*) {
+        *status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again");
+      }));
+  EXPECT_CALL(*client_, AsyncCheckAndMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::CheckAndMutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncCheckAndMutateRow(
+      "foo", bigtable::Filter::PassAllFilter(),
+      {bigtable::SetCell("fam", "col", 0_ms, "it was true")}, {}, cq,
+      [&called](bigtable::CompletionQueue&, bool, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+        called = true;
+      });
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncReadModifyWriteRow() works.
+TEST_F(TableAsyncCheckAndMutateRowTest, ReadModifyWriteRow) {
+  using namespace ::testing;
+
+  auto reader = bigtable::internal::make_unique<MockReadModifyWriteReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btproto::ReadModifyWriteRowResponse* r,
+                          grpc::Status* status, void*) {
+        auto& row = *r->mutable_row();
+        row.set_key("foo");
+        auto& family = *row.add_families();
+        family.set_name("fam");
+        auto& column = *family.add_columns();
+        column.set_qualifier("col");
+        auto& cell = *column.add_cells();
+        cell.set_value("suffix");
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*client_, AsyncReadModifyWriteRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::ReadModifyWriteRowRequest const& req,
+                                 grpc::CompletionQueue*) {
+        EXPECT_EQ("foo", req.row_key());
+        EXPECT_EQ(1, req.rules_size());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncReadModifyWriteRow(
+      "foo", cq,
+      [&called](bigtable::CompletionQueue&, bigtable::Row row,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_EQ("foo", row.row_key());
+        ASSERT_EQ(1U, row.cells().size());
+        EXPECT_EQ("suffix", row.cells()[0].value());
+        called = true;
+      },
+      bigtable::ReadModifyWriteRule::AppendValue("fam", "col", "suffix"));
+
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
@@ -0,0 +1,212 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableAsyncReadRowsTest : public bigtable::testing::TableTestFixture {};
+
+using MockReader =
+    bigtable::testing::MockClientAsyncReader<btproto::ReadRowsResponse>;
+
+/// Create a mock stream that returns @p response and then @p status.
+MockReader* MakeReader(btproto::ReadRowsResponse response,
+                       grpc::Status status) {
+  using namespace ::testing;
+  auto reader = new MockReader;
+  EXPECT_CALL(*reader, StartCall(_)).Times(1);
+  EXPECT_CALL(*reader, Read(_, _))
+      .WillOnce(Invoke(
+          [response](btproto::ReadRowsResponse* r, void*) { *r = response; }))
+      .WillOnce(Return());
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce(Invoke([status](grpc::Status* s, void*) { *s = status; }));
+  return reader;
+}
+
+/// Simulate the events for a stream created by `MakeReader()`.
+void SimulateStream(bigtable::testing::MockCompletionQueue& impl,
+                    bigtable::CompletionQueue& cq) {
+  impl.SimulateCompletion(cq, true);   // StartCall()
+  impl.SimulateCompletion(cq, true);   // Read() returns the response
+  impl.SimulateCompletion(cq, false);  // Read() reports end of stream
+  impl.SimulateCompletion(cq, true);   // Finish()
+}
+}  // anonymous namespace
+
+/// @test Verify that Table::AsyncReadRows() works in a simple case.
+TEST_F(TableAsyncReadRowsTest, Simple) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      )"),
+                           grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncReadRows(_, _, _))
+      .WillOnce(Invoke([this, reader](grpc::ClientContext*,
+                                      btproto::ReadRowsRequest const& request,
+                                      grpc::CompletionQueue*) {
+        EXPECT_EQ(kTableName, request.table_name());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  std::vector<std::string> keys;
+  bool finished = false;
+  table_.AsyncReadRows(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), cq,
+      [&keys](bigtable::CompletionQueue&, bigtable::Row row) {
+        keys.push_back(row.row_key());
+      },
+      [&finished](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        finished = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(finished);
+  EXPECT_THAT(keys, ElementsAre("r1", "r2"));
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncReadRows() resumes after the last row read.
+TEST_F(TableAsyncReadRowsTest, RetryResumes) {
+  using namespace ::testing;
+
+  auto r1 = MakeReader(bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      )"),
+                       grpc::Status(grpc::StatusCode::UNAVAILABLE, "retry"));
+  auto r2 = MakeReader(bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      )"),
+                       grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncReadRows(_, _, _))
+      .WillOnce(Invoke([r1](grpc::ClientContext*,
+                            btproto::ReadRowsRequest const&,
+                            grpc::CompletionQueue*) {
+        return r1->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([r2](grpc::ClientContext*,
+                            btproto::ReadRowsRequest const& request,
+                            grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.rows().row_ranges_size());
+        EXPECT_EQ("r1", request.rows().row_ranges(0).start_key_open());
+        return r2->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  std::vector<std::string> keys;
+  bool finished = false;
+  table_.AsyncReadRows(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), cq,
+      [&keys](bigtable::CompletionQueue&, bigtable::Row row) {
+        keys.push_back(row.row_key());
+      },
+      [&finished](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        finished = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_FALSE(finished);
+  impl->SimulateCompletion(cq, true);  // the backoff timer
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(finished);
+  EXPECT_THAT(keys, ElementsAre("r1", "r2"));
+  EXPECT_TRUE(impl->empty());
+}
+
+/// @test Verify that Table::AsyncReadRow() works.
+TEST_F(TableAsyncReadRowsTest, ReadRow) {
+  using namespace ::testing;
+
+  auto reader = MakeReader(bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      )"),
+                           grpc::Status::OK);
+  EXPECT_CALL(*client_, PrepareAsyncReadRows(_, _, _))
+      .WillOnce(Invoke([reader](grpc::ClientContext*,
+                                btproto::ReadRowsRequest const& request,
+                                grpc::CompletionQueue*) {
+        EXPECT_EQ(1, request.rows_limit());
+        EXPECT_EQ(1, request.rows().row_keys_size());
+        return reader->AsUniqueMocked();
+      }));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+
+  bool called = false;
+  table_.AsyncReadRow(
+      "r1", bigtable::Filter::PassAllFilter(), cq,
+      [&called](bigtable::CompletionQueue&, std::pair<bool, bigtable::Row> row,
+                grpc::Status& status) {
+        EXPECT_TRUE(status.ok());
+        EXPECT_TRUE(row.first);
+        EXPECT_EQ("r1", row.second.row_key());
+        called = true;
+      });
+
+  SimulateStream(*impl, cq);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+}
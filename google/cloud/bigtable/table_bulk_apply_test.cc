@@ -17,6 +17,8 @@
 #include "google/cloud/bigtable/testing/chrono_literals.h"
 #include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <mutex>
+#include <set>
 
 namespace btproto = google::bigtable::v2;
 namespace bigtable = google::cloud::bigtable;
@@ -299,4 +301,105 @@ TEST_F(TableBulkApplyTest, FailedRPC) {
     FAIL() << "unexpected exception of unknown type raised";
   }
 }
+namespace {
+/// Create a mutation with one SetCell() for each of @p count rows.
+bt::BulkMutation MakeRows(int count) {
+  bt::BulkMutation mut;
+  for (int i = 0; i != count; ++i) {
+    mut.emplace_back(bt::SingleRowMutation(
+        "r" + std::to_string(i), {bt::SetCell("fam", "col", 0_ms, "v")}));
+  }
+  return mut;
+}
+
+/**
+ * Return a stream that reports success for all the rows, except for any rows
+ * with key @p fail_key, which fail with OUT_OF_RANGE.
+ */
+std::unique_ptr<grpc::ClientReaderInterface<btproto::MutateRowsResponse>>
+MakeStream(btproto::MutateRowsRequest const& request,
+           std::string const& fail_key) {
+  btproto::MutateRowsResponse response;
+  for (int i = 0; i != request.entries_size(); ++i) {
+    auto& e = *response.add_entries();
+    e.set_index(i);
+    e.mutable_status()->set_code(request.entries(i).row_key() == fail_key
+                                     ? grpc::StatusCode::OUT_OF_RANGE
+                                     : grpc::StatusCode::OK);
+  }
+  auto reader = bigtable::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*reader, Read(_))
+      .WillOnce(Invoke([response](btproto::MutateRowsResponse* r) {
+        *r = response;
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status::OK));
+  return std::unique_ptr<
+      grpc::ClientReaderInterface<btproto::MutateRowsResponse>>(
+      reader.release());
+}
+}  // anonymous namespace
+
+/// @test Verify that Table::BulkApply() splits large mutations.
+TEST_F(TableBulkApplyTest, SplitLargeMutation) {
+  std::vector<int> request_sizes;
+  EXPECT_CALL(*client_, MutateRows(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&request_sizes](
+                                 grpc::ClientContext*,
+                                 btproto::MutateRowsRequest const& request) {
+        request_sizes.push_back(request.entries_size());
+        return MakeStream(request, "r3");
+      }));
+
+  table_.set_bulk_apply_options(bt::BulkApplyOptions()
+                                    .set_max_mutations_per_request(2)
+                                    .set_max_parallelism(1));
+  try {
+    table_.BulkApply(MakeRows(5));
+    FAIL() << "expected PermanentMutationFailure";
+  } catch (bt::PermanentMutationFailure const& ex) {
+    ASSERT_EQ(1UL, ex.failures().size());
+    // The failure is reported with its index in the original mutation.
+    EXPECT_EQ(3, ex.failures()[0].original_index());
+    EXPECT_EQ("r3", ex.failures()[0].mutation().row_key());
+    EXPECT_EQ(grpc::StatusCode::OUT_OF_RANGE,
+              ex.failures()[0].status().error_code());
+  }
+  std::vector<int> expected{2, 2, 1};
+  EXPECT_EQ(expected, request_sizes);
+}
+
+/// @test Verify that Table::BulkApply() sends the pieces concurrently.
+TEST_F(TableBulkApplyTest, SplitLargeMutationParallel) {
+  std::mutex mu;
+  std::multiset<std::string> keys;
+  EXPECT_CALL(*client_, MutateRows(_, _))
+      .Times(10)
+      .WillRepeatedly(
+          Invoke([&](grpc::ClientContext*,
+                     btproto::MutateRowsRequest const& request) {
+            {
+              std::lock_guard<std::mutex> lk(mu);
+              for (auto const& e : request.entries()) {
+                keys.insert(e.row_key());
+              }
+            }
+            return MakeStream(request, "r7");
+          }));
+
+  table_.set_bulk_apply_options(bt::BulkApplyOptions()
+                                    .set_max_mutations_per_request(10)
+                                    .set_max_parallelism(4));
+  try {
+    table_.BulkApply(MakeRows(100));
+    FAIL() << "expected PermanentMutationFailure";
+  } catch (bt::PermanentMutationFailure const& ex) {
+    ASSERT_EQ(1UL, ex.failures().size());
+    EXPECT_EQ(7, ex.failures()[0].original_index());
+  }
+  EXPECT_EQ(100UL, keys.size());
+  EXPECT_EQ(1UL, keys.count("r42"));
+}
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -276,3 +276,57 @@ TEST_F(TableReadModifyWriteTest, UnrecoverableFailureTest) {
       "exceptions are disabled");
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
+
+TEST_F(TableReadModifyWriteTest, ArenaResponseTest) {
+  std::string const request_text = R"""(
+table_name: "projects/foo-project/instances/bar-instance/tables/baz-table"
+row_key: "row-key"
+rules {
+  family_name: "family1"
+  column_qualifier: "colid1"
+  append_value: "value1"
+}
+)""";
+
+  std::string const response_text = R"""(
+row {
+  key: "response-row-key"
+  families {
+    name: "response-family1"
+    columns {
+      qualifier: "response-colid1"
+      cells {
+        value: "value1"
+        labels: "label1"
+      }
+    }
+  }
+}
+)""";
+
+  auto mock = create_rules_lambda(request_text, response_text);
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .WillOnce(Invoke([mock](grpc::ClientContext* ctx,
+                              btproto::ReadModifyWriteRowRequest const& request,
+                              btproto::ReadModifyWriteRowResponse* response) {
+        EXPECT_NE(nullptr, response->GetArena());
+        return mock(ctx, request, response);
+      }));
+
+  bigtable::Table table = table_;
+  table.set_use_protobuf_arenas(true);
+  EXPECT_TRUE(table.use_protobuf_arenas());
+  EXPECT_FALSE(table_.use_protobuf_arenas());
+  auto row = table.ReadModifyWriteRow(
+      "row-key",
+      bigtable::ReadModifyWriteRule::AppendValue("family1", "colid1",
+                                                 "value1"));
+
+  EXPECT_EQ("response-row-key", row.row_key());
+  ASSERT_EQ(1U, row.cells().size());
+  EXPECT_EQ("response-family1", row.cells().at(0).family_name());
+  EXPECT_EQ("response-colid1", row.cells().at(0).column_qualifier());
+  EXPECT_EQ("value1", row.cells().at(0).value());
+  ASSERT_EQ(1U, row.cells().at(0).labels().size());
+  EXPECT_EQ("label1", row.cells().at(0).labels().at(0));
+}
@@ -0,0 +1,234 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/make_unique.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <future>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = ::google::bigtable::v2;
+
+/// Define helper types and functions for this test.
+namespace {
+using bigtable::testing::MockReadRowsReader;
+
+class TableReadRowHedgingTest : public bigtable::testing::TableTestFixture {
+ protected:
+  btproto::ReadRowsResponse RowResponse() {
+    return bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "col" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+)");
+  }
+
+  /// Create a stream that returns the test row.
+  std::unique_ptr<MockReadRowsReader> MakeRowStream() {
+    using namespace ::testing;
+    auto response = RowResponse();
+    auto stream = bigtable::internal::make_unique<MockReadRowsReader>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([response](btproto::ReadRowsResponse* r) {
+          *r = response;
+          return true;
+        }))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+    return stream;
+  }
+};
+}  // anonymous namespace
+
+/// @test Verify that a fast response is not hedged.
+TEST_F(TableReadRowHedgingTest, FastResponseIsNotHedged) {
+  using namespace ::testing;
+
+  auto stream = MakeRowStream();
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&stream, this](grpc::ClientContext*,
+                                       btproto::ReadRowsRequest const& req) {
+        EXPECT_EQ(1, req.rows().row_keys_size());
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        EXPECT_EQ(1, req.rows_limit());
+        EXPECT_EQ(table_.table_name(), req.table_name());
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::seconds(10), 1.0));
+  EXPECT_TRUE(table_.has_hedging_policy());
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+}
+
+/// @test Verify that the hedge is used when the original request is slow.
+TEST_F(TableReadRowHedgingTest, HedgeWinsWhenSlow) {
+  using namespace ::testing;
+
+  // The original request blocks until the hedge completes, simulating a slow
+  // server that only returns once the request is cancelled.
+  std::promise<void> hedge_done;
+  auto hedge_done_future = hedge_done.get_future().share();
+  auto slow = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*slow, Read(_))
+      .WillOnce(Invoke([hedge_done_future](btproto::ReadRowsResponse*) {
+        hedge_done_future.wait();
+        return false;
+      }));
+  EXPECT_CALL(*slow, Finish())
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::CANCELLED, "cancelled")));
+
+  auto response = RowResponse();
+  auto hedge = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*hedge, Read(_))
+      .WillOnce(Invoke([response](btproto::ReadRowsResponse* r) {
+        *r = response;
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*hedge, Finish()).WillOnce(Invoke([&hedge_done] {
+    hedge_done.set_value();
+    return grpc::Status::OK;
+  }));
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&slow](grpc::ClientContext*,
+                               btproto::ReadRowsRequest const&) {
+        return slow.release()->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([&hedge](grpc::ClientContext*,
+                                btproto::ReadRowsRequest const& req) {
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        return hedge.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::milliseconds(1), 1.0));
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+}
+
+/// @test Verify that no hedge is sent when the budget is exhausted.
+TEST_F(TableReadRowHedgingTest, NoHedgeWithoutBudget) {
+  using namespace ::testing;
+
+  auto response = RowResponse();
+  auto stream = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(Invoke([response](btproto::ReadRowsResponse* r) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        *r = response;
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&stream](grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&) {
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::milliseconds(1), 0.0));
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+}
+
+/// @test Verify that failed hedged requests fall back to the retry loop.
+TEST_F(TableReadRowHedgingTest, FailureFallsBackToRetry) {
+  using namespace ::testing;
+
+  auto failed = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*failed, Read(_)).WillOnce(Return(false));
+  EXPECT_CALL(*failed, Finish())
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+  auto stream = MakeRowStream();
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&failed](grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&) {
+        return failed.release()->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([&stream](grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&) {
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::seconds(10), 1.0));
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+}
+
+/// @test Verify that permanent errors in hedged requests are not retried.
+TEST_F(TableReadRowHedgingTest, PermanentFailureIsNotRetried) {
+  using namespace ::testing;
+
+  auto failed = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*failed, Read(_)).WillOnce(Return(false));
+  EXPECT_CALL(*failed, Finish())
+      .WillOnce(Return(
+          grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh")));
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&failed](grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&) {
+        return failed.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::seconds(10), 1.0));
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  EXPECT_THROW(table_.ReadRow("r1", bigtable::Filter::PassAllFilter()),
+               std::exception);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(
+      table_.ReadRow("r1", bigtable::Filter::PassAllFilter()),
+      "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+/// @test Verify that a missing row is reported as such.
+TEST_F(TableReadRowHedgingTest, MissingRow) {
+  using namespace ::testing;
+
+  auto stream = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([&stream](grpc::ClientContext*,
+                                 btproto::ReadRowsRequest const&) {
+        return stream.release()->AsUniqueMocked();
+      }));
+
+  table_.set_hedging_policy(
+      bigtable::FixedDelayHedgingPolicy(std::chrono::seconds(10), 1.0));
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_FALSE(std::get<0>(result));
+}
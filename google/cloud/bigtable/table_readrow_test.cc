@@ -14,6 +14,8 @@
 
 #include "google/cloud/bigtable/internal/make_unique.h"
 #include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_async_response_reader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
 #include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
 
@@ -23,6 +25,31 @@ namespace bigtable = google::cloud::bigtable;
 namespace {
 class TableReadRowTest : public bigtable::testing::TableTestFixture {};
 using bigtable::testing::MockReadRowsReader;
+
+/// Create a stream that returns the row "r1", the caller owns the stream.
+MockReadRowsReader::UniquePtr MakeSingleRowStream() {
+  using namespace ::testing;
+  namespace btproto = ::google::bigtable::v2;
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "col" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+)");
+  auto stream = bigtable::internal::make_unique<MockReadRowsReader>();
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(Invoke([response](btproto::ReadRowsResponse* r) {
+        *r = response;
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  return stream.release()->AsUniqueMocked();
+}
 }  // anonymous namespace
 
 TEST_F(TableReadRowTest, ReadRowSimple) {
@@ -112,3 +139,105 @@ TEST_F(TableReadRowTest, UnrecoverableFailure) {
       "exceptions are disabled");
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
+
+TEST_F(TableReadRowTest, ReadRowCached) {
+  using namespace ::testing;
+  namespace btproto = ::google::bigtable::v2;
+
+  // The second ReadRow() is served from the cache, the write invalidates the
+  // row, so the third ReadRow() makes a new request.
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(
+          Invoke([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            return MakeSingleRowStream();
+          }))
+      .WillOnce(
+          Invoke([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            return MakeSingleRowStream();
+          }));
+  EXPECT_CALL(*client_, MutateRow(_, _, _))
+      .WillOnce(Return(grpc::Status::OK));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024,
+                                                    std::chrono::minutes(5));
+  table_.set_row_cache(cache);
+  for (int i = 0; i != 2; ++i) {
+    auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+    EXPECT_TRUE(std::get<0>(result));
+    EXPECT_EQ("r1", std::get<1>(result).row_key());
+  }
+  table_.Apply(bigtable::SingleRowMutation(
+      "r1", {bigtable::SetCell("fam", "col", "new-value")}));
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+
+  auto stats = cache->stats();
+  EXPECT_EQ(1U, stats.hits);
+  EXPECT_EQ(2U, stats.misses);
+  EXPECT_EQ(1U, stats.invalidations);
+}
+
+/// @test Verify that asynchronous writes invalidate the row cache, even if
+/// they fail.
+TEST_F(TableReadRowTest, ReadRowCachedAsyncWrite) {
+  using namespace ::testing;
+  namespace btproto = ::google::bigtable::v2;
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(
+          Invoke([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            return MakeSingleRowStream();
+          }))
+      .WillOnce(
+          Invoke([](grpc::ClientContext*, btproto::ReadRowsRequest const&) {
+            return MakeSingleRowStream();
+          }));
+
+  using MockReader =
+      bigtable::testing::MockAsyncResponseReader<btproto::MutateRowResponse>;
+  auto reader = bigtable::internal::make_unique<MockReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btproto::MutateRowResponse*, grpc::Status* status,
+                          void*) {
+        *status = grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                               "mocked-status");
+      }));
+  EXPECT_CALL(*client_, AsyncMutateRow(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext*,
+                                 btproto::MutateRowRequest const&,
+                                 grpc::CompletionQueue*) {
+        return reader->AsUniqueMocked();
+      }));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024,
+                                                    std::chrono::minutes(5));
+  table_.set_row_cache(cache);
+  auto result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  bool called = false;
+  table_.AsyncApply(
+      bigtable::SingleRowMutation(
+          "r1", {bigtable::SetCell("fam", "col", "new-value")}),
+      cq, [&called](bigtable::CompletionQueue&, grpc::Status& status) {
+        EXPECT_EQ(grpc::StatusCode::FAILED_PRECONDITION, status.error_code());
+        called = true;
+      });
+  // The row is still cached until the write completes.
+  result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(impl->empty());
+
+  result = table_.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+
+  auto stats = cache->stats();
+  EXPECT_EQ(1U, stats.hits);
+  EXPECT_EQ(2U, stats.misses);
+  EXPECT_EQ(1U, stats.invalidations);
+}
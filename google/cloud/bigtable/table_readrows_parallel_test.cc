@@ -0,0 +1,162 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/mock_sample_row_keys_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using bigtable::testing::MockReadRowsReader;
+using bigtable::testing::MockSampleRowKeysReader;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableReadRowsParallelTest : public bigtable::testing::TableTestFixture {
+ protected:
+  /// Setup the mocks so SampleRows() returns @p keys.
+  void ExpectSampleRows(std::vector<std::string> keys) {
+    using namespace ::testing;
+    auto reader = new MockSampleRowKeysReader;
+    EXPECT_CALL(*client_, SampleRowKeys(_, _))
+        .WillOnce(Invoke(reader->MakeMockReturner()));
+    auto& read = EXPECT_CALL(*reader, Read(_));
+    for (auto& k : keys) {
+      read.WillOnce(Invoke([k](btproto::SampleRowKeysResponse* r) {
+        r->set_row_key(k);
+        r->set_offset_bytes(1000);
+        return true;
+      }));
+    }
+    read.WillOnce(Return(false));
+    EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status::OK));
+  }
+};
+
+/// Create a stream returning a single row with @p key, then @p status.
+MockReadRowsReader* MakeStream(std::string const& key, grpc::Status status) {
+  using namespace ::testing;
+  auto stream = new MockReadRowsReader;
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: ")" + key + R"("
+        family_name { value: "fam" }
+        qualifier { value: "qual" }
+        timestamp_micros: 42000
+        value: "value"
+        commit_row: true
+      }
+      )");
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(status));
+  return stream;
+}
+}  // anonymous namespace
+
+/// @test Verify that Table::ReadRowsParallel() reads each shard.
+TEST_F(TableReadRowsParallelTest, Simple) {
+  using namespace ::testing;
+
+  ExpectSampleRows({"m", ""});
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(
+          [](grpc::ClientContext*, btproto::ReadRowsRequest const& request) {
+            EXPECT_EQ(1, request.rows().row_ranges_size());
+            auto const& range = request.rows().row_ranges(0);
+            // The first shard is ["", "m"), the second is ["m", "").
+            auto key = range.start_key_closed().empty() ? "a" : "z";
+            return MakeStream(key, grpc::Status::OK)->AsUniqueMocked();
+          }));
+
+  std::mutex mu;
+  std::vector<std::pair<std::size_t, std::string>> rows;
+  table_.ReadRowsParallel(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), 4,
+      [&mu, &rows](std::size_t shard, bigtable::Row row) {
+        std::lock_guard<std::mutex> lk(mu);
+        rows.emplace_back(shard, row.row_key());
+      });
+  std::sort(rows.begin(), rows.end());
+  ASSERT_EQ(2U, rows.size());
+  EXPECT_EQ(0U, rows[0].first);
+  EXPECT_EQ("a", rows[0].second);
+  EXPECT_EQ(1U, rows[1].first);
+  EXPECT_EQ("z", rows[1].second);
+}
+
+/// @test Verify that Table::ReadRowsParallel() reports shard failures.
+TEST_F(TableReadRowsParallelTest, ShardFailure) {
+  using namespace ::testing;
+
+  ExpectSampleRows({"m"});
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(
+          [](grpc::ClientContext*, btproto::ReadRowsRequest const& request) {
+            auto const& range = request.rows().row_ranges(0);
+            if (range.start_key_closed().empty()) {
+              return MakeStream("a", grpc::Status::OK)->AsUniqueMocked();
+            }
+            return MakeStream("z", grpc::Status(
+                                       grpc::StatusCode::PERMISSION_DENIED,
+                                       "uh-oh"))
+                ->AsUniqueMocked();
+          }));
+
+  // Use a single thread so the test is deterministic.
+  auto callback = [](std::size_t, bigtable::Row) {};
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  EXPECT_THROW(table_.ReadRowsParallel(bigtable::RowSet(),
+                                       bigtable::Filter::PassAllFilter(), 1,
+                                       callback),
+               std::exception);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(
+      table_.ReadRowsParallel(bigtable::RowSet(),
+                              bigtable::Filter::PassAllFilter(), 1, callback),
+      "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that exceptions raised by the callback reach the caller.
+TEST_F(TableReadRowsParallelTest, CallbackThrows) {
+  using namespace ::testing;
+
+  ExpectSampleRows({"m"});
+  // The second shard may, or may not, start before the exception stops the
+  // workers.
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .Times(Between(1, 2))
+      .WillRepeatedly(Invoke(
+          [](grpc::ClientContext*, btproto::ReadRowsRequest const& request) {
+            auto const& range = request.rows().row_ranges(0);
+            auto key = range.start_key_closed().empty() ? "a" : "z";
+            return MakeStream(key, grpc::Status::OK)->AsUniqueMocked();
+          }));
+
+  EXPECT_THROW(table_.ReadRowsParallel(
+                   bigtable::RowSet(), bigtable::Filter::PassAllFilter(), 4,
+                   [](std::size_t, bigtable::Row) {
+                     throw std::runtime_error("callback failed");
+                   }),
+               std::runtime_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -139,3 +139,127 @@ TEST_F(TableReadRowsTest, ReadRowsThrowsWhenTooManyErrors) {
   EXPECT_THROW(reader.begin(), std::exception);
 }
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+namespace {
+/// Create a stream returning a row for each key, and then @p status.
+MockReadRowsReader* MakeKeysStream(std::vector<std::string> const& keys,
+                                   grpc::Status status = grpc::Status::OK) {
+  google::bigtable::v2::ReadRowsResponse response;
+  for (auto const& key : keys) {
+    auto& chunk = *response.add_chunks();
+    chunk.set_row_key(key);
+    chunk.mutable_family_name()->set_value("fam");
+    chunk.mutable_qualifier()->set_value("qual");
+    chunk.set_timestamp_micros(42000);
+    chunk.set_value("value");
+    chunk.set_commit_row(true);
+  }
+  auto stream = new MockReadRowsReader;
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(status));
+  return stream;
+}
+
+std::vector<std::string> RowKeys(std::vector<bigtable::Row> const& rows) {
+  std::vector<std::string> keys;
+  for (auto const& row : rows) {
+    keys.push_back(row.row_key());
+  }
+  return keys;
+}
+
+std::vector<std::string> RequestKeys(
+    google::bigtable::v2::ReadRowsRequest const& request) {
+  return {request.rows().row_keys().begin(), request.rows().row_keys().end()};
+}
+}  // anonymous namespace
+
+TEST_F(TableReadRowsTest, MultiGetSplitsRequests) {
+  std::vector<std::vector<std::string>> requests;
+  std::mutex mu;
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](grpc::ClientContext*,
+                                 google::bigtable::v2::ReadRowsRequest const&
+                                     request) {
+        EXPECT_EQ(0, request.rows().row_ranges_size());
+        auto keys = RequestKeys(request);
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          requests.push_back(keys);
+        }
+        return MakeKeysStream(keys)->AsUniqueMocked();
+      }));
+
+  auto rows = table_.ReadRows({"r3", "r1", "r2", "r1"},
+                              bigtable::Filter::PassAllFilter(),
+                              bigtable::MultiGetOptions()
+                                  .set_max_request_bytes(4)
+                                  .set_max_parallelism(2));
+  EXPECT_THAT(RowKeys(rows), ::testing::ElementsAre("r1", "r2", "r3"));
+  EXPECT_THAT(requests, ::testing::UnorderedElementsAre(
+                            std::vector<std::string>{"r1", "r2"},
+                            std::vector<std::string>{"r3"}));
+}
+
+TEST_F(TableReadRowsTest, MultiGetCompletionOrder) {
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke(
+          [](grpc::ClientContext*,
+             google::bigtable::v2::ReadRowsRequest const& request) {
+            return MakeKeysStream(RequestKeys(request))->AsUniqueMocked();
+          }));
+
+  using RowOrder = bigtable::MultiGetOptions::RowOrder;
+  auto rows = table_.ReadRows({"r1", "r2", "r3", "r4", "r5"},
+                              bigtable::Filter::PassAllFilter(),
+                              bigtable::MultiGetOptions()
+                                  .set_max_request_bytes(4)
+                                  .set_row_order(RowOrder::kCompletionOrder));
+  EXPECT_THAT(RowKeys(rows),
+              ::testing::UnorderedElementsAre("r1", "r2", "r3", "r4", "r5"));
+}
+
+TEST_F(TableReadRowsTest, MultiGetRetryRequestsMissingKeys) {
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          google::bigtable::v2::ReadRowsRequest const&
+                              request) {
+        EXPECT_THAT(RequestKeys(request),
+                    ::testing::ElementsAre("r1", "r2", "r3"));
+        return MakeKeysStream(
+                   {"r1"},
+                   grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again"))
+            ->AsUniqueMocked();
+      }))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          google::bigtable::v2::ReadRowsRequest const&
+                              request) {
+        EXPECT_THAT(RequestKeys(request), ::testing::ElementsAre("r2", "r3"));
+        return MakeKeysStream({"r2", "r3"})->AsUniqueMocked();
+      }));
+
+  std::vector<std::string> keys{"r1", "r2", "r3"};
+  auto rows = table_.ReadRows(keys, bigtable::Filter::PassAllFilter());
+  EXPECT_THAT(RowKeys(rows), ::testing::ElementsAre("r1", "r2", "r3"));
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST_F(TableReadRowsTest, MultiGetThrowsOnPermanentError) {
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([](grpc::ClientContext*,
+                          google::bigtable::v2::ReadRowsRequest const&) {
+        return MakeKeysStream({}, grpc::Status(
+                                      grpc::StatusCode::PERMISSION_DENIED,
+                                      "uh oh"))
+            ->AsUniqueMocked();
+      }));
+
+  std::vector<std::string> keys{"r1", "r2"};
+  EXPECT_THROW(table_.ReadRows(keys, bigtable::Filter::PassAllFilter()),
+               std::exception);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -0,0 +1,56 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_DRAINED_RETRY_BUDGET_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_DRAINED_RETRY_BUDGET_H_
+
+#include "google/cloud/internal/retry_budget.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace testing {
+
+/**
+ * Drain the process-wide retry budget, and refill it on destruction.
+ *
+ * All the tests in a binary share the budget, so it must be restored even if
+ * the test fails.
+ */
+class DrainedRetryBudget {
+ public:
+  DrainedRetryBudget()
+      : budget_(google::cloud::internal::DefaultRetryBudget()) {
+    while (budget_.TryRetry()) {
+    }
+  }
+  ~DrainedRetryBudget() {
+    while (budget_.tokens() < budget_.max_tokens()) {
+      budget_.OnSuccess();
+    }
+  }
+
+  DrainedRetryBudget(DrainedRetryBudget const&) = delete;
+  DrainedRetryBudget& operator=(DrainedRetryBudget const&) = delete;
+
+ private:
+  google::cloud::internal::RetryBudget& budget_;
+};
+
+}  // namespace testing
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_DRAINED_RETRY_BUDGET_H_
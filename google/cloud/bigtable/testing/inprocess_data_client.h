@@ -81,6 +81,37 @@ class InProcessDataClient : public bigtable::DataClient {
              google::bigtable::v2::MutateRowsRequest const& request) override;
   //@}
 
+  //@{
+  /// @name the google.bigtable.v2.Bigtable asynchronous operations.
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::MutateRowResponse>>
+  AsyncMutateRow(grpc::ClientContext* context,
+                 google::bigtable::v2::MutateRowRequest const& request,
+                 grpc::CompletionQueue* cq) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::CheckAndMutateRowResponse>>
+  AsyncCheckAndMutateRow(
+      grpc::ClientContext* context,
+      google::bigtable::v2::CheckAndMutateRowRequest const& request,
+      grpc::CompletionQueue* cq) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::bigtable::v2::ReadModifyWriteRowResponse>>
+  AsyncReadModifyWriteRow(
+      grpc::ClientContext* context,
+      google::bigtable::v2::ReadModifyWriteRowRequest const& request,
+      grpc::CompletionQueue* cq) override;
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+  PrepareAsyncReadRows(grpc::ClientContext* context,
+                       google::bigtable::v2::ReadRowsRequest const& request,
+                       grpc::CompletionQueue* cq) override;
+  std::unique_ptr<grpc::ClientAsyncReaderInterface<
+      google::bigtable::v2::MutateRowsResponse>>
+  PrepareAsyncMutateRows(grpc::ClientContext* context,
+                         google::bigtable::v2::MutateRowsRequest const& request,
+                         grpc::CompletionQueue* cq) override;
+  //@}
+
  private:
   std::string project_;
   std::string instance_;
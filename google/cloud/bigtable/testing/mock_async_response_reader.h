@@ -0,0 +1,82 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_ASYNC_RESPONSE_READER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_ASYNC_RESPONSE_READER_H_
+
+#include <gmock/gmock.h>
+#include <grpcpp/support/async_stream.h>
+#include <grpcpp/support/async_unary_call.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace testing {
+/**
+ * Mock the result of an asynchronous unary RPC.
+ *
+ * The `Finish()` mock is expected to set the response and status, the test
+ * then uses `MockCompletionQueue::SimulateCompletion()` to deliver them.
+ *
+ * gRPC specializes `std::default_delete<>` for
+ * `grpc::ClientAsyncResponseReaderInterface<>` (the real objects are allocated
+ * in the call arena), so the `std::unique_ptr<>` returned to the library never
+ * deletes the mock. The test must own the mock object.
+ *
+ * @tparam Response the response type.
+ */
+template <typename Response>
+class MockAsyncResponseReader
+    : public grpc::ClientAsyncResponseReaderInterface<Response> {
+ public:
+  MOCK_METHOD0(StartCall, void());
+  MOCK_METHOD1(ReadInitialMetadata, void(void*));
+  MOCK_METHOD3_T(Finish, void(Response*, grpc::Status*, void*));
+
+  using UniquePtr =
+      std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<Response>>;
+
+  /// Return a `std::unique_ptr<>` wrapping this (non-owned) mock.
+  UniquePtr AsUniqueMocked() { return UniquePtr(this); }
+};
+
+/**
+ * Mock the result of an asynchronous streaming read RPC.
+ *
+ * Each event in the stream (start, each read, and finish) must be delivered
+ * using `MockCompletionQueue::SimulateCompletion()`.
+ *
+ * @tparam Response the response type.
+ */
+template <typename Response>
+class MockClientAsyncReader
+    : public grpc::ClientAsyncReaderInterface<Response> {
+ public:
+  MOCK_METHOD1(StartCall, void(void*));
+  MOCK_METHOD1(ReadInitialMetadata, void(void*));
+  MOCK_METHOD2(Finish, void(grpc::Status*, void*));
+  MOCK_METHOD2_T(Read, void(Response*, void*));
+
+  using UniquePtr = std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>>;
+
+  /// Return a `std::unique_ptr< mocked-class >`
+  UniquePtr AsUniqueMocked() { return UniquePtr(this); }
+};
+
+}  // namespace testing
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_ASYNC_RESPONSE_READER_H_
@@ -0,0 +1,59 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_COMPLETION_QUEUE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_COMPLETION_QUEUE_H_
+
+#include "google/cloud/bigtable/completion_queue.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace testing {
+/**
+ * A `CompletionQueueImpl` where the tests control when operations complete.
+ *
+ * Timers never expire on their own, and RPCs started with the mocks in
+ * `mock_async_response_reader.h` never complete on their own. The test calls
+ * `SimulateCompletion()` to complete all the pending operations, one event at
+ * a time.
+ */
+class MockCompletionQueue : public bigtable::internal::CompletionQueueImpl {
+ public:
+  std::unique_ptr<grpc::Alarm> CreateAlarm() const override {
+    // grpc::Alarm objects are really hard to cleanup when mocking their
+    // behavior, so we do not create an alarm, instead we return nullptr, which
+    // the classes that care (AsyncTimerFunctor) know what to do with.
+    return std::unique_ptr<grpc::Alarm>();
+  }
+
+  using bigtable::internal::CompletionQueueImpl::SimulateCompletion;
+  using bigtable::internal::CompletionQueueImpl::size;
+
+  /// Simulate one event for each pending operation.
+  void SimulateCompletion(CompletionQueue& cq, bool ok) {
+    for (auto& op : pending_operations()) {
+      SimulateCompletion(cq, op.get(), ok);
+    }
+  }
+
+  bool empty() const { return size() == 0U; }
+};
+
+}  // namespace testing
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TESTING_MOCK_COMPLETION_QUEUE_H_
@@ -2,21 +2,30 @@
 google_cloud_cpp_common_HDRS = [
     "internal/backoff_policy.h",
     "internal/build_info.h",
+    "internal/operation_metrics.h",
     "internal/optional.h",
     "internal/port_platform.h",
     "internal/random.h",
+    "internal/retry_budget.h",
     "internal/retry_policy.h",
     "internal/setenv.h",
     "internal/throw_delegate.h",
+    "internal/timer_service.h",
     "log.h",
+    "metrics.h",
+    "tracing.h",
     "version.h",
 ]
 
 google_cloud_cpp_common_SRCS = [
     "internal/backoff_policy.cc",
     "internal/random.cc",
+    "internal/retry_budget.cc",
     "internal/setenv.cc",
     "internal/throw_delegate.cc",
+    "internal/timer_service.cc",
     "log.cc",
+    "metrics.cc",
+    "tracing.cc",
 ]
 
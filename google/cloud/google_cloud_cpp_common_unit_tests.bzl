@@ -3,8 +3,12 @@ google_cloud_cpp_common_unit_tests = [
     "internal/backoff_policy_test.cc",
     "internal/optional_test.cc",
     "internal/random_test.cc",
+    "internal/retry_budget_test.cc",
     "internal/retry_policy_test.cc",
     "internal/throw_delegate_test.cc",
+    "internal/timer_service_test.cc",
     "log_test.cc",
+    "metrics_test.cc",
+    "tracing_test.cc",
 ]
 
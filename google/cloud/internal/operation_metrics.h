@@ -0,0 +1,84 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_OPERATION_METRICS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_OPERATION_METRICS_H_
+
+#include "google/cloud/metrics.h"
+#include <chrono>
+#include <string>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/**
+ * The metrics recorded for each kind of operation, e.g. `bigtable.ReadRows`.
+ *
+ * The metrics are called `<prefix>.latency`, `<prefix>.attempt_latency`, etc.
+ * Looking them up requires a lock, the libraries create one instance for each
+ * kind of operation, and keep it in a function-local static variable.
+ */
+struct OperationMetrics {
+  explicit OperationMetrics(
+      std::string const& prefix,
+      MetricsRegistry& registry = DefaultMetricsRegistry())
+      : name(prefix),
+        latency(registry.GetHistogram(prefix + ".latency")),
+        attempt_latency(registry.GetHistogram(prefix + ".attempt_latency")),
+        operations(registry.GetCounter(prefix + ".operations")),
+        attempts(registry.GetCounter(prefix + ".attempts")),
+        retries(registry.GetCounter(prefix + ".retries")),
+        errors(registry.GetCounter(prefix + ".errors")),
+        bytes_sent(registry.GetCounter(prefix + ".bytes_sent")),
+        bytes_received(registry.GetCounter(prefix + ".bytes_received")) {}
+
+  /// The name of the operation, also used for its tracing spans.
+  std::string const name;
+  /// The latency of each operation, including retries and backoff, in usecs.
+  Histogram& latency;
+  /// The latency of each attempt (RPC or HTTP request), in usecs.
+  Histogram& attempt_latency;
+  Counter& operations;
+  Counter& attempts;
+  Counter& retries;
+  /// The number of operations that failed, after any retries.
+  Counter& errors;
+  Counter& bytes_sent;
+  Counter& bytes_received;
+};
+
+/// Record the time since its construction in a histogram.
+class LatencyTimer {
+ public:
+  explicit LatencyTimer(Histogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~LatencyTimer() {
+    histogram_.Record(std::chrono::steady_clock::now() - start_);
+  }
+
+  LatencyTimer(LatencyTimer const&) = delete;
+  LatencyTimer& operator=(LatencyTimer const&) = delete;
+
+ private:
+  Histogram& histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_OPERATION_METRICS_H_
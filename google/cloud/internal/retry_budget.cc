@@ -0,0 +1,73 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/retry_budget.h"
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+constexpr std::int64_t kUnitsPerToken = 1000;
+}  // namespace
+
+RetryBudget::RetryBudget(double retry_ratio, double max_tokens)
+    : deposit_(static_cast<std::int64_t>(retry_ratio * kUnitsPerToken)),
+      capacity_(static_cast<std::int64_t>(max_tokens * kUnitsPerToken)),
+      balance_(capacity_),
+      exhausted_count_(0) {}
+
+void RetryBudget::OnSuccess() {
+  // Several threads may pass the check at the same time, so the balance can
+  // exceed the capacity by a few deposits.  That is harmless, and avoids a
+  // compare-and-swap loop in the common case.
+  if (balance_.load(std::memory_order_relaxed) < capacity_) {
+    balance_.fetch_add(deposit_, std::memory_order_relaxed);
+  }
+}
+
+bool RetryBudget::TryRetry() {
+  auto balance = balance_.load(std::memory_order_relaxed);
+  do {
+    if (balance < kUnitsPerToken) {
+      exhausted_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  } while (not balance_.compare_exchange_weak(balance, balance - kUnitsPerToken,
+                                              std::memory_order_relaxed));
+  return true;
+}
+
+double RetryBudget::tokens() const {
+  return static_cast<double>(balance_.load(std::memory_order_relaxed)) /
+         kUnitsPerToken;
+}
+
+double RetryBudget::retry_ratio() const {
+  return static_cast<double>(deposit_) / kUnitsPerToken;
+}
+
+double RetryBudget::max_tokens() const {
+  return static_cast<double>(capacity_) / kUnitsPerToken;
+}
+
+RetryBudget& DefaultRetryBudget() {
+  static RetryBudget* const budget = new RetryBudget;
+  return *budget;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,100 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H_
+
+#include "google/cloud/version.h"
+#include <atomic>
+#include <cstdint>
+
+// Define the defaults using a pre-processor macro, this allows the application
+// developers to change the defaults for their application by compiling with
+// different values.
+#ifndef GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_RATIO
+#define GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_RATIO 0.1
+#endif  // GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_RATIO
+
+#ifndef GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_TOKENS
+#define GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_TOKENS 1000
+#endif  // GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_TOKENS
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/// Included in the error messages when an operation runs out of retry budget.
+constexpr char kRetryBudgetExhausted[] = "Retry budget exhausted";
+
+/**
+ * Cap the number of retries at a fraction of the successful requests.
+ *
+ * The retry policies limit the retries of each operation.  During a partial
+ * outage every operation in flight retries independently, and the retries can
+ * multiply the traffic sent to an already overloaded service.  A retry budget
+ * is a token bucket shared by many operations: each successful request
+ * deposits `retry_ratio` tokens, up to `max_tokens`, and each retry withdraws
+ * a full token.  When the bucket is empty the retry loops give up, and report
+ * `kRetryBudgetExhausted` as the reason.
+ *
+ * The bucket starts full, so a process can retry some requests before it has
+ * any successes.
+ *
+ * @par Thread-safety
+ * All the member functions are thread-safe, and lock-free.
+ */
+class RetryBudget {
+ public:
+  explicit RetryBudget(
+      double retry_ratio = GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_RATIO,
+      double max_tokens = GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_TOKENS);
+
+  RetryBudget(RetryBudget const&) = delete;
+  RetryBudget& operator=(RetryBudget const&) = delete;
+
+  /// Report a successful request, which deposits `retry_ratio()` tokens.
+  void OnSuccess();
+
+  /// Withdraw a token for a retry, return false if there are none left.
+  bool TryRetry();
+
+  /// The number of tokens available.
+  double tokens() const;
+
+  /// The number of retries denied because the budget was exhausted.
+  std::uint64_t exhausted_count() const {
+    return exhausted_count_.load(std::memory_order_relaxed);
+  }
+
+  double retry_ratio() const;
+  double max_tokens() const;
+
+ private:
+  // The balance is kept in thousandths of a token, so it can use integer
+  // atomics.
+  std::int64_t const deposit_;
+  std::int64_t const capacity_;
+  std::atomic<std::int64_t> balance_;
+  std::atomic<std::uint64_t> exhausted_count_;
+};
+
+/// Return the retry budget shared by all the clients in the process.
+RetryBudget& DefaultRetryBudget();
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RETRY_BUDGET_H_
@@ -0,0 +1,86 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/retry_budget.h"
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+using google::cloud::internal::RetryBudget;
+
+/// @test Verify that a new budget starts full.
+TEST(RetryBudgetTest, StartsFull) {
+  RetryBudget budget(0.1, 3);
+  EXPECT_DOUBLE_EQ(3.0, budget.tokens());
+  EXPECT_DOUBLE_EQ(0.1, budget.retry_ratio());
+  EXPECT_DOUBLE_EQ(3.0, budget.max_tokens());
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+  EXPECT_EQ(1U, budget.exhausted_count());
+}
+
+/// @test Verify that retries are capped at a fraction of the successes.
+TEST(RetryBudgetTest, RetriesAreFractionOfSuccesses) {
+  RetryBudget budget(0.2, 1);
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+  int retries = 0;
+  for (int i = 0; i != 100; ++i) {
+    budget.OnSuccess();
+    if (budget.TryRetry()) {
+      ++retries;
+    }
+  }
+  EXPECT_EQ(20, retries);
+}
+
+/// @test Verify that the budget does not grow past its capacity.
+TEST(RetryBudgetTest, Capacity) {
+  RetryBudget budget(0.5, 2);
+  for (int i = 0; i != 100; ++i) {
+    budget.OnSuccess();
+  }
+  EXPECT_DOUBLE_EQ(2.0, budget.tokens());
+}
+
+/// @test Verify that concurrent retries never overdraw the budget.
+TEST(RetryBudgetTest, Concurrent) {
+  RetryBudget budget(0.1, 100);
+  std::atomic<int> retries(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([&budget, &retries] {
+      for (int i = 0; i != 1000; ++i) {
+        if (budget.TryRetry()) {
+          ++retries;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(100, retries.load());
+  EXPECT_EQ(3900U, budget.exhausted_count());
+}
+
+/// @test Verify that the default budget is shared.
+TEST(RetryBudgetTest, Default) {
+  auto& budget = google::cloud::internal::DefaultRetryBudget();
+  EXPECT_EQ(&budget, &google::cloud::internal::DefaultRetryBudget());
+  EXPECT_DOUBLE_EQ(GOOGLE_CLOUD_CPP_DEFAULT_RETRY_BUDGET_RATIO,
+                   budget.retry_ratio());
+}
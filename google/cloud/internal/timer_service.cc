@@ -0,0 +1,131 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/timer_service.h"
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+TimerService::TimerService(std::size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = 1;
+  }
+  threads_.reserve(thread_count);
+  for (std::size_t i = 0; i != thread_count; ++i) {
+    threads_.emplace_back(&TimerService::Run, this);
+  }
+}
+
+TimerService::~TimerService() { Shutdown(); }
+
+TimerService::TimerId TimerService::Schedule(Clock::time_point deadline,
+                                             Callback callback) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (shutdown_) {
+    lk.unlock();
+    callback(false);
+    return 0;
+  }
+  auto id = ++next_id_;
+  bool const is_first =
+      timers_.empty() or deadline < timers_.begin()->first.first;
+  timers_.emplace(Key(deadline, id), std::move(callback));
+  deadlines_.emplace(id, deadline);
+  lk.unlock();
+  // Only the threads waiting for the (old) first timer need to wake up.
+  if (is_first) {
+    cv_.notify_all();
+  }
+  return id;
+}
+
+bool TimerService::Cancel(TimerId id) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto loc = deadlines_.find(id);
+  if (loc == deadlines_.end()) {
+    return false;
+  }
+  // Release the callback outside the lock, it may own objects whose
+  // destructors call back into this service.
+  auto timer = timers_.find(Key(loc->second, id));
+  Callback callback = std::move(timer->second);
+  timers_.erase(timer);
+  deadlines_.erase(loc);
+  lk.unlock();
+  return true;
+}
+
+void TimerService::Shutdown() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (shutdown_) {
+    return;
+  }
+  shutdown_ = true;
+  std::map<Key, Callback> pending;
+  pending.swap(timers_);
+  deadlines_.clear();
+  lk.unlock();
+  cv_.notify_all();
+  for (auto& t : threads_) {
+    if (t.get_id() == std::this_thread::get_id()) {
+      // A callback shut down the service, it cannot wait for itself.
+      t.detach();
+      continue;
+    }
+    t.join();
+  }
+  for (auto& kv : pending) {
+    kv.second(false);
+  }
+}
+
+std::size_t TimerService::pending() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return timers_.size();
+}
+
+void TimerService::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (not shutdown_) {
+    if (timers_.empty()) {
+      cv_.wait(lk);
+      continue;
+    }
+    auto const deadline = timers_.begin()->first.first;
+    if (Clock::now() < deadline) {
+      cv_.wait_until(lk, deadline);
+      continue;
+    }
+    auto first = timers_.begin();
+    Callback callback = std::move(first->second);
+    deadlines_.erase(first->first.second);
+    timers_.erase(first);
+    lk.unlock();
+    callback(true);
+    lk.lock();
+  }
+}
+
+TimerService& DefaultTimerService() {
+  // Never destroyed, the threads would otherwise need to stop while other
+  // static objects may still use the service.
+  static TimerService* const service = new TimerService;
+  return *service;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,112 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_SERVICE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_SERVICE_H_
+
+#include "google/cloud/version.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/**
+ * Run callbacks at a given time, using a small, fixed, number of threads.
+ *
+ * Code that needs to wait before doing more work (to back off before a retry,
+ * or to send a hedged request) can schedule a callback instead of creating a
+ * thread, or blocking one, while it waits.  The number of threads stays fixed,
+ * no matter how many timers are pending.
+ *
+ * The callbacks run in the service threads, they should be short, and should
+ * hand off any blocking work to other threads.  The callbacks receive `true`
+ * if the timer expired, and `false` if the service shut down before that.
+ *
+ * @par Thread-safety
+ * All the member functions are thread-safe.
+ */
+class TimerService {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void(bool)>;
+  using TimerId = std::uint64_t;
+
+  explicit TimerService(std::size_t thread_count = 1);
+  ~TimerService();
+
+  TimerService(TimerService const&) = delete;
+  TimerService& operator=(TimerService const&) = delete;
+
+  /**
+   * Run @p callback at @p deadline.
+   *
+   * If the service is already shut down the callback runs immediately, in the
+   * calling thread, with `false` as its argument.
+   */
+  TimerId Schedule(Clock::time_point deadline, Callback callback);
+
+  /// Run @p callback after @p duration.
+  template <typename Rep, typename Period>
+  TimerId ScheduleAfter(std::chrono::duration<Rep, Period> duration,
+                        Callback callback) {
+    return Schedule(Clock::now() + duration, std::move(callback));
+  }
+
+  /**
+   * Cancel a pending timer.
+   *
+   * @return true if the timer was cancelled, in which case its callback never
+   *     runs.  False if the callback already ran, or is running.
+   */
+  bool Cancel(TimerId id);
+
+  /// Run all the pending callbacks with `false`, and stop the threads.
+  void Shutdown();
+
+  /// The number of timers waiting to expire.
+  std::size_t pending() const;
+
+ private:
+  void Run();
+
+  using Key = std::pair<Clock::time_point, TimerId>;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  // Ordered by deadline, the id breaks ties and makes the keys unique.
+  std::map<Key, Callback> timers_;
+  std::map<TimerId, Clock::time_point> deadlines_;
+  TimerId next_id_ = 0;
+  bool shutdown_ = false;
+  std::vector<std::thread> threads_;
+};
+
+/// Return the timer service shared by all the clients in the process.
+TimerService& DefaultTimerService();
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_TIMER_SERVICE_H_
@@ -0,0 +1,122 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/timer_service.h"
+#include <gmock/gmock.h>
+#include <future>
+
+using google::cloud::internal::TimerService;
+using namespace ::testing;
+
+/// @test Verify that timers run in deadline order.
+TEST(TimerServiceTest, RunsInOrder) {
+  TimerService service;
+  std::mutex mu;
+  std::vector<int> order;
+  std::promise<void> done;
+  auto const now = TimerService::Clock::now();
+  auto record = [&mu, &order](int value) {
+    return [&mu, &order, value](bool expired) {
+      EXPECT_TRUE(expired);
+      std::lock_guard<std::mutex> lk(mu);
+      order.push_back(value);
+    };
+  };
+  service.Schedule(now + std::chrono::milliseconds(30), record(3));
+  service.Schedule(now + std::chrono::milliseconds(10), record(1));
+  service.Schedule(now + std::chrono::milliseconds(20), record(2));
+  service.Schedule(now + std::chrono::milliseconds(40),
+                   [&done](bool) { done.set_value(); });
+  done.get_future().get();
+  std::lock_guard<std::mutex> lk(mu);
+  EXPECT_THAT(order, ElementsAre(1, 2, 3));
+}
+
+/// @test Verify that timers do not expire early.
+TEST(TimerServiceTest, ScheduleAfter) {
+  TimerService service;
+  std::promise<TimerService::Clock::time_point> expired;
+  auto const start = TimerService::Clock::now();
+  service.ScheduleAfter(std::chrono::milliseconds(20), [&expired](bool) {
+    expired.set_value(TimerService::Clock::now());
+  });
+  auto const elapsed = expired.get_future().get() - start;
+  EXPECT_LE(std::chrono::milliseconds(20), elapsed);
+}
+
+/// @test Verify that cancelled timers never run.
+TEST(TimerServiceTest, Cancel) {
+  TimerService service;
+  bool called = false;
+  auto id = service.ScheduleAfter(std::chrono::hours(1),
+                                  [&called](bool) { called = true; });
+  EXPECT_EQ(1U, service.pending());
+  EXPECT_TRUE(service.Cancel(id));
+  EXPECT_FALSE(service.Cancel(id));
+  EXPECT_EQ(0U, service.pending());
+  service.Shutdown();
+  EXPECT_FALSE(called);
+}
+
+/// @test Verify that shutting down runs the pending callbacks.
+TEST(TimerServiceTest, Shutdown) {
+  TimerService service(2);
+  int expired_count = 0;
+  int cancelled_count = 0;
+  for (int i = 0; i != 3; ++i) {
+    service.ScheduleAfter(std::chrono::hours(1),
+                          [&expired_count, &cancelled_count](bool expired) {
+                            ++(expired ? expired_count : cancelled_count);
+                          });
+  }
+  service.Shutdown();
+  EXPECT_EQ(0, expired_count);
+  EXPECT_EQ(3, cancelled_count);
+
+  // New timers are cancelled immediately.
+  service.ScheduleAfter(std::chrono::hours(1),
+                        [&cancelled_count](bool expired) {
+                          EXPECT_FALSE(expired);
+                          ++cancelled_count;
+                        });
+  EXPECT_EQ(4, cancelled_count);
+}
+
+/// @test Verify that many timers do not need more threads.
+TEST(TimerServiceTest, ManyTimers) {
+  TimerService service(2);
+  std::atomic<int> count(0);
+  std::promise<void> done;
+  int const timer_count = 1000;
+  for (int i = 0; i != timer_count; ++i) {
+    service.ScheduleAfter(std::chrono::microseconds(i * 10),
+                          [&count, &done, timer_count](bool) {
+                            if (++count == timer_count) {
+                              done.set_value();
+                            }
+                          });
+  }
+  done.get_future().get();
+  EXPECT_EQ(timer_count, count.load());
+}
+
+/// @test Verify that the default service is shared.
+TEST(TimerServiceTest, Default) {
+  auto& service = google::cloud::internal::DefaultTimerService();
+  EXPECT_EQ(&service, &google::cloud::internal::DefaultTimerService());
+  std::promise<bool> expired;
+  service.ScheduleAfter(std::chrono::milliseconds(1),
+                        [&expired](bool e) { expired.set_value(e); });
+  EXPECT_TRUE(expired.get_future().get());
+}
@@ -0,0 +1,157 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/metrics.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+std::size_t MetricShard() {
+  // Assign the shards round-robin as threads record their first value, that
+  // spreads the threads more evenly than hashing their ids.
+  static std::atomic<std::size_t> next_shard(0);
+  thread_local std::size_t const shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return shard;
+}
+}  // namespace internal
+
+namespace {
+/// Return the position of the most significant bit set in @p value.
+int MostSignificantBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  int bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+#endif  // defined(__GNUC__) || defined(__clang__)
+}
+}  // namespace
+
+std::uint64_t Counter::value() const {
+  std::uint64_t total = 0;
+  for (auto const& shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+constexpr std::size_t Histogram::kBucketCount;
+
+Histogram::Shard::Shard() : count(0), sum(0) {
+  for (auto& bucket : buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::size_t Histogram::BucketIndex(std::uint64_t value) {
+  if (value < 16) {
+    return static_cast<std::size_t>(value);
+  }
+  auto const exponent = MostSignificantBit(value);
+  // The 3 bits after the most significant bit select one of 8 buckets.
+  auto const linear = static_cast<std::size_t>(value >> (exponent - 3)) & 7U;
+  auto const index = 16 + (exponent - 4) * 8 + linear;
+  return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+std::uint64_t Histogram::BucketLowerBound(std::size_t index) {
+  if (index < 16) {
+    return index;
+  }
+  auto const exponent = (index - 16) / 8 + 4;
+  auto const linear = (index - 16) % 8;
+  return static_cast<std::uint64_t>(8 + linear) << (exponent - 3);
+}
+
+HistogramSnapshot Histogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.buckets.resize(kBucketCount);
+  for (auto const& shard : shards_) {
+    for (std::size_t i = 0; i != kBucketCount; ++i) {
+      snapshot.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count += shard.count.load(std::memory_order_relaxed);
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+std::uint64_t HistogramSnapshot::Percentile(double percentile) const {
+  // The buckets and the count are loaded at slightly different times, use the
+  // buckets as the source of truth.
+  std::uint64_t total = 0;
+  for (auto n : buckets) {
+    total += n;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  auto const rank = (std::min)(
+      static_cast<std::uint64_t>(percentile / 100.0 * total), total - 1);
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i != buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return Histogram::BucketLowerBound(i);
+    }
+  }
+  return Histogram::BucketLowerBound(buckets.size() - 1);
+}
+
+Counter& MetricsRegistry::GetCounter(std::string const& name) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& counter = counters_[name];
+  if (not counter) {
+    counter.reset(new Counter);
+  }
+  return *counter;
+}
+
+Histogram& MetricsRegistry::GetHistogram(std::string const& name) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& histogram = histograms_[name];
+  if (not histogram) {
+    histogram.reset(new Histogram);
+  }
+  return *histogram;
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot() const {
+  MetricsSnapshot snapshot;
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto const& kv : counters_) {
+    snapshot.counters.emplace(kv.first, kv.second->value());
+  }
+  for (auto const& kv : histograms_) {
+    snapshot.histograms.emplace(kv.first, kv.second->Snapshot());
+  }
+  return snapshot;
+}
+
+MetricsRegistry& DefaultMetricsRegistry() {
+  // Never destroyed, the libraries keep references to its metrics in static
+  // variables, which may be used during program shutdown.
+  static MetricsRegistry* const registry = new MetricsRegistry;
+  return *registry;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,213 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_METRICS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_METRICS_H_
+/**
+ * @file metrics.h
+ *
+ * Google Cloud Platform C++ Libraries metrics.
+ *
+ * The libraries record the latency of each operation, and of each attempt
+ * (the RPCs) made to complete the operation, as well as the number of retries,
+ * errors, and the volume of data transferred.  The metrics are recorded in a
+ * process-wide registry, the application can snapshot them at any time, or
+ * send them to its own monitoring system via a `MetricsExporter`.
+ *
+ * Recording a value must be cheap, it happens on the hot path of every
+ * operation.  The counters and histograms are sharded by thread, and each
+ * shard is a set of relaxed atomic counters: recording a value never blocks,
+ * and rarely contends with other threads.
+ *
+ * @par Example: Print the Latency of the Bigtable Reads
+ * @code
+ * void AppCode() {
+ *   auto snapshot = google::cloud::DefaultMetricsRegistry().Snapshot();
+ *   auto const& latency = snapshot.histograms["bigtable.ReadRows.latency"];
+ *   std::cout << "p99=" << latency.Percentile(99) << "us\n";
+ * }
+ * @endcode
+ */
+
+#include "google/cloud/version.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/// The number of shards in each counter and histogram.
+constexpr std::size_t kMetricShards = 8;
+
+/// Return the shard used by the calling thread.
+std::size_t MetricShard();
+}  // namespace internal
+
+/// A monotonically increasing counter.
+class Counter {
+ public:
+  Counter() = default;
+  Counter(Counter const&) = delete;
+  Counter& operator=(Counter const&) = delete;
+
+  void Increment(std::uint64_t n = 1) {
+    shards_[internal::MetricShard()].value.fetch_add(
+        n, std::memory_order_relaxed);
+  }
+
+  /// The sum of all the increments.
+  std::uint64_t value() const;
+
+ private:
+  struct Shard {
+    std::atomic<std::uint64_t> value{0};
+    // Keep each shard in its own cache line.
+    char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+  };
+  Shard shards_[internal::kMetricShards];
+};
+
+/// A point-in-time copy of a `Histogram`.
+struct HistogramSnapshot {
+  /// The number of values in each bucket, see `Histogram::BucketLowerBound()`.
+  std::vector<std::uint64_t> buckets;
+  std::uint64_t count = 0;
+  std::uint64_t sum = 0;
+
+  double Mean() const {
+    return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+  }
+
+  /**
+   * Estimate the @p percentile (in the [0, 100] range) of the values.
+   *
+   * @return the lower bound of the bucket containing the percentile, the
+   *     relative error is at most 1/8.
+   */
+  std::uint64_t Percentile(double percentile) const;
+};
+
+/**
+ * A histogram with log-linear buckets.
+ *
+ * Values smaller than 16 have their own bucket, larger values are grouped in 8
+ * buckets for each power of 2.  That bounds the relative error to 1/8, with a
+ * fixed number of buckets and no configuration.  The library records latencies
+ * in microseconds.
+ */
+class Histogram {
+ public:
+  /// The number of buckets, values beyond the last bucket are clamped.
+  static constexpr std::size_t kBucketCount = 16 + 8 * 44;
+
+  Histogram() = default;
+  Histogram(Histogram const&) = delete;
+  Histogram& operator=(Histogram const&) = delete;
+
+  void Record(std::uint64_t value) {
+    auto& shard = shards_[internal::MetricShard()];
+    shard.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /// Record a duration, in microseconds.
+  template <typename Rep, typename Period>
+  void Record(std::chrono::duration<Rep, Period> duration) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    Record(static_cast<std::uint64_t>(us.count() < 0 ? 0 : us.count()));
+  }
+
+  HistogramSnapshot Snapshot() const;
+
+  /// The bucket used for @p value.
+  static std::size_t BucketIndex(std::uint64_t value);
+
+  /// The smallest value in bucket @p index.
+  static std::uint64_t BucketLowerBound(std::size_t index);
+
+ private:
+  struct Shard {
+    std::atomic<std::uint64_t> buckets[kBucketCount];
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> sum;
+    Shard();
+  };
+  Shard shards_[internal::kMetricShards];
+};
+
+/// A point-in-time copy of all the metrics in a `MetricsRegistry`.
+struct MetricsSnapshot {
+  std::map<std::string, std::uint64_t> counters;
+  std::map<std::string, HistogramSnapshot> histograms;
+};
+
+/**
+ * Define the interface to send metrics to a monitoring system.
+ *
+ * Applications implement this interface to integrate the library metrics with
+ * their monitoring system, and call `MetricsRegistry::Export()` periodically.
+ */
+class MetricsExporter {
+ public:
+  virtual ~MetricsExporter() = default;
+
+  virtual void Export(MetricsSnapshot const& snapshot) = 0;
+};
+
+/**
+ * A set of counters and histograms, identified by name.
+ *
+ * Creating (or finding) a metric requires a lock, the code recording values
+ * should look up the metrics once and keep a reference to them.  The metrics
+ * are never deleted, the references remain valid as long as the registry.
+ */
+class MetricsRegistry {
+ public:
+  MetricsRegistry() = default;
+  MetricsRegistry(MetricsRegistry const&) = delete;
+  MetricsRegistry& operator=(MetricsRegistry const&) = delete;
+
+  /// Return the counter called @p name, creating it if needed.
+  Counter& GetCounter(std::string const& name);
+
+  /// Return the histogram called @p name, creating it if needed.
+  Histogram& GetHistogram(std::string const& name);
+
+  MetricsSnapshot Snapshot() const;
+
+  /// Send a snapshot of the metrics to @p exporter.
+  void Export(MetricsExporter& exporter) const { exporter.Export(Snapshot()); }
+
+ private:
+  mutable std::mutex mu_;
+  std::map<std::string, std::unique_ptr<Counter>> counters_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+
+/// Return the registry used by all the clients in the process.
+MetricsRegistry& DefaultMetricsRegistry();
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_METRICS_H_
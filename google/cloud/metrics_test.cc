@@ -0,0 +1,153 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/metrics.h"
+#include "google/cloud/internal/operation_metrics.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+using namespace google::cloud;
+using namespace ::testing;
+
+TEST(CounterTest, Simple) {
+  Counter counter;
+  EXPECT_EQ(0U, counter.value());
+  counter.Increment();
+  counter.Increment(41);
+  EXPECT_EQ(42U, counter.value());
+}
+
+TEST(CounterTest, Concurrent) {
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 8; ++t) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i != 10000; ++i) {
+        counter.Increment();
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(80000U, counter.value());
+}
+
+/// @test Verify that the buckets are log-linear, and cover all the values.
+TEST(HistogramTest, Buckets) {
+  for (std::uint64_t v = 0; v != 16; ++v) {
+    EXPECT_EQ(v, Histogram::BucketIndex(v));
+    EXPECT_EQ(v, Histogram::BucketLowerBound(v));
+  }
+  EXPECT_EQ(16U, Histogram::BucketIndex(16));
+  EXPECT_EQ(16U, Histogram::BucketIndex(17));
+  EXPECT_EQ(17U, Histogram::BucketIndex(18));
+  EXPECT_EQ(23U, Histogram::BucketIndex(31));
+  EXPECT_EQ(24U, Histogram::BucketIndex(32));
+  EXPECT_EQ(1024U, Histogram::BucketLowerBound(Histogram::BucketIndex(1024)));
+  EXPECT_EQ(Histogram::kBucketCount - 1,
+            Histogram::BucketIndex(std::uint64_t(1) << 63));
+
+  for (std::size_t i = 1; i != Histogram::kBucketCount; ++i) {
+    auto lower = Histogram::BucketLowerBound(i);
+    EXPECT_LT(Histogram::BucketLowerBound(i - 1), lower);
+    EXPECT_EQ(i, Histogram::BucketIndex(lower));
+    EXPECT_EQ(i - 1, Histogram::BucketIndex(lower - 1));
+  }
+}
+
+TEST(HistogramTest, Snapshot) {
+  Histogram histogram;
+  for (std::uint64_t v = 1; v <= 100; ++v) {
+    histogram.Record(v);
+  }
+  histogram.Record(std::chrono::milliseconds(2));
+  auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(101U, snapshot.count);
+  EXPECT_EQ(5050U + 2000U, snapshot.sum);
+  EXPECT_DOUBLE_EQ((5050.0 + 2000.0) / 101, snapshot.Mean());
+  EXPECT_EQ(1U, snapshot.Percentile(0));
+  // The relative error is bounded by the bucket width.
+  EXPECT_NEAR(50.0, static_cast<double>(snapshot.Percentile(50)), 50.0 / 8);
+  EXPECT_NEAR(2000.0, static_cast<double>(snapshot.Percentile(100)),
+              2000.0 / 8);
+  EXPECT_EQ(0U, HistogramSnapshot().Percentile(50));
+}
+
+TEST(MetricsRegistryTest, Snapshot) {
+  MetricsRegistry registry;
+  auto& counter = registry.GetCounter("test.counter");
+  EXPECT_EQ(&counter, &registry.GetCounter("test.counter"));
+  counter.Increment(3);
+  registry.GetHistogram("test.histogram").Record(7);
+
+  auto snapshot = registry.Snapshot();
+  EXPECT_THAT(snapshot.counters, ElementsAre(Pair("test.counter", 3U)));
+  ASSERT_EQ(1U, snapshot.histograms.count("test.histogram"));
+  EXPECT_EQ(1U, snapshot.histograms["test.histogram"].count);
+  EXPECT_EQ(7U, snapshot.histograms["test.histogram"].sum);
+}
+
+namespace {
+class MockExporter : public MetricsExporter {
+ public:
+  MOCK_METHOD1(Export, void(MetricsSnapshot const&));
+};
+}  // namespace
+
+TEST(MetricsRegistryTest, Export) {
+  MetricsRegistry registry;
+  registry.GetCounter("test.counter").Increment();
+  MockExporter exporter;
+  EXPECT_CALL(exporter, Export(_))
+      .WillOnce(Invoke([](MetricsSnapshot const& s) {
+        EXPECT_EQ(1U, s.counters.at("test.counter"));
+      }));
+  registry.Export(exporter);
+}
+
+TEST(OperationMetricsTest, Names) {
+  MetricsRegistry registry;
+  google::cloud::internal::OperationMetrics metrics("test.Op", registry);
+  metrics.operations.Increment();
+  metrics.attempts.Increment(2);
+  metrics.retries.Increment();
+  { google::cloud::internal::LatencyTimer timer(metrics.latency); }
+
+  auto snapshot = registry.Snapshot();
+  EXPECT_EQ(1U, snapshot.counters["test.Op.operations"]);
+  EXPECT_EQ(2U, snapshot.counters["test.Op.attempts"]);
+  EXPECT_EQ(1U, snapshot.counters["test.Op.retries"]);
+  EXPECT_EQ(0U, snapshot.counters["test.Op.errors"]);
+  EXPECT_EQ(1U, snapshot.histograms["test.Op.latency"].count);
+  EXPECT_EQ(0U, snapshot.histograms["test.Op.attempt_latency"].count);
+}
+
+/// @test Verify that recording a value is cheap.
+TEST(HistogramTest, Overhead) {
+  Histogram histogram;
+  int const iterations = 1000000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i != iterations; ++i) {
+    histogram.Record(static_cast<std::uint64_t>(i));
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto per_record =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+      iterations;
+  // This is a very loose bound, sanitizer and debug builds are much slower
+  // than optimized builds.
+  EXPECT_GT(1000, per_record);
+  EXPECT_EQ(std::uint64_t(iterations), histogram.Snapshot().count);
+}
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/retry_client.h"
+#include "google/cloud/internal/operation_metrics.h"
+#include "google/cloud/internal/retry_budget.h"
+#include "google/cloud/tracing.h"
 #include <sstream>
 #include <thread>
 
@@ -107,21 +110,55 @@ struct RetryUtils {
            MemberFunction function,
            typename CheckSignature<MemberFunction>::RequestType const& request,
            char const* error_message) {
+    // Each RawClient member function has a different signature, so there is
+    // an instance of this function, and of its metrics, for each operation.
+    static auto* const metrics = new google::cloud::internal::OperationMetrics(
+        std::string("storage.") + error_message);
+    google::cloud::internal::LatencyTimer timer(metrics->latency);
+    metrics->operations.Increment();
+    // The spans end (and are exported) even if the operation throws.
+    google::cloud::internal::Span span(metrics->name);
+    std::int64_t attempt = 0;
     google::cloud::storage::Status last_status;
     while (not retry_policy.IsExhausted()) {
+      metrics->attempts.Increment();
+      google::cloud::internal::Span attempt_span("attempt", span);
+      attempt_span.SetAttribute("attempt", ++attempt);
+      auto const attempt_start = std::chrono::steady_clock::now();
       auto result = (client.*function)(request);
+      metrics->attempt_latency.Record(std::chrono::steady_clock::now() -
+                                      attempt_start);
+      attempt_span.SetStatus(static_cast<int>(result.first.status_code()),
+                             result.first.error_message());
+      attempt_span.End();
+      span.SetAttribute("attempts", attempt);
+      span.SetStatus(static_cast<int>(result.first.status_code()),
+                     result.first.error_message());
       if (result.first.ok()) {
+        google::cloud::internal::DefaultRetryBudget().OnSuccess();
         return result;
       }
       last_status = std::move(result.first);
       if (not retry_policy.OnFailure(last_status)) {
+        metrics->errors.Increment();
         std::ostringstream os;
         os << "Permanent error in " << error_message << ": " << last_status;
         google::cloud::internal::RaiseRuntimeError(os.str());
       }
+      if (not google::cloud::internal::DefaultRetryBudget().TryRetry()) {
+        metrics->errors.Increment();
+        std::ostringstream os;
+        os << google::cloud::internal::kRetryBudgetExhausted << " in "
+           << error_message << ": " << last_status;
+        google::cloud::internal::RaiseRuntimeError(os.str());
+      }
+      metrics->retries.Increment();
       auto delay = backoff_policy.OnCompletion();
+      google::cloud::internal::Span backoff_span("backoff", span);
+      backoff_span.SetAttribute("delay_us", delay);
       std::this_thread::sleep_for(delay);
     }
+    metrics->errors.Increment();
     std::ostringstream os;
     os << "Retry policy exhausted in " << error_message << ": " << last_status;
     google::cloud::internal::RaiseRuntimeError(os.str());
@@ -0,0 +1,130 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/tracing.h"
+#include <atomic>
+#include <mutex>
+#include <random>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+struct TracingConfig {
+  std::mutex mu;
+  std::shared_ptr<SpanExporter> exporter;
+  double sampling_rate = 0.0;
+};
+
+// Never destroyed, spans may end during program shutdown.
+TracingConfig& GetTracingConfig() {
+  static TracingConfig* const config = new TracingConfig;
+  return *config;
+}
+
+// Checked before taking the mutex, so disabled tracing is (almost) free.
+std::atomic<bool> tracing_enabled(false);
+
+std::mt19937_64& TracingGenerator() {
+  thread_local std::mt19937_64 generator(std::random_device{}());
+  return generator;
+}
+
+std::uint64_t NewId() {
+  std::uint64_t id;
+  do {
+    id = TracingGenerator()();
+  } while (id == 0);
+  return id;
+}
+
+thread_local internal::Span* current_span = nullptr;
+}  // namespace
+
+void SetSpanExporter(std::shared_ptr<SpanExporter> exporter,
+                     double sampling_rate) {
+  auto& config = GetTracingConfig();
+  std::lock_guard<std::mutex> lk(config.mu);
+  config.exporter = std::move(exporter);
+  config.sampling_rate = sampling_rate;
+  tracing_enabled.store(config.exporter != nullptr and sampling_rate > 0.0,
+                        std::memory_order_release);
+}
+
+void ClearSpanExporter() { SetSpanExporter(nullptr, 0.0); }
+
+namespace internal {
+Span::Span(std::string const& name) {
+  if (not tracing_enabled.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto& config = GetTracingConfig();
+  {
+    std::lock_guard<std::mutex> lk(config.mu);
+    if (not config.exporter) {
+      return;
+    }
+    if (config.sampling_rate < 1.0) {
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      if (dist(TracingGenerator()) >= config.sampling_rate) {
+        return;
+      }
+    }
+    exporter_ = config.exporter;
+  }
+  data_.reset(new SpanData);
+  data_->name = name;
+  data_->trace_id = NewId();
+  data_->span_id = NewId();
+  data_->start_time = std::chrono::system_clock::now();
+  start_ = std::chrono::steady_clock::now();
+}
+
+Span::Span(char const* name, Span const& parent) {
+  if (not parent.active()) {
+    return;
+  }
+  exporter_ = parent.exporter_;
+  data_.reset(new SpanData);
+  data_->name = name;
+  data_->trace_id = parent.data_->trace_id;
+  data_->span_id = NewId();
+  data_->parent_span_id = parent.data_->span_id;
+  data_->start_time = std::chrono::system_clock::now();
+  start_ = std::chrono::steady_clock::now();
+}
+
+void Span::End() {
+  if (not data_) {
+    return;
+  }
+  data_->duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_);
+  std::unique_ptr<SpanData> data(std::move(data_));
+  std::shared_ptr<SpanExporter> exporter(std::move(exporter_));
+  exporter->Export(std::move(*data));
+}
+
+CurrentSpanScope::CurrentSpanScope(Span& span) : previous_(current_span) {
+  current_span = &span;
+}
+
+CurrentSpanScope::~CurrentSpanScope() { current_span = previous_; }
+
+Span* CurrentSpan() { return current_span; }
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,177 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TRACING_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TRACING_H_
+/**
+ * @file tracing.h
+ *
+ * Google Cloud Platform C++ Libraries tracing.
+ *
+ * The libraries create a span for each operation (e.g. reading a set of
+ * rows), and child spans for each attempt (the RPCs) and each backoff period
+ * between attempts.  The spans record the attempt number, the channel used,
+ * the status, the backoff delay, and how much data was transferred.
+ *
+ * Tracing is disabled by default, and then costs a single atomic load per
+ * operation.  The application enables tracing by installing a `SpanExporter`,
+ * and samples a fraction of the operations to limit the overhead:
+ *
+ * @code
+ * void AppCode() {
+ *   google::cloud::SetSpanExporter(std::make_shared<MyExporter>(), 0.01);
+ * }
+ * @endcode
+ */
+
+#include "google/cloud/version.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+/// The data recorded in a span.
+struct SpanData {
+  std::string name;
+  /// All the spans for the same operation have the same trace id.
+  std::uint64_t trace_id = 0;
+  std::uint64_t span_id = 0;
+  /// The id of the parent span, 0 for the operation spans.
+  std::uint64_t parent_span_id = 0;
+  std::chrono::system_clock::time_point start_time;
+  std::chrono::nanoseconds duration{0};
+  /// A `grpc::StatusCode`, or the HTTP status code for storage operations.
+  int status_code = 0;
+  std::string status_message;
+  std::map<std::string, std::int64_t> int_attributes;
+  std::map<std::string, std::string> string_attributes;
+};
+
+/**
+ * Define the interface to send spans to a tracing system.
+ *
+ * The libraries call `Export()` as each span ends, from the thread that ends
+ * it, the implementation must be thread-safe, and should not block.
+ */
+class SpanExporter {
+ public:
+  virtual ~SpanExporter() = default;
+
+  virtual void Export(SpanData span) = 0;
+};
+
+/**
+ * Send the spans for a fraction of the operations to @p exporter.
+ *
+ * @param exporter receives the spans, replaces any previous exporter.
+ * @param sampling_rate the fraction of the operations traced, in [0, 1].  All
+ *     the spans for a sampled operation are exported.
+ */
+void SetSpanExporter(std::shared_ptr<SpanExporter> exporter,
+                     double sampling_rate = 1.0);
+
+/// Disable tracing.
+void ClearSpanExporter();
+
+namespace internal {
+/**
+ * Record a span, and send it to the exporter when it ends.
+ *
+ * A default-constructed span, or one created while tracing is disabled (or
+ * not sampled), is inactive: all its member functions are no-ops.  The child
+ * spans of an inactive span are inactive too, so the sampling decision for an
+ * operation covers all its attempts.
+ */
+class Span {
+ public:
+  Span() = default;
+  /// Start a new operation span, if tracing is enabled and it is sampled.
+  explicit Span(std::string const& name);
+  /// Start a child span, active only if @p parent is active.
+  Span(char const* name, Span const& parent);
+  ~Span() { End(); }
+
+  Span(Span&&) noexcept = default;
+  Span& operator=(Span&& rhs) noexcept {
+    End();
+    data_ = std::move(rhs.data_);
+    start_ = rhs.start_;
+    exporter_ = std::move(rhs.exporter_);
+    return *this;
+  }
+
+  bool active() const { return data_ != nullptr; }
+
+  void SetAttribute(char const* key, std::int64_t value) {
+    if (data_) {
+      data_->int_attributes[key] = value;
+    }
+  }
+  /// Record a duration, such as a backoff delay, in microseconds.
+  void SetAttribute(char const* key, std::chrono::microseconds value) {
+    SetAttribute(key, static_cast<std::int64_t>(value.count()));
+  }
+  void SetAttribute(char const* key, std::string value) {
+    if (data_) {
+      data_->string_attributes[key] = std::move(value);
+    }
+  }
+  void SetStatus(int code, std::string message) {
+    if (data_) {
+      data_->status_code = code;
+      data_->status_message = std::move(message);
+    }
+  }
+
+  /// End the span and export it, the span is inactive afterwards.
+  void End();
+
+ private:
+  std::unique_ptr<SpanData> data_;
+  std::chrono::steady_clock::time_point start_;
+  std::shared_ptr<SpanExporter> exporter_;
+};
+
+/**
+ * Make @p span the current span of the calling thread, while in scope.
+ *
+ * Lower layers, which do not receive the span as a parameter, annotate the
+ * current span.  For example, the connection pool records which channel it
+ * selects for each attempt.
+ */
+class CurrentSpanScope {
+ public:
+  explicit CurrentSpanScope(Span& span);
+  ~CurrentSpanScope();
+
+  CurrentSpanScope(CurrentSpanScope const&) = delete;
+  CurrentSpanScope& operator=(CurrentSpanScope const&) = delete;
+
+ private:
+  Span* previous_;
+};
+
+/// The current span of the calling thread, `nullptr` if there is none.
+Span* CurrentSpan();
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_TRACING_H_
@@ -0,0 +1,152 @@
+// Copyright 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/tracing.h"
+#include <gmock/gmock.h>
+#include <mutex>
+#include <vector>
+
+using namespace google::cloud;
+using namespace ::testing;
+using google::cloud::internal::CurrentSpan;
+using google::cloud::internal::CurrentSpanScope;
+using google::cloud::internal::Span;
+
+namespace {
+class CapturingExporter : public SpanExporter {
+ public:
+  void Export(SpanData span) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    spans_.push_back(std::move(span));
+  }
+
+  std::vector<SpanData> spans() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return spans_;
+  }
+
+ private:
+  std::mutex mu_;
+  std::vector<SpanData> spans_;
+};
+
+class TracingTest : public ::testing::Test {
+ protected:
+  void TearDown() override { ClearSpanExporter(); }
+};
+}  // namespace
+
+/// @test Verify that spans are inactive when tracing is disabled.
+TEST_F(TracingTest, Disabled) {
+  Span span("test.Op");
+  EXPECT_FALSE(span.active());
+  Span child("attempt", span);
+  EXPECT_FALSE(child.active());
+  // These are no-ops, but must be safe.
+  child.SetAttribute("attempt", std::int64_t(1));
+  child.SetStatus(14, "unavailable");
+  child.End();
+}
+
+/// @test Verify that child spans are linked to their parent.
+TEST_F(TracingTest, ParentChild) {
+  auto exporter = std::make_shared<CapturingExporter>();
+  SetSpanExporter(exporter);
+  {
+    Span span("test.Op");
+    ASSERT_TRUE(span.active());
+    {
+      Span child("attempt", span);
+      child.SetAttribute("attempt", std::int64_t(1));
+      child.SetAttribute("method", "Apply");
+      child.SetAttribute("delay_us", std::chrono::milliseconds(2));
+      child.SetStatus(14, "unavailable");
+    }
+    span.SetStatus(0, "");
+  }
+
+  auto spans = exporter->spans();
+  ASSERT_EQ(2U, spans.size());
+  auto const& child = spans[0];
+  auto const& parent = spans[1];
+  EXPECT_EQ("attempt", child.name);
+  EXPECT_EQ("test.Op", parent.name);
+  EXPECT_EQ(parent.trace_id, child.trace_id);
+  EXPECT_EQ(parent.span_id, child.parent_span_id);
+  EXPECT_NE(parent.span_id, child.span_id);
+  EXPECT_EQ(0U, parent.parent_span_id);
+  EXPECT_EQ(14, child.status_code);
+  EXPECT_EQ("unavailable", child.status_message);
+  EXPECT_EQ(1, child.int_attributes.at("attempt"));
+  EXPECT_EQ(2000, child.int_attributes.at("delay_us"));
+  EXPECT_EQ("Apply", child.string_attributes.at("method"));
+  EXPECT_LE(child.duration, parent.duration);
+}
+
+/// @test Verify that ending a span twice exports it once.
+TEST_F(TracingTest, EndOnce) {
+  auto exporter = std::make_shared<CapturingExporter>();
+  SetSpanExporter(exporter);
+  {
+    Span span("test.Op");
+    span.End();
+    EXPECT_FALSE(span.active());
+    Span moved(std::move(span));
+    Span assigned;
+    assigned = std::move(moved);
+  }
+  EXPECT_EQ(1U, exporter->spans().size());
+}
+
+/// @test Verify that the sampling rate is (approximately) respected.
+TEST_F(TracingTest, Sampling) {
+  auto exporter = std::make_shared<CapturingExporter>();
+  SetSpanExporter(exporter, 0.25);
+  int const count = 4000;
+  for (int i = 0; i != count; ++i) {
+    Span span("test.Op");
+    Span child("attempt", span);
+  }
+  auto spans = exporter->spans();
+  // The children are sampled with their parents.
+  EXPECT_EQ(0U, spans.size() % 2);
+  EXPECT_NEAR(count / 4.0, spans.size() / 2.0, count / 20.0);
+
+  SetSpanExporter(exporter, 0.0);
+  Span span("test.Op");
+  EXPECT_FALSE(span.active());
+}
+
+TEST_F(TracingTest, CurrentSpan) {
+  auto exporter = std::make_shared<CapturingExporter>();
+  SetSpanExporter(exporter);
+  EXPECT_EQ(nullptr, CurrentSpan());
+  Span outer("test.Op");
+  {
+    CurrentSpanScope outer_scope(outer);
+    EXPECT_EQ(&outer, CurrentSpan());
+    Span inner("attempt", outer);
+    {
+      CurrentSpanScope inner_scope(inner);
+      EXPECT_EQ(&inner, CurrentSpan());
+      CurrentSpan()->SetAttribute("channel_index", std::int64_t(3));
+    }
+    EXPECT_EQ(&outer, CurrentSpan());
+  }
+  EXPECT_EQ(nullptr, CurrentSpan());
+
+  auto spans = exporter->spans();
+  ASSERT_EQ(1U, spans.size());
+  EXPECT_EQ(3, spans[0].int_attributes.at("channel_index"));
+}